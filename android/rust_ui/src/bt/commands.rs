@@ -88,7 +88,7 @@ fn make_bt_command_map() -> HashMap<String, String> {
     );
     m.insert(
         "subghz.packet.send".into(),
-        "Send a custom sub‑GHz packet. Params: { frequency_khz: int, modulation: string, payload: string }".into(),
+        "Send one CC1101 packet. Params: { radio: 1 | 2, frequency_mhz: float, power_dbm: int, payload: base64 (up to 61 bytes) }, or a CC1101Tx body in a binary command".into(),
     );
     m.insert(
         "subghz.disruptor.start".into(),
@@ -198,6 +198,22 @@ fn make_bt_command_map() -> HashMap<String, String> {
         "status.reporting.stop".into(),
         "Stop periodic status reporting. No params.".into(),
     );
+    m.insert(
+        "ble.link".into(),
+        "Report the negotiated BLE MTU and compression counters, optionally switching status notifications to MTU-sized frames and LZSS compression. Params: { framing: bool (optional), compress: bool (optional, implies framing) }".into(),
+    );
+    m.insert(
+        "serial.link".into(),
+        "Report or switch the USB serial output between text (PROTO: lines) and COBS-framed binary. Params: { binary: bool (optional) }".into(),
+    );
+    m.insert(
+        "radio.batch.policy".into(),
+        "Report or set when JSON radio-batches are sent, per module or for all, and whether this client receives them. Params: { module: int (optional), preset: \"interactive\"|\"bulk\"|\"default\" (optional), max_events: int, max_bytes: int, idle_ms: int, max_age_ms: int, frame_bytes: int, match_mtu: bool, layout: \"rows\"|\"columns\", json: bool (subscribes this client over BLE, implies framing; cleared on disconnect) (all optional; 0 turns a limit off) }".into(),
+    );
+    m.insert(
+        "mem.stats".into(),
+        "Report free PSRAM and internal heap (with its largest free block) and the bytes each buffer region holds in PSRAM and internal RAM. No params".into(),
+    );
 
     m
 }
@@ -44,91 +44,7 @@ pub fn init(app: &AppHandle) {
           let b64 = &msg[6..];
           match base64::decode(b64) {
             Ok(bytes) => {
-              // strip optional 0xAA55 + u16 length framing
-              let mut cursor = 0usize;
-              if bytes.len() >= 4 && bytes[0] == 0xAA && bytes[1] == 0x55 {
-                let len = (bytes[2] as usize) | ((bytes[3] as usize) << 8);
-                cursor = 4;
-                if cursor + len > bytes.len() { cursor = 4; }
-              }
-              let body = &bytes[cursor..];
-              // Parse minimal protobuf fields for RadioSignal
-              let mut i = 0usize;
-              let mut obj = serde_json::Map::new();
-              while i < body.len() {
-                // read varint tag
-                let mut shift = 0u32;
-                let mut tag: u64 = 0;
-                loop {
-                  if i >= body.len() { break; }
-                  let b = body[i]; i += 1;
-                  tag |= ((b & 0x7F) as u64) << shift;
-                  if (b & 0x80) == 0 { break; }
-                  shift += 7;
-                }
-                let field = (tag >> 3) as u32;
-                let wire = (tag & 0x7) as u8;
-                match wire {
-                  0 => { // varint
-                    // read varint value
-                    let mut shift = 0u32; let mut val: u64 = 0;
-                    loop {
-                      if i >= body.len() { break; }
-                      let b = body[i]; i += 1;
-                      val |= ((b & 0x7F) as u64) << shift;
-                      if (b & 0x80) == 0 { break; }
-                      shift += 7;
-                    }
-                    match field {
-                      1 => { obj.insert("timestamp_ms".into(), Value::from(val)); }
-                      2 => { obj.insert("module".into(), Value::from(val as i64)); }
-                      4 => {
-                        // ZigZag-decode RSSI (sint) encoded as varint
-                        let rssi = ((val >> 1) as i64) ^ -((val & 1) as i64);
-                        obj.insert("rssi".into(), Value::from(rssi));
-                      }
-                      _ => {}
-                    }
-                  }
-                  5 => { // 32-bit
-                    if i + 4 <= body.len() {
-                      let b0 = body[i]; let b1 = body[i+1]; let b2 = body[i+2]; let b3 = body[i+3];
-                      i += 4;
-                      let u = ((b3 as u32) << 24) | ((b2 as u32) << 16) | ((b1 as u32) << 8) | (b0 as u32);
-                      let f = f32::from_bits(u);
-                      if field == 3 { obj.insert("frequency_mhz".into(), Value::from(f as f64)); }
-                    }
-                  }
-                  2 => { // length-delimited
-                    // read length varint
-                    let mut shift = 0u32; let mut l: u64 = 0;
-                    loop {
-                      if i >= body.len() { break; }
-                      let b = body[i]; i += 1;
-                      l |= ((b & 0x7F) as u64) << shift;
-                      if (b & 0x80) == 0 { break; }
-                      shift += 7;
-                    }
-                    let li = l as usize;
-                    if i + li <= body.len() {
-                      let slice = &body[i..i+li];
-                      i += li;
-                      if field == 5 {
-                        // payload bytes -> base64
-                        let b64 = base64::encode(slice);
-                        obj.insert("payload".into(), Value::from(b64));
-                      } else if field == 6 {
-                        if let Ok(s) = std::str::from_utf8(slice) { obj.insert("extra".into(), Value::from(s)); }
-                      }
-                    }
-                  }
-                  _ => {
-                    // unsupported wire type: bail out to avoid infinite loop
-                    break;
-                  }
-                }
-              }
-              Some(Value::Object(obj))
+              Some(Value::Object(decode_radio_signal_frame(&bytes)))
             }
             Err(e) => {
               log::warn!("bt::listener: base64 decode failed: {}", e);
@@ -155,91 +71,7 @@ pub fn init(app: &AppHandle) {
           }
 
           if let Some(bytes) = decoded {
-            // strip optional 0xAA55 + u16 length framing
-            let mut cursor = 0usize;
-            if bytes.len() >= 4 && bytes[0] == 0xAA && bytes[1] == 0x55 {
-              let len = (bytes[2] as usize) | ((bytes[3] as usize) << 8);
-              cursor = 4;
-              if cursor + len > bytes.len() { cursor = 4; }
-            }
-            let body = &bytes[cursor..];
-            // Parse minimal protobuf fields for RadioSignal
-            let mut i = 0usize;
-            let mut obj = serde_json::Map::new();
-            while i < body.len() {
-              // read varint tag
-              let mut shift = 0u32;
-              let mut tag: u64 = 0;
-              loop {
-                if i >= body.len() { break; }
-                let b = body[i]; i += 1;
-                tag |= ((b & 0x7F) as u64) << shift;
-                if (b & 0x80) == 0 { break; }
-                shift += 7;
-              }
-              let field = (tag >> 3) as u32;
-              let wire = (tag & 0x7) as u8;
-              match wire {
-                0 => { // varint
-                  // read varint value
-                  let mut shift = 0u32; let mut val: u64 = 0;
-                  loop {
-                    if i >= body.len() { break; }
-                    let b = body[i]; i += 1;
-                    val |= ((b & 0x7F) as u64) << shift;
-                    if (b & 0x80) == 0 { break; }
-                    shift += 7;
-                  }
-                  match field {
-                    1 => { obj.insert("timestamp_ms".into(), Value::from(val)); }
-                    2 => { obj.insert("module".into(), Value::from(val as i64)); }
-                    4 => {
-                      // ZigZag-decode RSSI (sint) encoded as varint
-                      let rssi = ((val >> 1) as i64) ^ -((val & 1) as i64);
-                      obj.insert("rssi".into(), Value::from(rssi));
-                    }
-                    _ => {}
-                  }
-                }
-                5 => { // 32-bit
-                  if i + 4 <= body.len() {
-                    let b0 = body[i]; let b1 = body[i+1]; let b2 = body[i+2]; let b3 = body[i+3];
-                    i += 4;
-                    let u = ((b3 as u32) << 24) | ((b2 as u32) << 16) | ((b1 as u32) << 8) | (b0 as u32);
-                    let f = f32::from_bits(u);
-                    if field == 3 { obj.insert("frequency_mhz".into(), Value::from(f as f64)); }
-                  }
-                }
-                2 => { // length-delimited
-                  // read length varint
-                  let mut shift = 0u32; let mut l: u64 = 0;
-                  loop {
-                    if i >= body.len() { break; }
-                    let b = body[i]; i += 1;
-                    l |= ((b & 0x7F) as u64) << shift;
-                    if (b & 0x80) == 0 { break; }
-                    shift += 7;
-                  }
-                  let li = l as usize;
-                  if i + li <= body.len() {
-                    let slice = &body[i..i+li];
-                    i += li;
-                    if field == 5 {
-                      // payload bytes -> base64
-                      let b64 = base64::encode(slice);
-                      obj.insert("payload".into(), Value::from(b64));
-                    } else if field == 6 {
-                      if let Ok(s) = std::str::from_utf8(slice) { obj.insert("extra".into(), Value::from(s)); }
-                    }
-                  }
-                }
-                _ => {
-                  // unsupported wire type: bail out to avoid infinite loop
-                  break;
-                }
-              }
-            }
-            Some(Value::Object(obj))
+            Some(Value::Object(decode_radio_signal_frame(&bytes)))
           } else {
             None
           }
@@ -337,6 +169,10 @@ pub fn init(app: &AppHandle) {
             for s in arr {
               process_signal(s);
             }
+          } else if v.get("layout").and_then(|l| l.as_str()) == Some("columns") {
+            for s in expand_columnar_batch(&v) {
+              process_signal(&s);
+            }
           }
         } else {
           // single
@@ -349,6 +185,168 @@ pub fn init(app: &AppHandle) {
   });
 }
 
+/// Turn a columnar radio batch (`"layout":"columns"`: one array per field)
+/// back into the per-signal objects of the row layout.
+fn expand_columnar_batch(v: &Value) -> Vec<Value> {
+  let module = v.get("module").cloned().unwrap_or(Value::Null);
+  let column = |name: &str| v.get(name).and_then(|c| c.as_array()).cloned().unwrap_or_default();
+  let ts = column("timestamp_ms");
+  let freq = column("frequency_mhz");
+  let rssi = column("rssi");
+  let payload = column("payload");
+  let n = ts.len().min(freq.len()).min(rssi.len()).min(payload.len());
+  (0..n)
+    .map(|i| {
+      let mut obj = serde_json::Map::new();
+      obj.insert("timestamp_ms".into(), ts[i].clone());
+      obj.insert("module".into(), module.clone());
+      obj.insert("frequency_mhz".into(), freq[i].clone());
+      obj.insert("rssi".into(), rssi[i].clone());
+      obj.insert("payload".into(), payload[i].clone());
+      Value::Object(obj)
+    })
+    .collect()
+}
+
+/// Decode a firmware RadioSignal protobuf (optionally framed as
+/// `[0xAA 0x55][u16 le length][message]`) into the same JSON shape the
+/// firmware sends in radio batches. A RadioSignalBatch sweep chunk (fields
+/// 16+) becomes a `radio-batch` object with one signal per step.
+fn decode_radio_signal_frame(bytes: &[u8]) -> serde_json::Map<String, Value> {
+  // strip optional 0xAA55 + u16 length framing
+  let mut cursor = 0usize;
+  if bytes.len() >= 4 && bytes[0] == 0xAA && bytes[1] == 0x55 {
+    let len = (bytes[2] as usize) | ((bytes[3] as usize) << 8);
+    cursor = 4;
+    if cursor + len > bytes.len() { cursor = 4; }
+  }
+  let body = &bytes[cursor..];
+  // Parse minimal protobuf fields for RadioSignal
+  let mut i = 0usize;
+  let mut obj = serde_json::Map::new();
+  // RadioSignalBatch fields
+  let mut is_batch = false;
+  let mut base_khz: u64 = 0;
+  let mut step_khz: u64 = 0;
+  let mut rssi_deltas: Vec<i64> = Vec::new();
+  let mut modulation = String::new();
+  while i < body.len() {
+    // read varint tag
+    let mut shift = 0u32;
+    let mut tag: u64 = 0;
+    loop {
+      if i >= body.len() { break; }
+      let b = body[i]; i += 1;
+      tag |= ((b & 0x7F) as u64) << shift;
+      if (b & 0x80) == 0 { break; }
+      shift += 7;
+    }
+    let field = (tag >> 3) as u32;
+    let wire = (tag & 0x7) as u8;
+    match wire {
+      0 => { // varint
+        // read varint value
+        let mut shift = 0u32; let mut val: u64 = 0;
+        loop {
+          if i >= body.len() { break; }
+          let b = body[i]; i += 1;
+          val |= ((b & 0x7F) as u64) << shift;
+          if (b & 0x80) == 0 { break; }
+          shift += 7;
+        }
+        match field {
+          1 => { obj.insert("timestamp_ms".into(), Value::from(val)); }
+          2 => { obj.insert("module".into(), Value::from(val as i64)); }
+          4 => {
+            // ZigZag-decode RSSI (sint) encoded as varint
+            let rssi = ((val >> 1) as i64) ^ -((val & 1) as i64);
+            obj.insert("rssi".into(), Value::from(rssi));
+          }
+          16 => { is_batch = true; obj.insert("timestamp_ms".into(), Value::from(val)); }
+          17 => { is_batch = true; obj.insert("module".into(), Value::from(val as i64)); }
+          18 => { is_batch = true; base_khz = val; }
+          19 => { is_batch = true; step_khz = val; }
+          16..=23 => { is_batch = true; }
+          _ => {}
+        }
+      }
+      5 => { // 32-bit
+        if i + 4 <= body.len() {
+          let b0 = body[i]; let b1 = body[i+1]; let b2 = body[i+2]; let b3 = body[i+3];
+          i += 4;
+          let u = ((b3 as u32) << 24) | ((b2 as u32) << 16) | ((b1 as u32) << 8) | (b0 as u32);
+          let f = f32::from_bits(u);
+          if field == 3 { obj.insert("frequency_mhz".into(), Value::from(f as f64)); }
+        }
+      }
+      2 => { // length-delimited
+        // read length varint
+        let mut shift = 0u32; let mut l: u64 = 0;
+        loop {
+          if i >= body.len() { break; }
+          let b = body[i]; i += 1;
+          l |= ((b & 0x7F) as u64) << shift;
+          if (b & 0x80) == 0 { break; }
+          shift += 7;
+        }
+        let li = l as usize;
+        if i + li <= body.len() {
+          let slice = &body[i..i+li];
+          i += li;
+          if field == 5 {
+            // payload bytes -> base64
+            let b64 = base64::encode(slice);
+            obj.insert("payload".into(), Value::from(b64));
+          } else if field == 6 {
+            if let Ok(s) = std::str::from_utf8(slice) { obj.insert("extra".into(), Value::from(s)); }
+          } else if field == 20 {
+            is_batch = true;
+            if let Ok(s) = std::str::from_utf8(slice) { modulation = s.to_string(); }
+          } else if field == 21 {
+            // packed sint32 RSSI deltas
+            is_batch = true;
+            let (mut j, mut shift, mut val) = (0usize, 0u32, 0u64);
+            while j < slice.len() {
+              let b = slice[j]; j += 1;
+              val |= ((b & 0x7F) as u64) << shift;
+              shift += 7;
+              if (b & 0x80) == 0 {
+                rssi_deltas.push(((val >> 1) as i64) ^ -((val & 1) as i64));
+                shift = 0;
+                val = 0;
+              }
+            }
+          }
+        }
+      }
+      _ => {
+        // unsupported wire type: bail out to avoid infinite loop
+        break;
+      }
+    }
+  }
+  if is_batch {
+    let ts = obj.get("timestamp_ms").cloned().unwrap_or(Value::from(0u64));
+    let module = obj.get("module").cloned().unwrap_or(Value::from(-1i64));
+    let mut rssi = 0i64;
+    let signals: Vec<Value> = rssi_deltas.iter().enumerate().map(|(n, d)| {
+      rssi += d;
+      let mut sig = serde_json::Map::new();
+      sig.insert("timestamp_ms".into(), ts.clone());
+      sig.insert("module".into(), module.clone());
+      sig.insert("frequency_mhz".into(), Value::from((base_khz + n as u64 * step_khz) as f64 / 1000.0));
+      sig.insert("rssi".into(), Value::from(rssi));
+      sig.insert("extra".into(), Value::from(modulation.as_str()));
+      Value::Object(sig)
+    }).collect();
+    let mut batch = serde_json::Map::new();
+    batch.insert("type".into(), Value::from("radio-batch"));
+    batch.insert("signals".into(), Value::from(signals));
+    return batch;
+  }
+  obj
+}
+
 /// Tauri command: send a JSON payload (string) to the listener thread.
 #[tauri::command]
 pub fn bt_listener_append(payload: String) -> Result<(), String> {
@@ -359,3 +357,58 @@ pub fn bt_listener_append(payload: String) -> Result<(), String> {
     Err("listener_not_initialized".into())
   }
 }
+
+#[cfg(test)]
+mod tests {
+  use super::*;
+
+  // RadioSignal from the firmware's generated encoder (main/sharkos.pb.h),
+  // framed; regenerate with `host/build/bench_proto --golden`.
+  const GOLDEN_FRAME: &str =
+    "aa55240008959aef3a10011dc3f5d84320b5012a0702289c0600b500320a7363616e5f72616e6765";
+  // RadioSignalBatch sweep chunk, second line of the same command.
+  const GOLDEN_BATCH_FRAME: &str =
+    "aa552400800188278801009001e8b61a980164a2010741534b2f4f4f4baa0105c701046a6bb80100";
+
+  fn unhex(s: &str) -> Vec<u8> {
+    (0..s.len()).step_by(2).map(|i| u8::from_str_radix(&s[i..i + 2], 16).unwrap()).collect()
+  }
+
+  #[test]
+  fn decodes_firmware_radio_signal() {
+    let obj = decode_radio_signal_frame(&unhex(GOLDEN_FRAME));
+    assert_eq!(obj["timestamp_ms"], Value::from(123456789u64));
+    assert_eq!(obj["module"], Value::from(1i64));
+    assert!((obj["frequency_mhz"].as_f64().unwrap() - 433.92).abs() < 1e-4);
+    assert_eq!(obj["rssi"], Value::from(-91i64));
+    assert_eq!(obj["payload"], Value::from(base64::encode([2u8, 0x28, 0x9C, 0x06, 0x00, 0xB5, 0x00])));
+    assert_eq!(obj["extra"], Value::from("scan_range"));
+  }
+
+  #[test]
+  fn decodes_firmware_sweep_batch() {
+    let obj = decode_radio_signal_frame(&unhex(GOLDEN_BATCH_FRAME));
+    assert_eq!(obj["type"], Value::from("radio-batch"));
+    let signals = obj["signals"].as_array().unwrap();
+    let rssi: Vec<i64> = signals.iter().map(|s| s["rssi"].as_i64().unwrap()).collect();
+    assert_eq!(rssi, vec![-100, -98, -45, -99]);
+    assert!((signals[3]["frequency_mhz"].as_f64().unwrap() - 433.3).abs() < 1e-9);
+    assert_eq!(signals[0]["module"], Value::from(0i64));
+    assert_eq!(signals[0]["timestamp_ms"], Value::from(5000u64));
+    assert_eq!(signals[0]["extra"], Value::from("ASK/OOK"));
+  }
+
+  #[test]
+  fn expands_columnar_batch() {
+    let v: Value = serde_json::from_str(
+      r#"{"type":"radio-batch","module":2,"layout":"columns","count":2,"timestamp_ms":[10,20],"frequency_mhz":[433.920000,868.350000],"rssi":[-60,-72],"payload":["AQI=",""]}"#,
+    )
+    .unwrap();
+    let signals = expand_columnar_batch(&v);
+    assert_eq!(signals.len(), 2);
+    assert_eq!(signals[1]["timestamp_ms"], Value::from(20u64));
+    assert_eq!(signals[1]["module"], Value::from(2i64));
+    assert_eq!(signals[0]["rssi"], Value::from(-60i64));
+    assert_eq!(signals[0]["payload"], Value::from("AQI="));
+  }
+}
@@ -1319,6 +1319,13 @@ async function setup() {
       }
       return val >>> 0; // unsigned
     }
+    // RadioSignalBatch (sweep chunk) fields are numbered from 16
+    if (i < bytes.length) {
+      const first = i;
+      const firstField = readVarint() >>> 3;
+      i = first;
+      if (firstField >= 16) return decodeSweepBatch(bytes, i);
+    }
     // flag to detect whether this appears to be the status struct
     let statusMsg = false;
     while (i < bytes.length) {
@@ -1393,6 +1400,55 @@ async function setup() {
     return (Object.keys(obj).length > 0) ? obj : null;
   }
 
+  // RadioSignalBatch -> { type: 'radio-batch', signals } with one signal per
+  // sweep step, the shape the JSON radio batches use.
+  function decodeSweepBatch(bytes: Uint8Array, start: number): any | null {
+    let i = start;
+    function readVarint(): number {
+      let val = 0, mul = 1;
+      while (i < bytes.length) {
+        const b = bytes[i++];
+        val += (b & 0x7F) * mul;
+        if ((b & 0x80) === 0) break;
+        mul *= 128;
+      }
+      return val;
+    }
+    const zigzag = (v: number) => (v % 2 ? -(v + 1) / 2 : v / 2);
+    let ts = 0, module = -1, baseKhz = 0, stepKhz = 0, modulation = '';
+    const deltas: number[] = [];
+    while (i < bytes.length) {
+      const tag = readVarint();
+      const field = Math.floor(tag / 8);
+      const wire = tag & 0x7;
+      if (wire === 0) {
+        const val = readVarint();
+        if (field === 16) ts = val;
+        else if (field === 17) module = val;
+        else if (field === 18) baseKhz = val;
+        else if (field === 19) stepKhz = val;
+      } else if (wire === 2) {
+        const len = readVarint();
+        if (i + len > bytes.length) return null;
+        const end = i + len;
+        if (field === 20) {
+          modulation = new TextDecoder().decode(bytes.slice(i, end));
+        } else if (field === 21) {
+          while (i < end) deltas.push(zigzag(readVarint()));
+        }
+        i = end;
+      } else {
+        return null;
+      }
+    }
+    let rssi = 0;
+    const signals = deltas.map((d, n) => {
+      rssi += d;
+      return { timestamp_ms: ts, module, frequency_mhz: (baseKhz + n * stepKhz) / 1000, rssi, extra: modulation };
+    });
+    return { type: 'radio-batch', signals };
+  }
+
 
 // BLE Advertising Channels: 37, 38, 39 are primary. Data channels 0-36.
 // LE scanners typically hop all 3 advertising channels.
@@ -1637,7 +1693,15 @@ function getBleChannel(freq: number): number | null {
       showSubghzTestResult(r);
       return;
     }
-    if (r && r.type === 'radio-batch' && Array.isArray(r.signals)) {
+    if (r && r.type === 'radio-batch' && r.layout === 'columns') {
+      // columnar batch: one array per field, same signals as the row layout
+      const n = Math.min(r.timestamp_ms?.length ?? 0, r.frequency_mhz?.length ?? 0, r.rssi?.length ?? 0, r.payload?.length ?? 0);
+      for (let i = 0; i < n; i++) {
+        const s = { timestamp_ms: r.timestamp_ms[i], module: r.module, frequency_mhz: r.frequency_mhz[i], rssi: r.rssi[i], payload: r.payload[i] };
+        processSignal(s);
+        try { invoke('bt_listener_append', { payload: JSON.stringify(s) }).catch(() => {}); } catch {}
+      }
+    } else if (r && r.type === 'radio-batch' && Array.isArray(r.signals)) {
       for (const s of r.signals) {
         processSignal(s);
         try { invoke('bt_listener_append', { payload: JSON.stringify(s) }).catch(() => {}); } catch {}
@@ -0,0 +1,208 @@
+"""Generate main/sharkos.pb.h from .proto.
+
+Emits one plain struct per message plus inline pb_encode_<Msg>() /
+pb_decode_<Msg>() functions on top of the wire runtime in main/pb_codec.h
+(nanopb-style: fixed caller buffers, no heap). Re-run after editing .proto:
+
+    python3 gen_proto.py            # writes main/sharkos.pb.h
+    python3 gen_proto.py --check    # exit 1 if the header is stale
+
+Only the subset of proto3 that .proto uses is understood: top-level enums and
+messages with scalar, enum, bytes and string fields, packed repeated
+int32/sint32 (PbPackedInt32) and message fields. A message field is a PbBytes
+(on decode a view of the nested message, decoded on demand); a repeated one is
+a PbRepeated walked with pb_repeated_next(). Every message used as a field
+also gets pb_message() / pb_repeated() helpers that stream structs into them.
+
+Scalar fields are always written, even at their default value. That is legal
+proto3 and keeps the bytes identical to the original hand-rolled encoder,
+which the app decoders (bt/listener.rs, main.ts) rely on: they tell a status
+message from a RadioSignal by which fields are present. Empty bytes/string
+fields are omitted.
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+PROTO = os.path.join(ROOT, ".proto")
+OUT = os.path.join(ROOT, "main", "sharkos.pb.h")
+
+# proto type -> (C++ type, wire type, write expr, decode stmt)
+SCALARS = {
+    "uint64": ("uint64_t", "PB_WT_VARINT", "pb_write_varint(s, {v})", "{dst} = v;"),
+    "uint32": ("uint32_t", "PB_WT_VARINT", "pb_write_varint(s, {v})", "{dst} = (uint32_t)v;"),
+    "int32": ("int32_t", "PB_WT_VARINT", "pb_write_int32(s, {v})", "{dst} = (int32_t)v;"),
+    "sint32": ("int32_t", "PB_WT_VARINT", "pb_write_sint32(s, {v})", "{dst} = pb_zigzag32(v);"),
+    "bool": ("bool", "PB_WT_VARINT", "pb_write_varint(s, {v} ? 1 : 0)", "{dst} = v != 0;"),
+    "float": ("float", "PB_WT_32BIT", "pb_write_float(s, {v})", None),
+}
+
+
+# packed repeated fields -> PbPackedInt32
+REPEATED = ("repeated int32", "repeated sint32")
+
+
+def strip_comments(text):
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def parse(text):
+    text = strip_comments(text)
+    enums, messages = [], []
+    for m in re.finditer(r"\b(enum|message)\s+(\w+)\s*\{([^}]*)\}", text):
+        kind, name, body = m.groups()
+        if kind == "enum":
+            values = re.findall(r"(\w+)\s*=\s*(-?\d+)\s*;", body)
+            enums.append((name, [(v, int(n)) for v, n in values]))
+        else:
+            fields = re.findall(r"(repeated\s+)?(\w+)\s+(\w+)\s*=\s*(\d+)\s*;", body)
+            messages.append((name, [(("repeated " + t) if r else t, f, int(n)) for r, t, f, n in fields]))
+    return enums, messages
+
+
+def generate(enums, messages):
+    enum_names = {name for name, _ in enums}
+    message_names = {name for name, _ in messages}
+    nested = {t.replace("repeated ", "") for _, fields in messages for t, _, _ in fields} & message_names
+    out = []
+    w = out.append
+    w("// Generated by gen_proto.py from .proto -- do not edit.")
+    w("//")
+    w("// Encoders write into a PbOStream over a caller buffer; decoders fill the")
+    w("// struct from a PbIStream, with bytes/string fields pointing into the")
+    w("// input. See pb_codec.h.")
+    w("")
+    w("#ifndef SHARKOS_PB_H")
+    w("#define SHARKOS_PB_H")
+    w("")
+    w('#include "pb_codec.h"')
+    w("")
+    for name, values in enums:
+        w("enum %s_pb : int32_t {" % name)
+        for v, n in values:
+            w("  %s_%s = %d," % (name, v, n))
+        w("};")
+        w("")
+
+    for name, fields in messages:
+        for ptype, fname, _ in fields:
+            base = ptype.replace("repeated ", "")
+            if base in message_names:
+                continue
+            if ptype not in SCALARS and ptype not in enum_names and ptype not in ("bytes", "string") + REPEATED:
+                sys.exit("gen_proto.py: %s.%s: unsupported type '%s'" % (name, fname, ptype))
+
+        w("struct %s_pb {" % name)
+        for ptype, fname, num in fields:
+            if ptype in ("bytes", "string"):
+                w("  PbBytes %s = {};" % fname)
+            elif ptype in message_names:
+                w("  PbBytes %s = {};  // %s" % (fname, ptype))
+            elif ptype.startswith("repeated ") and ptype[9:] in message_names:
+                w("  PbRepeated %s = {};  // %s" % (fname, ptype[9:]))
+            elif ptype in REPEATED:
+                w("  PbPackedInt32 %s = {};" % fname)
+            elif ptype in enum_names:
+                w("  %s_pb %s = (%s_pb)0;" % (ptype, fname, ptype))
+            else:
+                ctype = SCALARS[ptype][0]
+                w("  %s %s = %s;" % (ctype, fname, "false" if ctype == "bool" else "0"))
+        w("};")
+        w("")
+
+        w("static inline bool pb_encode_%s(PbOStream &s, const %s_pb &m) {" % (name, name))
+        for ptype, fname, num in fields:
+            if ptype in ("bytes", "string") or ptype in message_names:
+                w("  if (!m.%s.empty() && !(pb_write_tag(s, %d, PB_WT_BYTES) && pb_write_bytes(s, m.%s))) return false;"
+                  % (fname, num, fname))
+            elif ptype.startswith("repeated ") and ptype[9:] in message_names:
+                w("  if (!pb_write_repeated(s, %d, m.%s)) return false;" % (num, fname))
+            elif ptype in REPEATED:
+                w("  if (!m.%s.empty() && !(pb_write_tag(s, %d, PB_WT_BYTES) && pb_write_packed_int32(s, m.%s, %s))) return false;"
+                  % (fname, num, fname, "true" if ptype == "repeated sint32" else "false"))
+            elif ptype in enum_names:
+                w("  if (!(pb_write_tag(s, %d, PB_WT_VARINT) && pb_write_int32(s, (int32_t)m.%s))) return false;"
+                  % (num, fname))
+            else:
+                _, wt, expr, _ = SCALARS[ptype]
+                w("  if (!(pb_write_tag(s, %d, %s) && %s)) return false;" % (num, wt, expr.format(v="m." + fname)))
+        w("  return true;")
+        w("}")
+        w("")
+
+        needs_varint = any(t in enum_names or (t in SCALARS and SCALARS[t][1] == "PB_WT_VARINT") for t, _, _ in fields)
+        w("static inline bool pb_decode_%s(PbIStream &s, %s_pb &m) {" % (name, name))
+        w("  m = %s_pb();" % name)
+        w("  uint32_t field;")
+        w("  PbWireType wt;")
+        if needs_varint:
+            w("  uint64_t v;")
+        repeated_msgs = any(t.startswith("repeated ") and t[9:] in message_names for t, _, _ in fields)
+        w("  while (s.p < s.end) {")
+        if repeated_msgs:
+            w("    const uint8_t *tag = s.p;")
+        w("    if (!pb_read_tag(s, field, wt)) return false;")
+        w("    switch (field) {")
+        for ptype, fname, num in fields:
+            dst = "m." + fname
+            if ptype in ("bytes", "string") or ptype in message_names:
+                w("      case %d: if (wt != PB_WT_BYTES || !pb_read_bytes(s, %s)) return false; break;" % (num, dst))
+            elif ptype.startswith("repeated ") and ptype[9:] in message_names:
+                w("      case %d: if (wt != PB_WT_BYTES || !pb_read_repeated(s, %d, tag, %s)) return false; break;"
+                  % (num, num, dst))
+            elif ptype in REPEATED:
+                w("      case %d: if (wt != PB_WT_BYTES || !pb_read_packed_int32(s, %s)) return false; break;" % (num, dst))
+            elif ptype == "float":
+                w("      case %d: if (wt != PB_WT_32BIT || !pb_read_float(s, %s)) return false; break;" % (num, dst))
+            else:
+                stmt = ("%s = (%s_pb)(int32_t)v;" % (dst, ptype)) if ptype in enum_names else SCALARS[ptype][3].format(dst=dst)
+                w("      case %d: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; %s break;" % (num, stmt))
+        w("      default: if (!pb_skip(s, wt)) return false; break;")
+        w("    }")
+        w("  }")
+        w("  return true;")
+        w("}")
+        w("")
+        w("static inline bool pb_decode_%s(const uint8_t *data, size_t len, %s_pb &m) {" % (name, name))
+        w("  PbIStream s = pb_istream(data, len);")
+        w("  return pb_decode_%s(s, m);" % name)
+        w("}")
+        w("")
+
+        if name in nested:
+            w("static inline bool pb_write_msg_%s(PbOStream &s, const void *arg) {" % name)
+            w("  return pb_encode_%s(s, *(const %s_pb *)arg);" % (name, name))
+            w("}")
+            w("static inline bool pb_write_item_%s(PbOStream &s, const void *arg, size_t i) {" % name)
+            w("  return pb_encode_%s(s, ((const %s_pb *)arg)[i]);" % (name, name))
+            w("}")
+            w("// Encode `m` as a message field; it must outlive the encode.")
+            w("static inline PbBytes pb_message(const %s_pb &m) { return pb_stream(pb_write_msg_%s, &m); }" % (name, name))
+            w("static inline PbRepeated pb_repeated(const %s_pb *items, size_t count) {" % name)
+            w("  return PbRepeated{pb_write_item_%s, items, count, nullptr, nullptr, 0};" % name)
+            w("}")
+            w("")
+
+    w("#endif // SHARKOS_PB_H")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    with open(PROTO) as f:
+        header = generate(*parse(f.read()))
+    if "--check" in sys.argv[1:]:
+        with open(OUT) as f:
+            if f.read() != header:
+                print("gen_proto.py: %s is stale, re-run gen_proto.py" % os.path.relpath(OUT, ROOT))
+                return 1
+        return 0
+    with open(OUT, "w") as f:
+        f.write(header)
+    print("wrote %s" % os.path.relpath(OUT, ROOT))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
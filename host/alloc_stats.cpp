@@ -0,0 +1,67 @@
+#include "alloc_stats.h"
+
+#include <atomic>
+#include <malloc.h>
+
+extern "C" {
+void *__libc_malloc(size_t n);
+void *__libc_calloc(size_t n, size_t m);
+void *__libc_realloc(void *p, size_t n);
+void __libc_free(void *p);
+}
+
+static std::atomic<uint64_t> allocCount{0};
+static std::atomic<uint64_t> freeCount{0};
+static std::atomic<uint64_t> allocBytes{0};
+static std::atomic<int64_t> liveBytes{0};
+static std::atomic<HostAllocObserver> observer{nullptr};
+
+static inline void noteAlloc(void *p, size_t requested) {
+  if (!p) return;
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  allocBytes.fetch_add(requested, std::memory_order_relaxed);
+  liveBytes.fetch_add((int64_t)malloc_usable_size(p), std::memory_order_relaxed);
+  if (HostAllocObserver fn = observer.load(std::memory_order_acquire)) fn(p, requested, true);
+}
+
+static inline void noteFree(void *p) {
+  if (!p) return;
+  freeCount.fetch_add(1, std::memory_order_relaxed);
+  liveBytes.fetch_sub((int64_t)malloc_usable_size(p), std::memory_order_relaxed);
+  if (HostAllocObserver fn = observer.load(std::memory_order_acquire)) fn(p, 0, false);
+}
+
+extern "C" void *malloc(size_t n) {
+  void *p = __libc_malloc(n);
+  noteAlloc(p, n);
+  return p;
+}
+
+extern "C" void *calloc(size_t n, size_t m) {
+  void *p = __libc_calloc(n, m);
+  noteAlloc(p, n * m);
+  return p;
+}
+
+extern "C" void *realloc(void *old, size_t n) {
+  noteFree(old);
+  void *p = __libc_realloc(old, n);
+  noteAlloc(p, n);
+  return p;
+}
+
+extern "C" void free(void *p) {
+  noteFree(p);
+  __libc_free(p);
+}
+
+HostAllocStats host_alloc_stats() {
+  HostAllocStats s;
+  s.allocs = allocCount.load(std::memory_order_relaxed);
+  s.frees = freeCount.load(std::memory_order_relaxed);
+  s.bytes = allocBytes.load(std::memory_order_relaxed);
+  s.liveBytes = liveBytes.load(std::memory_order_relaxed);
+  return s;
+}
+
+void host_alloc_set_observer(HostAllocObserver fn) { observer.store(fn, std::memory_order_release); }
@@ -0,0 +1,24 @@
+#pragma once
+
+// Process-wide heap counters for host benchmarks. Linking alloc_stats.o into
+// a binary interposes malloc/calloc/realloc/free (and with them operator new,
+// String and ArduinoJson pools), so every heap call made by the firmware code
+// is counted.
+
+#include <cstddef>
+#include <cstdint>
+
+struct HostAllocStats {
+  uint64_t allocs;     // malloc/calloc/realloc calls that returned memory
+  uint64_t frees;
+  uint64_t bytes;      // bytes requested by those calls
+  int64_t liveBytes;   // requested minus freed (realloc/free use usable size)
+};
+
+HostAllocStats host_alloc_stats();
+
+// Told of every heap call counted above, from whichever thread made it
+// (realloc as a free then an alloc), so a bench can replay them into a model
+// heap. Must not allocate. Null detaches.
+typedef void (*HostAllocObserver)(void *p, size_t bytes, bool alloc);
+void host_alloc_set_observer(HostAllocObserver observer);
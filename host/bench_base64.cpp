@@ -0,0 +1,231 @@
+// Base64 benchmark and round-trip tests: the block codec in base64.h against
+// the two encoders hardware-utils.ino had before it.
+//
+//   build/bench_base64 [--iterations N]
+//
+// Checks every input of up to three bytes and random inputs up to 1 KiB
+// against the old encoders, decodes every encoding back, and walks each
+// invalid character through each position of a group. Fails (exit 1) on
+// any mismatch or if encode/decode touches the heap.
+//
+// The old String encoder (used for radio-batch payloads) got the padding
+// wrong: where '=' belongs it mostly wrote 'A', so a strict decoder read an
+// extra zero byte. The output must match it everywhere else.
+
+#include "globals.h"
+#include "base64.h"
+#include "alloc_stats.h"
+#define BENCH_NAME "bench_base64"
+#include "bench_check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// --- baseline: the encoder hardware-utils.ino used before base64.h ---
+
+namespace legacy {
+
+static const char b64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static String base64_encode(const uint8_t *data, size_t len) {
+  String out;
+  out.reserve(4 * ((len + 2) / 3));
+  size_t i = 0;
+  while (i < len) {
+    uint32_t a = i < len ? data[i++] : 0;
+    uint32_t b = i < len ? data[i++] : 0;
+    uint32_t c = i < len ? data[i++] : 0;
+    uint32_t triple = (a << 16) | (b << 8) | c;
+    out += b64_table[(triple >> 18) & 0x3F];
+    out += b64_table[(triple >> 12) & 0x3F];
+    out += (i - 2 <= len) ? b64_table[(triple >> 6) & 0x3F] : '=';
+    out += (i - 1 <= len) ? b64_table[triple & 0x3F] : '=';
+  }
+  return out;
+}
+
+// The stack encoder telemetry.ino used for PROTO: lines (correct padding).
+static size_t base64_encode_to(const uint8_t *data, size_t len, char *out) {
+  size_t n = 0;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t triple = (uint32_t)data[i] << 16;
+    if (i + 1 < len) triple |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < len) triple |= data[i + 2];
+    out[n++] = b64_table[(triple >> 18) & 0x3F];
+    out[n++] = b64_table[(triple >> 12) & 0x3F];
+    out[n++] = i + 1 < len ? b64_table[(triple >> 6) & 0x3F] : '=';
+    out[n++] = i + 2 < len ? b64_table[triple & 0x3F] : '=';
+  }
+  return n;
+}
+
+}  // namespace legacy
+
+// --- helpers ---
+
+template <typename Fn>
+static void bench(const char *name, int iterations, size_t bytes, Fn fn) {
+  HostAllocStats a0 = host_alloc_stats();
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) fn(i);
+  auto t1 = std::chrono::steady_clock::now();
+  HostAllocStats a1 = host_alloc_stats();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+  printf("%-26s %10.1f %10.1f %12.2f %8zu\n", name, ns, bytes * 1000.0 / ns, (double)(a1.allocs - a0.allocs) / iterations,
+         bytes);
+}
+
+static volatile size_t sink;
+
+// Encode with both implementations, compare, and decode back. Returns false
+// on the first mismatch so exhaustive loops stop early.
+static bool check_one(const uint8_t *data, size_t len) {
+  char enc[base64_encoded_len(1024)], prev[base64_encoded_len(1024)];
+  uint8_t dec[1024];
+  size_t n = base64_encode_to(data, len, enc);
+  size_t pn = legacy::base64_encode_to(data, len, prev);
+  if (n != base64_encoded_len(len) || n != pn || memcmp(enc, prev, n) != 0) {
+    fprintf(stderr, "bench_base64: encode mismatch for %zu bytes\n", len);
+    return false;
+  }
+  String old = legacy::base64_encode(data, len);
+  size_t pad = (3 - len % 3) % 3;
+  bool oldSame = old.length() == n && memcmp(enc, old.c_str(), n - pad) == 0;
+  for (size_t i = n - pad; i < n && oldSame; ++i) oldSame = enc[i] == '=' && (old[i] == 'A' || old[i] == '=');
+  if (!oldSame) {
+    fprintf(stderr, "bench_base64: String encoder mismatch for %zu bytes\n", len);
+    return false;
+  }
+  size_t m = base64_decode_to(enc, n, dec, sizeof(dec));
+  if (m != len || memcmp(dec, data, len) != 0) {
+    fprintf(stderr, "bench_base64: round trip failed for %zu bytes\n", len);
+    return false;
+  }
+  // the same text with its padding stripped
+  size_t bare = n;
+  while (bare > 0 && enc[bare - 1] == '=') --bare;
+  m = base64_decode_to(enc, bare, dec, sizeof(dec));
+  if (m != len || memcmp(dec, data, len) != 0) {
+    fprintf(stderr, "bench_base64: unpadded round trip failed for %zu bytes\n", len);
+    return false;
+  }
+  return true;
+}
+
+static void check_exhaustive() {
+  uint8_t b[3] = {};
+  CHECK(check_one(b, 0));
+  bool ok = true;
+  for (uint32_t v = 0; v < 0x100 && ok; ++v) {
+    b[0] = (uint8_t)v;
+    ok = check_one(b, 1);
+  }
+  for (uint32_t v = 0; v < 0x10000 && ok; ++v) {
+    b[0] = (uint8_t)(v >> 8);
+    b[1] = (uint8_t)v;
+    ok = check_one(b, 2);
+  }
+  for (uint32_t v = 0; v < 0x1000000 && ok; ++v) {
+    b[0] = (uint8_t)(v >> 16);
+    b[1] = (uint8_t)(v >> 8);
+    b[2] = (uint8_t)v;
+    ok = check_one(b, 3);
+  }
+  CHECK(ok);
+}
+
+static void check_random() {
+  std::mt19937 rng(1234);
+  std::vector<uint8_t> data(1024);
+  bool ok = true;
+  for (int round = 0; round < 20000 && ok; ++round) {
+    size_t len = rng() % (data.size() + 1);
+    for (size_t i = 0; i < len; ++i) data[i] = (uint8_t)rng();
+    ok = check_one(data.data(), len);
+  }
+  CHECK(ok);
+}
+
+static void check_invalid() {
+  uint8_t out[16];
+  // every byte outside the alphabet, in every position of a group
+  const char *valid = "QUJDRA==";  // "ABCD"
+  for (int c = 0; c < 256; ++c) {
+    bool inAlphabet = c != 0 && strchr(BASE64_ALPHABET, c) != nullptr;
+    for (int pos = 0; pos < 6; ++pos) {
+      char s[9];
+      memcpy(s, valid, 9);
+      s[pos] = (char)c;
+      size_t n = base64_decode_to(s, 8, out, sizeof(out));
+      if (inAlphabet) CHECK(n == 4);
+      else CHECK(n == BASE64_INVALID);
+    }
+  }
+  CHECK(base64_decode_to("QUJDRA==", 8, out, 4) == 4);
+  CHECK(base64_decode_to("QUJDRA==", 8, out, 3) == BASE64_INVALID);  // buffer too small
+  CHECK(base64_decode_to("QUJDR", 5, out, sizeof(out)) == BASE64_INVALID);    // one char left over
+  CHECK(base64_decode_to("QUJDRA=", 7, out, sizeof(out)) == BASE64_INVALID);  // padding short of a group
+  CHECK(base64_decode_to("QU=D", 4, out, sizeof(out)) == BASE64_INVALID);     // padding inside a group
+  CHECK(base64_decode_to("====", 4, out, sizeof(out)) == BASE64_INVALID);
+  CHECK(base64_decode_to("", 0, out, 0) == 0);
+}
+
+int main(int argc, char **argv) {
+  int iterations = 200000;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--iterations" && i + 1 < argc) iterations = atoi(argv[++i]);
+  }
+
+  check_exhaustive();
+  check_random();
+  check_invalid();
+
+  // the block codec itself must not allocate
+  {
+    uint8_t data[256], dec[256];
+    char enc[base64_encoded_len(sizeof(data))];
+    for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 37);
+    HostAllocStats a0 = host_alloc_stats();
+    size_t n = base64_encode_to(data, sizeof(data), enc);
+    size_t m = base64_decode_to(enc, n, dec, sizeof(dec));
+    CHECK(host_alloc_stats().allocs == a0.allocs);
+    CHECK(m == sizeof(data) && memcmp(dec, data, m) == 0);
+  }
+
+  // --- timing: a 7-byte radio sample, a full telemetry frame, 1 KiB ---
+  printf("bench_base64: %d iterations\n", iterations);
+  printf("%-26s %10s %10s %12s %8s\n", "case", "ns/op", "MB/s", "allocs/op", "bytes");
+  static uint8_t data[1024];
+  for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 131 + 7);
+  static char enc[base64_encoded_len(sizeof(data))];
+  static uint8_t dec[sizeof(data)];
+  const size_t sizes[] = {7, 256, 1024};
+  for (size_t len : sizes) {
+    char name[32];
+    snprintf(name, sizeof(name), "encode %zu legacy", len);
+    bench(name, iterations, len, [&](int i) {
+      data[0] = (uint8_t)i;
+      String s = legacy::base64_encode(data, len);
+      sink = s.length();
+    });
+    snprintf(name, sizeof(name), "encode %zu block", len);
+    bench(name, iterations, len, [&](int i) {
+      data[0] = (uint8_t)i;
+      sink = base64_encode_to(data, len, enc);
+    });
+    size_t n = base64_encode_to(data, len, enc);
+    snprintf(name, sizeof(name), "decode %zu block", len);
+    bench(name, iterations, len, [&](int) { sink = base64_decode_to(enc, n, dec, sizeof(dec)); });
+  }
+
+  if (bench_checks_failed()) return 1;
+  printf("base64 checks: ok (all inputs up to 3 bytes and 20000 random inputs match the old encoders and round-trip, "
+         "invalid input rejected, no heap)\n");
+  return 0;
+}
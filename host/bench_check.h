@@ -0,0 +1,27 @@
+#pragma once
+
+// Result checks for host benchmarks that also verify what they measure.
+// Define BENCH_NAME (the program name) before including: CHECK() reports a
+// false condition with its line and counts it in `failures`, and
+// bench_checks_failed() prints the tally at the end, so main() can return 1.
+
+#include <cstdio>
+
+#ifndef BENCH_NAME
+#error "define BENCH_NAME before including bench_check.h"
+#endif
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                   \
+  do {                                                                                \
+    if (!(cond)) {                                                                    \
+      fprintf(stderr, BENCH_NAME ": check failed line %d: %s\n", __LINE__, #cond);    \
+      ++failures;                                                                     \
+    }                                                                                 \
+  } while (0)
+
+static inline bool bench_checks_failed() {
+  if (failures) fprintf(stderr, BENCH_NAME ": %d check(s) failed\n", failures);
+  return failures != 0;
+}
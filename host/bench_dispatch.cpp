@@ -0,0 +1,144 @@
+// Command-dispatch benchmark: replays a BLE command corpus through the real
+// ingress path (bluetooth_receive_command_bytes -> event ring -> events_process_one)
+// and reports latency percentiles and heap traffic per command.
+//
+//   build/bench_dispatch [corpus-file] [--iterations N]
+//
+// Each corpus line is written once per iteration ("hex:" lines as the bytes
+// they spell); commands are timed from the BLE write until
+// events_process_one() returns.
+
+#include "globals.h"
+#include "events.h"
+#include "fake_radios.h"
+#include "alloc_stats.h"
+
+#include <ArduinoJson.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+void setup();
+
+struct CorpusEntry {
+  std::string category;
+  std::string payload;
+};
+
+struct Sample {
+  double ns;
+  uint64_t allocs;
+  uint64_t bytes;
+};
+
+static std::vector<CorpusEntry> loadCorpus(const char *path) {
+  std::vector<CorpusEntry> out;
+  std::ifstream in(path);
+  if (!in) return out;
+  std::string line;
+  std::string category = "default";
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty() || line[0] == '#') continue;
+    if (line[0] == '@') {
+      category = line.substr(1);
+      continue;
+    }
+    if (line.compare(0, 4, "hex:") == 0) {
+      std::string bytes;
+      for (size_t i = 4; i + 1 < line.size(); i += 2) bytes += (char)std::stoi(line.substr(i, 2), nullptr, 16);
+      line = bytes;
+    }
+    out.push_back({category, line});
+  }
+  return out;
+}
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0.0;
+  std::sort(v.begin(), v.end());
+  size_t idx = (size_t)(p * (double)(v.size() - 1) + 0.5);
+  return v[idx];
+}
+
+static void report(const char *name, const std::vector<Sample> &samples) {
+  if (samples.empty()) return;
+  std::vector<double> ns;
+  uint64_t allocs = 0, bytes = 0;
+  for (const auto &s : samples) {
+    ns.push_back(s.ns);
+    allocs += s.allocs;
+    bytes += s.bytes;
+  }
+  double n = (double)samples.size();
+  printf("%-10s %8zu %10.2f %10.2f %12.1f %12.1f\n", name, samples.size(), percentile(ns, 0.50) / 1000.0,
+         percentile(ns, 0.99) / 1000.0, (double)allocs / n, (double)bytes / n);
+}
+
+int main(int argc, char **argv) {
+  const char *corpusPath = "corpus/dispatch.txt";
+  int iterations = 200;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--iterations" && i + 1 < argc) iterations = atoi(argv[++i]);
+    else corpusPath = argv[i];
+  }
+
+  std::vector<CorpusEntry> corpus = loadCorpus(corpusPath);
+  if (corpus.empty()) {
+    fprintf(stderr, "bench_dispatch: empty or missing corpus %s\n", corpusPath);
+    return 1;
+  }
+
+  host_attach_fake_radios();
+  setup();
+  host_ble_connect(pServer);
+
+  // Warm up once so one-time lazy initialisation is not attributed to the
+  // first command of each kind.
+  for (const auto &e : corpus) {
+    bluetooth_receive_command_bytes((const uint8_t *)e.payload.data(), e.payload.size());
+    events_process_one();
+  }
+
+  std::map<std::string, std::vector<Sample>> byCategory;
+  std::vector<Sample> all;
+  uint64_t ingressAllocs = 0;  // allocations on the BLE-task side alone
+  for (int it = 0; it < iterations; ++it) {
+    for (const auto &e : corpus) {
+      HostAllocStats a0 = host_alloc_stats();
+      auto t0 = std::chrono::steady_clock::now();
+      bluetooth_receive_command_bytes((const uint8_t *)e.payload.data(), e.payload.size());
+      ingressAllocs += host_alloc_stats().allocs - a0.allocs;
+      events_process_one();
+      auto t1 = std::chrono::steady_clock::now();
+      HostAllocStats a1 = host_alloc_stats();
+      Sample s;
+      s.ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+      s.allocs = a1.allocs - a0.allocs;
+      s.bytes = a1.bytes - a0.bytes;
+      byCategory[e.category].push_back(s);
+      all.push_back(s);
+    }
+  }
+
+  printf("bench_dispatch: %zu commands x %d iterations (%s)\n", corpus.size(), iterations, corpusPath);
+  printf("%-10s %8s %10s %10s %12s %12s\n", "category", "samples", "p50 us", "p99 us", "allocs/cmd", "bytes/cmd");
+  for (const auto &kv : byCategory) report(kv.first.c_str(), kv.second);
+  report("all", all);
+  EventsQueueStats q;
+  events_queue_stats(q);
+  printf("ingress (BLE task side): %.2f allocs/cmd, %u dropped, lane hwm control=%u normal=%u\n",
+         (double)ingressAllocs / (double)all.size(), (unsigned)events_queue_overflows(), (unsigned)q.control.highWater,
+         (unsigned)q.normal.highWater);
+  printf("JSON library: %s\n", HOST_JSON_LIBRARY);
+#ifdef ARDUINOJSON_HOST_POOL_SCALE
+  printf("(bytes include the stand-in's JSON pools, scaled x%d for 64-bit nodes; not the device's)\n",
+         ARDUINOJSON_HOST_POOL_SCALE);
+#endif
+  return 0;
+}
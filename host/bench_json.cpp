@@ -0,0 +1,313 @@
+// Radio-batch JSON benchmark: the streaming JsonWriter (main/json_writer.h)
+// used by events_flush_radio_buffer() against the String builder it
+// replaced.
+//
+//   build/bench_json [--iterations N]
+//
+// Fails (exit 1) if the row layout differs by a byte from the old String
+// output, if any chunk size changes the document, if the columnar layout
+// does not parse back to the same signals, or if the writer touches the
+// heap; built against json_standin/, also if a document does not fill and
+// overflow the way it would on the device. Also reports the text size of
+// both layouts.
+
+#include "globals.h"
+#include "json_writer.h"
+#include "alloc_stats.h"
+#define BENCH_NAME "bench_json"
+#include "bench_check.h"
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Signal {
+  std::vector<uint8_t> payload;
+  float frequency_mhz;
+  int32_t rssi;
+  uint64_t timestamp_ms;
+};
+
+// --- baseline: the builder events.ino used before json_writer.h ---
+
+namespace legacy {
+
+static String radio_batch(int moduleIdx, const std::vector<Signal> &signals) {
+  String out;
+  out.reserve(256);
+  out += "{\"type\":\"radio-batch\",\"module\":";
+  out += String(moduleIdx);
+  out += ",\"signals\":[";
+
+  bool first = true;
+  for (auto &bs : signals) {
+    if (!first) out += ',';
+    first = false;
+    out += "{";
+    out += "\"timestamp_ms\":"; out += String(bs.timestamp_ms);
+    out += ",\"module\":"; out += String(moduleIdx);
+    out += ",\"frequency_mhz\":"; out += String(bs.frequency_mhz, 6);
+    out += ",\"rssi\":"; out += String(bs.rssi);
+    out += ",\"payload\":\""; base64_append(out, bs.payload.data(), bs.payload.size()); out += "\"";
+    out += "}";
+  }
+
+  out += "]}";
+  return out;
+}
+
+}  // namespace legacy
+
+// --- the writer, as events_flush_radio_buffer() drives it ---
+
+static void radio_batch(JsonWriter &w, int moduleIdx, const std::vector<Signal> &signals, bool columns) {
+  w.beginObject();
+  w.key("type"); w.valueString("radio-batch");
+  w.key("module"); w.valueInt(moduleIdx);
+  if (columns) {
+    w.key("layout"); w.valueString("columns");
+    w.key("count"); w.valueUint(signals.size());
+    w.key("timestamp_ms"); w.beginArray();
+    for (const auto &bs : signals) w.valueUint(bs.timestamp_ms);
+    w.endArray();
+    w.key("frequency_mhz"); w.beginArray();
+    for (const auto &bs : signals) w.valueFixed(bs.frequency_mhz, 6);
+    w.endArray();
+    w.key("rssi"); w.beginArray();
+    for (const auto &bs : signals) w.valueInt(bs.rssi);
+    w.endArray();
+    w.key("payload"); w.beginArray();
+    for (const auto &bs : signals) w.valueBase64(bs.payload.data(), bs.payload.size());
+    w.endArray();
+  } else {
+    w.key("signals"); w.beginArray();
+    for (const auto &bs : signals) {
+      w.beginObject();
+      w.key("timestamp_ms"); w.valueUint(bs.timestamp_ms);
+      w.key("module"); w.valueInt(moduleIdx);
+      w.key("frequency_mhz"); w.valueFixed(bs.frequency_mhz, 6);
+      w.key("rssi"); w.valueInt(bs.rssi);
+      w.key("payload"); w.valueBase64(bs.payload.data(), bs.payload.size());
+      w.endObject();
+    }
+    w.endArray();
+  }
+  w.endObject();
+  w.flush();
+}
+
+// --- helpers ---
+
+template <typename Fn>
+static void bench(const char *name, int iterations, size_t bytes, Fn fn) {
+  HostAllocStats a0 = host_alloc_stats();
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) fn(i);
+  auto t1 = std::chrono::steady_clock::now();
+  HostAllocStats a1 = host_alloc_stats();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+  printf("%-26s %10.1f %10.1f %12.2f %8zu\n", name, ns, bytes * 1000.0 / ns, (double)(a1.allocs - a0.allocs) / iterations,
+         bytes);
+}
+
+static volatile size_t sink;
+
+static void append_sink(void *ctx, const char *data, size_t len) { ((std::string *)ctx)->append(data, len); }
+static void count_sink(void *ctx, const char *data, size_t len) {
+  (void)data;
+  *(size_t *)ctx += len;
+}
+
+static std::string write_batch(size_t chunk, int moduleIdx, const std::vector<Signal> &signals, bool columns) {
+  std::vector<char> buf(chunk);
+  std::string out;
+  JsonWriter w(buf.data(), buf.size(), append_sink, &out);
+  radio_batch(w, moduleIdx, signals, columns);
+  if (!w.ok() || w.bytesWritten() != out.size()) out = "<writer error>";
+  return out;
+}
+
+static std::vector<Signal> random_signals(std::mt19937 &rng, size_t count) {
+  std::vector<Signal> signals(count);
+  for (auto &s : signals) {
+    s.payload.resize(rng() % 65);
+    for (auto &b : s.payload) b = (uint8_t)rng();
+    s.frequency_mhz = 300.0f + (float)(rng() % 650000000) / 1e6f;
+    s.rssi = -(int32_t)(rng() % 130);
+    s.timestamp_ms = ((uint64_t)rng() << 12) ^ rng();
+  }
+  return signals;
+}
+
+static void check_rows_match_legacy() {
+  std::mt19937 rng(4321);
+  for (int round = 0; round < 2000; ++round) {
+    std::vector<Signal> signals = random_signals(rng, rng() % 12);
+    int module = (int)(rng() % 8);
+    String old = legacy::radio_batch(module, signals);
+    std::string now = write_batch(256, module, signals, false);
+    if (now != old.c_str()) {
+      fprintf(stderr, "bench_json: row layout differs from the String builder\n  old: %s\n  new: %s\n", old.c_str(),
+              now.c_str());
+      ++failures;
+      return;
+    }
+  }
+}
+
+static void check_chunk_sizes() {
+  std::mt19937 rng(99);
+  std::vector<Signal> signals = random_signals(rng, 20);
+  for (int layout = 0; layout < 2; ++layout) {
+    std::string whole = write_batch(1 << 16, 3, signals, layout != 0);
+    for (size_t chunk = 32; chunk <= 300; ++chunk) {
+      if (write_batch(chunk, 3, signals, layout != 0) != whole) {
+        fprintf(stderr, "bench_json: %zu-byte chunks change the %s document\n", chunk, layout ? "columnar" : "row");
+        ++failures;
+        break;
+      }
+    }
+  }
+}
+
+static void check_columns_parse() {
+  std::mt19937 rng(7);
+  std::vector<Signal> signals = random_signals(rng, 40);
+  std::string text = write_batch(256, 5, signals, true);
+  DynamicJsonDocument doc(16384);
+  CHECK(!deserializeJson(doc, text.c_str(), text.size()));
+  CHECK(strcmp(doc["type"].as<const char *>(), "radio-batch") == 0);
+  CHECK(strcmp(doc["layout"].as<const char *>(), "columns") == 0);
+  CHECK(doc["module"].as<int>() == 5);
+  CHECK(doc["count"].as<size_t>() == signals.size());
+  JsonArray ts = doc["timestamp_ms"].as<JsonArray>(), freq = doc["frequency_mhz"].as<JsonArray>();
+  JsonArray rssi = doc["rssi"].as<JsonArray>(), payload = doc["payload"].as<JsonArray>();
+  CHECK(ts.size() == signals.size() && freq.size() == signals.size() && rssi.size() == signals.size() &&
+        payload.size() == signals.size());
+  for (size_t i = 0; i < signals.size() && failures == 0; ++i) {
+    const Signal &s = signals[i];
+    CHECK(ts[i].as<uint64_t>() == s.timestamp_ms);
+    CHECK(fabs(freq[i].as<double>() - s.frequency_mhz) < 1e-6);
+    CHECK(rssi[i].as<int32_t>() == s.rssi);
+    const char *b64 = payload[i].as<const char *>();
+    uint8_t dec[64];
+    size_t n = base64_decode_to(b64, strlen(b64), dec, sizeof(dec));
+    CHECK(n == s.payload.size() && memcmp(dec, s.payload.data(), n) == 0);
+  }
+}
+
+static void check_values() {
+  std::string out;
+  char buf[32];
+  JsonWriter w(buf, sizeof(buf), append_sink, &out);
+  w.beginArray();
+  w.valueInt(INT64_MIN);
+  w.valueUint(UINT64_MAX);
+  w.valueInt(0);
+  w.valueFixed(-0.0000004, 6);  // rounds to zero: no "-0"
+  w.valueFixed(-12.5, 0);   // exact ties go to even, as printf does
+  w.valueFixed(-13.5, 0);
+  w.valueFixed(0.1234566, 6);
+  w.valueFixed(NAN, 3);
+  w.valueFixed(INFINITY, 3);
+  w.valueBool(true);
+  w.valueNull();
+  w.valueString("q\"b\\n\n\x01");
+  w.beginObject();
+  w.endObject();
+  w.beginArray();
+  w.endArray();
+  w.endArray();
+  w.flush();
+  CHECK(w.ok());
+  CHECK(out == "[-9223372036854775808,18446744073709551615,0,0.000000,-12,-14,0.123457,null,null,true,null,"
+               "\"q\\\"b\\\\n\\n\\u0001\",{},[]]");
+
+  // the writer itself must not allocate
+  std::mt19937 rng(1);
+  std::vector<Signal> signals = random_signals(rng, 50);
+  char chunk[256];
+  size_t total = 0;
+  HostAllocStats a0 = host_alloc_stats();
+  JsonWriter cw(chunk, sizeof(chunk), count_sink, &total);
+  radio_batch(cw, 1, signals, false);
+  radio_batch(cw, 1, signals, true);
+  CHECK(host_alloc_stats().allocs == a0.allocs);
+  CHECK(total > 0 && cw.ok());
+}
+
+#ifdef ARDUINOJSON_HOST_POOL_SCALE
+// The stand-in counts its pool in device bytes: a slot per member, n + 1 per
+// copied string, nothing for a linked const char *.
+static void check_standin_pool() {
+  StaticJsonDocument<3 * ARDUINOJSON_HOST_SLOT_BYTES> doc;
+  doc["module"] = 1;
+  doc["name"] = "linked";
+  CHECK(doc.memoryUsage() == 2 * ARDUINOJSON_HOST_SLOT_BYTES && !doc.overflowed());
+  char text[] = "copied";
+  char *copied = text;
+  doc["copy"] = copied;  // the slot fits, its string does not
+  CHECK(doc.overflowed() && doc.memoryUsage() == doc.capacity());
+}
+#endif
+
+int main(int argc, char **argv) {
+  int iterations = 20000;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--iterations" && i + 1 < argc) iterations = atoi(argv[++i]);
+  }
+
+  check_rows_match_legacy();
+  check_chunk_sizes();
+  check_columns_parse();
+  check_values();
+#ifdef ARDUINOJSON_HOST_POOL_SCALE
+  check_standin_pool();
+#endif
+
+  // --- timing: one flush of a typical and of a full (250-signal) buffer ---
+  printf("bench_json: %d iterations\n", iterations);
+  printf("%-26s %10s %10s %12s %8s\n", "case", "ns/op", "MB/s", "allocs/op", "bytes");
+  std::mt19937 rng(2024);
+  const size_t counts[] = {10, 250};
+  for (size_t count : counts) {
+    std::vector<Signal> signals = random_signals(rng, count);
+    for (auto &s : signals) s.payload.resize(7);  // a CC1101 sample
+    size_t rowBytes = legacy::radio_batch(2, signals).length();
+    size_t colBytes = write_batch(256, 2, signals, true).size();
+    int n = count > 100 ? iterations / 25 : iterations;
+    char name[32];
+    snprintf(name, sizeof(name), "%zu signals legacy", count);
+    bench(name, n, rowBytes, [&](int) { sink = legacy::radio_batch(2, signals).length(); });
+    static char chunk[256];
+    snprintf(name, sizeof(name), "%zu signals rows", count);
+    bench(name, n, rowBytes, [&](int) {
+      size_t total = 0;
+      JsonWriter w(chunk, sizeof(chunk), count_sink, &total);
+      radio_batch(w, 2, signals, false);
+      sink = total;
+    });
+    snprintf(name, sizeof(name), "%zu signals columns", count);
+    bench(name, n, colBytes, [&](int) {
+      size_t total = 0;
+      JsonWriter w(chunk, sizeof(chunk), count_sink, &total);
+      radio_batch(w, 2, signals, true);
+      sink = total;
+    });
+    printf("  %zu signals: rows %zu bytes, columns %zu bytes (%.0f%%), String peak %zu bytes vs %zu-byte chunk\n",
+           count, rowBytes, colBytes, 100.0 * colBytes / rowBytes, rowBytes + 1, sizeof(chunk));
+  }
+
+  if (bench_checks_failed()) return 1;
+  printf("json checks: ok (rows match the String builder byte for byte at every chunk size, columns parse back, "
+         "no heap)\n");
+  return 0;
+}
@@ -0,0 +1,319 @@
+// BLE link compression benchmark: lzss.h on the message streams the
+// firmware notifies, compressed one message at a time against a shared
+// window exactly as ble_link_send() does with {"compress":true}.
+//
+//   build/bench_lzss [--iterations N]
+//
+// For each stream it prints the wire size before and after and the CPU time
+// per KB both ways, which is what decides whether compression pays off for
+// a client. Fails (exit 1) if any message does not decode back, if the
+// decoder accepts a corrupt or truncated message, or if either side touches
+// the heap.
+
+#include "lzss.h"
+#include "json_writer.h"
+#include "sharkos.pb.h"
+#include "alloc_stats.h"
+#define BENCH_NAME "bench_lzss"
+#include "bench_check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::vector<std::vector<uint8_t>> Stream;
+
+static const size_t RADIO_SWEEP_STEPS = 64;  // telemetry_publish_sweep() chunk
+
+// --- helpers ---
+
+static void append_sink(void *ctx, const uint8_t *data, size_t len) {
+  std::vector<uint8_t> &v = *(std::vector<uint8_t> *)ctx;
+  v.insert(v.end(), data, data + len);
+}
+static void count_sink(void *ctx, const uint8_t *data, size_t len) {
+  (void)data;
+  *(size_t *)ctx += len;
+}
+static void json_sink(void *ctx, const char *data, size_t len) {
+  std::vector<uint8_t> &v = *(std::vector<uint8_t> *)ctx;
+  v.insert(v.end(), data, data + len);
+}
+
+// --- the streams ---
+
+// Sweep chunks as telemetry_publish_sweep() frames them: a noise floor with
+// a little jitter and the odd carrier.
+static Stream sweep_stream(std::mt19937 &rng) {
+  Stream out;
+  uint64_t ts = 5000;
+  for (int sweep = 0; sweep < 20; ++sweep) {
+    for (uint32_t step = 0; step < 640; step += RADIO_SWEEP_STEPS) {
+      int32_t deltas[RADIO_SWEEP_STEPS];
+      int32_t prev = 0;
+      for (size_t i = 0; i < RADIO_SWEEP_STEPS; ++i) {
+        int32_t rssi = -100 + (int32_t)(rng() % 4) + ((step + i) % 97 == 0 ? 50 : 0);
+        deltas[i] = rssi - prev;
+        prev = rssi;
+      }
+      RadioSignalBatch_pb m;
+      m.base_timestamp_ms = ts;
+      m.module = RadioModule_CC1101_1;
+      m.base_frequency_khz = 433000 + step * 100;
+      m.step_khz = 100;
+      m.modulation = pb_str("ASK/OOK");
+      m.rssi_delta.values = deltas;
+      m.rssi_delta.count = RADIO_SWEEP_STEPS;
+      uint8_t frame[512];
+      PbOStream s = pb_ostream(frame + PB_FRAME_HEADER, sizeof(frame) - PB_FRAME_HEADER);
+      CHECK(pb_encode_RadioSignalBatch(s, m));
+      pb_frame_header(frame, s.len);
+      out.emplace_back(frame, frame + PB_FRAME_HEADER + s.len);
+      ts += 40;
+    }
+  }
+  return out;
+}
+
+// Received signals, one RadioSignal frame each (telemetry_publish()).
+static Stream signal_stream(std::mt19937 &rng) {
+  Stream out;
+  static const float freqs[] = {433.92f, 315.0f, 868.35f};
+  for (int i = 0; i < 300; ++i) {
+    uint8_t payload[7];
+    for (auto &b : payload) b = (uint8_t)(rng() % 4 == 0 ? rng() : 0x55);
+    RadioSignal_pb m;
+    m.timestamp_ms = 100000 + (uint64_t)i * 37;
+    m.module = RadioModule_CC1101_2;
+    m.frequency_mhz = freqs[rng() % 3];
+    m.rssi = -60 - (int32_t)(rng() % 8);
+    m.payload = pb_bytes(payload, sizeof(payload));
+    m.extra = pb_str("scan_range");
+    uint8_t frame[256];
+    PbOStream s = pb_ostream(frame + PB_FRAME_HEADER, sizeof(frame) - PB_FRAME_HEADER);
+    CHECK(pb_encode_RadioSignal(s, m));
+    pb_frame_header(frame, s.len);
+    out.emplace_back(frame, frame + PB_FRAME_HEADER + s.len);
+  }
+  return out;
+}
+
+// JSON radio batches (events_flush_radio_buffer(), row layout).
+static Stream radio_batch_stream(std::mt19937 &rng) {
+  Stream out;
+  char chunk[256];
+  for (int batch = 0; batch < 40; ++batch) {
+    std::vector<uint8_t> text;
+    JsonWriter w(chunk, sizeof(chunk), json_sink, &text);
+    w.beginObject();
+    w.key("type"); w.valueString("radio-batch");
+    w.key("module"); w.valueInt(1);
+    w.key("signals"); w.beginArray();
+    for (int i = 0; i < 10; ++i) {
+      uint8_t payload[7];
+      for (auto &b : payload) b = (uint8_t)(rng() % 3 == 0 ? rng() : 0xAA);
+      w.beginObject();
+      w.key("timestamp_ms"); w.valueUint(200000 + (uint64_t)batch * 1000 + (uint64_t)i * 13);
+      w.key("module"); w.valueInt(1);
+      w.key("frequency_mhz"); w.valueFixed(433.92f, 6);
+      w.key("rssi"); w.valueInt(-70 - (int)(rng() % 6));
+      w.key("payload"); w.valueBase64(payload, sizeof(payload));
+      w.endObject();
+    }
+    w.endArray();
+    w.endObject();
+    w.flush();
+    out.push_back(text);
+  }
+  return out;
+}
+
+// WiFi scan results as the wifi.scan task notifies them: the same handful
+// of networks every scan, RSSI moving a little.
+static Stream wifi_stream(std::mt19937 &rng) {
+  static const char *ssids[] = {"HomeNet",      "HomeNet-5G",  "xfinitywifi", "DIRECT-4B-HP OfficeJet",
+                                "Guest",        "TP-Link_0A3C", "NETGEAR42",  "eduroam",
+                                "ATT9xK2",      "Pixel_7311",  "SharkOS-AP",  "linksys"};
+  Stream out;
+  for (int scan = 0; scan < 30; ++scan) {
+    std::string s = "{\"Networks\":[";
+    for (int i = 0; i < 12; ++i) {
+      char item[128];
+      snprintf(item, sizeof(item), "%s{\"ssid\":\"%s\",\"rssi\":%d,\"bssid\":\"A4:2B:B0:%02X:%02X:%02X\"}", i ? "," : "",
+               ssids[i], -40 - i * 4 - (int)(rng() % 5), 0x10 + i, 0x3C ^ i, 0x90 + i * 3);
+      s += item;
+    }
+    s += "]}";
+    out.emplace_back(s.begin(), s.end());
+  }
+  return out;
+}
+
+// Incompressible: the worst case the link has to carry.
+static Stream random_stream(std::mt19937 &rng) {
+  Stream out;
+  for (int i = 0; i < 100; ++i) {
+    std::vector<uint8_t> m(rng() % 300 + 1);
+    for (auto &b : m) b = (uint8_t)rng();
+    out.push_back(m);
+  }
+  return out;
+}
+
+// --- checks ---
+
+static size_t stream_bytes(const Stream &s) {
+  size_t n = 0;
+  for (const auto &m : s) n += m.size();
+  return n;
+}
+
+// Compress every message against the shared window, decode it back, and
+// return the compressed size.
+static size_t round_trip(const Stream &stream, size_t resetEvery) {
+  static LzssEncoder enc;
+  static LzssDecoder dec;
+  enc.reset();
+  dec.reset();
+  std::vector<uint8_t> packed, plain(1 << 16);
+  size_t total = 0, sinceReset = 0;
+  for (const auto &m : stream) {
+    if (resetEvery && sinceReset >= resetEvery) {
+      enc.reset();
+      dec.reset();
+      sinceReset = 0;
+    }
+    sinceReset += m.size();
+    packed.clear();
+    size_t n = enc.compress(m.data(), m.size(), append_sink, &packed);
+    if (n != packed.size() || n > lzss_bound(m.size())) {
+      fprintf(stderr, "bench_lzss: compressed size %zu for a %zu-byte message\n", n, m.size());
+      ++failures;
+      return 0;
+    }
+    size_t d = dec.decompress(packed.data(), packed.size(), plain.data(), plain.size());
+    if (d != m.size() || memcmp(plain.data(), m.data(), d) != 0) {
+      fprintf(stderr, "bench_lzss: round trip failed for a %zu-byte message\n", m.size());
+      ++failures;
+      return 0;
+    }
+    total += n;
+  }
+  return total;
+}
+
+static void check_edges() {
+  // empty message, single byte, a long run (overlapping copies), a message
+  // longer than the window
+  std::mt19937 rng(5);
+  Stream s;
+  s.emplace_back();
+  s.push_back({0x42});
+  s.emplace_back(5000, 0x7E);
+  std::vector<uint8_t> big(6000);
+  for (size_t i = 0; i < big.size(); ++i) big[i] = (uint8_t)(i % 251 < 200 ? i % 251 : rng());
+  s.push_back(big);
+  s.push_back(big);
+  CHECK(round_trip(s, 0) < stream_bytes(s) / 4);
+
+  // random messages with random resets, small enough to hit every boundary
+  Stream r;
+  for (int i = 0; i < 3000; ++i) {
+    std::vector<uint8_t> m(rng() % 70);
+    for (auto &b : m) b = (uint8_t)(rng() % 6);  // small alphabet: lots of matches
+    r.push_back(m);
+  }
+  round_trip(r, 0);
+  round_trip(r, 997);
+
+  // the decoder refuses what the encoder never produces
+  LzssDecoder dec;
+  uint8_t out[64];
+  const uint8_t before[] = {0x01, 0x00, 0x00};   // match with nothing decoded yet
+  CHECK(dec.decompress(before, sizeof(before), out, sizeof(out)) == LZSS_INVALID);
+  LzssDecoder dec2;
+  const uint8_t cut[] = {0x02, 'a', 0x00};        // match missing its second byte
+  CHECK(dec2.decompress(cut, sizeof(cut), out, sizeof(out)) == LZSS_INVALID);
+  LzssDecoder dec3;
+  const uint8_t longRun[] = {0x02, 'a', 0x00, 0xF8};  // 'a' then 34 copies of it
+  CHECK(dec3.decompress(longRun, sizeof(longRun), out, 8) == LZSS_INVALID);
+  LzssDecoder dec4;
+  CHECK(dec4.decompress(longRun, sizeof(longRun), out, sizeof(out)) == 35);
+  CHECK(out[0] == 'a' && out[34] == 'a');
+  LzssDecoder dec5;
+  const uint8_t far[] = {0x02, 'a', 0x01, 0x00};  // distance 2, only 1 byte of history
+  CHECK(dec5.decompress(far, sizeof(far), out, sizeof(out)) == LZSS_INVALID);
+}
+
+// --- timing ---
+
+template <typename Fn>
+static double time_ns(int iterations, Fn fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) fn();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+static void report(const char *name, const Stream &stream, int iterations) {
+  static LzssEncoder enc;
+  static LzssDecoder dec;
+  size_t in = stream_bytes(stream);
+  size_t out = round_trip(stream, 16384);
+
+  // framed once so decode has real input
+  std::vector<std::vector<uint8_t>> packed;
+  enc.reset();
+  for (const auto &m : stream) {
+    packed.emplace_back();
+    enc.compress(m.data(), m.size(), append_sink, &packed.back());
+  }
+  static uint8_t plain[1 << 16];
+
+  int n = iterations * 4096 / (int)(in + 1) + 1;
+  HostAllocStats a0 = host_alloc_stats();
+  double encNs = time_ns(n, [&] {
+    enc.reset();
+    size_t total = 0;
+    for (const auto &m : stream) enc.compress(m.data(), m.size(), count_sink, &total);
+  });
+  double decNs = time_ns(n, [&] {
+    dec.reset();
+    for (const auto &p : packed) dec.decompress(p.data(), p.size(), plain, sizeof(plain));
+  });
+  HostAllocStats a1 = host_alloc_stats();
+  CHECK(a1.allocs == a0.allocs);
+
+  // one kind byte per message on the link
+  size_t wire = out + stream.size();
+  printf("%-22s %6zu %8zu %8zu %7.0f%% %10.0f %10.0f\n", name, stream.size(), in, wire, 100.0 * wire / in,
+         encNs * 1024 / in, decNs * 1024 / in);
+}
+
+int main(int argc, char **argv) {
+  int iterations = 2000;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--iterations" && i + 1 < argc) iterations = atoi(argv[++i]);
+  }
+
+  check_edges();
+
+  std::mt19937 rng(77);
+  printf("bench_lzss: window %zu bytes, %u-deep chains, encoder state %zu bytes\n", LZSS_WINDOW,
+         (unsigned)LZSS_MAX_CHAIN, sizeof(LzssEncoder));
+  printf("%-22s %6s %8s %8s %8s %10s %10s\n", "stream", "msgs", "bytes", "wire", "ratio", "enc ns/KB", "dec ns/KB");
+  report("sweep chunks (pb)", sweep_stream(rng), iterations);
+  report("radio signals (pb)", signal_stream(rng), iterations);
+  report("radio-batch json", radio_batch_stream(rng), iterations);
+  report("wifi scan json", wifi_stream(rng), iterations);
+  report("random", random_stream(rng), iterations);
+
+  if (bench_checks_failed()) return 1;
+  printf("lzss checks: ok (every message round-trips across window resets, corrupt input rejected, no heap)\n");
+  return 0;
+}
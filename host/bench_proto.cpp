@@ -0,0 +1,531 @@
+// Protobuf codec benchmark: the generated encoders in sharkos.pb.h against
+// the hand-rolled std::vector encoder they replaced, plus decode round trips
+// for every message in .proto.
+//
+//   build/bench_proto [--iterations N] [--golden]
+//
+// Fails (exit 1) if the generated RadioSignal/status bytes differ from the
+// old encoder's, if a round trip loses a field, or if encode/decode touches
+// the heap. --golden prints the framed RadioSignal and RadioSignalBatch used
+// by the decoder tests in android/rust_ui/src/bt/listener.rs.
+
+#include "sharkos.pb.h"
+#include "alloc_stats.h"
+#define BENCH_NAME "bench_proto"
+#include "bench_check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// --- baseline: the encoder hardware-utils.ino used before sharkos.pb.h ---
+
+namespace legacy {
+
+static void write_varint(std::vector<uint8_t> &out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back((uint8_t)((v & 0x7F) | 0x80));
+    v >>= 7;
+  }
+  out.push_back((uint8_t)v);
+}
+
+static void write_tag(std::vector<uint8_t> &out, uint32_t field, uint8_t wire_type) {
+  write_varint(out, ((uint64_t)field << 3) | (wire_type & 0x7));
+}
+
+static void write_fixed32(std::vector<uint8_t> &out, float f) {
+  union { float f; uint32_t u; } u; u.f = f;
+  out.push_back((uint8_t)(u.u & 0xFF));
+  out.push_back((uint8_t)((u.u >> 8) & 0xFF));
+  out.push_back((uint8_t)((u.u >> 16) & 0xFF));
+  out.push_back((uint8_t)((u.u >> 24) & 0xFF));
+}
+
+static void write_bytes_len_prefixed(std::vector<uint8_t> &out, const uint8_t *buf, size_t len) {
+  write_varint(out, (uint64_t)len);
+  for (size_t i = 0; i < len; ++i) out.push_back(buf[i]);
+}
+
+struct RadioSignal {
+  uint64_t timestamp_ms;
+  int module;
+  float frequency_mhz;
+  int32_t rssi;
+  std::vector<uint8_t> payload;
+  std::string extra;
+};
+
+static void encode_radio_signal(const RadioSignal &rs, std::vector<uint8_t> &out) {
+  out.clear();
+  write_tag(out, 1, 0);
+  write_varint(out, rs.timestamp_ms);
+  write_tag(out, 2, 0);
+  write_varint(out, (uint64_t)rs.module);
+  write_tag(out, 3, 5);
+  write_fixed32(out, rs.frequency_mhz);
+  write_tag(out, 4, 0);
+  int64_t rssi_signed = (int64_t)rs.rssi;
+  write_varint(out, ((uint64_t)(rssi_signed << 1)) ^ (uint64_t)(rssi_signed >> 63));
+  if (!rs.payload.empty()) {
+    write_tag(out, 5, 2);
+    write_bytes_len_prefixed(out, rs.payload.data(), rs.payload.size());
+  }
+  if (!rs.extra.empty()) {
+    write_tag(out, 6, 2);
+    write_bytes_len_prefixed(out, (const uint8_t *)rs.extra.data(), rs.extra.size());
+  }
+}
+
+static void encode_status(const bool flags[9], int battery, std::vector<uint8_t> &out) {
+  out.clear();
+  write_tag(out, 1, 0); write_varint(out, flags[0] ? 1 : 0);
+  write_tag(out, 2, 0); write_varint(out, (uint64_t)battery);
+  for (int f = 3; f <= 10; ++f) {
+    write_tag(out, (uint32_t)f, 0);
+    write_varint(out, flags[f - 2] ? 1 : 0);
+  }
+}
+
+// send_protobuf_framed() built the frame in a second vector
+static void frame(const std::vector<uint8_t> &payload, std::vector<uint8_t> &framed) {
+  uint8_t header[4] = {0xAA, 0x55, (uint8_t)(payload.size() & 0xFF), (uint8_t)(payload.size() >> 8)};
+  framed.clear();
+  framed.insert(framed.end(), header, header + 4);
+  framed.insert(framed.end(), payload.begin(), payload.end());
+}
+
+}  // namespace legacy
+
+// --- helpers ---
+
+static bool same_bytes(const PbBytes &b, const void *data, size_t len) {
+  return b.len == len && (len == 0 || memcmp(b.data, data, len) == 0);
+}
+
+// scan_range sample: modulation, freq kHz (LE32), rssi, 0
+static const uint8_t kSample[7] = {2, 0x28, 0x9C, 0x06, 0x00, 0xB5, 0x00};
+
+// RADIO_SWEEP_CHUNK_STEPS in bus_workers.h
+static const size_t RADIO_SWEEP_STEPS = 64;
+
+template <typename Fn>
+static void bench(const char *name, int iterations, size_t bytes, Fn fn) {
+  HostAllocStats a0 = host_alloc_stats();
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) fn(i);
+  auto t1 = std::chrono::steady_clock::now();
+  HostAllocStats a1 = host_alloc_stats();
+  printf("%-26s %10.1f %12.2f %10zu\n", name, std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations,
+         (double)(a1.allocs - a0.allocs) / iterations, bytes);
+}
+
+static volatile size_t sink;
+
+// Streams the payload in two pieces to exercise the callback path.
+static bool write_sample_split(PbOStream &s, const void *arg) {
+  const uint8_t *p = (const uint8_t *)arg;
+  return s.write(p, 3) && s.write(p + 3, sizeof(kSample) - 3);
+}
+
+static RadioSignal_pb sample_signal(uint64_t ts) {
+  RadioSignal_pb m;
+  m.timestamp_ms = ts;
+  m.module = RadioModule_CC1101_2;
+  m.frequency_mhz = 433.92f;
+  m.rssi = -91;
+  m.payload = pb_bytes(kSample, sizeof(kSample));
+  m.extra = pb_str("scan_range");
+  return m;
+}
+
+// Sweep chunk as telemetry_publish_sweep() builds it: first RSSI
+// absolute, then deltas.
+static RadioSignalBatch_pb sample_batch(uint64_t ts, const int16_t *rssi, size_t count, int32_t *deltas) {
+  int32_t prev = 0;
+  for (size_t i = 0; i < count; ++i) {
+    deltas[i] = rssi[i] - prev;
+    prev = rssi[i];
+  }
+  RadioSignalBatch_pb m;
+  m.base_timestamp_ms = ts;
+  m.module = RadioModule_CC1101_1;
+  m.base_frequency_khz = 433000;
+  m.step_khz = 100;
+  m.modulation = pb_str("ASK/OOK");
+  m.rssi_delta.values = deltas;
+  m.rssi_delta.count = count;
+  return m;
+}
+
+// A noise floor with a carrier in the middle.
+static void sample_sweep_rssi(int16_t *rssi, size_t count) {
+  for (size_t i = 0; i < count; ++i) rssi[i] = (int16_t)(-100 + (int)(i * 7 % 5) + (i == count / 2 ? 55 : 0));
+}
+
+static void check_round_trips() {
+  uint8_t buf[128];
+
+  {
+    RadioSignal_pb in = sample_signal(123456789ULL);
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_RadioSignal(s, in));
+    RadioSignal_pb out;
+    CHECK(pb_decode_RadioSignal(buf, s.len, out));
+    CHECK(out.timestamp_ms == in.timestamp_ms && out.module == in.module && out.frequency_mhz == in.frequency_mhz);
+    CHECK(out.rssi == -91 && same_bytes(out.payload, kSample, sizeof(kSample)) && same_bytes(out.extra, "scan_range", 10));
+
+    // callback payload produces the same bytes as the pointer form
+    RadioSignal_pb streamed = in;
+    streamed.payload = pb_stream(write_sample_split, kSample);
+    uint8_t buf2[128];
+    PbOStream s2 = pb_ostream(buf2, sizeof(buf2));
+    CHECK(pb_encode_RadioSignal(s2, streamed));
+    CHECK(s2.len == s.len && memcmp(buf, buf2, s.len) == 0);
+
+    // too small a buffer fails cleanly
+    PbOStream tiny = pb_ostream(buf2, 8);
+    CHECK(!pb_encode_RadioSignal(tiny, in));
+  }
+  {
+    Command_pb in;
+    in.timestamp_ms = 42;
+    in.command = pb_str("status.info");
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_Command(s, in));
+    Command_pb out;
+    CHECK(pb_decode_Command(buf, s.len, out));
+    CHECK(out.timestamp_ms == 42 && same_bytes(out.command, "status.info", 11));
+  }
+  {
+    // binary command: repeated params and a nested transmit body
+    CommandParam_pb params[3];
+    params[0].key = pb_str("radio");
+    params[0].type = ParamType_PARAM_INT;
+    params[0].int_value = -2;
+    params[1].key = pb_str("modulation");
+    params[1].type = ParamType_PARAM_STRING;
+    params[1].string_value = pb_str("2-FSK");
+    params[2].key = pb_str("frequency_mhz");
+    params[2].type = ParamType_PARAM_FLOAT;
+    params[2].float_value = 868.3f;
+    CC1101Tx_pb tx;
+    tx.frequency_mhz = 433.92f;
+    tx.payload = pb_bytes(kSample, sizeof(kSample));
+    Command_pb in;
+    in.command_id = 20;
+    in.correlation_id = pb_str("c1");
+    in.params = pb_repeated(params, 3);
+    in.cc1101_tx = pb_message(tx);
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_Command(s, in));
+    Command_pb out;
+    CHECK(pb_decode_Command(buf, s.len, out));
+    CHECK(out.command_id == 20 && same_bytes(out.correlation_id, "c1", 2) && out.params.count == 3);
+    PbIStream it = pb_repeated_iter(out.params);
+    PbBytes item;
+    CommandParam_pb p;
+    CHECK(pb_repeated_next(it, out.params, item) && pb_decode_CommandParam(item.data, item.len, p));
+    CHECK(same_bytes(p.key, "radio", 5) && p.type == ParamType_PARAM_INT && p.int_value == -2);
+    CHECK(pb_repeated_next(it, out.params, item) && pb_decode_CommandParam(item.data, item.len, p));
+    CHECK(p.type == ParamType_PARAM_STRING && same_bytes(p.string_value, "2-FSK", 5));
+    CHECK(pb_repeated_next(it, out.params, item) && pb_decode_CommandParam(item.data, item.len, p));
+    CHECK(p.type == ParamType_PARAM_FLOAT && p.float_value == 868.3f);
+    CHECK(!pb_repeated_next(it, out.params, item));
+    CC1101Tx_pb body;
+    CHECK(pb_decode_CC1101Tx(out.cc1101_tx.data, out.cc1101_tx.len, body));
+    CHECK(body.frequency_mhz == 433.92f && same_bytes(body.payload, kSample, sizeof(kSample)));
+    CHECK(out.lora_tx.len == 0 && out.ir_tx.len == 0);
+
+    // an unknown field between the params is skipped by the walk
+    size_t firstEnd = 0;
+    PbIStream w = pb_istream(buf, s.len);
+    uint32_t f;
+    PbWireType wt;
+    while (firstEnd == 0 && w.p < w.end && pb_read_tag(w, f, wt) && pb_skip(w, wt)) {
+      if (f == 5) firstEnd = (size_t)(w.p - buf);
+    }
+    CHECK(firstEnd > 0);
+    uint8_t mixed[sizeof(buf) + 2];
+    const uint8_t unknown[] = {0x78, 0x05};
+    memcpy(mixed, buf, firstEnd);
+    memcpy(mixed + firstEnd, unknown, sizeof(unknown));
+    memcpy(mixed + firstEnd + sizeof(unknown), buf + firstEnd, s.len - firstEnd);
+    CHECK(pb_decode_Command(mixed, s.len + sizeof(unknown), out) && out.params.count == 3);
+    it = pb_repeated_iter(out.params);
+    size_t walked = 0;
+    while (pb_repeated_next(it, out.params, item)) ++walked;
+    CHECK(walked == 3);
+
+    // framing: only an exact frame is a command
+    uint8_t frame[sizeof(buf) + PB_FRAME_HEADER];
+    pb_frame_header(frame, s.len);
+    memcpy(frame + PB_FRAME_HEADER, buf, s.len);
+    PbIStream msg;
+    CHECK(pb_frame_message(frame, s.len + PB_FRAME_HEADER, msg) && (size_t)(msg.end - msg.p) == s.len);
+    CHECK(!pb_frame_message(frame, s.len + PB_FRAME_HEADER - 1, msg));
+    CHECK(!pb_frame_message((const uint8_t *)"{\"command\":1}", 14, msg));
+  }
+  {
+    status_pb in;
+    in.is_scanning = true;
+    in.battery_percent = 87;
+    in.cc1101_2_connected = true;
+    in.serial_connected = true;
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_status(s, in));
+    status_pb out;
+    CHECK(pb_decode_status(buf, s.len, out));
+    CHECK(out.is_scanning && out.battery_percent == 87 && !out.cc1101_1_connected && out.cc1101_2_connected);
+    CHECK(!out.lora_connected && out.serial_connected);
+  }
+  {
+    CC1101Tx_pb in;
+    in.timestamp_ms = 7;
+    in.module = RadioModuleCC_CC1101_2;
+    in.frequency_mhz = 868.3f;
+    in.power_dbm = -10;
+    in.payload = pb_bytes(kSample, sizeof(kSample));
+    in.mod = pb_str("2FSK");
+    in.extra = pb_str("x");
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_CC1101Tx(s, in));
+    CC1101Tx_pb out;
+    CHECK(pb_decode_CC1101Tx(buf, s.len, out));
+    CHECK(out.timestamp_ms == 7 && out.module == RadioModuleCC_CC1101_2 && out.frequency_mhz == 868.3f);
+    CHECK(out.power_dbm == -10 && same_bytes(out.payload, kSample, sizeof(kSample)));
+    CHECK(same_bytes(out.mod, "2FSK", 4) && same_bytes(out.extra, "x", 1));
+    // a truncated message is rejected rather than half-applied
+    CHECK(!pb_decode_CC1101Tx(buf, s.len - 1, out));
+  }
+  {
+    LoraTx_pb in;
+    in.frequency_mhz = 915.0f;
+    in.power_dbm = 17;
+    in.payload = pb_bytes(kSample, 4);
+    in.mod = pb_str("LoRa");
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_LoraTx(s, in));
+    LoraTx_pb out;
+    CHECK(pb_decode_LoraTx(buf, s.len, out));
+    CHECK(out.frequency_mhz == 915.0f && out.power_dbm == 17 && same_bytes(out.payload, kSample, 4));
+    CHECK(same_bytes(out.mod, "LoRa", 4) && out.extra.len == 0);
+  }
+  {
+    NfcWrite_pb in;
+    in.timestamp_ms = 1;
+    in.payload = pb_bytes(kSample, sizeof(kSample));
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_NfcWrite(s, in));
+    NfcWrite_pb out;
+    CHECK(pb_decode_NfcWrite(buf, s.len, out) && same_bytes(out.payload, kSample, sizeof(kSample)));
+  }
+  {
+    RFIDWrite_pb in;
+    in.payload = pb_bytes(kSample, 2);
+    in.extra = pb_str("em4100");
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_RFIDWrite(s, in));
+    RFIDWrite_pb out;
+    CHECK(pb_decode_RFIDWrite(buf, s.len, out) && same_bytes(out.extra, "em4100", 6));
+  }
+  {
+    IRTx_pb in;
+    in.frequency_khz = 38;
+    in.payload = pb_bytes(kSample, sizeof(kSample));
+    PbOStream s = pb_ostream(buf, sizeof(buf));
+    CHECK(pb_encode_IRTx(s, in));
+    // unknown fields from a newer peer are skipped
+    const uint8_t extraFields[] = {0x78, 0x01, 0x82, 0x01, 0x02, 0xAB, 0xCD, 0x8D, 0x01, 1, 2, 3, 4};
+    memcpy(buf + s.len, extraFields, sizeof(extraFields));
+    IRTx_pb out;
+    CHECK(pb_decode_IRTx(buf, s.len + sizeof(extraFields), out));
+    CHECK(out.frequency_khz == 38 && same_bytes(out.payload, kSample, sizeof(kSample)));
+  }
+  {
+    int16_t rssi[RADIO_SWEEP_STEPS];
+    int32_t deltas[RADIO_SWEEP_STEPS];
+    sample_sweep_rssi(rssi, RADIO_SWEEP_STEPS);
+    RadioSignalBatch_pb in = sample_batch(5000, rssi, RADIO_SWEEP_STEPS, deltas);
+    uint8_t big[256];
+    PbOStream s = pb_ostream(big, sizeof(big));
+    CHECK(pb_encode_RadioSignalBatch(s, in));
+    RadioSignalBatch_pb out;
+    CHECK(pb_decode_RadioSignalBatch(big, s.len, out));
+    CHECK(out.base_timestamp_ms == 5000 && out.module == RadioModule_CC1101_1 && out.base_frequency_khz == 433000);
+    CHECK(out.step_khz == 100 && same_bytes(out.modulation, "ASK/OOK", 7) && out.payload.len == 0);
+    CHECK(out.rssi_delta.count == RADIO_SWEEP_STEPS);
+    PbIStream it = pb_istream(out.rssi_delta.data, out.rssi_delta.len);
+    int32_t v, acc = 0;
+    size_t n = 0;
+    for (; pb_packed_next(it, true, v); ++n) {
+      acc += v;
+      CHECK(n < RADIO_SWEEP_STEPS && acc == rssi[n]);
+    }
+    CHECK(n == RADIO_SWEEP_STEPS);
+    // a RadioSignal decoder sees none of its fields in a batch
+    RadioSignal_pb asSignal;
+    CHECK(pb_decode_RadioSignal(big, s.len, asSignal) && asSignal.timestamp_ms == 0 && asSignal.payload.len == 0);
+    // a packed run cut mid-varint is rejected
+    const uint8_t cut[] = {0xAA, 0x01, 0x02, 0x01, 0x80};
+    CHECK(!pb_decode_RadioSignalBatch(cut, sizeof(cut), out));
+  }
+}
+
+int main(int argc, char **argv) {
+  int iterations = 200000;
+  bool golden = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--iterations" && i + 1 < argc) iterations = atoi(argv[++i]);
+    else if (a == "--golden") golden = true;
+  }
+
+  // --- byte-for-byte compatibility with the old encoder ---
+  legacy::RadioSignal lrs{123456789ULL, 1, 433.92f, -91, std::vector<uint8_t>(kSample, kSample + sizeof(kSample)),
+                          "scan_range"};
+  std::vector<uint8_t> legacyBytes;
+  legacy::encode_radio_signal(lrs, legacyBytes);
+  uint8_t frame[256];
+  RadioSignal_pb rs = sample_signal(123456789ULL);
+  PbOStream s = pb_ostream(frame + PB_FRAME_HEADER, sizeof(frame) - PB_FRAME_HEADER);
+  CHECK(pb_encode_RadioSignal(s, rs));
+  pb_frame_header(frame, s.len);
+  CHECK(s.len == legacyBytes.size() && memcmp(frame + PB_FRAME_HEADER, legacyBytes.data(), s.len) == 0);
+
+  const bool flags[9] = {true, false, true, false, true, false, true, false, true};
+  std::vector<uint8_t> legacyStatus;
+  legacy::encode_status(flags, 87, legacyStatus);
+  status_pb st;
+  st.is_scanning = flags[0];
+  st.battery_percent = 87;
+  st.cc1101_1_connected = flags[1];
+  st.cc1101_2_connected = flags[2];
+  st.lora_connected = flags[3];
+  st.nfc_connected = flags[4];
+  st.wifi_connected = flags[5];
+  st.bluetooth_connected = flags[6];
+  st.ir_connected = flags[7];
+  st.serial_connected = flags[8];
+  uint8_t statusBuf[32];
+  PbOStream ss = pb_ostream(statusBuf, sizeof(statusBuf));
+  CHECK(pb_encode_status(ss, st));
+  CHECK(ss.len == legacyStatus.size() && memcmp(statusBuf, legacyStatus.data(), ss.len) == 0);
+
+  if (golden) {
+    for (size_t i = 0; i < PB_FRAME_HEADER + s.len; ++i) printf("%02x", frame[i]);
+    printf("\n");
+    const int16_t rssi[4] = {-100, -98, -45, -99};
+    int32_t deltas[4];
+    RadioSignalBatch_pb b = sample_batch(5000, rssi, 4, deltas);
+    uint8_t bf[64];
+    PbOStream bs = pb_ostream(bf + PB_FRAME_HEADER, sizeof(bf) - PB_FRAME_HEADER);
+    CHECK(pb_encode_RadioSignalBatch(bs, b));
+    pb_frame_header(bf, bs.len);
+    for (size_t i = 0; i < PB_FRAME_HEADER + bs.len; ++i) printf("%02x", bf[i]);
+    printf("\n");
+    return bench_checks_failed() ? 1 : 0;
+  }
+
+  HostAllocStats a0 = host_alloc_stats();
+  check_round_trips();
+  CHECK(host_alloc_stats().allocs == a0.allocs);
+
+  // --- timing ---
+  printf("bench_proto: %d iterations\n", iterations);
+  printf("%-26s %10s %12s %10s\n", "case", "ns/msg", "allocs/msg", "bytes");
+  // the old path built a RadioSignal and fresh vectors for every message
+  bench("radio_signal legacy+frame", iterations, legacyBytes.size() + 4, [&](int i) {
+    legacy::RadioSignal m{(uint64_t)i, 1, 433.92f, -91, std::vector<uint8_t>(kSample, kSample + sizeof(kSample)),
+                          "scan_range"};
+    std::vector<uint8_t> pb, framed;
+    legacy::encode_radio_signal(m, pb);
+    legacy::frame(pb, framed);
+    sink = framed.size();
+  });
+  bench("radio_signal generated", iterations, s.len + PB_FRAME_HEADER, [&](int i) {
+    // per-message setup as in telemetry_publish()
+    RadioSignal_pb m = sample_signal((uint64_t)i);
+    uint8_t f[256];
+    PbOStream o = pb_ostream(f + PB_FRAME_HEADER, sizeof(f) - PB_FRAME_HEADER);
+    pb_encode_RadioSignal(o, m);
+    pb_frame_header(f, o.len);
+    sink = o.len + f[4];
+  });
+  bench("status legacy+frame", iterations, legacyStatus.size() + 4, [&](int i) {
+    std::vector<uint8_t> pb, framed;
+    legacy::encode_status(flags, i % 101, pb);
+    legacy::frame(pb, framed);
+    sink = framed.size();
+  });
+  bench("status generated", iterations, ss.len + PB_FRAME_HEADER, [&](int i) {
+    st.battery_percent = i % 101;
+    uint8_t f[PB_FRAME_HEADER + 32];
+    PbOStream o = pb_ostream(f + PB_FRAME_HEADER, sizeof(f) - PB_FRAME_HEADER);
+    pb_encode_status(o, st);
+    pb_frame_header(f, o.len);
+    sink = o.len + f[4];
+  });
+
+  uint8_t txBuf[128];
+  CC1101Tx_pb tx;
+  tx.timestamp_ms = 99;
+  tx.frequency_mhz = 433.92f;
+  tx.power_dbm = 10;
+  tx.payload = pb_bytes(kSample, sizeof(kSample));
+  tx.mod = pb_str("ASK/OOK");
+  PbOStream txs = pb_ostream(txBuf, sizeof(txBuf));
+  pb_encode_CC1101Tx(txs, tx);
+  bench("cc1101_tx decode", iterations, txs.len, [&](int) {
+    CC1101Tx_pb out;
+    pb_decode_CC1101Tx(txBuf, txs.len, out);
+    sink = out.payload.len;
+  });
+
+  // --- sweep telemetry: 400-433 MHz at 100 kHz, one frame per step vs batches ---
+  const size_t sweepSteps = 331;
+  static int16_t sweepRssi[sweepSteps];
+  sample_sweep_rssi(sweepRssi, sweepSteps);
+  size_t perStepBytes = 0, batchBytes = 0, batchFrames = 0;
+  for (size_t i = 0; i < sweepSteps; ++i) {
+    RadioSignal_pb m = sample_signal(5000 + i);
+    m.frequency_mhz = 400.0f + i * 0.1f;
+    m.rssi = sweepRssi[i];
+    PbOStream o = pb_ostream_sizing();
+    pb_encode_RadioSignal(o, m);
+    perStepBytes += PB_FRAME_HEADER + o.len;
+  }
+  for (size_t i = 0; i < sweepSteps; i += RADIO_SWEEP_STEPS) {
+    int32_t deltas[RADIO_SWEEP_STEPS];
+    size_t n = sweepSteps - i < RADIO_SWEEP_STEPS ? sweepSteps - i : RADIO_SWEEP_STEPS;
+    RadioSignalBatch_pb m = sample_batch(5000 + i, sweepRssi + i, n, deltas);
+    PbOStream o = pb_ostream_sizing();
+    pb_encode_RadioSignalBatch(o, m);
+    CHECK(PB_FRAME_HEADER + o.len <= 256);
+    batchBytes += PB_FRAME_HEADER + o.len;
+    ++batchFrames;
+  }
+  printf("sweep %zu steps: %zu frames / %zu bytes per-step, %zu frames / %zu bytes batched (%.1fx)\n", sweepSteps,
+         sweepSteps, perStepBytes, batchFrames, batchBytes, (double)perStepBytes / batchBytes);
+
+  int16_t chunkRssi[RADIO_SWEEP_STEPS];
+  int32_t chunkDeltas[RADIO_SWEEP_STEPS];
+  sample_sweep_rssi(chunkRssi, RADIO_SWEEP_STEPS);
+  PbOStream chunkSize = pb_ostream_sizing();
+  pb_encode_RadioSignalBatch(chunkSize, sample_batch(0, chunkRssi, RADIO_SWEEP_STEPS, chunkDeltas));
+  bench("sweep chunk generated", iterations / 8, chunkSize.len + PB_FRAME_HEADER, [&](int i) {
+    int32_t deltas[RADIO_SWEEP_STEPS];
+    RadioSignalBatch_pb m = sample_batch((uint64_t)i, chunkRssi, RADIO_SWEEP_STEPS, deltas);
+    uint8_t f[256];
+    PbOStream o = pb_ostream(f + PB_FRAME_HEADER, sizeof(f) - PB_FRAME_HEADER);
+    pb_encode_RadioSignalBatch(o, m);
+    pb_frame_header(f, o.len);
+    sink = o.len + f[4];
+  });
+
+  if (bench_checks_failed()) return 1;
+  printf("codec checks: ok (generated bytes match the old encoder, round trips for all %d messages, no heap)\n", 10);
+  return 0;
+}
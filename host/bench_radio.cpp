@@ -0,0 +1,270 @@
+// Radio-batch buffer benchmark: the fixed per-module buffer in
+// main/radio_batch.h against the std::vector<BufferedSignal> (one heap
+// payload vector per signal) that events.ino used before it.
+//
+//   build/bench_radio [--iterations N]
+//
+// Reports enqueue cost and heap calls per signal, and the heap each leaves
+// behind after a long capture interleaved with long-lived allocations (the
+// way BLE/WiFi results outlive a batch on the device). Each fragmentation
+// run gets a fresh heap in a child process. Fails (exit 1) if the buffer
+// does not return what was pushed, mishandles a full buffer or arena, or
+// touches the heap.
+
+#include "radio_batch.h"
+#include "alloc_stats.h"
+#define BENCH_NAME "bench_radio"
+#include "bench_check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <random>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// --- baseline: the buffer events.ino used before radio_batch.h ---
+
+namespace legacy {
+
+struct BufferedSignal {
+  std::vector<uint8_t> payload;
+  float frequency_mhz;
+  int32_t rssi;
+  uint64_t timestamp_ms;
+};
+
+struct Buffer {
+  std::vector<BufferedSignal> signals;
+  size_t bytes = 0;
+
+  void push(uint64_t timestampMs, float frequencyMhz, int32_t rssi, const uint8_t *data, size_t len) {
+    BufferedSignal bs;
+    bs.payload.assign(data, data + len);
+    bs.frequency_mhz = frequencyMhz;
+    bs.rssi = rssi;
+    bs.timestamp_ms = timestampMs;
+    signals.push_back(std::move(bs));
+    bytes += len;
+  }
+  void clear() {
+    signals.clear();
+    bytes = 0;
+  }
+};
+
+}  // namespace legacy
+
+// --- helpers ---
+
+template <typename Fn>
+static void bench(const char *name, int iterations, size_t signals, Fn fn) {
+  HostAllocStats a0 = host_alloc_stats();
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) fn(i);
+  auto t1 = std::chrono::steady_clock::now();
+  HostAllocStats a1 = host_alloc_stats();
+  double n = (double)iterations * signals;
+  printf("%-30s %10.1f %12.2f\n", name, std::chrono::duration<double, std::nano>(t1 - t0).count() / n,
+         (double)(a1.allocs - a0.allocs) / n);
+}
+
+// Storage as events.ino sizes it for an event-counted (sub-GHz) module.
+static const size_t CAPACITY = 250;
+static const size_t ARENA = 1024;
+static RadioBatchEntry entries[CAPACITY];
+static uint8_t arena[ARENA];
+
+static void sweep_sample(uint8_t *out, uint32_t freqKhz, int16_t rssi) {
+  out[0] = 2;
+  out[1] = (uint8_t)freqKhz;
+  out[2] = (uint8_t)(freqKhz >> 8);
+  out[3] = (uint8_t)(freqKhz >> 16);
+  out[4] = (uint8_t)(freqKhz >> 24);
+  out[5] = (uint8_t)rssi;
+  out[6] = 0;
+}
+
+static void check_contents() {
+  std::mt19937 rng(11);
+  RadioBatchBuffer buf;
+  buf.init(entries, CAPACITY, arena, ARENA);
+  for (int round = 0; round < 500 && failures == 0; ++round) {
+    legacy::Buffer old;
+    buf.clear();
+    for (;;) {
+      uint8_t data[300];
+      size_t len = rng() % 4 == 0 ? rng() % sizeof(data) : rng() % (RADIO_BATCH_INLINE + 1);
+      for (size_t i = 0; i < len; ++i) data[i] = (uint8_t)rng();
+      uint64_t ts = ((uint64_t)rng() << 20) ^ rng();
+      float freq = 300.0f + (float)(rng() % 600000) / 1000.0f;
+      int32_t rssi = -(int32_t)(rng() % 130);
+      size_t kept = len > RADIO_BATCH_MAX_PAYLOAD ? RADIO_BATCH_MAX_PAYLOAD : len;
+      bool fits = !buf.full() && (kept <= RADIO_BATCH_INLINE || kept <= ARENA - buf.arenaUsed());
+      bool pushed = buf.push(ts, freq, rssi, data, len);
+      CHECK(pushed == fits);
+      if (!pushed) break;
+      old.push(ts, freq, rssi, data, kept);
+    }
+    CHECK(buf.count() == old.signals.size() && buf.payloadBytes() == old.bytes);
+    for (size_t i = 0; i < buf.count() && failures == 0; ++i) {
+      const RadioBatchEntry &e = buf.at(i);
+      const legacy::BufferedSignal &s = old.signals[i];
+      CHECK(e.timestampMs == s.timestamp_ms && e.frequencyMhz == s.frequency_mhz && e.rssi == s.rssi);
+      CHECK(e.payloadLen == s.payload.size() && memcmp(buf.payload(e), s.payload.data(), e.payloadLen) == 0);
+    }
+  }
+
+  // a full buffer takes nothing more until cleared; clear() rewinds the arena
+  uint8_t sample[7] = {};
+  buf.clear();
+  for (size_t i = 0; i < CAPACITY; ++i) CHECK(buf.push(i, 433.92f, -60, sample, sizeof(sample)));
+  CHECK(buf.full() && !buf.push(0, 0, 0, sample, 0));
+  buf.clear();
+  uint8_t big[RADIO_BATCH_MAX_PAYLOAD] = {};
+  for (size_t i = 0; i < ARENA / sizeof(big); ++i) CHECK(buf.push(i, 0, 0, big, sizeof(big)));
+  CHECK(!buf.push(0, 0, 0, big, sizeof(big)) && buf.push(0, 0, 0, sample, sizeof(sample)));
+  buf.clear();
+  CHECK(buf.empty() && buf.arenaUsed() == 0 && buf.push(0, 0, 0, big, sizeof(big)));
+}
+
+static void check_no_heap() {
+  RadioBatchBuffer buf;
+  buf.init(entries, CAPACITY, arena, ARENA);
+  uint8_t sample[7], packet[61] = {};
+  HostAllocStats a0 = host_alloc_stats();
+  for (int cycle = 0; cycle < 10; ++cycle) {
+    for (size_t i = 0; i < CAPACITY - 10; ++i) {
+      sweep_sample(sample, 433000 + (uint32_t)i * 25, -90);
+      buf.push(i, 433.0f, -90, sample, sizeof(sample));
+    }
+    for (int i = 0; i < 10; ++i) buf.push(i, 433.92f, -40, packet, sizeof(packet));
+    buf.clear();
+  }
+  CHECK(host_alloc_stats().allocs == a0.allocs);
+}
+
+// --- fragmentation ---
+
+struct HeapReport {
+  size_t heldBytes;   // taken from the system (mallinfo arena)
+  size_t freeBytes;   // free inside it: holes between live blocks
+  size_t liveBytes;
+  uint64_t allocs;
+};
+
+// `cycles` flushes of `CAPACITY` sweep samples each. Every 25 signals
+// something long-lived is allocated (a scan result, a log line) and kept, so
+// the per-signal blocks freed by a flush sit between survivors.
+template <typename Buf>
+static HeapReport capture_heap(Buf &buf, int cycles) {
+  std::vector<void *> survivors;
+  survivors.reserve((size_t)cycles * CAPACITY / 25 + 1);
+  uint8_t sample[7];
+  HostAllocStats a0 = host_alloc_stats();
+  for (int cycle = 0; cycle < cycles; ++cycle) {
+    for (size_t i = 0; i < CAPACITY; ++i) {
+      sweep_sample(sample, 433000 + (uint32_t)i * 25, -90 + (int16_t)(i % 7));
+      buf.push((uint64_t)cycle * 1000 + i, 433.0f + i * 0.025f, -90, sample, sizeof(sample));
+      if (i % 25 == 0) survivors.push_back(malloc(48 + (i % 3) * 16));
+    }
+    buf.clear();
+  }
+  HostAllocStats a1 = host_alloc_stats();
+  struct mallinfo2 mi = mallinfo2();
+  HeapReport r;
+  r.heldBytes = mi.arena;
+  r.freeBytes = mi.fordblks;
+  r.liveBytes = mi.uordblks;
+  r.allocs = a1.allocs - a0.allocs;
+  return r;
+}
+
+// Run `fn` in a child so each report starts from an untouched heap.
+template <typename Fn>
+static bool in_child(Fn fn, HeapReport &out) {
+  int fds[2];
+  if (pipe(fds) != 0) return false;
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    HeapReport r = fn();
+    ssize_t w = write(fds[1], &r, sizeof(r));
+    _exit(w == (ssize_t)sizeof(r) ? 0 : 1);
+  }
+  close(fds[1]);
+  ssize_t n = read(fds[0], &out, sizeof(out));
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return n == (ssize_t)sizeof(out) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char **argv) {
+  int iterations = 20000;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--iterations" && i + 1 < argc) iterations = atoi(argv[++i]);
+  }
+
+  check_contents();
+  check_no_heap();
+
+  // --- timing: one batch of CAPACITY signals pushed and flushed ---
+  printf("bench_radio: %d iterations of %zu signals\n", iterations, CAPACITY);
+  printf("%-30s %10s %12s\n", "case", "ns/signal", "allocs/signal");
+  static uint8_t packet[61];
+  for (size_t i = 0; i < sizeof(packet); ++i) packet[i] = (uint8_t)(i * 7);
+  const size_t lens[] = {7, 61};
+  for (size_t len : lens) {
+    char name[48];
+    legacy::Buffer old;
+    snprintf(name, sizeof(name), "%zu-byte payload legacy", len);
+    bench(name, iterations, CAPACITY, [&](int it) {
+      for (size_t i = 0; i < CAPACITY; ++i) old.push(i, 433.92f, -60 - it % 3, packet, len);
+      old.clear();
+    });
+    old.signals.shrink_to_fit();
+    RadioBatchBuffer buf;
+    buf.init(entries, CAPACITY, arena, ARENA);
+    snprintf(name, sizeof(name), "%zu-byte payload buffer", len);
+    bench(name, iterations, CAPACITY, [&](int it) {
+      for (size_t i = 0; i < CAPACITY; ++i) {
+        if (!buf.push(i, 433.92f, -60 - it % 3, packet, len)) {
+          buf.clear();  // arena full: the firmware flushes here
+          buf.push(i, 433.92f, -60 - it % 3, packet, len);
+        }
+      }
+      buf.clear();
+    });
+  }
+
+  // --- heap left behind by a 200-flush capture ---
+  const int cycles = 200;
+  HeapReport oldHeap, newHeap;
+  bool ranOld = in_child([&] {
+    legacy::Buffer old;
+    return capture_heap(old, cycles);
+  }, oldHeap);
+  bool ranNew = in_child([&] {
+    RadioBatchBuffer buf;
+    buf.init(entries, CAPACITY, arena, ARENA);
+    return capture_heap(buf, cycles);
+  }, newHeap);
+  CHECK(ranOld && ranNew);
+  printf("heap after %d flushes with long-lived allocations in between:\n", cycles);
+  printf("  %-8s %10s %10s %10s %10s\n", "", "allocs", "held", "live", "free holes");
+  printf("  %-8s %10llu %10zu %10zu %10zu\n", "legacy", (unsigned long long)oldHeap.allocs, oldHeap.heldBytes,
+         oldHeap.liveBytes, oldHeap.freeBytes);
+  printf("  %-8s %10llu %10zu %10zu %10zu\n", "buffer", (unsigned long long)newHeap.allocs, newHeap.heldBytes,
+         newHeap.liveBytes, newHeap.freeBytes);
+  CHECK(newHeap.allocs == (uint64_t)cycles * CAPACITY / 25);  // only the survivors
+
+  if (bench_checks_failed()) return 1;
+  printf("radio buffer checks: ok (contents match the vector buffer, full buffer and arena refused, no heap)\n");
+  return 0;
+}
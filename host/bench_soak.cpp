@@ -0,0 +1,285 @@
+// Long-run heap soak: replays command/response and BLE-scan cycles through
+// the firmware for a long time and watches the largest free block of a
+// model of the ESP32's internal RAM.
+//
+//   build/bench_soak [--cycles N]
+//
+// glibc cannot say how fragmented its heap is, so every heap call the
+// firmware makes while the soak runs (alloc_stats.h) is replayed into a
+// first-fit heap of MODEL_HEAP bytes with 8-byte granules and headers, the
+// way multi_heap carves internal RAM on the device; simulated PSRAM blocks
+// are left out. Each cycle also swaps one long-lived block (a log line, a
+// scan result kept by the app), so short-lived blocks freed around it leave
+// holes. Fails (exit 1) if the model runs out of room or its largest free
+// block ends the run smaller than it was once the long-lived blocks were in
+// place. The host String has no small-string buffer, so the heap calls per
+// cycle are an upper bound on the device's.
+
+#include "globals.h"
+#include "events.h"
+#include "fake_radios.h"
+#include "alloc_stats.h"
+#define BENCH_NAME "bench_soak"
+#include "bench_check.h"
+#include <esp_heap_caps.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+void setup();
+
+// --- model of internal RAM ---
+
+static const size_t MODEL_HEAP = 96 * 1024;
+static const size_t GRANULE = 8;
+static const size_t HEADER = 8;
+static const size_t MAX_RANGES = 8192;
+static const size_t MAX_BLOCKS = 1 << 15;  // power of two
+
+struct FreeRange {
+  uint32_t start;  // granules
+  uint32_t len;
+};
+
+struct ModelBlock {
+  const void *p;  // nullptr: empty slot
+  uint32_t start;
+  uint32_t len;
+};
+
+static std::mutex modelMutex;
+static FreeRange freeRanges[MAX_RANGES];  // sorted by start, never adjacent
+static size_t rangeCount = 0;
+static ModelBlock blocks[MAX_BLOCKS];
+static uint32_t usedGranules = 0;
+static uint64_t modelFailures = 0;
+
+static size_t block_slot(const void *p) {
+  return (size_t)(((uintptr_t)p >> 4) * 0x9E3779B97F4A7C15ull >> 49) & (MAX_BLOCKS - 1);
+}
+
+static void model_reset() {
+  rangeCount = 1;
+  freeRanges[0] = {0, (uint32_t)(MODEL_HEAP / GRANULE)};
+  memset(blocks, 0, sizeof(blocks));
+  usedGranules = 0;
+  modelFailures = 0;
+}
+
+static void model_alloc(const void *p, size_t bytes) {
+  uint32_t need = (uint32_t)((bytes + HEADER + GRANULE - 1) / GRANULE);
+  size_t r = 0;
+  while (r < rangeCount && freeRanges[r].len < need) ++r;
+  size_t slot = block_slot(p);
+  size_t probes = 0;
+  while (blocks[slot].p && probes++ < MAX_BLOCKS) slot = (slot + 1) & (MAX_BLOCKS - 1);
+  if (r == rangeCount || blocks[slot].p) {
+    ++modelFailures;
+    return;
+  }
+  blocks[slot] = {p, freeRanges[r].start, need};
+  freeRanges[r].start += need;
+  freeRanges[r].len -= need;
+  if (freeRanges[r].len == 0) {
+    memmove(&freeRanges[r], &freeRanges[r + 1], (rangeCount - r - 1) * sizeof(FreeRange));
+    --rangeCount;
+  }
+  usedGranules += need;
+}
+
+static void model_free(const void *p) {
+  size_t slot = block_slot(p);
+  while (blocks[slot].p && blocks[slot].p != p) slot = (slot + 1) & (MAX_BLOCKS - 1);
+  if (!blocks[slot].p) return;  // allocated before the model was attached
+  uint32_t start = blocks[slot].start, len = blocks[slot].len;
+  usedGranules -= len;
+
+  // backward-shift delete keeps every probe chain unbroken
+  size_t hole = slot;
+  for (size_t next = (hole + 1) & (MAX_BLOCKS - 1); blocks[next].p; next = (next + 1) & (MAX_BLOCKS - 1)) {
+    size_t home = block_slot(blocks[next].p);
+    if (((next - home) & (MAX_BLOCKS - 1)) >= ((next - hole) & (MAX_BLOCKS - 1))) {
+      blocks[hole] = blocks[next];
+      hole = next;
+    }
+  }
+  blocks[hole].p = nullptr;
+
+  size_t lo = 0, hi = rangeCount;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (freeRanges[mid].start < start) lo = mid + 1;
+    else hi = mid;
+  }
+  bool joinPrev = lo > 0 && freeRanges[lo - 1].start + freeRanges[lo - 1].len == start;
+  bool joinNext = lo < rangeCount && start + len == freeRanges[lo].start;
+  if (joinPrev && joinNext) {
+    freeRanges[lo - 1].len += len + freeRanges[lo].len;
+    memmove(&freeRanges[lo], &freeRanges[lo + 1], (rangeCount - lo - 1) * sizeof(FreeRange));
+    --rangeCount;
+  } else if (joinPrev) {
+    freeRanges[lo - 1].len += len;
+  } else if (joinNext) {
+    freeRanges[lo].start = start;
+    freeRanges[lo].len += len;
+  } else if (rangeCount == MAX_RANGES) {
+    ++modelFailures;  // the granules stay lost
+  } else {
+    memmove(&freeRanges[lo + 1], &freeRanges[lo], (rangeCount - lo) * sizeof(FreeRange));
+    freeRanges[lo] = {start, len};
+    ++rangeCount;
+  }
+}
+
+static void observe(void *p, size_t bytes, bool alloc) {
+  if (alloc && host_psram_allocating) return;
+  std::lock_guard<std::mutex> lock(modelMutex);
+  if (alloc) model_alloc(p, bytes);
+  else model_free(p);
+}
+
+struct ModelReport {
+  size_t largestFree;
+  size_t freeBytes;
+  size_t holes;  // free ranges
+  uint64_t failures;
+};
+
+static ModelReport model_report() {
+  std::lock_guard<std::mutex> lock(modelMutex);
+  ModelReport r = {0, 0, rangeCount, modelFailures};
+  for (size_t i = 0; i < rangeCount; ++i) {
+    size_t bytes = (size_t)freeRanges[i].len * GRANULE;
+    r.freeBytes += bytes;
+    if (bytes > r.largestFree) r.largestFree = bytes;
+  }
+  return r;
+}
+
+// --- one soak cycle ---
+
+// Replies seen by the client, and the kinds the cycle must produce.
+static uint64_t replies = 0;
+static bool sawStopped = false, sawCancelled = false, sawReplyTo = false;
+
+static bool contains(const uint8_t *data, size_t len, const char *s) {
+  return memmem(data, len, s, strlen(s)) != nullptr;
+}
+
+static void onNotify(BLECharacteristic *c, const uint8_t *data, size_t len) {
+  if (c != pStatusChar) return;
+  ++replies;
+  if (contains(data, len, "oscilloscope.stop:stopped")) sawStopped = true;
+  if (contains(data, len, "sensor.stream.start:cancelled")) sawCancelled = true;
+  if (contains(data, len, "\"inReplyTo\":\"r1\"")) sawReplyTo = true;
+}
+
+static void command(const char *text) {
+  bluetooth_receive_command_bytes((const uint8_t *)text, strlen(text));
+}
+
+static void process(int n) {
+  for (int i = 0; i < n; ++i) events_process_one();
+}
+
+static const size_t SURVIVORS = 64;
+static void *survivors[SURVIVORS];
+
+static void run_cycle(int cycle) {
+  static const char *const mods[] = {"OOK", "2-FSK", "GFSK", "MSK", "ASK"};
+  char text[160];
+
+  snprintf(text, sizeof(text), "{\"command\":\"subghz.set.mod.one\",\"params\":{\"modulation\":\"%s\"},\"id\":\"m%d\"}",
+           mods[cycle % 5], cycle);
+  command(text);
+  command("{\"command\":\"subghz.set.mod.two\",\"params\":{\"modulation\":\"2-FSK\"},\"id\":\"m2\"}");
+  command("{\"Command\":{\"StartRadioScan\":{\"frequency\":433.92,\"modulation\":\"OOK\"}},\"id\":\"r1\"}");
+  command("{\"Command\":{\"StopRadioScan\":{}},\"id\":\"r2\"}");
+  process(4);
+
+  command("{\"command\":\"oscilloscope.start\",\"id\":\"o1\"}");
+  process(1);
+  command("{\"command\":\"oscilloscope.stop\",\"id\":\"o2\"}");
+  process(1);
+  // the stop overtakes the start, which is answered ":cancelled"
+  command("{\"command\":\"sensor.stream.start\",\"id\":\"c1\"}");
+  command("{\"command\":\"sensor.stream.stop\",\"id\":\"c2\"}");
+  process(2);
+  command("{\"batch\":[{\"command\":\"subghz.set.mod.one\",\"params\":{\"modulation\":\"OOK\"},\"id\":\"a\"},"
+          "\"list.paired.devices\"],\"id\":\"B1\"}");
+  process(1);
+
+  // what the BLE scan callback collects over one report period
+  for (int i = 0; i < 20; ++i) {
+    blescanner_Device dev;
+    snprintf(text, sizeof(text), "device-%d", (cycle * 7 + i) % 1000);
+    dev.name = text;
+    snprintf(text, sizeof(text), "aa:bb:cc:dd:%02x:%02x", cycle & 0xFF, i);
+    dev.address = text;
+    dev.rssi = -40 - i;
+    dev.manufacturer = i % 3 ? "0x004C" : "unknown";
+    dev.deviceType = "0000180f-0000-1000-8000-00805f9b34fb";
+    blescanner_devices.push_back(dev);
+    if (i == 10) {
+      // a long-lived block lands among the short-lived ones, the way the
+      // app's own allocations interleave with a running scan
+      free(survivors[cycle % SURVIVORS]);
+      survivors[cycle % SURVIVORS] = malloc(40 + (cycle % 4) * 16);
+    }
+  }
+  blescanner_devices.clear();
+}
+
+int main(int argc, char **argv) {
+  int cycles = 5000;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--cycles" && i + 1 < argc) cycles = atoi(argv[++i]);
+  }
+  if (cycles < 10 * (int)SURVIVORS) cycles = 10 * (int)SURVIVORS;
+
+  host_attach_fake_radios();
+  BLECharacteristic::setNotifyObserver(onNotify);
+  setup();
+  host_ble_connect(pServer);
+  // once outside the model, so one-time lazy setup is not counted
+  run_cycle(0);
+  for (size_t i = 0; i < SURVIVORS; ++i) {
+    free(survivors[i]);
+    survivors[i] = nullptr;
+  }
+
+  printf("bench_soak: %d cycles, %zu KB first-fit model of internal RAM\n", cycles, MODEL_HEAP / 1024);
+  printf("%8s %12s %12s %10s %10s %8s\n", "cycle", "replies/cycle", "allocs/cycle", "largest", "free", "holes");
+  model_reset();
+  host_alloc_set_observer(observe);
+  const int every = cycles / 10;
+  ModelReport first = {}, last = {};
+  HostAllocStats a0 = host_alloc_stats();
+  uint64_t replies0 = replies;
+  for (int c = 1; c <= cycles; ++c) {
+    run_cycle(c);
+    if (c % every) continue;
+    HostAllocStats a1 = host_alloc_stats();
+    ModelReport r = model_report();
+    printf("%8d %12.1f %12.1f %10zu %10zu %8zu\n", c, (double)(replies - replies0) / every,
+           (double)(a1.allocs - a0.allocs) / every, r.largestFree, r.freeBytes, r.holes);
+    a0 = a1;
+    replies0 = replies;
+    if (c == every) first = r;  // every long-lived block is in place by now
+    last = r;
+  }
+  host_alloc_set_observer(nullptr);
+
+  CHECK(sawStopped && sawCancelled && sawReplyTo);
+  CHECK(last.failures == 0);
+  CHECK(last.largestFree >= first.largestFree);
+
+  if (bench_checks_failed()) return 1;
+  printf("soak checks: ok (largest free block %zu -> %zu bytes over %d cycles)\n", first.largestFree, last.largestFree,
+         cycles);
+  return 0;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+// Reference reassembler for the notifications main/ble_link.h produces: feed
+// it every status-characteristic notification in order and it hands back the
+// original messages. Unframed (legacy) notifications come back as they are.
+// On a sequence gap the partially assembled message is dropped and counted,
+// and records continuing it are skipped until the next whole message starts.
+// BleLinkInflater undoes `ble.link` compression on the reassembled messages.
+
+#include "ble_link.h"
+#include "lzss.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class BleLinkReassembler {
+public:
+  using MessageFn = std::function<void(const uint8_t *data, size_t len)>;
+
+  explicit BleLinkReassembler(MessageFn fn) : fn_(std::move(fn)) {}
+
+  void feed(const uint8_t *data, size_t len) {
+    ++notifications_;
+    if (len == 0 || data[0] != BLE_LINK_MAGIC) {
+      ++messages_;
+      fn_(data, len);
+      return;
+    }
+    if (len < BLE_LINK_HEADER) { ++malformed_; return; }
+
+    uint8_t seq = data[1];
+    if (haveSeq_ && seq != (uint8_t)(lastSeq_ + 1)) {
+      ++gaps_;
+      drop();
+    }
+    haveSeq_ = true;
+    lastSeq_ = seq;
+
+    size_t at = BLE_LINK_HEADER;
+    while (at < len) {
+      if (len - at < BLE_LINK_RECORD_HEADER) { ++malformed_; drop(); return; }
+      uint16_t hdr = (uint16_t)(data[at] | (data[at + 1] << 8));
+      at += BLE_LINK_RECORD_HEADER;
+      size_t n = hdr & BLE_LINK_LEN_MASK;
+      if (n > len - at) { ++malformed_; drop(); return; }
+
+      bool cont = (hdr & BLE_LINK_CONT) != 0;
+      if (!cont && assembling_) { ++malformed_; drop(); }
+      if (cont && !assembling_) {
+        // tail of a message whose head was lost
+        at += n;
+        continue;
+      }
+      if (!cont) partial_.clear();
+      partial_.insert(partial_.end(), data + at, data + at + n);
+      at += n;
+
+      if (hdr & BLE_LINK_MORE) {
+        assembling_ = true;
+      } else {
+        assembling_ = false;
+        ++messages_;
+        fn_(partial_.data(), partial_.size());
+        partial_.clear();
+      }
+    }
+  }
+
+  unsigned long notifications() const { return notifications_; }
+  unsigned long messages() const { return messages_; }
+  unsigned long gaps() const { return gaps_; }
+  unsigned long dropped() const { return dropped_; }
+  unsigned long malformed() const { return malformed_; }
+
+private:
+  void drop() {
+    if (assembling_) ++dropped_;
+    assembling_ = false;
+    partial_.clear();
+  }
+
+  MessageFn fn_;
+  std::vector<uint8_t> partial_;
+  bool assembling_ = false;
+  bool haveSeq_ = false;
+  uint8_t lastSeq_ = 0;
+  unsigned long notifications_ = 0;
+  unsigned long messages_ = 0;
+  unsigned long gaps_ = 0;
+  unsigned long dropped_ = 0;
+  unsigned long malformed_ = 0;
+};
+
+// Reference decompressor for messages sent with {"compress":true}: a kind
+// byte, then one lzss.h message. Feed it every reassembled message once the
+// ble.link reply has confirmed compression, and call gap() whenever the
+// reassembler reports a lost notification; it then drops messages until the
+// window is next reset.
+class BleLinkInflater {
+public:
+  // True with the original message in `out`; false if it has to be dropped.
+  bool inflate(const uint8_t *data, size_t len, std::vector<uint8_t> &out) {
+    if (len == 0 || (data[0] != BLE_LINK_LZ && data[0] != BLE_LINK_LZ_RESET)) {
+      ++invalid_;
+      synced_ = false;
+      return false;
+    }
+    if (data[0] == BLE_LINK_LZ_RESET) {
+      dec_.reset();
+      synced_ = true;
+    }
+    if (!synced_) {
+      ++dropped_;
+      return false;
+    }
+    out.resize((len - 1) / 2 * LZSS_MAX_MATCH + 1);
+    size_t n = dec_.decompress(data + 1, len - 1, out.data(), out.size());
+    if (n == LZSS_INVALID) {
+      ++invalid_;
+      synced_ = false;
+      return false;
+    }
+    out.resize(n);
+    ++messages_;
+    return true;
+  }
+
+  void gap() { synced_ = false; }
+
+  unsigned long messages() const { return messages_; }
+  unsigned long dropped() const { return dropped_; }
+  unsigned long invalid() const { return invalid_; }
+
+private:
+  LzssDecoder dec_;
+  bool synced_ = false;
+  unsigned long messages_ = 0;
+  unsigned long dropped_ = 0;
+  unsigned long invalid_ = 0;
+};
@@ -0,0 +1,166 @@
+#include "fake_radios.h"
+
+#include "globals.h"
+
+#define CC1101_READ 0x80
+#define CC1101_BURST 0x40
+
+// CC1101 MARCSTATE values
+#define MARC_IDLE 0x01
+#define MARC_RX 0x0D
+#define MARC_TX 0x13
+
+extern SPIClass cc1101_spi2;
+
+static FakeCC1101 fakeCC1101[2];
+
+static int misoReady(void *ctx, uint8_t pin) {
+  (void)pin;
+  FakeCC1101 *dev = (FakeCC1101 *)ctx;
+  return dev->present ? LOW : HIGH;
+}
+
+// GDO0 in sync-word mode: high from the sync word to the end of the packet.
+// A transmit is over after one high and one low read.
+static int gdo0Level(void *ctx, uint8_t pin) {
+  (void)pin;
+  return ((FakeCC1101 *)ctx)->gdo0();
+}
+
+FakeCC1101::FakeCC1101()
+    : marc_(MARC_IDLE), selected_(false), haveHeader_(false), header_(0), burstIdx_(0),
+      regWrites_(0), statusReads_(0), strobes_(0), jitter_(0x1234567u), txPackets_(0), txSync_(false) {
+  memset(regs_, 0, sizeof(regs_));
+  memset(pa_, 0, sizeof(pa_));
+}
+
+void FakeCC1101::attach(SPIClass &bus, uint8_t csPin, uint8_t misoPin, uint8_t gdo0Pin) {
+  bus.attach(csPin, this);
+  host_gpio_source(misoPin, misoReady, this);
+  host_gpio_source(gdo0Pin, gdo0Level, this);
+}
+
+int FakeCC1101::gdo0() {
+  if (marc_ != MARC_TX) return LOW;
+  if (!txSync_) {
+    txSync_ = true;
+    return HIGH;
+  }
+  txSync_ = false;
+  marc_ = MARC_IDLE;
+  return LOW;
+}
+
+float FakeCC1101::tunedMHz() const {
+  uint32_t word = ((uint32_t)regs_[0x0D] << 16) | ((uint32_t)regs_[0x0E] << 8) | regs_[0x0F];
+  return 26.0f * (float)word / 65536.0f;
+}
+
+uint8_t FakeCC1101::rssiRegister() const {
+  float d = fabsf(tunedMHz() - carrierMHz);
+  float dbm = noiseFloorDbm;
+  if (d < 1.0f) {
+    float peak = carrierDbm - d * 60.0f;
+    if (peak > dbm) dbm = peak;
+  }
+  // +/-2 dB of deterministic jitter around the model
+  dbm += (float)((int)(jitter_ % 5) - 2);
+  int dec = (int)((dbm + 74.0f) * 2.0f);
+  if (dec < -128) dec = -128;
+  if (dec > 127) dec = 127;
+  return (uint8_t)(int8_t)dec;
+}
+
+uint8_t FakeCC1101::readStatus(uint8_t addr) {
+  ++statusReads_;
+  switch (addr) {
+    case 0x30: return 0x00;  // PARTNUM
+    case 0x31: return 0x14;  // VERSION
+    case 0x33: return 0x80;  // LQI (CRC ok)
+    case 0x34:
+      jitter_ = jitter_ * 1103515245u + 12345u;
+      return rssiRegister();
+    case 0x35: return marc_;
+    default: return 0x00;    // FIFOs always empty
+  }
+}
+
+void FakeCC1101::strobe(uint8_t cmd) {
+  ++strobes_;
+  switch (cmd) {
+    case 0x30: memset(regs_, 0, sizeof(regs_)); marc_ = MARC_IDLE; break;  // SRES
+    case 0x34: marc_ = MARC_RX; break;   // SRX
+    case 0x35:                           // STX: the FIFO goes out as one packet
+      marc_ = MARC_TX;
+      txSync_ = false;
+      if (!txFifo_.empty()) {
+        lastTx_.assign(txFifo_.begin() + 1, txFifo_.end());
+        txFifo_.clear();
+        ++txPackets_;
+      }
+      break;
+    case 0x36: marc_ = MARC_IDLE; break; // SIDLE
+    case 0x3B: txFifo_.clear(); break;   // SFTX
+    default: break;
+  }
+}
+
+void FakeCC1101::select(bool selected) {
+  selected_ = selected;
+  haveHeader_ = false;
+  burstIdx_ = 0;
+}
+
+uint8_t FakeCC1101::transfer(uint8_t out) {
+  if (!present || !selected_) return 0xFF;
+
+  if (!haveHeader_) {
+    uint8_t addr = out & 0x3F;
+    bool read = (out & CC1101_READ) != 0;
+    bool burst = (out & CC1101_BURST) != 0;
+    if (addr >= 0x30 && addr <= 0x3D && !burst && !read) {
+      strobe(addr);
+      return marc_;
+    }
+    haveHeader_ = true;
+    header_ = out;
+    burstIdx_ = 0;
+    return marc_;
+  }
+
+  uint8_t addr = header_ & 0x3F;
+  bool read = (header_ & CC1101_READ) != 0;
+  bool burst = (header_ & CC1101_BURST) != 0;
+  uint8_t idx = burst ? burstIdx_++ : 0;
+
+  if (addr == 0x3E) {  // PATABLE
+    uint8_t slot = idx & 7;
+    if (read) return pa_[slot];
+    pa_[slot] = out;
+    return 0;
+  }
+  if (addr == 0x3F) {  // FIFO: writes queue a packet, reads empty
+    if (!read) txFifo_.push_back(out);
+    return 0;
+  }
+
+  if (read) {
+    if (burst && addr >= 0x30) return readStatus(addr);
+    uint8_t a = (uint8_t)(addr + idx);
+    return a < sizeof(regs_) ? regs_[a] : 0;
+  }
+
+  uint8_t a = (uint8_t)(addr + idx);
+  if (a < sizeof(regs_)) {
+    regs_[a] = out;
+    ++regWrites_;
+  }
+  return 0;
+}
+
+void host_attach_fake_radios() {
+  fakeCC1101[0].attach(SPI, CC1101_1_CS, CC1101_1_MISO, CC1101_1_GDO0);
+  fakeCC1101[1].attach(cc1101_spi2, CC1101_2_CS, CC1101_2_MISO, CC1101_2_GDO0);
+}
+
+FakeCC1101 &host_fake_cc1101(int index) { return fakeCC1101[index ? 1 : 0]; }
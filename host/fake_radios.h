@@ -0,0 +1,63 @@
+#pragma once
+
+// Fake radios for the host build. FakeCC1101 sits on a host SPI bus behind the
+// real ELECHOUSE_CC1101 driver, so CC1101_1Transceiver/CC1101_2Transceiver run
+// unmodified and every register access is exercised.
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include <vector>
+
+class FakeCC1101 : public HostSpiDevice {
+public:
+  FakeCC1101();
+
+  // Wire the fake onto `bus` with the given chip-select, MISO and GDO0 pins.
+  void attach(SPIClass &bus, uint8_t csPin, uint8_t misoPin, uint8_t gdo0Pin);
+
+  // Signal model: a noise floor plus one carrier whose RSSI falls off with
+  // distance from `carrierMHz`.
+  float noiseFloorDbm = -100.0f;
+  float carrierMHz = 433.92f;
+  float carrierDbm = -40.0f;
+  bool present = true;
+
+  float tunedMHz() const;
+  unsigned long registerWrites() const { return regWrites_; }
+  unsigned long statusReads() const { return statusReads_; }
+  unsigned long strobes() const { return strobes_; }
+  // Packets sent with STX, and the last one (TX FIFO less its length byte).
+  unsigned long txPackets() const { return txPackets_; }
+  const std::vector<uint8_t> &lastTx() const { return lastTx_; }
+  int gdo0();
+
+  void select(bool selected) override;
+  uint8_t transfer(uint8_t out) override;
+
+private:
+  uint8_t rssiRegister() const;
+  uint8_t readStatus(uint8_t addr);
+  void strobe(uint8_t cmd);
+
+  uint8_t regs_[0x30];
+  uint8_t pa_[8];
+  uint8_t marc_;
+  bool selected_;
+  bool haveHeader_;
+  uint8_t header_;
+  uint8_t burstIdx_;
+  unsigned long regWrites_;
+  unsigned long statusReads_;
+  unsigned long strobes_;
+  uint32_t jitter_;
+  std::vector<uint8_t> txFifo_;
+  std::vector<uint8_t> lastTx_;
+  unsigned long txPackets_;
+  bool txSync_;   // GDO0 has reported the sync word of the packet in flight
+};
+
+// Create the fake CC1101 pair on FSPI (#1) and HSPI (#2) and attach them to
+// the pins used by deviceSetup(). Call before deviceSetup().
+void host_attach_fake_radios();
+FakeCC1101 &host_fake_cc1101(int index);
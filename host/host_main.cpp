@@ -0,0 +1,447 @@
+// Smoke driver for the host build: boots the firmware against the fake
+// radios, pairs a simulated BLE client, runs one sub-GHz sweep and prints
+// what went over the air. Halfway through, the client negotiates a larger
+// MTU and switches to framed, then compressed notifications (ble_link.h);
+// every notification is fed through the reference reassembler and
+// decompressor, which must lose nothing. The
+// serial port is then switched to binary mode (serial_link.h) and its
+// output decoded the way host/serial_decode.cpp does; given a path, the raw
+// binary stream is also written there for serial_decode to replay. A
+// binary (protobuf) subghz.packet.send must reach the fake CC1101's TX FIFO
+// and be answered under its correlation id. Status reporting at its
+// shortest interval must probe the buses only on the slow presence refresh
+// and send a frame only on a change or a heartbeat. JSON radio-batches must
+// follow the radio.batch.policy limits: age and idle deadlines, and a
+// target frame size. They are encoded on the radio TX task. Large buffers
+// must land in (simulated) PSRAM and fall back to internal RAM when it is full.
+// Every item of a full batch must be answered, even when the replies outgrow
+// one aggregate notification. Background jobs must share a scheduler pass
+// unless they share a bus, and wait out a busy bus worker.
+
+#include "globals.h"
+#include "events.h"
+#include "fake_radios.h"
+#include "ble_link.h"
+#include "ble_link_reassembler.h"
+#include "serial_frame.h"
+#include "commands.h"
+#include "sharkos.pb.h"
+#include "telemetry.h"
+#include "psram_alloc.h"
+#include "radio_batch.h"
+#include "bus_workers.h"
+#include <esp_heap_caps.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+void setup();
+void loop();
+void notifyStatus(const char *s);
+extern SPIClass cc1101_spi2;
+
+static unsigned long statusNotifies = 0;
+static unsigned long statusBytes = 0;
+static std::string longMessage;
+
+static BleLinkInflater inflater;
+static bool linkCompressed = false;
+static unsigned long linkGaps = 0;
+static unsigned long longMessagesSeen = 0;
+static bool packetSendAcked = false;
+static bool memStatsReplied = false;
+static unsigned long bleBatches = 0, bleBatchSignals = 0;  // radio-batch messages over BLE
+static unsigned batchItemsAnswered = 0;                     // bit i: item "bi<i>" of batch "bt1"
+static unsigned long batchAggregates = 0, batchSingles = 0;
+static unsigned long noActiveScanReplies = 0;
+
+static void onMessage(const uint8_t *data, size_t len) {
+  std::string text((const char *)data, len);
+  if (text.find("subghz.packet.send:ok") != std::string::npos && text.find("\"inReplyTo\":\"tx1\"") != std::string::npos)
+    packetSendAcked = true;
+  if (text.find("radio_batch") != std::string::npos && text.find("\"inReplyTo\":\"m1\"") != std::string::npos)
+    memStatsReplied = true;
+  if (text == "ERROR:no_active_scan") ++noActiveScanReplies;
+  for (int i = 0; i < 8; ++i) {
+    char id[24];
+    snprintf(id, sizeof(id), "\"inReplyTo\":\"bi%d\"", i);
+    if (text.find(id) != std::string::npos) batchItemsAnswered |= 1u << i;
+  }
+  static const char batchTail[] = "],\"inReplyTo\":\"bt1\"}";
+  if (text.compare(0, 10, "{\"batch\":[") == 0 && text.size() >= sizeof(batchTail) - 1 &&
+      text.compare(text.size() - (sizeof(batchTail) - 1), std::string::npos, batchTail) == 0)
+    ++batchAggregates;
+  else if (text.find("\"inReplyTo\":\"bi") != std::string::npos)
+    ++batchSingles;
+  if (len == longMessage.size() && std::string((const char *)data, len) == longMessage) ++longMessagesSeen;
+  if (text.compare(0, 21, "{\"type\":\"radio-batch\"") == 0) {
+    ++bleBatches;
+    for (size_t at = 0; (at = text.find("\"timestamp_ms\"", at)) != std::string::npos; ++at) ++bleBatchSignals;
+  }
+  // the ble.link reply ({"Response":"{\"mtu\":..,\"compress\":true,..}"}) is
+  // the last message before compression starts
+  if (!linkCompressed && text.find("\\\"compress\\\":true") != std::string::npos)
+    linkCompressed = true;
+}
+
+static BleLinkReassembler reassembler([](const uint8_t *data, size_t len) {
+  if (!linkCompressed) {
+    onMessage(data, len);
+    return;
+  }
+  if (reassembler.gaps() != linkGaps) {
+    linkGaps = reassembler.gaps();
+    inflater.gap();
+  }
+  static std::vector<uint8_t> plain;
+  if (inflater.inflate(data, len, plain)) onMessage(plain.data(), plain.size());
+});
+
+extern void events_enqueue_radio_bytes_at(int module, const uint8_t *data, size_t len, float frequency_mhz,
+                                          int32_t rssi, uint64_t timestamp_ms);
+
+// JSON radio-batch subscriber, on only for the batch policy checks.
+static bool jsonBatchOn = false;
+static std::string jsonBatch;
+static std::vector<std::pair<size_t, size_t>> jsonBatches;  // (signals, text bytes)
+
+static const TelemetrySubscriber jsonBatchSub = {
+    "host-json", TELEMETRY_FORMAT_JSON_BATCH, [] { return jsonBatchOn; },
+    [](const uint8_t *data, size_t len) { jsonBatch.append((const char *)data, len); },
+    [] {
+      size_t signals = 0;
+      for (size_t at = 0; (at = jsonBatch.find("\"timestamp_ms\"", at)) != std::string::npos; ++at) ++signals;
+      jsonBatches.push_back({signals, jsonBatch.size()});
+      jsonBatch.clear();
+    }};
+
+// Feed `count` NFC-module signals `gapMs` apart, then wait `settleMs`, and
+// return the batches that came out.
+static std::vector<std::pair<size_t, size_t>> feedBatches(int count, unsigned long gapMs, unsigned long settleMs);
+
+static SerialFrameDecoder serialDecoder;
+static unsigned long serialTelemetryFrames = 0;
+static unsigned long serialLogLines = 0;
+static FILE *serialCapture = nullptr;
+
+static void onSerial(const char *data, size_t len) {
+  if (!serial_link_binary()) return;
+  if (serialCapture) fwrite(data, 1, len, serialCapture);
+  for (size_t i = 0; i < len; ++i) {
+    if (!serialDecoder.push((uint8_t)data[i])) continue;
+    if (serialDecoder.channel() == SERIAL_CH_TELEMETRY) ++serialTelemetryFrames;
+    if (serialDecoder.channel() == SERIAL_CH_LOG) ++serialLogLines;
+  }
+}
+
+static void onNotify(BLECharacteristic *c, const uint8_t *data, size_t len) {
+  if (c != pStatusChar) return;
+  ++statusNotifies;
+  statusBytes += len;
+  reassembler.feed(data, len);
+}
+
+// loop() sleeps until its next deadline, so drive it for a span of
+// (virtual) time rather than a fixed number of passes.
+static void runFor(unsigned long ms) {
+  unsigned long until = millis() + ms;
+  while ((long)(millis() - until) < 0) loop();
+}
+
+static std::vector<std::pair<size_t, size_t>> feedBatches(int count, unsigned long gapMs, unsigned long settleMs) {
+  static const uint8_t sample[7] = {2, 0x10, 0x9E, 0x06, 0x00, 0xC4, 3};
+  jsonBatches.clear();
+  for (int i = 0; i < count; ++i) {
+    events_enqueue_radio_bytes_at(NFC, sample, sizeof(sample), 13.56f, -60, millis());
+    if (gapMs) runFor(gapMs);
+  }
+  runFor(settleMs);
+  // the TX task sleeps in real time when its ring is full, while the loop
+  // skips ahead in virtual time
+  events_radio_flush_wait();
+  return jsonBatches;
+}
+
+static size_t batchSignals(const std::vector<std::pair<size_t, size_t>> &batches, size_t *maxSignals, size_t *maxText) {
+  size_t total = 0;
+  *maxSignals = *maxText = 0;
+  for (const auto &b : batches) {
+    total += b.first;
+    if (b.first > *maxSignals) *maxSignals = b.first;
+    if (b.second > *maxText) *maxText = b.second;
+  }
+  return total;
+}
+
+int main(int argc, char **argv) {
+  host_attach_fake_radios();
+  BLECharacteristic::setNotifyObserver(onNotify);
+  if (argc > 1) serialCapture = fopen(argv[1], "wb");
+  serial_link_port().setSink(onSerial);
+
+  auto t0 = std::chrono::steady_clock::now();
+  setup();
+  host_ble_connect(pServer);
+
+  host_ble_client_write(pCmdChar, "{\"command\":\"pair.set\",\"params\":{\"pin\":\"6942\"},\"id\":\"p1\"}");
+  host_ble_client_write(pCmdChar, "status.info");
+  runFor(400);
+
+  // binary command: subghz.packet.send with a CC1101Tx body, named by id
+  static const uint8_t packet[] = {0x55, 0xAA, 0x01, 0x02, 0x03, 0x04, 0x05};
+  CC1101Tx_pb tx;
+  tx.module = RadioModuleCC_CC1101_1;
+  tx.frequency_mhz = 433.92f;
+  tx.power_dbm = 10;
+  tx.payload = pb_bytes(packet, sizeof(packet));
+  Command_pb pbCmd;
+  pbCmd.command_id = CMDID_SUBGHZ_PACKET_SEND + 1;
+  pbCmd.correlation_id = pb_str("tx1");
+  pbCmd.cc1101_tx = pb_message(tx);
+  uint8_t frame[128];
+  PbOStream o = pb_ostream(frame + PB_FRAME_HEADER, sizeof(frame) - PB_FRAME_HEADER);
+  pb_encode_Command(o, pbCmd);
+  pb_frame_header(frame, o.len);
+  host_ble_client_write(pCmdChar, frame, PB_FRAME_HEADER + o.len);
+  runFor(100);
+  const std::vector<uint8_t> &sent = host_fake_cc1101(0).lastTx();
+  bool packetOk = packetSendAcked && host_fake_cc1101(0).txPackets() == 1 && sent.size() == sizeof(packet) &&
+                  memcmp(sent.data(), packet, sizeof(packet)) == 0;
+
+  host_ble_set_mtu(pServer, 185);
+  host_ble_client_write(pCmdChar, "{\"command\":\"ble.link\",\"params\":{\"framing\":true},\"id\":\"l1\"}");
+  runFor(100);
+  // longer than any notification: must arrive in fragments and reassemble
+  for (int i = 0; i < 1200; ++i) longMessage += (char)('a' + i % 26);
+  notifyStatus(longMessage.c_str());
+  host_ble_client_write(pCmdChar, "{\"command\":\"ble.link\",\"params\":{\"compress\":true},\"id\":\"l2\"}");
+  runFor(100);
+  notifyStatus(longMessage.c_str());  // the same again, now compressed
+
+  host_ble_client_write(pCmdChar, "{\"command\":\"serial.link\",\"params\":{\"binary\":true}}");
+  runFor(100);
+
+  host_ble_client_write(pCmdChar,
+      "{\"command\":\"subghz.read.start\",\"params\":{\"bottom_frequency_mhz\":433.0,\"top_frequency_mhz\":435.0}}");
+  runFor(600);
+  host_ble_client_write(pCmdChar, "subghz.read.stop");
+  runFor(1000);
+
+  // Burst past the normal lane while the loop is busy: the trailing stop
+  // must overtake the queue and cancel the start queued ahead of it.
+  host_ble_client_write(pCmdChar, "{\"command\":\"subghz.read.start\",\"id\":\"r2\"}");
+  for (int i = 0; i < 18; ++i) host_ble_client_write(pCmdChar, "battery.info");
+  // only a sub-GHz stop cuts the sweep short
+  host_ble_client_write(pCmdChar, "oscilloscope.stop");
+  bool preemptOk = !events_preempt_requested();
+  host_ble_client_write(pCmdChar, "subghz.read.stop");
+  preemptOk = preemptOk && events_preempt_requested();
+  runFor(200);
+  preemptOk = preemptOk && !events_preempt_requested();
+
+  // status.reporting at 250 ms for 41 s; the NFC reader drops out at 5 s and
+  // shows up at the 10 s refresh, the snapshot then stays the same until the
+  // 30 s heartbeat
+  EventsStatusStats st0;
+  events_status_stats(st0);
+  unsigned long nfcQueries0 = Adafruit_PN532::firmwareQueries();
+  unsigned long versionReads0 = host_fake_cc1101(0).statusReads() + host_fake_cc1101(1).statusReads();
+  host_ble_client_write(pCmdChar, "{\"command\":\"status.reporting.start\",\"params\":{\"interval_ms\":250}}");
+  runFor(5000);
+  Adafruit_PN532::setPresent(false);
+  runFor(36000);
+  host_ble_client_write(pCmdChar, "status.reporting.stop");
+  runFor(100);
+  Adafruit_PN532::setPresent(true);
+  EventsStatusStats st;
+  events_status_stats(st);
+  unsigned long statusProbes = st.probes - st0.probes, statusSent = st.sent - st0.sent;
+  unsigned long nfcQueries = Adafruit_PN532::firmwareQueries() - nfcQueries0;
+  unsigned long versionReads =
+      host_fake_cc1101(0).statusReads() + host_fake_cc1101(1).statusReads() - versionReads0;
+  // nothing of the JSON batch path is allocated before a subscriber
+  PsramRegionStats radioIdle;
+  psram_region_stats(PSRAM_REGION_RADIO_BATCH, radioIdle);
+  // radio.batch.policy on the (otherwise quiet) NFC module
+  telemetry_subscribe(&jsonBatchSub);
+  jsonBatchOn = true;
+  EventsRadioFlushStats rf0, rf;
+  events_radio_flush_stats(rf0);
+  size_t maxSignals, maxText;
+  host_ble_client_write(pCmdChar,
+      "{\"command\":\"radio.batch.policy\",\"params\":{\"module\":3,\"max_events\":100,\"idle_ms\":0,\"max_age_ms\":300}}");
+  runFor(50);
+  auto aged = feedBatches(10, 100, 400);  // a signal every 100 ms: out every 300 ms by age
+  size_t agedSignals = batchSignals(aged, &maxSignals, &maxText);
+  bool ageOk = agedSignals == 10 && aged.size() >= 3 && maxSignals <= 4;
+  host_ble_client_write(pCmdChar, "{\"command\":\"radio.batch.policy\",\"params\":{\"module\":3,\"preset\":\"bulk\"}}");
+  runFor(50);
+  auto bulk = feedBatches(20, 0, 1200);  // a burst: one batch after the idle deadline
+  bool idleOk = bulk.size() == 1 && bulk[0].first == 20;
+  host_ble_client_write(pCmdChar,
+      "{\"command\":\"radio.batch.policy\",\"params\":{\"module\":3,\"preset\":\"default\",\"frame_bytes\":300}}");
+  runFor(50);
+  auto framed = feedBatches(10, 0, 600);
+  size_t framedSignals = batchSignals(framed, &maxSignals, &maxText);
+  bool frameOk = framedSignals == 10 && framed.size() >= 3 && maxText <= 300;
+  host_ble_client_write(pCmdChar, "{\"command\":\"radio.batch.policy\",\"params\":{\"preset\":\"default\"}}");
+  runFor(50);
+  jsonBatchOn = false;
+  events_radio_flush_stats(rf);
+  bool batchOk = ageOk && idleOk && frameOk && rf.age - rf0.age >= 3 && rf.idle - rf0.idle == 2 &&
+                 rf.frame - rf0.frame >= 2 && rf.offloaded - rf0.offloaded == rf.batches - rf0.batches;
+  // the same batches to the BLE client once it asks for them (compressed
+  // by now), and none after it stops
+  host_ble_client_write(pCmdChar, "{\"command\":\"radio.batch.policy\",\"params\":{\"json\":true}}");
+  runFor(50);
+  bool bleJsonOn = telemetry_format_active(TELEMETRY_FORMAT_JSON_BATCH);
+  feedBatches(20, 0, 1200);
+  host_ble_client_write(pCmdChar, "{\"command\":\"radio.batch.policy\",\"params\":{\"json\":false}}");
+  runFor(50);
+  batchOk = batchOk && bleJsonOn && !telemetry_format_active(TELEMETRY_FORMAT_JSON_BATCH) && bleBatches == 1 &&
+            bleBatchSignals == 20;
+
+  // PSRAM regions: the NFC batch buffers went to (simulated) PSRAM; with
+  // PSRAM full, BLE scan results fall back to internal RAM and are counted
+  PsramRegionStats radioMem, bleMem, bleFull, bleFreed;
+  psram_region_stats(PSRAM_REGION_RADIO_BATCH, radioMem);
+  psram_region_stats(PSRAM_REGION_BLE_DEVICES, bleMem);
+  host_psram_set_size(8u * 1024 * 1024 - psram_free_bytes());
+  for (int i = 0; i < 40; ++i) blescanner_devices.push_back(blescanner_Device());
+  psram_region_stats(PSRAM_REGION_BLE_DEVICES, bleFull);
+  blescanner_devices.clear();
+  blescanner_devices.shrink_to_fit();
+  psram_region_stats(PSRAM_REGION_BLE_DEVICES, bleFreed);
+  host_psram_set_size(8u * 1024 * 1024);
+  host_ble_client_write(pCmdChar, "{\"command\":\"mem.stats\",\"id\":\"m1\"}");
+  runFor(50);
+  // a full batch whose replies outgrow one aggregate: every item is still
+  // answered, the overflow on its own
+  host_ble_client_write(pCmdChar,
+      "{\"batch\":[{\"command\":\"mem.stats\",\"id\":\"bi0\"},{\"command\":\"radio.batch.policy\",\"id\":\"bi1\"},"
+      "{\"command\":\"status.info\",\"id\":\"bi2\"},{\"command\":\"mem.stats\",\"id\":\"bi3\"},"
+      "{\"command\":\"radio.batch.policy\",\"id\":\"bi4\"},{\"command\":\"battery.info\",\"id\":\"bi5\"},"
+      "{\"command\":\"mem.stats\",\"id\":\"bi6\"},{\"command\":\"radio.batch.policy\",\"id\":\"bi7\"}],\"id\":\"bt1\"}");
+  runFor(50);
+  bool batchReplyOk = batchItemsAnswered == 0xff && batchAggregates == 1 && batchSingles > 0;
+  // background jobs: independent resources run in the same pass, a second
+  // FSPI job waits for the next one, a job whose bus worker is busy retries
+  // every EVENTS_JOB_BUS_RETRY_MS (10), and stopping one kind stops only that
+  EventsJobStats nrfJob, scopeJob, subJob;
+  host_ble_client_write(pCmdChar, "{\"batch\":[{\"command\":\"nrf.scan.start\"},{\"command\":\"oscilloscope.start\"}]}");
+  runFor(50);
+  events_job_stats(SCAN_NRF, nrfJob);
+  events_job_stats(SCAN_OSCILLOSCOPE, scopeJob);
+  bool jobsOk = nrfJob.runs == 1 && scopeJob.runs == 1 && nrfJob.firstTick == scopeJob.firstTick;
+  host_ble_client_write(pCmdChar, "oscilloscope.stop");
+  runFor(450);
+  events_job_stats(SCAN_NRF, nrfJob);
+  events_job_stats(SCAN_OSCILLOSCOPE, scopeJob);
+  jobsOk = jobsOk && nrfJob.active && nrfJob.runs >= 3 && !scopeJob.active;
+  unsigned long noActiveScan0 = noActiveScanReplies;
+  host_ble_client_write(pCmdChar, "oscilloscope.stop");  // no longer running
+  host_ble_client_write(pCmdChar,
+      "{\"batch\":[{\"command\":\"nrf.scan.start\"},{\"command\":\"subghz.read.start\",\"params\":"
+      "{\"bottom_frequency_mhz\":433.0,\"top_frequency_mhz\":433.5}}]}");
+  runFor(50);
+  events_job_stats(SCAN_NRF, nrfJob);
+  events_job_stats(SCAN_SUBGHZ, subJob);
+  jobsOk = jobsOk && noActiveScanReplies == noActiveScan0 + 1 && nrfJob.deferred + subJob.deferred >= 1 &&
+           nrfJob.runs > 0 && subJob.runs > 0 && nrfJob.firstTick != subJob.firstTick;
+  host_ble_client_write(pCmdChar, "subghz.read.stop");
+  runFor(50);
+  bus_worker_wait_idle(SPI_BUS_FSPI);
+  // hold the FSPI worker; it sleeps rather than spins so the loop's virtual
+  // clock can move on
+  static std::atomic<bool> busHeld{true};
+  events_job_stats(SCAN_NRF, nrfJob);
+  bus_worker_submit(SPI_BUS_FSPI, [](void *) { while (busHeld.load()) vTaskDelay(1); }, nullptr);
+  runFor(100);
+  EventsJobStats nrfHeld;
+  events_job_stats(SCAN_NRF, nrfHeld);
+  busHeld = false;
+  bus_worker_wait_idle(SPI_BUS_FSPI);
+  runFor(250);
+  EventsJobStats nrfFreed;
+  events_job_stats(SCAN_NRF, nrfFreed);
+  unsigned long busRetries = nrfHeld.busRetries - nrfJob.busRetries;
+  jobsOk = jobsOk && busRetries >= 8 && busRetries <= 11 && nrfHeld.runs == nrfJob.runs &&
+           nrfFreed.runs > nrfHeld.runs && nrfFreed.busRetries == nrfHeld.busRetries;
+  host_ble_client_write(pCmdChar, "nrf.scan.stop");
+  runFor(50);
+
+  const uint32_t nfcBatchBytes = 2 * (64 * sizeof(RadioBatchEntry) + 1024);  // two halves
+  bool memOk = radioIdle.allocs == 0 && radioMem.psramBytes >= nfcBatchBytes && radioMem.internalBytes == 0 && radioMem.fallbacks == 0 &&
+               bleFull.internalBytes > 0 && bleFull.fallbacks > bleMem.fallbacks &&
+               bleFreed.psramBytes + bleFreed.internalBytes == 0 && memStatsReplied;
+
+  bool statusOk = st.ticks - st0.ticks >= 150 && statusProbes >= 4 && statusProbes <= 6 &&
+                  nfcQueries == statusProbes && versionReads <= 2 * statusProbes && statusSent == 3 &&
+                  st.heartbeats - st0.heartbeats == 1;
+  ble_link_flush();
+  auto t1 = std::chrono::steady_clock::now();
+
+  printf("host smoke: JSON library: %s\n", HOST_JSON_LIBRARY);
+  printf("host smoke: paired=%s notifies=%lu bytes=%lu\n", paired ? "yes" : "no", statusNotifies, statusBytes);
+  printf("host smoke: cc1101#1 regWrites=%lu statusReads=%lu  cc1101#2 regWrites=%lu statusReads=%lu\n",
+         host_fake_cc1101(0).registerWrites(), host_fake_cc1101(0).statusReads(),
+         host_fake_cc1101(1).registerWrites(), host_fake_cc1101(1).statusReads());
+  EventsLatencyStats lat;
+  events_command_latency(lat);
+  printf("host smoke: command-to-ack latency n=%u avg=%.1f us max=%u us\n", (unsigned)lat.count,
+         lat.count ? (double)lat.totalUs / lat.count : 0.0, (unsigned)lat.maxUs);
+  EventsQueueStats q;
+  events_queue_stats(q);
+  printf("host smoke: queue control hwm=%u normal hwm=%u dropped=%u credit limit=%u scanning=%s preempt=%s\n",
+         (unsigned)q.control.highWater, (unsigned)q.normal.highWater, (unsigned)(q.control.dropped + q.normal.dropped),
+         (unsigned)q.creditLimit, scanningRadio ? "yes" : "no", preemptOk ? "ok" : "mismatch");
+  BleLinkStats link;
+  ble_link_stats(link);
+  printf("host smoke: ble link mtu=%u messages=%u notifies=%u fragmented=%u coalesced=%u payload=%u wire=%u\n",
+         (unsigned)ble_link_mtu(), (unsigned)link.messages, (unsigned)link.notifies, (unsigned)link.fragmented,
+         (unsigned)link.coalesced, (unsigned)link.payloadBytes, (unsigned)link.wireBytes);
+  printf("host smoke: reassembled messages=%lu gaps=%lu dropped=%lu malformed=%lu long=%s\n", reassembler.messages(),
+         reassembler.gaps(), reassembler.dropped(), reassembler.malformed(), longMessagesSeen == 2 ? "ok" : "missing");
+  printf("host smoke: ble lz messages=%u/%lu in=%u out=%u (%.0f%%) %.1f us/KB dropped=%lu invalid=%lu\n",
+         (unsigned)link.lzMessages, inflater.messages(), (unsigned)link.lzInBytes, (unsigned)link.lzOutBytes,
+         link.lzInBytes ? 100.0 * link.lzOutBytes / link.lzInBytes : 0.0,
+         link.lzInBytes ? link.lzMicros * 1024.0 / link.lzInBytes : 0.0, inflater.dropped(), inflater.invalid());
+  SerialLinkStats serial;
+  serial_link_stats(serial);
+  printf("host smoke: serial binary telemetry=%u/%lu log=%u/%lu wire=%u crc errors=%lu malformed=%lu\n",
+         (unsigned)serial.telemetryFrames, serialTelemetryFrames, (unsigned)serial.logFrames, serialLogLines,
+         (unsigned)serial.wireBytes, serialDecoder.crcErrors(), serialDecoder.malformed());
+  printf("host smoke: protobuf subghz.packet.send tx=%lu acked=%s %s\n", host_fake_cc1101(0).txPackets(),
+         packetSendAcked ? "yes" : "no", packetOk ? "ok" : "mismatch");
+  printf("host smoke: status reporting ticks=%u probes=%lu (i2c=%lu spi=%lu) sent=%lu heartbeats=%u %s\n",
+         (unsigned)(st.ticks - st0.ticks), statusProbes, nfcQueries, versionReads, statusSent,
+         (unsigned)(st.heartbeats - st0.heartbeats), statusOk ? "ok" : "mismatch");
+  printf("host smoke: radio batches age=%zu/%zu idle=%zu/%zu frame=%zu/%zu max text=%zu offloaded=%u stalls=%u "
+         "ble=%lu/%lu %s\n",
+         aged.size(), agedSignals, bulk.size(), bulk.empty() ? 0 : bulk[0].first, framed.size(), framedSignals, maxText,
+         (unsigned)(rf.offloaded - rf0.offloaded), (unsigned)(rf.stalls - rf0.stalls), bleBatches, bleBatchSignals,
+         batchOk ? "ok" : "mismatch");
+  printf("host smoke: psram regions radio_batch psram=%u internal=%u, ble_devices (psram full) psram=%u internal=%u "
+         "fallbacks=%u mem.stats=%s %s\n",
+         (unsigned)radioMem.psramBytes, (unsigned)radioMem.internalBytes, (unsigned)bleFull.psramBytes,
+         (unsigned)bleFull.internalBytes, (unsigned)bleFull.fallbacks, memStatsReplied ? "yes" : "no",
+         memOk ? "ok" : "mismatch");
+  printf("host smoke: batch of 8 answered=%d aggregate=%lu on their own=%lu %s\n",
+         __builtin_popcount(batchItemsAnswered), batchAggregates, batchSingles, batchReplyOk ? "ok" : "mismatch");
+  printf("host smoke: background jobs bus retries=%lu in 100 ms, nrf runs=%u after release %s\n", busRetries,
+         (unsigned)(nrfFreed.runs - nrfHeld.runs), jobsOk ? "ok" : "mismatch");
+  printf("host smoke: spi bytes fspi=%lu hspi=%lu wall=%.2f ms\n", SPI.bytesTransferred(),
+         cc1101_spi2.bytesTransferred(),
+         std::chrono::duration<double, std::milli>(t1 - t0).count());
+  bool linkOk = longMessagesSeen == 2 && reassembler.messages() == link.messages && reassembler.gaps() == 0 &&
+                reassembler.malformed() == 0 && link.lzMessages > 0 && inflater.messages() == link.lzMessages &&
+                inflater.invalid() == 0;
+  bool serialOk = serial.telemetryFrames > 0 && serialTelemetryFrames == serial.telemetryFrames &&
+                  serialLogLines == serial.logFrames && serialDecoder.crcErrors() == 0 && serialDecoder.malformed() == 0;
+  if (serialCapture) fclose(serialCapture);
+  return (paired && statusNotifies > 0 && linkOk && serialOk && packetOk && statusOk && batchOk && memOk && preemptOk &&
+          batchReplyOk && jobsOk)
+             ? 0
+             : 1;
+}
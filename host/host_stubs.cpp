@@ -0,0 +1,13 @@
+// Host stand-ins for sketch files that are not part of the host build
+// (UI-only or scanner modules that need hardware the shims do not model).
+
+#include "globals.h"
+
+DummyU8g2 u8g2;
+
+void blescanner_scan() {
+  Serial.println("blescanner_scan: DISABLED (host build)");
+}
+
+void nrfscanner() {}
+void scanAll() {}
@@ -0,0 +1,255 @@
+#include "ArduinoJson.h"
+
+namespace ArduinoJsonHost {
+
+namespace {
+
+class Parser {
+public:
+  Parser(const char *p, const char *end, Pool *pool) : p_(p), end_(end), pool_(pool) {}
+
+  DeserializationError parseRoot(Node *root) {
+    skipSpace();
+    if (p_ >= end_) return DeserializationError::EmptyInput;
+    return parseValue(root, ARDUINOJSON_DEFAULT_NESTING_LIMIT);
+  }
+
+private:
+  void skipSpace() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\n')) ++p_;
+  }
+
+  DeserializationError parseValue(Node *n, int depth) {
+    skipSpace();
+    if (p_ >= end_) return DeserializationError::IncompleteInput;
+    char c = *p_;
+    if (c == '{') return depth > 0 ? parseObject(n, depth - 1) : DeserializationError::TooDeep;
+    if (c == '[') return depth > 0 ? parseArray(n, depth - 1) : DeserializationError::TooDeep;
+    if (c == '"' || c == '\'') {
+      const char *s = nullptr;
+      DeserializationError e = parseString(&s);
+      if (e) return e;
+      n->type = NODE_STRING;
+      n->s = s;
+      return DeserializationError::Ok;
+    }
+    return parseLiteral(n);
+  }
+
+  DeserializationError parseObject(Node *n, int depth) {
+    ++p_;  // '{'
+    makeCollection(n, NODE_OBJECT);
+    skipSpace();
+    if (p_ < end_ && *p_ == '}') { ++p_; return DeserializationError::Ok; }
+    for (;;) {
+      skipSpace();
+      if (p_ >= end_) return DeserializationError::IncompleteInput;
+      if (*p_ != '"' && *p_ != '\'') return DeserializationError::InvalidInput;
+      const char *key = nullptr;
+      DeserializationError e = parseString(&key);
+      if (e) return e;
+      skipSpace();
+      if (p_ >= end_) return DeserializationError::IncompleteInput;
+      if (*p_ != ':') return DeserializationError::InvalidInput;
+      ++p_;
+      Slot *s = pool_->newSlot();
+      if (!s) return DeserializationError::NoMemory;
+      s->next = nullptr;
+      s->key = key;
+      if (n->c.tail) n->c.tail->next = s;
+      else n->c.head = s;
+      n->c.tail = s;
+      n->c.size++;
+      e = parseValue(&s->value, depth);
+      if (e) return e;
+      skipSpace();
+      if (p_ >= end_) return DeserializationError::IncompleteInput;
+      if (*p_ == ',') { ++p_; continue; }
+      if (*p_ == '}') { ++p_; return DeserializationError::Ok; }
+      return DeserializationError::InvalidInput;
+    }
+  }
+
+  DeserializationError parseArray(Node *n, int depth) {
+    ++p_;  // '['
+    makeCollection(n, NODE_ARRAY);
+    skipSpace();
+    if (p_ < end_ && *p_ == ']') { ++p_; return DeserializationError::Ok; }
+    for (;;) {
+      Slot *s = appendSlot(n, pool_, nullptr);
+      if (!s) return DeserializationError::NoMemory;
+      DeserializationError e = parseValue(&s->value, depth);
+      if (e) return e;
+      skipSpace();
+      if (p_ >= end_) return DeserializationError::IncompleteInput;
+      if (*p_ == ',') { ++p_; continue; }
+      if (*p_ == ']') { ++p_; return DeserializationError::Ok; }
+      return DeserializationError::InvalidInput;
+    }
+  }
+
+  static int hexVal(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  DeserializationError parseString(const char **out) {
+    char quote = *p_++;
+    // Worst case the decoded string is as long as the remaining input.
+    const char *scan = p_;
+    size_t maxLen = 0;
+    while (scan < end_ && *scan != quote) {
+      if (*scan == '\\') ++scan;
+      ++scan;
+      ++maxLen;
+    }
+    if (scan >= end_) return DeserializationError::IncompleteInput;
+    char *buf = (char *)pool_->alloc(maxLen * 3 + 1, 0);  // charged once decoded
+    if (!buf) return DeserializationError::NoMemory;
+    char *w = buf;
+    while (p_ < end_ && *p_ != quote) {
+      char c = *p_++;
+      if (c != '\\') { *w++ = c; continue; }
+      if (p_ >= end_) return DeserializationError::IncompleteInput;
+      char e = *p_++;
+      switch (e) {
+        case 'n': *w++ = '\n'; break;
+        case 'r': *w++ = '\r'; break;
+        case 't': *w++ = '\t'; break;
+        case 'b': *w++ = '\b'; break;
+        case 'f': *w++ = '\f'; break;
+        case 'u': {
+          if (end_ - p_ < 4) return DeserializationError::IncompleteInput;
+          unsigned cp = 0;
+          for (int i = 0; i < 4; ++i) {
+            int h = hexVal(p_[i]);
+            if (h < 0) return DeserializationError::InvalidInput;
+            cp = (cp << 4) | (unsigned)h;
+          }
+          p_ += 4;
+          if (cp < 0x80) {
+            *w++ = (char)cp;
+          } else if (cp < 0x800) {
+            *w++ = (char)(0xC0 | (cp >> 6));
+            *w++ = (char)(0x80 | (cp & 0x3F));
+          } else {
+            *w++ = (char)(0xE0 | (cp >> 12));
+            *w++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+            *w++ = (char)(0x80 | (cp & 0x3F));
+          }
+          break;
+        }
+        default: *w++ = e; break;
+      }
+    }
+    if (p_ >= end_) return DeserializationError::IncompleteInput;
+    ++p_;  // closing quote
+    *w = 0;
+    if (!pool_->charge((size_t)(w - buf) + 1)) return DeserializationError::NoMemory;
+    *out = buf;
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError parseLiteral(Node *n) {
+    const char *start = p_;
+    while (p_ < end_ && (isalnum((unsigned char)*p_) || *p_ == '.' || *p_ == '+' || *p_ == '-')) ++p_;
+    size_t len = (size_t)(p_ - start);
+    if (len == 0) return DeserializationError::InvalidInput;
+    if (len == 4 && strncmp(start, "true", 4) == 0) { n->type = NODE_BOOL; n->b = true; return DeserializationError::Ok; }
+    if (len == 5 && strncmp(start, "false", 5) == 0) { n->type = NODE_BOOL; n->b = false; return DeserializationError::Ok; }
+    if (len == 4 && strncmp(start, "null", 4) == 0) { n->type = NODE_NULL; return DeserializationError::Ok; }
+
+    char tmp[64];
+    if (len >= sizeof(tmp)) return DeserializationError::InvalidInput;
+    memcpy(tmp, start, len);
+    tmp[len] = 0;
+    char *endp = nullptr;
+    bool isFloat = strpbrk(tmp, ".eE") != nullptr;
+    if (!isFloat) {
+      long long v = strtoll(tmp, &endp, 10);
+      if (endp && *endp == 0) { n->type = NODE_INT; n->i = v; return DeserializationError::Ok; }
+    }
+    double d = strtod(tmp, &endp);
+    if (endp && *endp == 0) { n->type = NODE_FLOAT; n->f = d; return DeserializationError::Ok; }
+    return DeserializationError::InvalidInput;
+  }
+
+  const char *p_;
+  const char *end_;
+  Pool *pool_;
+};
+
+void writeEscaped(const char *s, String &out) {
+  out += '"';
+  for (; *s; ++s) {
+    char c = *s;
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      case '\b': out += "\\b"; break;
+      case '\f': out += "\\f"; break;
+      default: out += c; break;
+    }
+  }
+  out += '"';
+}
+
+void writeNode(const Node *n, String &out) {
+  if (!n) { out += "null"; return; }
+  switch (n->type) {
+    case NODE_NULL: out += "null"; break;
+    case NODE_BOOL: out += n->b ? "true" : "false"; break;
+    case NODE_INT: out += String(n->i); break;
+    case NODE_FLOAT: {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%.9g", n->f);
+      out += buf;
+      break;
+    }
+    case NODE_STRING: writeEscaped(n->s, out); break;
+    case NODE_OBJECT: {
+      out += '{';
+      for (Slot *s = n->c.head; s; s = s->next) {
+        if (s != n->c.head) out += ',';
+        writeEscaped(s->key ? s->key : "", out);
+        out += ':';
+        writeNode(&s->value, out);
+      }
+      out += '}';
+      break;
+    }
+    case NODE_ARRAY: {
+      out += '[';
+      for (Slot *s = n->c.head; s; s = s->next) {
+        if (s != n->c.head) out += ',';
+        writeNode(&s->value, out);
+      }
+      out += ']';
+      break;
+    }
+  }
+}
+
+}  // namespace
+
+size_t serializeNode(const Node *n, String &out) {
+  unsigned int before = out.length();
+  writeNode(n, out);
+  return out.length() - before;
+}
+
+}  // namespace ArduinoJsonHost
+
+DeserializationError deserializeJson(JsonDocument &doc, const char *input, size_t len) {
+  doc.clear();
+  if (!input) return DeserializationError::EmptyInput;
+  ArduinoJsonHost::Parser parser(input, input + len, doc.getPool());
+  DeserializationError err = parser.parseRoot(doc.getNode());
+  if (err) doc.clear();
+  return err;
+}
@@ -0,0 +1,612 @@
+#pragma once
+
+// Offline stand-in for ArduinoJson 6, used only when the host build cannot
+// find the real library that `make deps` installs (see Makefile); the build
+// then says so, and so do the smoke test and the benchmarks. It is not ArduinoJson: it covers the
+// subset the firmware calls, and its parse times and heap counts do not
+// describe the device. Do not tune against numbers measured with it.
+//
+// Like the real library, a JsonDocument owns one fixed memory pool allocated
+// up front (DynamicJsonDocument(capacity) is a single heap allocation) and all
+// nodes and strings are carved out of it. Nodes are wider on a 64-bit host,
+// so the buffer is ARDUINOJSON_HOST_POOL_SCALE times the capacity, but what
+// fills it is counted in the device's bytes: ARDUINOJSON_HOST_SLOT_BYTES per
+// member or element and n + 1 per copied string, with const char * values
+// and keys linked rather than copied. A document therefore overflows, and
+// memoryUsage() reads, as it would on the ESP32.
+//
+// Behaviour follows ArduinoJson 6 where the firmware depends on it:
+// deserializeJson() rejects plain (non-JSON) text with InvalidInput, ignores
+// trailing characters after the root value, and missing members read as null.
+
+#include <Arduino.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#ifndef ARDUINOJSON_HOST_POOL_SCALE
+#define ARDUINOJSON_HOST_POOL_SCALE 4
+#endif
+// sizeof(VariantSlot) in ArduinoJson 6 on a 32-bit target
+#ifndef ARDUINOJSON_HOST_SLOT_BYTES
+#define ARDUINOJSON_HOST_SLOT_BYTES 16
+#endif
+#ifndef ARDUINOJSON_DEFAULT_NESTING_LIMIT
+#define ARDUINOJSON_DEFAULT_NESTING_LIMIT 10
+#endif
+
+namespace ArduinoJsonHost {
+
+enum NodeType : uint8_t { NODE_NULL, NODE_BOOL, NODE_INT, NODE_FLOAT, NODE_STRING, NODE_OBJECT, NODE_ARRAY };
+
+struct Slot;
+
+struct Node {
+  NodeType type = NODE_NULL;
+  union {
+    bool b;
+    long long i;
+    double f;
+    const char *s;
+    struct {
+      Slot *head;
+      Slot *tail;
+      size_t size;
+    } c;
+  };
+  Node() : i(0) { c.head = c.tail = nullptr; c.size = 0; }
+};
+
+struct Slot {
+  Slot *next;
+  const char *key;  // null for array elements
+  Node value;
+};
+
+// `deviceCap` is the document's capacity as the firmware asked for it; the
+// host buffer behind it is larger (see above).
+class Pool {
+public:
+  Pool() {}
+  void reset(char *buf, size_t cap, size_t deviceCap) {
+    buf_ = buf;
+    cap_ = cap;
+    deviceCap_ = deviceCap;
+    clear();
+  }
+  void clear() { used_ = deviceUsed_ = 0; overflowed_ = false; }
+  // `n` host bytes, of which `device` count against the device capacity
+  void *alloc(size_t n, size_t device) {
+    size_t start = (used_ + 7) & ~(size_t)7;
+    if (!buf_ || start + n > cap_ || !charge(device)) { overflowed_ = true; return nullptr; }
+    used_ = start + n;
+    return buf_ + start;
+  }
+  bool charge(size_t device) {
+    if (deviceUsed_ + device > deviceCap_) { overflowed_ = true; return false; }
+    deviceUsed_ += device;
+    return true;
+  }
+  const char *dup(const char *s, size_t n, bool linked) {
+    char *p = (char *)alloc(n + 1, linked ? 0 : n + 1);
+    if (!p) return nullptr;
+    memcpy(p, s, n);
+    p[n] = 0;
+    return p;
+  }
+  Slot *newSlot() {
+    void *p = alloc(sizeof(Slot), ARDUINOJSON_HOST_SLOT_BYTES);
+    return p ? new (p) Slot() : nullptr;
+  }
+  size_t used() const { return deviceUsed_; }
+  size_t capacity() const { return deviceCap_; }
+  bool overflowed() const { return overflowed_; }
+private:
+  char *buf_ = nullptr;
+  size_t cap_ = 0;
+  size_t used_ = 0;
+  size_t deviceCap_ = 0;
+  size_t deviceUsed_ = 0;
+  bool overflowed_ = false;
+};
+
+inline Slot *findMember(const Node *n, const char *key) {
+  if (!n || n->type != NODE_OBJECT || !key) return nullptr;
+  for (Slot *s = n->c.head; s; s = s->next) {
+    if (s->key && strcmp(s->key, key) == 0) return s;
+  }
+  return nullptr;
+}
+
+inline Slot *appendSlot(Node *n, Pool *pool, const char *key) {
+  Slot *s = pool->newSlot();
+  if (!s) return nullptr;
+  s->next = nullptr;
+  s->key = nullptr;
+  if (key) {
+    s->key = pool->dup(key, strlen(key), true);
+    if (!s->key) return nullptr;
+  }
+  if (n->c.tail) n->c.tail->next = s;
+  else n->c.head = s;
+  n->c.tail = s;
+  n->c.size++;
+  return s;
+}
+
+inline Node *getOrAddMember(Node *n, Pool *pool, const char *key) {
+  if (!n || !pool) return nullptr;
+  if (n->type == NODE_NULL) {
+    n->type = NODE_OBJECT;
+    n->c.head = n->c.tail = nullptr;
+    n->c.size = 0;
+  }
+  if (n->type != NODE_OBJECT) return nullptr;
+  Slot *s = findMember(n, key);
+  if (!s) s = appendSlot(n, pool, key);
+  return s ? &s->value : nullptr;
+}
+
+inline void makeCollection(Node *n, NodeType t) {
+  n->type = t;
+  n->c.head = n->c.tail = nullptr;
+  n->c.size = 0;
+}
+
+// --- reading ---
+
+template <typename T, typename Enable = void> struct Converter;
+
+template <typename T>
+struct Converter<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+  static T read(const Node *n) {
+    if (!n) return 0;
+    if (n->type == NODE_INT) return (T)n->i;
+    if (n->type == NODE_FLOAT) return (T)n->f;
+    if (n->type == NODE_BOOL) return (T)(n->b ? 1 : 0);
+    return 0;
+  }
+  static bool is(const Node *n) { return n && n->type == NODE_INT; }
+  static void write(Node *n, Pool *, T v) { n->type = NODE_INT; n->i = (long long)v; }
+};
+
+template <typename T> struct Converter<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  static T read(const Node *n) {
+    if (!n) return 0;
+    if (n->type == NODE_FLOAT) return (T)n->f;
+    if (n->type == NODE_INT) return (T)n->i;
+    return 0;
+  }
+  static bool is(const Node *n) { return n && (n->type == NODE_FLOAT || n->type == NODE_INT); }
+  static void write(Node *n, Pool *, T v) { n->type = NODE_FLOAT; n->f = (double)v; }
+};
+
+template <> struct Converter<bool> {
+  static bool read(const Node *n) {
+    if (!n) return false;
+    if (n->type == NODE_BOOL) return n->b;
+    if (n->type == NODE_INT) return n->i != 0;
+    return false;
+  }
+  static bool is(const Node *n) { return n && n->type == NODE_BOOL; }
+  static void write(Node *n, Pool *, bool v) { n->type = NODE_BOOL; n->b = v; }
+};
+
+template <> struct Converter<const char *> {
+  static const char *read(const Node *n) { return (n && n->type == NODE_STRING) ? n->s : nullptr; }
+  static bool is(const Node *n) { return n && n->type == NODE_STRING; }
+  static void write(Node *n, Pool *pool, const char *v, bool linked = true) {
+    if (!v) { n->type = NODE_NULL; return; }
+    const char *s = pool->dup(v, strlen(v), linked);
+    if (!s) { n->type = NODE_NULL; return; }
+    n->type = NODE_STRING;
+    n->s = s;
+  }
+};
+
+template <> struct Converter<char *> {
+  static void write(Node *n, Pool *pool, char *v) { Converter<const char *>::write(n, pool, v, false); }
+};
+
+size_t serializeNode(const Node *n, String &out);
+
+template <> struct Converter<String> {
+  static String read(const Node *n) {
+    if (!n || n->type == NODE_NULL) return String();
+    if (n->type == NODE_STRING) return String(n->s);
+    String out;
+    serializeNode(n, out);
+    return out;
+  }
+  static bool is(const Node *n) { return n && n->type == NODE_STRING; }
+  static void write(Node *n, Pool *pool, const String &v) { Converter<const char *>::write(n, pool, v.c_str(), false); }
+};
+
+}  // namespace ArduinoJsonHost
+
+class JsonObject;
+class JsonArray;
+class JsonVariant;
+
+class JsonString {
+public:
+  explicit JsonString(const char *s) : s_(s) {}
+  const char *c_str() const { return s_; }
+private:
+  const char *s_;
+};
+
+// Base for everything that resolves to a node: JsonVariant, proxies, docs.
+template <typename TDerived> class JsonRefBase {
+public:
+  template <typename T> T as() const;
+  template <typename T> bool is() const;
+  template <typename T> operator T() const { return as<T>(); }
+  bool isNull() const {
+    const ArduinoJsonHost::Node *n = self().getNode();
+    return !n || n->type == ArduinoJsonHost::NODE_NULL;
+  }
+  bool containsKey(const char *key) const { return ArduinoJsonHost::findMember(self().getNode(), key) != nullptr; }
+  bool containsKey(const String &key) const { return containsKey(key.c_str()); }
+  size_t size() const {
+    const ArduinoJsonHost::Node *n = self().getNode();
+    if (!n) return 0;
+    if (n->type == ArduinoJsonHost::NODE_OBJECT || n->type == ArduinoJsonHost::NODE_ARRAY) return n->c.size;
+    return 0;
+  }
+  JsonArray createNestedArray(const char *key) const;
+  JsonObject createNestedObject(const char *key) const;
+
+private:
+  const TDerived &self() const { return static_cast<const TDerived &>(*this); }
+};
+
+template <typename TParent> class MemberProxy;
+
+class JsonVariant : public JsonRefBase<JsonVariant> {
+public:
+  JsonVariant() {}
+  JsonVariant(ArduinoJsonHost::Node *n, ArduinoJsonHost::Pool *p) : node_(n), pool_(p) {}
+
+  ArduinoJsonHost::Node *getNode() const { return node_; }
+  ArduinoJsonHost::Node *getOrCreateNode() const { return node_; }
+  ArduinoJsonHost::Pool *getPool() const { return pool_; }
+
+  template <typename T> JsonVariant &operator=(const T &v) { set(v); return *this; }
+  JsonVariant &operator=(const char *v) { set(v); return *this; }
+  template <typename T> bool set(const T &v);
+  bool set(const char *v);
+
+  MemberProxy<JsonVariant> operator[](const char *key) const;
+  MemberProxy<JsonVariant> operator[](const String &key) const;
+
+private:
+  ArduinoJsonHost::Node *node_ = nullptr;
+  ArduinoJsonHost::Pool *pool_ = nullptr;
+};
+
+class JsonPair {
+public:
+  JsonPair() {}
+  JsonPair(ArduinoJsonHost::Slot *s, ArduinoJsonHost::Pool *p) : key_(s ? s->key : nullptr), value_(s ? &s->value : nullptr, p) {}
+  JsonString key() const { return JsonString(key_); }
+  JsonVariant value() const { return value_; }
+private:
+  const char *key_ = nullptr;
+  JsonVariant value_;
+};
+
+class JsonObjectIterator {
+public:
+  JsonObjectIterator(ArduinoJsonHost::Slot *s, ArduinoJsonHost::Pool *p) : slot_(s), pool_(p), pair_(s, p) {}
+  const JsonPair &operator*() const { return pair_; }
+  const JsonPair *operator->() const { return &pair_; }
+  JsonObjectIterator &operator++() {
+    slot_ = slot_ ? slot_->next : nullptr;
+    pair_ = JsonPair(slot_, pool_);
+    return *this;
+  }
+  bool operator==(const JsonObjectIterator &o) const { return slot_ == o.slot_; }
+  bool operator!=(const JsonObjectIterator &o) const { return slot_ != o.slot_; }
+private:
+  ArduinoJsonHost::Slot *slot_;
+  ArduinoJsonHost::Pool *pool_;
+  JsonPair pair_;
+};
+
+class JsonObject : public JsonRefBase<JsonObject> {
+public:
+  JsonObject() {}
+  JsonObject(ArduinoJsonHost::Node *n, ArduinoJsonHost::Pool *p)
+      : node_((n && n->type == ArduinoJsonHost::NODE_OBJECT) ? n : nullptr), pool_(p) {}
+  ArduinoJsonHost::Node *getNode() const { return node_; }
+  ArduinoJsonHost::Node *getOrCreateNode() const { return node_; }
+  ArduinoJsonHost::Pool *getPool() const { return pool_; }
+  MemberProxy<JsonVariant> operator[](const char *key) const;
+  MemberProxy<JsonVariant> operator[](const String &key) const;
+  JsonObjectIterator begin() const { return JsonObjectIterator(node_ ? node_->c.head : nullptr, pool_); }
+  JsonObjectIterator end() const { return JsonObjectIterator(nullptr, pool_); }
+  operator JsonVariant() const { return JsonVariant(node_, pool_); }
+private:
+  ArduinoJsonHost::Node *node_ = nullptr;
+  ArduinoJsonHost::Pool *pool_ = nullptr;
+};
+
+class JsonArray : public JsonRefBase<JsonArray> {
+public:
+  JsonArray() {}
+  JsonArray(ArduinoJsonHost::Node *n, ArduinoJsonHost::Pool *p)
+      : node_((n && n->type == ArduinoJsonHost::NODE_ARRAY) ? n : nullptr), pool_(p) {}
+  ArduinoJsonHost::Node *getNode() const { return node_; }
+  ArduinoJsonHost::Node *getOrCreateNode() const { return node_; }
+  ArduinoJsonHost::Pool *getPool() const { return pool_; }
+
+  JsonVariant addElement() const {
+    if (!node_ || !pool_) return JsonVariant();
+    ArduinoJsonHost::Slot *s = ArduinoJsonHost::appendSlot(node_, pool_, nullptr);
+    return s ? JsonVariant(&s->value, pool_) : JsonVariant();
+  }
+  template <typename T> bool add(const T &v) const {
+    JsonVariant e = addElement();
+    return e.getNode() ? e.set(v) : false;
+  }
+  bool add(const char *v) const {
+    JsonVariant e = addElement();
+    return e.getNode() ? e.set(v) : false;
+  }
+  JsonObject createNestedObject() const {
+    JsonVariant e = addElement();
+    if (!e.getNode()) return JsonObject();
+    ArduinoJsonHost::makeCollection(e.getNode(), ArduinoJsonHost::NODE_OBJECT);
+    return JsonObject(e.getNode(), pool_);
+  }
+  JsonArray createNestedArray() const {
+    JsonVariant e = addElement();
+    if (!e.getNode()) return JsonArray();
+    ArduinoJsonHost::makeCollection(e.getNode(), ArduinoJsonHost::NODE_ARRAY);
+    return JsonArray(e.getNode(), pool_);
+  }
+  JsonVariant operator[](size_t index) const {
+    if (!node_) return JsonVariant();
+    ArduinoJsonHost::Slot *s = node_->c.head;
+    for (size_t i = 0; s && i < index; ++i) s = s->next;
+    return s ? JsonVariant(&s->value, pool_) : JsonVariant();
+  }
+  operator JsonVariant() const { return JsonVariant(node_, pool_); }
+private:
+  ArduinoJsonHost::Node *node_ = nullptr;
+  ArduinoJsonHost::Pool *pool_ = nullptr;
+};
+
+// Lazily-resolved `parent[key]`: reads never create members, writes do.
+template <typename TParent> class MemberProxy : public JsonRefBase<MemberProxy<TParent>> {
+public:
+  MemberProxy(const TParent &parent, const char *key) : parent_(parent), key_(key) {}
+  MemberProxy(const MemberProxy &) = default;
+
+  ArduinoJsonHost::Node *getNode() const {
+    ArduinoJsonHost::Slot *s = ArduinoJsonHost::findMember(parent_.getNode(), key_);
+    return s ? &s->value : nullptr;
+  }
+  ArduinoJsonHost::Node *getOrCreateNode() const {
+    return ArduinoJsonHost::getOrAddMember(parent_.getOrCreateNode(), parent_.getPool(), key_);
+  }
+  ArduinoJsonHost::Pool *getPool() const { return parent_.getPool(); }
+
+  template <typename T> MemberProxy &operator=(const T &v) {
+    JsonVariant(getOrCreateNode(), getPool()).set(v);
+    return *this;
+  }
+  MemberProxy &operator=(const char *v) {
+    JsonVariant(getOrCreateNode(), getPool()).set(v);
+    return *this;
+  }
+  MemberProxy &operator=(const MemberProxy &o) {
+    JsonVariant(getOrCreateNode(), getPool()).set(o.template as<JsonVariant>());
+    return *this;
+  }
+
+  MemberProxy<MemberProxy<TParent>> operator[](const char *key) const { return MemberProxy<MemberProxy<TParent>>(*this, key); }
+  MemberProxy<MemberProxy<TParent>> operator[](const String &key) const { return (*this)[key.c_str()]; }
+
+private:
+  TParent parent_;
+  const char *key_;
+};
+
+class JsonDocument : public JsonRefBase<JsonDocument> {
+public:
+  JsonDocument(const JsonDocument &) = delete;
+  JsonDocument &operator=(const JsonDocument &) = delete;
+
+  ArduinoJsonHost::Node *getNode() const { return const_cast<ArduinoJsonHost::Node *>(&root_); }
+  ArduinoJsonHost::Node *getOrCreateNode() const { return getNode(); }
+  ArduinoJsonHost::Pool *getPool() const { return const_cast<ArduinoJsonHost::Pool *>(&pool_); }
+
+  void clear() {
+    pool_.clear();
+    root_ = ArduinoJsonHost::Node();
+  }
+  size_t memoryUsage() const { return pool_.used(); }
+  size_t capacity() const { return pool_.capacity(); }
+  bool overflowed() const { return pool_.overflowed(); }
+
+  MemberProxy<JsonVariant> operator[](const char *key) const { return MemberProxy<JsonVariant>(as<JsonVariant>(), key); }
+  MemberProxy<JsonVariant> operator[](const String &key) const { return (*this)[key.c_str()]; }
+  JsonObject to_object() {
+    clear();
+    ArduinoJsonHost::makeCollection(&root_, ArduinoJsonHost::NODE_OBJECT);
+    return JsonObject(&root_, &pool_);
+  }
+  template <typename T> T to();
+
+protected:
+  JsonDocument() {}
+  ArduinoJsonHost::Pool pool_;
+  ArduinoJsonHost::Node root_;
+};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+  explicit DynamicJsonDocument(size_t capacity) {
+    size_t cap = capacity * ARDUINOJSON_HOST_POOL_SCALE;
+    buf_ = (char *)malloc(cap);
+    pool_.reset(buf_, buf_ ? cap : 0, buf_ ? capacity : 0);
+  }
+  ~DynamicJsonDocument() { free(buf_); }
+private:
+  char *buf_ = nullptr;
+};
+
+template <size_t N> class StaticJsonDocument : public JsonDocument {
+public:
+  StaticJsonDocument() { pool_.reset(buf_, sizeof(buf_), N); }
+private:
+  alignas(8) char buf_[N * ARDUINOJSON_HOST_POOL_SCALE];
+};
+
+// --- template definitions ---
+
+namespace ArduinoJsonHost {
+template <typename T> struct AsImpl {
+  static T get(Node *n, Pool *) { return Converter<typename std::decay<T>::type>::read(n); }
+  static bool is(Node *n) { return Converter<typename std::decay<T>::type>::is(n); }
+};
+template <> struct AsImpl<JsonObject> {
+  static JsonObject get(Node *n, Pool *p) { return JsonObject(n, p); }
+  static bool is(Node *n) { return n && n->type == NODE_OBJECT; }
+};
+template <> struct AsImpl<JsonArray> {
+  static JsonArray get(Node *n, Pool *p) { return JsonArray(n, p); }
+  static bool is(Node *n) { return n && n->type == NODE_ARRAY; }
+};
+template <> struct AsImpl<JsonVariant> {
+  static JsonVariant get(Node *n, Pool *p) { return JsonVariant(n, p); }
+  static bool is(Node *) { return true; }
+};
+inline void copyNode(Node *dst, Pool *pool, const Node *src) {
+  if (!src) { dst->type = NODE_NULL; return; }
+  switch (src->type) {
+    case NODE_STRING: Converter<const char *>::write(dst, pool, src->s); return;
+    case NODE_OBJECT:
+    case NODE_ARRAY: {
+      makeCollection(dst, src->type);
+      for (Slot *s = src->c.head; s; s = s->next) {
+        Slot *d = appendSlot(dst, pool, s->key);
+        if (!d) return;
+        copyNode(&d->value, pool, &s->value);
+      }
+      return;
+    }
+    default: *dst = *src; return;
+  }
+}
+}  // namespace ArduinoJsonHost
+
+template <typename TDerived> template <typename T> T JsonRefBase<TDerived>::as() const {
+  return ArduinoJsonHost::AsImpl<T>::get(self().getNode(), self().getPool());
+}
+
+template <typename TDerived> template <typename T> bool JsonRefBase<TDerived>::is() const {
+  return ArduinoJsonHost::AsImpl<T>::is(self().getNode());
+}
+
+template <typename TDerived> JsonArray JsonRefBase<TDerived>::createNestedArray(const char *key) const {
+  ArduinoJsonHost::Node *n = ArduinoJsonHost::getOrAddMember(self().getOrCreateNode(), self().getPool(), key);
+  if (!n) return JsonArray();
+  ArduinoJsonHost::makeCollection(n, ArduinoJsonHost::NODE_ARRAY);
+  return JsonArray(n, self().getPool());
+}
+
+template <typename TDerived> JsonObject JsonRefBase<TDerived>::createNestedObject(const char *key) const {
+  ArduinoJsonHost::Node *n = ArduinoJsonHost::getOrAddMember(self().getOrCreateNode(), self().getPool(), key);
+  if (!n) return JsonObject();
+  ArduinoJsonHost::makeCollection(n, ArduinoJsonHost::NODE_OBJECT);
+  return JsonObject(n, self().getPool());
+}
+
+template <typename T> bool JsonVariant::set(const T &v) {
+  if (!node_ || !pool_) return false;
+  if constexpr (std::is_same<T, JsonVariant>::value || std::is_same<T, JsonObject>::value || std::is_same<T, JsonArray>::value) {
+    ArduinoJsonHost::copyNode(node_, pool_, v.getNode());
+  } else if constexpr (std::is_array<T>::value) {
+    ArduinoJsonHost::Converter<const char *>::write(node_, pool_, v);
+  } else {
+    ArduinoJsonHost::Converter<typename std::decay<T>::type>::write(node_, pool_, v);
+  }
+  return !pool_->overflowed();
+}
+
+inline bool JsonVariant::set(const char *v) {
+  if (!node_ || !pool_) return false;
+  ArduinoJsonHost::Converter<const char *>::write(node_, pool_, v);
+  return !pool_->overflowed();
+}
+
+inline MemberProxy<JsonVariant> JsonVariant::operator[](const char *key) const { return MemberProxy<JsonVariant>(*this, key); }
+inline MemberProxy<JsonVariant> JsonVariant::operator[](const String &key) const { return (*this)[key.c_str()]; }
+inline MemberProxy<JsonVariant> JsonObject::operator[](const char *key) const {
+  return MemberProxy<JsonVariant>(JsonVariant(node_, pool_), key);
+}
+inline MemberProxy<JsonVariant> JsonObject::operator[](const String &key) const { return (*this)[key.c_str()]; }
+
+template <> inline JsonObject JsonDocument::to<JsonObject>() { return to_object(); }
+template <> inline JsonArray JsonDocument::to<JsonArray>() {
+  clear();
+  ArduinoJsonHost::makeCollection(&root_, ArduinoJsonHost::NODE_ARRAY);
+  return JsonArray(&root_, &pool_);
+}
+
+// --- deserialization ---
+
+class DeserializationError {
+public:
+  enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+  DeserializationError(Code c = Ok) : code_(c) {}
+  explicit operator bool() const { return code_ != Ok; }
+  bool operator==(Code c) const { return code_ == c; }
+  bool operator!=(Code c) const { return code_ != c; }
+  Code code() const { return code_; }
+  const char *c_str() const {
+    static const char *const names[] = {"Ok", "EmptyInput", "IncompleteInput", "InvalidInput", "NoMemory", "TooDeep"};
+    return names[code_];
+  }
+private:
+  Code code_;
+};
+
+DeserializationError deserializeJson(JsonDocument &doc, const char *input, size_t len);
+inline DeserializationError deserializeJson(JsonDocument &doc, const char *input) {
+  return deserializeJson(doc, input, input ? strlen(input) : 0);
+}
+inline DeserializationError deserializeJson(JsonDocument &doc, const String &input) {
+  return deserializeJson(doc, input.c_str(), input.length());
+}
+inline DeserializationError deserializeJson(JsonDocument &doc, const uint8_t *input, size_t len) {
+  return deserializeJson(doc, (const char *)input, len);
+}
+
+// --- serialization ---
+
+template <typename TSource> size_t serializeJson(const TSource &src, String &out) {
+  out = String();
+  return ArduinoJsonHost::serializeNode(src.getNode(), out);
+}
+
+template <typename TSource> size_t serializeJson(const TSource &src, char *buf, size_t cap) {
+  String s;
+  ArduinoJsonHost::serializeNode(src.getNode(), s);
+  if (!buf || cap == 0) return 0;
+  size_t n = s.length() < cap - 1 ? s.length() : cap - 1;
+  memcpy(buf, s.c_str(), n);
+  buf[n] = 0;
+  return n;
+}
+
+template <typename TSource> size_t measureJson(const TSource &src) {
+  String s;
+  return ArduinoJsonHost::serializeNode(src.getNode(), s);
+}
@@ -0,0 +1,177 @@
+// Decoder for the binary serial link (main/serial_link.h, wire format in
+// main/serial_frame.h). Replaces monitor_serial.py for tethered captures:
+// debug lines go to stdout, telemetry frames are written to a capture file
+// exactly as they came off the wire ([0xAA 0x55][u16 le len][protobuf], the
+// same stream the BLE decoders read).
+//
+//   build/serial_decode [--baud N] [--out FILE] [--seconds N] [--reset] PORT|FILE|-
+//
+// PORT is put in raw mode at --baud (default 115200; native USB-CDC ignores
+// it). --reset toggles DTR/RTS first, as monitor_serial.py did, to reboot
+// the board. --seconds stops after N seconds (default: until EOF or ^C).
+// A summary of frames, CRC errors and throughput goes to stderr at the end.
+
+#include "serial_frame.h"
+#include "pb_codec.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t stopRequested = 0;
+static void onSignal(int) { stopRequested = 1; }
+
+static speed_t baudConstant(unsigned long baud) {
+  switch (baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 500000: return B500000;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+    case 3000000: return B3000000;
+    case 4000000: return B4000000;
+    default: return 0;
+  }
+}
+
+static bool configurePort(int fd, unsigned long baud) {
+  speed_t speed = baudConstant(baud);
+  if (!speed) {
+    fprintf(stderr, "serial_decode: unsupported baud %lu\n", baud);
+    return false;
+  }
+  termios tio;
+  if (tcgetattr(fd, &tio) != 0) return false;
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 1;  // read() returns after 100 ms without data
+  return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+// DTR/RTS low, high, low: the auto-reset circuit reboots the ESP32.
+static void resetBoard(int fd) {
+  int lines = 0;
+  ioctl(fd, TIOCMGET, &lines);
+  lines &= ~(TIOCM_DTR | TIOCM_RTS);
+  ioctl(fd, TIOCMSET, &lines);
+  usleep(100000);
+  lines |= TIOCM_DTR | TIOCM_RTS;
+  ioctl(fd, TIOCMSET, &lines);
+  usleep(100000);
+  lines &= ~(TIOCM_DTR | TIOCM_RTS);
+  ioctl(fd, TIOCMSET, &lines);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: serial_decode [--baud N] [--out FILE] [--seconds N] [--reset] PORT|FILE|-\n");
+}
+
+int main(int argc, char **argv) {
+  unsigned long baud = 115200;
+  const char *outPath = "capture.bin";
+  double seconds = 0;
+  bool reset = false;
+  const char *input = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--baud") && i + 1 < argc) baud = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+    else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--reset")) reset = true;
+    else if (argv[i][0] == '-' && argv[i][1] != '\0') { usage(); return 2; }
+    else input = argv[i];
+  }
+  if (!input) { usage(); return 2; }
+
+  int fd = strcmp(input, "-") == 0 ? STDIN_FILENO : open(input, O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    fprintf(stderr, "serial_decode: %s: %s\n", input, strerror(errno));
+    return 1;
+  }
+  if (isatty(fd)) {
+    if (!configurePort(fd, baud)) {
+      fprintf(stderr, "serial_decode: cannot configure %s\n", input);
+      return 1;
+    }
+    if (reset) resetBoard(fd);
+    fprintf(stderr, "serial_decode: listening on %s at %lu baud\n", input, baud);
+  }
+  FILE *out = fopen(outPath, "wb");
+  if (!out) {
+    fprintf(stderr, "serial_decode: %s: %s\n", outPath, strerror(errno));
+    return 1;
+  }
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  SerialFrameDecoder dec;
+  unsigned long telemetryFrames = 0, telemetryBytes = 0, logLines = 0, badTelemetry = 0, unknown = 0;
+  unsigned long long wireBytes = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  uint8_t buf[4096];
+  while (!stopRequested) {
+    if (seconds > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() >= seconds) break;
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      fprintf(stderr, "serial_decode: read: %s\n", strerror(errno));
+      break;
+    }
+    if (n == 0) {
+      if (isatty(fd)) continue;  // read timeout
+      break;                     // end of file / pipe
+    }
+    wireBytes += (unsigned long long)n;
+    for (ssize_t i = 0; i < n; ++i) {
+      if (!dec.push(buf[i])) continue;
+      const uint8_t *p = dec.payload();
+      size_t len = dec.length();
+      switch (dec.channel()) {
+        case SERIAL_CH_TELEMETRY:
+          if (len < PB_FRAME_HEADER || p[0] != 0xAA || p[1] != 0x55 ||
+              (size_t)(p[2] | (p[3] << 8)) != len - PB_FRAME_HEADER) {
+            ++badTelemetry;
+            break;
+          }
+          fwrite(p, 1, len, out);
+          ++telemetryFrames;
+          telemetryBytes += len;
+          break;
+        case SERIAL_CH_LOG:
+          fwrite(p, 1, len, stdout);
+          fputc('\n', stdout);
+          ++logLines;
+          break;
+        default:
+          ++unknown;
+          break;
+      }
+    }
+  }
+  fflush(stdout);
+  fclose(out);
+
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  fprintf(stderr,
+          "serial_decode: %llu wire bytes, %lu telemetry frames (%lu bytes) -> %s, %lu log lines, "
+          "%lu crc errors, %lu malformed, %lu bad telemetry, %lu unknown channel, %.1f s\n",
+          wireBytes, telemetryFrames, telemetryBytes, outPath, logLines, dec.crcErrors(), dec.malformed(),
+          badTelemetry, unknown, secs);
+  return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// Host shim for the PN532 NFC reader. Reports a present chip and no tags by
+// default; host_pn532_present() toggles presence for status-reporting tests.
+
+#include <Wire.h>
+
+#define PN532_MIFARE_ISO14443A 0x00
+
+class Adafruit_PN532 {
+public:
+  Adafruit_PN532(uint8_t irq, uint8_t reset, TwoWire *wire = nullptr) : irq_(irq), reset_(reset), wire_(wire) {}
+  bool begin() { return true; }
+  uint32_t getFirmwareVersion();
+  bool SAMConfig() { return true; }
+  bool readPassiveTargetID(uint8_t cardbaudrate, uint8_t *uid, uint8_t *uidLength, uint16_t timeout = 0) {
+    (void)cardbaudrate; (void)uid; (void)timeout;
+    if (uidLength) *uidLength = 0;
+    return false;
+  }
+  // Host-only instrumentation.
+  static void setPresent(bool present);
+  static unsigned long firmwareQueries();
+private:
+  uint8_t irq_, reset_;
+  TwoWire *wire_;
+};
@@ -0,0 +1,146 @@
+#include "Arduino.h"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+// --- time ---------------------------------------------------------------
+
+static const auto hostEpoch = std::chrono::steady_clock::now();
+static std::atomic<unsigned long long> virtualUs{0};
+static thread_local bool taskThread = false;
+static thread_local unsigned long long taskVirtualUs = 0;
+
+void host_mark_task_thread() { taskThread = true; }
+
+bool host_realtime_delays() {
+  static int cached = -1;
+  if (cached < 0) {
+    const char *v = getenv("SHARKOS_HOST_REALTIME");
+    cached = (v && *v == '1') ? 1 : 0;
+  }
+  return cached == 1;
+}
+
+unsigned long micros() {
+  auto real = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostEpoch).count();
+  return (unsigned long)(real + virtualUs.load(std::memory_order_relaxed) + taskVirtualUs);
+}
+
+unsigned long millis() { return micros() / 1000UL; }
+
+void delay(unsigned long ms) {
+  if (host_realtime_delays()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  } else if (taskThread) {
+    taskVirtualUs += (unsigned long long)ms * 1000ULL;
+  } else {
+    virtualUs.fetch_add((unsigned long long)ms * 1000ULL, std::memory_order_relaxed);
+  }
+}
+
+void delayMicroseconds(unsigned int us) {
+  if (host_realtime_delays()) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+  } else if (taskThread) {
+    taskVirtualUs += us;
+  } else {
+    virtualUs.fetch_add(us, std::memory_order_relaxed);
+  }
+}
+
+void yield() { std::this_thread::yield(); }
+
+// --- GPIO ---------------------------------------------------------------
+
+struct HostPin {
+  uint8_t level = LOW;
+  host_pin_listener_t listener = nullptr;
+  void *listenerCtx = nullptr;
+  host_pin_source_t source = nullptr;
+  void *sourceCtx = nullptr;
+};
+static HostPin hostPins[256];
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  HostPin &p = hostPins[pin];
+  p.level = val ? HIGH : LOW;
+  if (p.listener) p.listener(p.listenerCtx, pin, p.level);
+}
+
+int digitalRead(uint8_t pin) {
+  HostPin &p = hostPins[pin];
+  if (p.source) return p.source(p.sourceCtx, pin);
+  return p.level;
+}
+
+int analogRead(uint8_t pin) { (void)pin; return (int)random(0, 4096); }
+
+void neopixelWrite(uint8_t pin, uint8_t r, uint8_t g, uint8_t b) { (void)pin; (void)r; (void)g; (void)b; }
+
+void host_gpio_listen(uint8_t pin, host_pin_listener_t fn, void *ctx) {
+  hostPins[pin].listener = fn;
+  hostPins[pin].listenerCtx = ctx;
+}
+
+void host_gpio_source(uint8_t pin, host_pin_source_t fn, void *ctx) {
+  hostPins[pin].source = fn;
+  hostPins[pin].sourceCtx = ctx;
+}
+
+uint8_t host_gpio_level(uint8_t pin) { return hostPins[pin].level; }
+
+// --- math ---------------------------------------------------------------
+
+static std::mt19937 hostRng(0x5eed);
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  return (long)(hostRng() % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) { hostRng.seed((unsigned int)seed); }
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  if (in_max == in_min) return out_min;
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// --- Serial -------------------------------------------------------------
+
+HardwareSerial Serial;
+
+static void stdoutSink(const char *data, size_t len) { fwrite(data, 1, len, stdout); }
+
+size_t HardwareSerial::write(const uint8_t *data, size_t len) {
+  sink_t s = sink_;
+  if (!s) {
+    static int echo = -1;
+    if (echo < 0) {
+      const char *v = getenv("SHARKOS_HOST_SERIAL");
+      echo = (v && *v == '1') ? 1 : 0;
+    }
+    if (echo) s = stdoutSink;
+  }
+  if (s) s((const char *)data, len);
+  return len;
+}
+
+size_t Print::printf(const char *fmt, ...) {
+  char buf[512];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0) return 0;
+  if ((size_t)n >= sizeof(buf)) n = sizeof(buf) - 1;
+  return write((const uint8_t *)buf, (size_t)n);
+}
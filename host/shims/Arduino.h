@@ -0,0 +1,132 @@
+#pragma once
+
+// Host (Linux) shim for the Arduino core used by the ESP32-S3 firmware.
+// Provides just enough of the Arduino API for the firmware core under `main/`
+// to compile as plain C++17 so it can be profiled and exercised off-device.
+//
+// Time model: millis()/micros() follow the host's monotonic clock, but
+// delay()/delayMicroseconds() do not sleep — they advance a virtual offset so
+// radio settle delays cost nothing. Set SHARKOS_HOST_REALTIME=1 to sleep for real.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "WString.h"
+
+// The ESP32 core pulls FreeRTOS in from Arduino.h; sketches rely on that.
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define SHARKOS_HOST 1
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+using std::max;
+using std::min;
+
+// --- time ---
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+// Host-only: true when SHARKOS_HOST_REALTIME=1 (delays really sleep).
+bool host_realtime_delays();
+// Host-only: called on FreeRTOS task threads. A task's delay() advances a
+// clock offset private to that thread, so tasks running in parallel neither
+// add up their settle delays nor move the main loop's clock.
+void host_mark_task_thread();
+
+// --- GPIO ---
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void neopixelWrite(uint8_t pin, uint8_t r, uint8_t g, uint8_t b);
+
+// Host-only GPIO hooks: a listener is told about every write to `pin`
+// (fake SPI devices use this to track chip-select), and an input source
+// overrides what digitalRead() returns for `pin`.
+typedef void (*host_pin_listener_t)(void *ctx, uint8_t pin, uint8_t val);
+typedef int (*host_pin_source_t)(void *ctx, uint8_t pin);
+void host_gpio_listen(uint8_t pin, host_pin_listener_t fn, void *ctx);
+void host_gpio_source(uint8_t pin, host_pin_source_t fn, void *ctx);
+uint8_t host_gpio_level(uint8_t pin);
+
+// --- math helpers ---
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+// --- Print / Serial ---
+// Print carries the formatting overloads; subclasses supply write(), as in
+// the Arduino core.
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(const uint8_t *data, size_t len) = 0;
+  virtual size_t write(uint8_t c) { return write(&c, 1); }
+
+  size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+  size_t print(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int base = DEC) { return print(String((long)v, (unsigned char)base)); }
+  size_t print(unsigned int v, int base = DEC) { return print(String((unsigned long)v, (unsigned char)base)); }
+  size_t print(long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+  size_t print(unsigned long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+  size_t print(long long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+  size_t print(unsigned long long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+  size_t print(unsigned char v, int base = DEC) { return print(String((unsigned long)v, (unsigned char)base)); }
+  size_t print(double v, int digits = 2) { return print(String(v, (unsigned int)digits)); }
+
+  size_t println() { return print("\r\n"); }
+  template <typename T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+  template <typename T> size_t println(const T &v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// Output is discarded unless SHARKOS_HOST_SERIAL=1 is set or a sink is
+// installed, so benchmarks are not dominated by terminal I/O.
+class HardwareSerial : public Print {
+public:
+  typedef void (*sink_t)(const char *data, size_t len);
+
+  void begin(unsigned long baud) { baud_ = baud; }
+  unsigned long baudRate() const { return baud_; }
+  void setSink(sink_t sink) { sink_ = sink; }
+  using Print::write;
+  size_t write(const uint8_t *data, size_t len) override;
+
+  operator bool() const { return true; }
+
+private:
+  sink_t sink_ = nullptr;
+  unsigned long baud_ = 0;
+};
+
+extern HardwareSerial Serial;
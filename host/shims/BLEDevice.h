@@ -0,0 +1,186 @@
+#pragma once
+
+// Host shim for the ESP32 Arduino BLE library. The GATT server is modelled in
+// memory: writes from a simulated client go through host_ble_client_write()
+// into the characteristic callbacks, and notify() hands the current value to
+// an optional observer so tests and benchmarks can see what went on air.
+
+#include <Arduino.h>
+
+#include <string>
+#include <vector>
+
+class BLECharacteristic;
+class BLEServer;
+
+class BLEUUID {
+public:
+  BLEUUID() {}
+  BLEUUID(const char *s) : s_(s ? s : "") {}
+  std::string toString() const { return s_; }
+private:
+  std::string s_;
+};
+
+class BLEDescriptor {
+public:
+  virtual ~BLEDescriptor() {}
+};
+
+class BLE2902 : public BLEDescriptor {};
+
+class BLECharacteristicCallbacks {
+public:
+  virtual ~BLECharacteristicCallbacks() {}
+  virtual void onWrite(BLECharacteristic *p) { (void)p; }
+  virtual void onRead(BLECharacteristic *p) { (void)p; }
+};
+
+class BLECharacteristic {
+public:
+  static const uint32_t PROPERTY_READ = 1 << 0;
+  static const uint32_t PROPERTY_WRITE = 1 << 1;
+  static const uint32_t PROPERTY_NOTIFY = 1 << 2;
+  static const uint32_t PROPERTY_BROADCAST = 1 << 3;
+  static const uint32_t PROPERTY_INDICATE = 1 << 4;
+  static const uint32_t PROPERTY_WRITE_NR = 1 << 5;
+
+  typedef void (*notify_observer_t)(BLECharacteristic *c, const uint8_t *data, size_t len);
+
+  BLECharacteristic(const char *uuid, uint32_t props) : uuid_(uuid), props_(props) {}
+
+  void setValue(const uint8_t *data, size_t len) { value_.assign((const char *)data, len); }
+  void setValue(const String &s) { value_ = s.str(); }
+  void setValue(const std::string &s) { value_ = s; }
+  void setValue(const char *s) { value_ = s ? s : ""; }
+  String getValue() const { return String(value_); }
+  const uint8_t *getData() const { return (const uint8_t *)value_.data(); }
+  size_t getLength() const { return value_.size(); }
+
+  void notify(bool isNotification = true);
+  void indicate() { notify(false); }
+  void setCallbacks(BLECharacteristicCallbacks *cb) { callbacks_ = cb; }
+  BLECharacteristicCallbacks *getCallbacks() const { return callbacks_; }
+  void addDescriptor(BLEDescriptor *d) { descriptors_.push_back(d); }
+  BLEUUID getUUID() const { return uuid_; }
+
+  // Host-only instrumentation.
+  static void setNotifyObserver(notify_observer_t fn);
+  unsigned long notifyCount() const { return notifyCount_; }
+  unsigned long notifyBytes() const { return notifyBytes_; }
+
+private:
+  BLEUUID uuid_;
+  uint32_t props_;
+  std::string value_;
+  BLECharacteristicCallbacks *callbacks_ = nullptr;
+  std::vector<BLEDescriptor *> descriptors_;
+  unsigned long notifyCount_ = 0;
+  unsigned long notifyBytes_ = 0;
+};
+
+class BLEService {
+public:
+  explicit BLEService(const char *uuid) : uuid_(uuid) {}
+  BLECharacteristic *createCharacteristic(const char *uuid, uint32_t props);
+  void start() {}
+private:
+  BLEUUID uuid_;
+  std::vector<BLECharacteristic *> chars_;
+};
+
+// The one member of the ESP-IDF GATTS callback union ServerCallbacks reads.
+struct esp_ble_gatts_cb_param_t {
+  struct {
+    uint16_t conn_id;
+    uint16_t mtu;
+  } mtu;
+};
+
+class BLEServerCallbacks {
+public:
+  virtual ~BLEServerCallbacks() {}
+  virtual void onConnect(BLEServer *s) { (void)s; }
+  virtual void onDisconnect(BLEServer *s) { (void)s; }
+  virtual void onMtuChanged(BLEServer *s, esp_ble_gatts_cb_param_t *param) { (void)s; (void)param; }
+};
+
+class BLEServer {
+public:
+  void setCallbacks(BLEServerCallbacks *cb) { callbacks_ = cb; }
+  BLEServerCallbacks *getCallbacks() const { return callbacks_; }
+  BLEService *createService(const char *uuid) { return new BLEService(uuid); }
+  int getConnId() const { return 0; }
+  uint32_t getConnectedCount() const { return connected_; }
+  void setConnected(uint32_t n) { connected_ = n; }
+private:
+  BLEServerCallbacks *callbacks_ = nullptr;
+  uint32_t connected_ = 0;
+};
+
+class BLEAdvertising {
+public:
+  void addServiceUUID(const char *uuid) { (void)uuid; }
+  void start() {}
+  void stop() {}
+};
+
+class BLEAdvertisedDevice {
+public:
+  String getName() const { return name_; }
+  String getAddressString() const { return addr_; }
+  int getRSSI() const { return rssi_; }
+  String name_;
+  String addr_;
+  int rssi_ = 0;
+};
+
+class BLEScanResults {
+public:
+  int getCount() const { return (int)devices_.size(); }
+  BLEAdvertisedDevice getDevice(int i) const { return devices_[(size_t)i]; }
+  std::vector<BLEAdvertisedDevice> devices_;
+};
+
+class BLEAdvertisedDeviceCallbacks {
+public:
+  virtual ~BLEAdvertisedDeviceCallbacks() {}
+  virtual void onResult(BLEAdvertisedDevice d) { (void)d; }
+};
+
+class BLEScan {
+public:
+  void setAdvertisedDeviceCallbacks(BLEAdvertisedDeviceCallbacks *cb) { cb_ = cb; }
+  void setActiveScan(bool) {}
+  void setInterval(uint16_t) {}
+  void setWindow(uint16_t) {}
+  BLEScanResults *start(uint32_t seconds, bool isContinue = false) { (void)seconds; (void)isContinue; return &results_; }
+  bool start(uint32_t seconds, void (*done)(BLEScanResults), bool isContinue) { (void)seconds; (void)done; (void)isContinue; return true; }
+  void stop() {}
+  void clearResults() { results_.devices_.clear(); }
+private:
+  BLEAdvertisedDeviceCallbacks *cb_ = nullptr;
+  BLEScanResults results_;
+};
+
+class BLEDevice {
+public:
+  static void init(const char *name) { (void)name; }
+  static BLEServer *createServer();
+  static BLEAdvertising *getAdvertising();
+  static void startAdvertising() {}
+  static BLEScan *getScan();
+  static uint16_t getMTU() { return mtu_; }
+  static void setMTU(uint16_t mtu) { mtu_ = mtu; }
+private:
+  static uint16_t mtu_;
+};
+
+// Host-only: simulate a central writing `value` to characteristic `c`.
+void host_ble_client_write(BLECharacteristic *c, const String &value);
+void host_ble_client_write(BLECharacteristic *c, const uint8_t *data, size_t len);
+// Host-only: simulate a central connecting / disconnecting.
+void host_ble_connect(BLEServer *server);
+void host_ble_disconnect(BLEServer *server);
+// Host-only: simulate the central negotiating an ATT MTU.
+void host_ble_set_mtu(BLEServer *server, uint16_t mtu);
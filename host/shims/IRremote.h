@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+
+struct decode_results {
+  uint32_t value = 0;
+  int bits = 0;
+};
+
+class IRrecv {
+public:
+  explicit IRrecv(uint8_t pin) : pin_(pin) {}
+  void begin(uint8_t pin = 0, bool led = false) { (void)pin; (void)led; }
+  void enableIRIn() {}
+  bool decode() { return false; }
+  bool decode(decode_results *r) { (void)r; return false; }
+  void resume() {}
+private:
+  uint8_t pin_;
+};
+
+class IRsend {
+public:
+  IRsend(uint8_t pin = 0) : pin_(pin) {}
+  void begin(uint8_t pin = 0) { (void)pin; }
+  void sendNEC(uint32_t data, uint8_t nbits = 32) { (void)data; (void)nbits; }
+  void sendRaw(const uint16_t *buf, size_t len, uint8_t khz) { (void)buf; (void)len; (void)khz; }
+private:
+  uint8_t pin_;
+};
+
+extern IRrecv IrReceiver;
+extern IRsend IrSender;
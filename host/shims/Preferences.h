@@ -0,0 +1,34 @@
+#pragma once
+
+// Host shim for ESP32 NVS Preferences: an in-memory key/value store.
+
+#include <Arduino.h>
+
+#include <map>
+#include <string>
+
+class Preferences {
+public:
+  bool begin(const char *ns, bool readOnly = false) { (void)ns; (void)readOnly; return true; }
+  void end() {}
+  bool clear() { values_.clear(); return true; }
+  bool remove(const char *key) { return values_.erase(key) > 0; }
+  bool isKey(const char *key) { return values_.count(key) > 0; }
+  size_t putBool(const char *key, bool v) { values_[key] = v ? "1" : "0"; return 1; }
+  bool getBool(const char *key, bool def = false) {
+    auto it = values_.find(key);
+    return it == values_.end() ? def : it->second == "1";
+  }
+  size_t putInt(const char *key, int32_t v) { values_[key] = std::to_string(v); return 4; }
+  int32_t getInt(const char *key, int32_t def = 0) {
+    auto it = values_.find(key);
+    return it == values_.end() ? def : (int32_t)strtol(it->second.c_str(), nullptr, 10);
+  }
+  size_t putString(const char *key, const String &v) { values_[key] = v.str(); return v.length(); }
+  String getString(const char *key, const String &def = String()) {
+    auto it = values_.find(key);
+    return it == values_.end() ? def : String(it->second);
+  }
+private:
+  std::map<std::string, std::string> values_;
+};
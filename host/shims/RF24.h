@@ -0,0 +1,35 @@
+#pragma once
+
+// Host shim for the nRF24L01 driver. testRPD() reports carrier on a fixed set
+// of channels so channel-sweep reporting has something to show.
+
+#include <Arduino.h>
+
+#define RF24_PA_MIN 0
+#define RF24_PA_LOW 1
+#define RF24_PA_HIGH 2
+#define RF24_PA_MAX 3
+#define RF24_1MBPS 0
+#define RF24_2MBPS 1
+#define RF24_250KBPS 2
+
+class RF24 {
+public:
+  RF24(uint16_t ce, uint16_t csn) : ce_(ce), csn_(csn) {}
+  bool begin() { return true; }
+  bool isChipConnected() { return true; }
+  void setChannel(uint8_t ch) { ch_ = ch; }
+  uint8_t getChannel() const { return ch_; }
+  bool testRPD() { return ch_ == 1 || ch_ == 6 || ch_ == 11; }
+  bool testCarrier() { return testRPD(); }
+  void startListening() {}
+  void stopListening() {}
+  void setAutoAck(bool) {}
+  void setPALevel(uint8_t, bool = true) {}
+  bool setDataRate(uint8_t) { return true; }
+  void powerDown() {}
+  void powerUp() {}
+private:
+  uint16_t ce_, csn_;
+  uint8_t ch_ = 0;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+// Host shim for the RadioLib types the firmware instantiates (LoRa is not
+// initialised on the current board, so these are inert).
+
+#include <SPI.h>
+
+#define RADIOLIB_ERR_NONE 0
+
+class Module {
+public:
+  Module(uint32_t cs, uint32_t irq, uint32_t rst, uint32_t gpio, SPIClass &spi)
+      : cs_(cs), irq_(irq), rst_(rst), gpio_(gpio), spi_(&spi) {}
+private:
+  uint32_t cs_, irq_, rst_, gpio_;
+  SPIClass *spi_;
+};
+
+class SX1276 {
+public:
+  explicit SX1276(Module *m) : mod_(m) {}
+  int16_t begin(float freq = 434.0) { (void)freq; return RADIOLIB_ERR_NONE; }
+  int16_t setFrequency(float freq) { (void)freq; return RADIOLIB_ERR_NONE; }
+  float getRSSI() { return -120.0f; }
+private:
+  Module *mod_;
+};
+
+class CC1101 {
+public:
+  explicit CC1101(Module *m) : mod_(m) {}
+private:
+  Module *mod_;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+// Host shim for the ESP32 SPIClass. Devices are attached per chip-select pin;
+// transfer() is routed to whichever attached device currently has CS LOW.
+
+#include <Arduino.h>
+
+#define FSPI 0
+#define HSPI 1
+#define VSPI 2
+
+#define SPI_MODE0 0x00
+#define MSBFIRST 1
+
+class SPISettings {
+public:
+  SPISettings() {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) { (void)clock; (void)bitOrder; (void)dataMode; }
+};
+
+// A fake peripheral on a host SPI bus (see host/fake_radios.h).
+class HostSpiDevice {
+public:
+  virtual ~HostSpiDevice() {}
+  // CS edge: selected == true on the falling edge, false on the rising edge.
+  virtual void select(bool selected) = 0;
+  virtual uint8_t transfer(uint8_t out) = 0;
+};
+
+class SPIClass {
+public:
+  explicit SPIClass(uint8_t bus = FSPI) : bus_(bus) {}
+
+  bool begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+    (void)sck; (void)miso; (void)mosi; (void)ss;
+    return true;
+  }
+  void end() {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data);
+  void transfer(void *buf, size_t count) {
+    uint8_t *p = (uint8_t *)buf;
+    for (size_t i = 0; i < count; ++i) p[i] = transfer(p[i]);
+  }
+
+  uint8_t bus() const { return bus_; }
+  // Host-only: route CS pin `cs` on this bus to `dev`.
+  void attach(uint8_t cs, HostSpiDevice *dev);
+  // Host-only: number of bytes clocked on this bus since start.
+  unsigned long bytesTransferred() const { return bytes_; }
+
+private:
+  uint8_t bus_;
+  static const int MAX_DEVICES = 4;
+  uint8_t cs_[MAX_DEVICES] = {0};
+  HostSpiDevice *dev_[MAX_DEVICES] = {nullptr};
+  int count_ = 0;
+  unsigned long bytes_ = 0;
+};
+
+extern SPIClass SPI;
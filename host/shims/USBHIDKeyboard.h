@@ -0,0 +1,14 @@
+#pragma once
+
+// Host shim: USB HID keyboard is not available off-device.
+
+#include <Arduino.h>
+
+class USBHIDKeyboard {
+public:
+  void begin() {}
+  size_t print(const char *) { return 0; }
+  size_t write(uint8_t) { return 1; }
+  size_t press(uint8_t) { return 1; }
+  void releaseAll() {}
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+// Host shim for the Arduino `String` class.
+// Backed by std::string so the firmware's String-heavy code paths compile and
+// behave the same on Linux. Only the subset of the API used under `main/` is
+// provided; add members here as firmware code starts using them.
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifndef DEC
+#define DEC 10
+#endif
+#ifndef HEX
+#define HEX 16
+#endif
+#ifndef OCT
+#define OCT 8
+#endif
+#ifndef BIN
+#define BIN 2
+#endif
+
+class String {
+public:
+  String() {}
+  String(const char *s) : s_(s ? s : "") {}
+  String(const char *s, size_t n) : s_(s ? s : "", s ? n : 0) {}
+  String(const std::string &s) : s_(s) {}
+  String(const String &o) = default;
+  String(String &&o) noexcept = default;
+  explicit String(char c) : s_(1, c) {}
+  explicit String(unsigned char v, unsigned char base = DEC) { fromUnsigned(v, base); }
+  explicit String(int v, unsigned char base = DEC) { fromSigned(v, base); }
+  explicit String(unsigned int v, unsigned char base = DEC) { fromUnsigned(v, base); }
+  explicit String(long v, unsigned char base = DEC) { fromSigned(v, base); }
+  explicit String(unsigned long v, unsigned char base = DEC) { fromUnsigned(v, base); }
+  explicit String(long long v, unsigned char base = DEC) { fromSigned(v, base); }
+  explicit String(unsigned long long v, unsigned char base = DEC) { fromUnsigned(v, base); }
+  explicit String(float v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+  explicit String(double v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+
+  String &operator=(const String &o) = default;
+  String &operator=(String &&o) noexcept = default;
+  String &operator=(const char *s) { s_ = s ? s : ""; return *this; }
+
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  bool isEmpty() const { return s_.empty(); }
+  const char *c_str() const { return s_.c_str(); }
+  bool reserve(unsigned int n) { s_.reserve(n); return true; }
+  char charAt(unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+
+  void trim() {
+    size_t b = 0, e = s_.size();
+    while (b < e && isspace((unsigned char)s_[b])) ++b;
+    while (e > b && isspace((unsigned char)s_[e - 1])) --e;
+    s_ = s_.substr(b, e - b);
+  }
+  bool startsWith(const String &p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool endsWith(const String &p) const {
+    return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+  }
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t p = s_.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(const String &n, unsigned int from = 0) const {
+    size_t p = s_.find(n.s_, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  String substring(unsigned int b) const { return b < s_.size() ? String(s_.substr(b)) : String(); }
+  String substring(unsigned int b, unsigned int e) const {
+    if (b > e) { unsigned int t = b; b = e; e = t; }
+    if (b >= s_.size()) return String();
+    return String(s_.substr(b, e - b));
+  }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s_.c_str(), nullptr); }
+  bool equals(const String &o) const { return s_ == o.s_; }
+
+  String &operator+=(const String &o) { s_ += o.s_; return *this; }
+  String &operator+=(const char *s) { if (s) s_ += s; return *this; }
+  String &operator+=(char c) { s_ += c; return *this; }
+  String &operator+=(int v) { return *this += String(v); }
+  String &operator+=(unsigned int v) { return *this += String(v); }
+  String &operator+=(long v) { return *this += String(v); }
+  String &operator+=(unsigned long v) { return *this += String(v); }
+  bool concat(const String &o) { s_ += o.s_; return true; }
+  bool concat(const char *s, unsigned int len) { if (s) s_.append(s, len); return true; }
+
+  friend String operator+(const String &a, const String &b) { String r(a); r += b; return r; }
+  friend String operator+(const String &a, const char *b) { String r(a); r += b; return r; }
+  friend String operator+(const char *a, const String &b) { String r(a); r += b; return r; }
+  friend String operator+(const String &a, char b) { String r(a); r += b; return r; }
+
+  friend bool operator==(const String &a, const String &b) { return a.s_ == b.s_; }
+  friend bool operator==(const String &a, const char *b) { return a.s_ == (b ? b : ""); }
+  friend bool operator==(const char *a, const String &b) { return b == a; }
+  friend bool operator!=(const String &a, const String &b) { return !(a == b); }
+  friend bool operator!=(const String &a, const char *b) { return !(a == b); }
+  friend bool operator!=(const char *a, const String &b) { return !(b == a); }
+  friend bool operator<(const String &a, const String &b) { return a.s_ < b.s_; }
+
+  // Host-only accessor used by other shims.
+  const std::string &str() const { return s_; }
+
+private:
+  template <typename T> void fromUnsigned(T v, unsigned char base) {
+    char buf[66];
+    char *p = buf + sizeof(buf) - 1;
+    *p = 0;
+    if (base < 2) base = 10;
+    do {
+      unsigned d = (unsigned)(v % base);
+      *--p = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+      v /= base;
+    } while (v);
+    s_ = p;
+  }
+  template <typename T> void fromSigned(T v, unsigned char base) {
+    if (base == 10 && v < 0) {
+      fromUnsigned((unsigned long long)(-(long long)v), base);
+      s_.insert(s_.begin(), '-');
+    } else if (base == 10) {
+      fromUnsigned((unsigned long long)v, base);
+    } else {
+      // Arduino prints negative numbers in non-decimal bases as two's complement
+      fromUnsigned((unsigned long)v, base);
+    }
+  }
+  void fromDouble(double v, unsigned int decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    s_ = buf;
+  }
+
+  std::string s_;
+};
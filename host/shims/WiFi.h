@@ -0,0 +1,46 @@
+#pragma once
+
+// Host shim for the ESP32 WiFi scanner API. Scan results come from a fixed
+// table of fake networks so WiFi reporting paths can be exercised.
+
+#include <Arduino.h>
+
+typedef enum {
+  WIFI_AUTH_OPEN = 0,
+  WIFI_AUTH_WEP,
+  WIFI_AUTH_WPA_PSK,
+  WIFI_AUTH_WPA2_PSK,
+  WIFI_AUTH_WPA_WPA2_PSK,
+  WIFI_AUTH_WPA2_ENTERPRISE,
+  WIFI_AUTH_WPA3_PSK,
+  WIFI_AUTH_WPA2_WPA3_PSK,
+  WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+typedef enum { WIFI_MODE_NULL = 0, WIFI_MODE_STA, WIFI_MODE_AP, WIFI_MODE_APSTA } wifi_mode_t;
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_OFF WIFI_MODE_NULL
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+class WiFiClass {
+public:
+  int16_t scanNetworks(bool async = false, bool show_hidden = false, bool passive = false,
+                       uint32_t max_ms_per_chan = 300, uint8_t channel = 0);
+  int16_t scanComplete() { return scanned_; }
+  void scanDelete() { scanned_ = WIFI_SCAN_FAILED; }
+  String SSID(uint8_t i);
+  int32_t RSSI(uint8_t i);
+  String BSSIDstr(uint8_t i);
+  int32_t channel(uint8_t i);
+  wifi_auth_mode_t encryptionType(uint8_t i);
+  wifi_mode_t getMode() { return mode_; }
+  bool mode(wifi_mode_t m) { mode_ = m; return true; }
+  void disconnect() {}
+private:
+  int16_t scanned_ = WIFI_SCAN_FAILED;
+  wifi_mode_t mode_ = WIFI_MODE_NULL;
+};
+
+extern WiFiClass WiFi;
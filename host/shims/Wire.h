@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  explicit TwoWire(uint8_t bus = 0) : bus_(bus) {}
+  bool begin(int sda = -1, int scl = -1, uint32_t freq = 0) { (void)sda; (void)scl; (void)freq; return true; }
+  void beginTransmission(uint8_t addr) { (void)addr; }
+  uint8_t endTransmission(bool stop = true) { (void)stop; return 2; }  // NACK: nothing on the bus
+  uint8_t requestFrom(uint8_t addr, uint8_t n) { (void)addr; (void)n; return 0; }
+  int available() { return 0; }
+  int read() { return -1; }
+  size_t write(uint8_t b) { (void)b; return 1; }
+private:
+  uint8_t bus_;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+typedef struct {
+  int model;
+  uint32_t features;
+  uint16_t revision;
+  uint8_t cores;
+} esp_chip_info_t;
+
+inline void esp_chip_info(esp_chip_info_t *info) { info->model = 9; info->features = 0; info->revision = 0; info->cores = 2; }
@@ -0,0 +1,72 @@
+// Simulated PSRAM for the host build (esp_heap_caps.h).
+
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+
+#include <cstdlib>
+#include <malloc.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+std::mutex psramMutex;
+size_t psramSize = 8u * 1024 * 1024;
+size_t psramUsed = 0;
+std::unordered_map<const void *, size_t> psramBlocks;
+
+size_t internalFree() { return mallinfo2().fordblks; }
+
+}  // namespace
+
+thread_local bool host_psram_allocating = false;
+
+void host_psram_set_size(size_t bytes) {
+  std::lock_guard<std::mutex> lock(psramMutex);
+  psramSize = bytes;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+  if (!(caps & MALLOC_CAP_SPIRAM)) return malloc(size);
+  std::lock_guard<std::mutex> lock(psramMutex);
+  if (size > psramSize - psramUsed) return nullptr;
+  host_psram_allocating = true;
+  void *p = malloc(size);
+  host_psram_allocating = false;
+  if (!p) return nullptr;
+  psramUsed += size;
+  psramBlocks[p] = size;
+  return p;
+}
+
+void heap_caps_free(void *p) {
+  if (!p) return;
+  {
+    std::lock_guard<std::mutex> lock(psramMutex);
+    auto it = psramBlocks.find(p);
+    if (it != psramBlocks.end()) {
+      psramUsed -= it->second;
+      psramBlocks.erase(it);
+    }
+  }
+  free(p);
+}
+
+bool esp_ptr_external_ram(const void *p) {
+  std::lock_guard<std::mutex> lock(psramMutex);
+  return psramBlocks.count(p) != 0;
+}
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+  if (!(caps & MALLOC_CAP_SPIRAM)) return mallinfo2().arena;
+  std::lock_guard<std::mutex> lock(psramMutex);
+  return psramSize;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+  if (!(caps & MALLOC_CAP_SPIRAM)) return internalFree();
+  std::lock_guard<std::mutex> lock(psramMutex);
+  return psramSize - psramUsed;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) { return heap_caps_get_free_size(caps); }
@@ -0,0 +1,27 @@
+#pragma once
+
+// Host shim for the ESP-IDF capability heap. PSRAM is simulated: SPIRAM
+// allocations come from malloc but count against a budget set with
+// host_psram_set_size() (8 MB, the N16R8, by default; 0 models a board
+// without PSRAM). Everything else is plain malloc; glibc does not track its
+// largest free block, so that reports the free bytes inside the arena.
+
+#include <cstddef>
+#include <cstdint>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void heap_caps_free(void *p);
+size_t heap_caps_get_total_size(uint32_t caps);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+void host_psram_set_size(size_t bytes);
+
+// True on a thread while it takes a simulated PSRAM block from malloc, so a
+// model of internal RAM (host/bench_soak.cpp) can leave the block out.
+extern thread_local bool host_psram_allocating;
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host shim: "external RAM" is the simulated PSRAM of esp_heap_caps.h.
+
+bool esp_ptr_external_ram(const void *p);
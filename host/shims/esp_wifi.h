@@ -0,0 +1,6 @@
+#pragma once
+
+#include "WiFi.h"
+
+typedef int esp_err_t;
+#define ESP_OK 0
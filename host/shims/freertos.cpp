@@ -0,0 +1,227 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+struct HostTask {
+  TaskFunction_t fn;
+  void *param;
+  const char *name;
+  std::atomic<bool> deleted{false};
+};
+
+namespace {
+// Thrown inside a task thread to unwind it once it has been deleted.
+struct HostTaskDeleted {};
+thread_local HostTask *currentTask = nullptr;
+
+// Queue items not yet finished: still queued, or received by a task that has
+// not come back for the next one. With virtual delays the loop lets this
+// drain before it skips time ahead, so worker tasks keep up with it.
+std::atomic<int> queuedWork{0};
+thread_local bool holdingWork = false;
+
+void checkDeleted() {
+  if (currentTask && currentTask->deleted.load()) throw HostTaskDeleted();
+}
+
+void taskTrampoline(HostTask *t) {
+  currentTask = t;
+  host_mark_task_thread();
+  try {
+    t->fn(t->param);
+  } catch (const HostTaskDeleted &) {
+  }
+  // Handles are never reused, so leaking the control block keeps stale
+  // handles held by firmware code safe to compare against.
+}
+}  // namespace
+
+void host_port_enter_critical(portMUX_TYPE *mux) { mux->m.lock(); }
+void host_port_exit_critical(portMUX_TYPE *mux) { mux->m.unlock(); }
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *param,
+                       UBaseType_t priority, TaskHandle_t *outHandle) {
+  return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, outHandle, tskNO_AFFINITY);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *param,
+                                   UBaseType_t priority, TaskHandle_t *outHandle, BaseType_t coreId) {
+  (void)stackDepth;
+  (void)priority;
+  (void)coreId;
+  HostTask *t = new HostTask();
+  t->fn = fn;
+  t->param = param;
+  t->name = name;
+  if (outHandle) *outHandle = t;
+  std::thread(taskTrampoline, t).detach();
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (task == nullptr) task = currentTask;
+  if (!task) return;
+  task->deleted.store(true);
+  if (task == currentTask) throw HostTaskDeleted();
+}
+
+void vTaskDelay(TickType_t ticks) {
+  checkDeleted();
+  if (currentTask) {
+    // Background tasks really sleep so they do not spin a host core. A task
+    // sleeping on the loop (e.g. for ring space) must not hold it up.
+    if (holdingWork) queuedWork.fetch_sub(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+    if (holdingWork) queuedWork.fetch_add(1);
+  } else {
+    delay(ticks);
+  }
+  checkDeleted();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return currentTask; }
+
+void host_task_yield() {
+  checkDeleted();
+  std::this_thread::yield();
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+
+// --- event groups --------------------------------------------------------
+
+struct HostEventGroup {
+  std::mutex m;
+  std::condition_variable cv;
+  EventBits_t bits = 0;
+};
+
+EventGroupHandle_t xEventGroupCreate() { return new HostEventGroup(); }
+
+void vEventGroupDelete(EventGroupHandle_t group) { delete group; }
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+  std::lock_guard<std::mutex> lock(group->m);
+  group->bits |= bits;
+  group->cv.notify_all();
+  return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+  std::lock_guard<std::mutex> lock(group->m);
+  EventBits_t before = group->bits;
+  group->bits &= ~bits;
+  return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+  std::lock_guard<std::mutex> lock(group->m);
+  return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(group->m);
+  auto satisfied = [&] {
+    EventBits_t hit = group->bits & bits;
+    return waitForAll ? hit == bits : hit != 0;
+  };
+  if (!satisfied() && ticks > 0) {
+    if (host_realtime_delays()) {
+      if (ticks == portMAX_DELAY) group->cv.wait(lock, satisfied);
+      else group->cv.wait_for(lock, std::chrono::milliseconds(ticks), satisfied);
+    } else {
+      // Let task threads finish the queue work they hold first (they wake
+      // the loop when done); after that nothing else runs on the virtual
+      // clock while the loop sleeps, so a timed-out wait is simply the
+      // timeout elapsing.
+      while (!satisfied() && queuedWork.load() > 0) group->cv.wait_for(lock, std::chrono::microseconds(100));
+      if (satisfied()) {
+        EventBits_t result = group->bits;
+        if (clearOnExit) group->bits &= ~bits;
+        return result;
+      }
+      lock.unlock();
+      delay(ticks == portMAX_DELAY ? 1000 : ticks);
+      lock.lock();
+    }
+  }
+  EventBits_t result = group->bits;
+  if (satisfied() && clearOnExit) group->bits &= ~bits;
+  return result;
+}
+
+// --- queues --------------------------------------------------------------
+
+struct HostQueue {
+  std::mutex m;
+  std::condition_variable cv;
+  std::vector<uint8_t> storage;
+  size_t itemSize = 0;
+  size_t length = 0;
+  size_t head = 0;
+  size_t count = 0;
+};
+
+namespace {
+template <typename Pred>
+bool queueWait(HostQueue *q, std::unique_lock<std::mutex> &lock, TickType_t ticks, Pred ready) {
+  if (ready()) return true;
+  if (ticks == 0) return false;
+  if (ticks == portMAX_DELAY) {
+    q->cv.wait(lock, ready);
+    return true;
+  }
+  return q->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+}
+}  // namespace
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  HostQueue *q = new HostQueue();
+  q->storage.resize((size_t)length * itemSize);
+  q->itemSize = itemSize;
+  q->length = length;
+  return q;
+}
+
+void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(q->m);
+  if (!queueWait(q, lock, ticks, [&] { return q->count < q->length; })) return pdFAIL;
+  memcpy(&q->storage[((q->head + q->count) % q->length) * q->itemSize], item, q->itemSize);
+  q->count++;
+  queuedWork.fetch_add(1);
+  q->cv.notify_all();
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *out, TickType_t ticks) {
+  if (holdingWork) {
+    holdingWork = false;
+    queuedWork.fetch_sub(1);
+  }
+  std::unique_lock<std::mutex> lock(q->m);
+  if (!queueWait(q, lock, ticks, [&] { return q->count > 0; })) return pdFAIL;
+  if (currentTask) holdingWork = true;
+  else queuedWork.fetch_sub(1);
+  memcpy(out, &q->storage[q->head * q->itemSize], q->itemSize);
+  q->head = (q->head + 1) % q->length;
+  q->count--;
+  q->cv.notify_all();
+  return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+  std::lock_guard<std::mutex> lock(q->m);
+  return (UBaseType_t)q->count;
+}
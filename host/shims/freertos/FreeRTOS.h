@@ -0,0 +1,38 @@
+#pragma once
+
+// Host shim for the subset of ESP-IDF FreeRTOS used by the firmware.
+// Tasks run as std::threads; a task deleted by another task unwinds the next
+// time it reaches a scheduling point (vTaskDelay/taskYIELD), which mirrors
+// where FreeRTOS would have switched it out. portMUX critical sections are
+// recursive mutexes.
+
+#include <cstdint>
+#include <mutex>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configMAX_PRIORITIES 25
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+struct portMUX_TYPE {
+  std::recursive_mutex m;
+};
+#define portMUX_INITIALIZER_UNLOCKED {}
+
+void host_port_enter_critical(portMUX_TYPE *mux);
+void host_port_exit_critical(portMUX_TYPE *mux);
+#define portENTER_CRITICAL(mux) host_port_enter_critical(mux)
+#define portEXIT_CRITICAL(mux) host_port_exit_critical(mux)
+#define portENTER_CRITICAL_ISR(mux) host_port_enter_critical(mux)
+#define portEXIT_CRITICAL_ISR(mux) host_port_exit_critical(mux)
+#define taskENTER_CRITICAL(mux) host_port_enter_critical(mux)
+#define taskEXIT_CRITICAL(mux) host_port_exit_critical(mux)
@@ -0,0 +1,19 @@
+#pragma once
+
+// Host shim for FreeRTOS event groups. A wait that times out advances the
+// virtual clock by the timeout (like delay()), unless SHARKOS_HOST_REALTIME=1,
+// in which case it blocks on a condition variable until a bit is set.
+
+#include "FreeRTOS.h"
+
+typedef uint32_t EventBits_t;
+struct HostEventGroup;
+typedef HostEventGroup *EventGroupHandle_t;
+
+EventGroupHandle_t xEventGroupCreate();
+void vEventGroupDelete(EventGroupHandle_t group);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks);
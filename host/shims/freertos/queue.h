@@ -0,0 +1,18 @@
+#pragma once
+
+// Host shim for FreeRTOS queues: fixed-size items copied in and out of a
+// preallocated ring. Blocking sends/receives wait on a condition variable in
+// real time (queues are only waited on by background tasks).
+
+#include "FreeRTOS.h"
+
+struct HostQueue;
+typedef HostQueue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *out, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+#define xQueueSendToBack(q, item, ticks) xQueueSend(q, item, ticks)
@@ -0,0 +1,150 @@
+// Out-of-line parts of the host peripheral shims (SPI, BLE, WiFi, NFC, IR).
+
+#include <Adafruit_PN532.h>
+#include <Arduino.h>
+#include <BLEDevice.h>
+#include <IRremote.h>
+#include <SPI.h>
+#include <Update.h>
+#include <WiFi.h>
+#include <Wire.h>
+
+// --- SPI ----------------------------------------------------------------
+
+SPIClass SPI(FSPI);
+
+static void spiCsListener(void *ctx, uint8_t pin, uint8_t val) {
+  (void)pin;
+  ((HostSpiDevice *)ctx)->select(val == LOW);
+}
+
+void SPIClass::attach(uint8_t cs, HostSpiDevice *dev) {
+  if (count_ >= MAX_DEVICES) return;
+  cs_[count_] = cs;
+  dev_[count_] = dev;
+  ++count_;
+  host_gpio_listen(cs, spiCsListener, dev);
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+  ++bytes_;
+  for (int i = 0; i < count_; ++i) {
+    if (host_gpio_level(cs_[i]) == LOW) return dev_[i]->transfer(data);
+  }
+  return 0xFF;  // nothing selected: bus floats high
+}
+
+// --- BLE ----------------------------------------------------------------
+
+uint16_t BLEDevice::mtu_ = 23;
+static BLECharacteristic::notify_observer_t notifyObserver = nullptr;
+
+void BLECharacteristic::setNotifyObserver(notify_observer_t fn) { notifyObserver = fn; }
+
+void BLECharacteristic::notify(bool isNotification) {
+  (void)isNotification;
+  ++notifyCount_;
+  notifyBytes_ += value_.size();
+  if (notifyObserver) notifyObserver(this, (const uint8_t *)value_.data(), value_.size());
+}
+
+BLECharacteristic *BLEService::createCharacteristic(const char *uuid, uint32_t props) {
+  BLECharacteristic *c = new BLECharacteristic(uuid, props);
+  chars_.push_back(c);
+  return c;
+}
+
+BLEServer *BLEDevice::createServer() { return new BLEServer(); }
+
+BLEAdvertising *BLEDevice::getAdvertising() {
+  static BLEAdvertising adv;
+  return &adv;
+}
+
+BLEScan *BLEDevice::getScan() {
+  static BLEScan scan;
+  return &scan;
+}
+
+void host_ble_client_write(BLECharacteristic *c, const String &value) {
+  if (!c) return;
+  c->setValue(value);
+  if (c->getCallbacks()) c->getCallbacks()->onWrite(c);
+}
+
+void host_ble_client_write(BLECharacteristic *c, const uint8_t *data, size_t len) {
+  if (!c) return;
+  c->setValue(data, len);
+  if (c->getCallbacks()) c->getCallbacks()->onWrite(c);
+}
+
+void host_ble_connect(BLEServer *server) {
+  if (!server) return;
+  server->setConnected(1);
+  if (server->getCallbacks()) server->getCallbacks()->onConnect(server);
+}
+
+void host_ble_disconnect(BLEServer *server) {
+  if (!server) return;
+  server->setConnected(0);
+  if (server->getCallbacks()) server->getCallbacks()->onDisconnect(server);
+}
+
+void host_ble_set_mtu(BLEServer *server, uint16_t mtu) {
+  if (!server || !server->getCallbacks()) return;
+  esp_ble_gatts_cb_param_t param = {};
+  param.mtu.mtu = mtu;
+  server->getCallbacks()->onMtuChanged(server, &param);
+}
+
+// --- WiFi ---------------------------------------------------------------
+
+WiFiClass WiFi;
+
+struct FakeNetwork {
+  const char *ssid;
+  const char *bssid;
+  int32_t rssi;
+  int32_t channel;
+  wifi_auth_mode_t auth;
+};
+
+static const FakeNetwork fakeNetworks[] = {
+  {"home-2g", "aa:bb:cc:00:00:01", -48, 1, WIFI_AUTH_WPA2_PSK},
+  {"home-2g", "aa:bb:cc:00:00:02", -71, 6, WIFI_AUTH_WPA2_PSK},
+  {"coffee-guest", "aa:bb:cc:00:00:03", -64, 6, WIFI_AUTH_OPEN},
+  {"printer-direct", "aa:bb:cc:00:00:04", -80, 11, WIFI_AUTH_WPA_WPA2_PSK},
+  {"office", "aa:bb:cc:00:00:05", -57, 11, WIFI_AUTH_WPA3_PSK},
+};
+static const int fakeNetworkCount = sizeof(fakeNetworks) / sizeof(fakeNetworks[0]);
+
+int16_t WiFiClass::scanNetworks(bool async, bool show_hidden, bool passive, uint32_t max_ms_per_chan, uint8_t channel) {
+  (void)async; (void)show_hidden; (void)passive; (void)max_ms_per_chan; (void)channel;
+  mode_ = WIFI_MODE_STA;
+  scanned_ = (int16_t)fakeNetworkCount;
+  return scanned_;
+}
+
+String WiFiClass::SSID(uint8_t i) { return i < fakeNetworkCount ? String(fakeNetworks[i].ssid) : String(); }
+int32_t WiFiClass::RSSI(uint8_t i) { return i < fakeNetworkCount ? fakeNetworks[i].rssi : 0; }
+String WiFiClass::BSSIDstr(uint8_t i) { return i < fakeNetworkCount ? String(fakeNetworks[i].bssid) : String(); }
+int32_t WiFiClass::channel(uint8_t i) { return i < fakeNetworkCount ? fakeNetworks[i].channel : 0; }
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t i) { return i < fakeNetworkCount ? fakeNetworks[i].auth : WIFI_AUTH_OPEN; }
+
+// --- NFC / IR / misc ----------------------------------------------------
+
+static bool pn532Present = true;
+static unsigned long pn532Queries = 0;
+
+uint32_t Adafruit_PN532::getFirmwareVersion() {
+  ++pn532Queries;
+  return pn532Present ? 0x32010607UL : 0;
+}
+
+void Adafruit_PN532::setPresent(bool present) { pn532Present = present; }
+unsigned long Adafruit_PN532::firmwareQueries() { return pn532Queries; }
+
+TwoWire Wire(0);
+IRrecv IrReceiver(0);
+IRsend IrSender(0);
+UpdateClass Update;
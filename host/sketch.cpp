@@ -0,0 +1,20 @@
+// Host build of the firmware sketch.
+//
+// arduino-cli concatenates main.ino followed by the remaining .ino files in
+// alphabetical order into one translation unit and generates prototypes for
+// every function. This file reproduces that for the subset of the sketch the
+// host build covers, so file-static state and call order match the device.
+
+#include "sketch_prototypes.h"
+
+#include "main.ino"
+#include "ble_link.ino"
+#include "bus_workers.ino"
+#include "check-sys-devices.ino"
+#include "events.ino"
+#include "hardware-utils.ino"
+#include "psram_alloc.ino"
+#include "serial_link.ino"
+#include "subghz_control.ino"
+#include "telemetry.ino"
+#include "wifi-scanning.ino"
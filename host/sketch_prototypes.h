@@ -0,0 +1,16 @@
+#pragma once
+
+// Prototypes arduino-cli would auto-generate for functions that are called
+// before their definition in the concatenated sketch (see sketch.cpp).
+
+#include "globals.h"
+
+String performCc1101TestDetailed();
+bool performCc1101Test();
+bool cc1101Connected();
+bool cc1101_2Connected();
+void initTransceivers();
+void runTransceiverPollTasks();
+void events_enqueue_radio_bytes_at(int module, const uint8_t* data, size_t len, float frequency_mhz, int32_t rssi,
+                                   uint64_t timestamp_ms);
+void cc1101ReadAsync();
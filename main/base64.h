@@ -0,0 +1,104 @@
+#pragma once
+
+// Base64 (RFC 4648, standard alphabet, '=' padding) into and out of caller
+// buffers. Both directions are table driven and move a whole group per step,
+// 3 bytes -> 4 chars on encode and 4 chars -> 3 bytes on decode, with the
+// partial group handled once at the end. Nothing allocates, so the encoder
+// can write straight into an output frame (e.g. after the "PROTO:" prefix of
+// a telemetry line). host/bench_base64.cpp checks it against the String
+// encoder it replaced.
+
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const size_t BASE64_INVALID = (size_t)-1;
+
+constexpr size_t base64_encoded_len(size_t len) { return 4 * ((len + 2) / 3); }
+// Upper bound; padding makes the real length up to two bytes shorter.
+constexpr size_t base64_decoded_max(size_t len) { return 3 * ((len + 3) / 4); }
+
+// Character -> 6-bit value, 0x80 for anything outside the alphabet.
+struct Base64DecodeTable {
+  uint8_t v[256];
+};
+
+constexpr Base64DecodeTable base64_build_decode_table() {
+  Base64DecodeTable t{};
+  for (int i = 0; i < 256; ++i) t.v[i] = 0x80;
+  for (int i = 0; i < 64; ++i) t.v[(uint8_t)BASE64_ALPHABET[i]] = (uint8_t)i;
+  return t;
+}
+
+static constexpr Base64DecodeTable BASE64_DECODE = base64_build_decode_table();
+
+// Encode `len` bytes into `out`, which must hold base64_encoded_len(len)
+// chars (no terminator is written). Returns the number of chars written.
+static inline size_t base64_encode_to(const uint8_t *data, size_t len, char *out) {
+  char *o = out;
+  size_t i = 0;
+  for (; i + 3 <= len; i += 3) {
+    uint32_t g = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+    o[0] = BASE64_ALPHABET[g >> 18];
+    o[1] = BASE64_ALPHABET[(g >> 12) & 0x3F];
+    o[2] = BASE64_ALPHABET[(g >> 6) & 0x3F];
+    o[3] = BASE64_ALPHABET[g & 0x3F];
+    o += 4;
+  }
+  size_t rest = len - i;
+  if (rest > 0) {
+    uint32_t g = (uint32_t)data[i] << 16;
+    if (rest == 2) g |= (uint32_t)data[i + 1] << 8;
+    o[0] = BASE64_ALPHABET[g >> 18];
+    o[1] = BASE64_ALPHABET[(g >> 12) & 0x3F];
+    o[2] = rest == 2 ? BASE64_ALPHABET[(g >> 6) & 0x3F] : '=';
+    o[3] = '=';
+    o += 4;
+  }
+  return (size_t)(o - out);
+}
+
+// Decode `len` chars into `out` (capacity `cap`). Padding is optional, so
+// input whose '=' was stripped in transit decodes too, but padded input must
+// be whole groups. Returns the number of bytes written, or BASE64_INVALID on
+// a character outside the alphabet ('=' included, except as padding), an
+// impossible length or too small a buffer.
+static inline size_t base64_decode_to(const char *in, size_t len, uint8_t *out, size_t cap) {
+  if (len >= 1 && in[len - 1] == '=') {
+    if (len % 4 != 0) return BASE64_INVALID;
+    --len;
+    if (in[len - 1] == '=') --len;
+  }
+  size_t rest = len % 4;
+  if (rest == 1) return BASE64_INVALID;
+  size_t full = len - rest;
+  size_t need = full / 4 * 3 + (rest ? rest - 1 : 0);
+  if (need > cap) return BASE64_INVALID;
+
+  const uint8_t *s = (const uint8_t *)in;
+  uint8_t *o = out;
+  for (size_t i = 0; i < full; i += 4) {
+    uint8_t a = BASE64_DECODE.v[s[i]], b = BASE64_DECODE.v[s[i + 1]];
+    uint8_t c = BASE64_DECODE.v[s[i + 2]], d = BASE64_DECODE.v[s[i + 3]];
+    if ((a | b | c | d) & 0x80) return BASE64_INVALID;
+    uint32_t g = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | d;
+    o[0] = (uint8_t)(g >> 16);
+    o[1] = (uint8_t)(g >> 8);
+    o[2] = (uint8_t)g;
+    o += 3;
+  }
+  if (rest) {
+    uint8_t a = BASE64_DECODE.v[s[full]], b = BASE64_DECODE.v[s[full + 1]];
+    uint8_t c = rest == 3 ? BASE64_DECODE.v[s[full + 2]] : 0;
+    if ((a | b | c) & 0x80) return BASE64_INVALID;
+    uint32_t g = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6);
+    *o++ = (uint8_t)(g >> 16);
+    if (rest == 3) *o++ = (uint8_t)(g >> 8);
+  }
+  return (size_t)(o - out);
+}
+
+#endif // BASE64_H
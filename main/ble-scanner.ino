@@ -14,7 +14,7 @@ class blescanner_AdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks
       if (mData.length() >= 2) {
         char buffer[10];
         sprintf(buffer, "0x%02X%02X", (uint8_t)mData[1], (uint8_t)mData[0]);
-        dev.manufacturer = String(buffer);
+        dev.manufacturer = buffer;
       } else {
         dev.manufacturer = "unknown";
       }
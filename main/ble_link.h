@@ -0,0 +1,89 @@
+#pragma once
+
+// Notification framer for the BLE status characteristic. Everything the
+// firmware notifies (notifyStatus() text/JSON, telemetry protobuf frames)
+// goes through ble_link_send().
+//
+// By default each message is one notification, as before; anything longer
+// than the ATT payload (MTU - 3) is cut off by the stack. A client that
+// sends `ble.link` with {"framing":true} gets framed notifications instead,
+// sized to the negotiated MTU:
+//
+//   notification := 0xFB  seq:u8  record+
+//   record       := hdr:u16le  bytes[hdr & 0x3FFF]
+//
+// hdr bit 14 (BLE_LINK_MORE) means the message continues in the next record
+// and bit 15 (BLE_LINK_CONT) means this record continues the previous one,
+// so a whole message is a record with neither bit set. Small messages are
+// coalesced into one notification until it is full or the main loop is
+// about to sleep (ble_link_flush()). Large ones are split across
+// notifications. `seq` increments per notification so a reassembler can
+// tell it lost one and drop the partial message. Legacy messages never
+// start with 0xFB (they are text, JSON or 0xAA 0x55 frames), so a client
+// can accept both forms on the same characteristic.
+//
+// With {"compress":true} (which implies framing) every message is
+// compressed against the ones before it (lzss.h) and carried as
+//
+//   message := kind:u8  lzss-message
+//
+// kind BLE_LINK_LZ_RESET clears the window before decoding, BLE_LINK_LZ
+// continues it. The window is cleared on the first message after the switch
+// and then every BLE_LINK_LZ_RESET_BYTES of input, so a client that lost a
+// notification (a seq gap) drops messages until the next reset and
+// resynchronises. Compression runs on the main loop; BleLinkStats reports
+// bytes in/out and the time spent, so a client can tell whether it pays off
+// for what it subscribes to and switch it off again.
+//
+// host/ble_link_reassembler.h is the reference reassembler and
+// decompressor.
+
+#ifndef BLE_LINK_H
+#define BLE_LINK_H
+
+#include <Arduino.h>
+
+static const uint8_t BLE_LINK_MAGIC = 0xFB;
+static const size_t BLE_LINK_HEADER = 2;          // magic + seq
+static const size_t BLE_LINK_RECORD_HEADER = 2;
+static const uint16_t BLE_LINK_LEN_MASK = 0x3FFF;
+static const uint16_t BLE_LINK_MORE = 0x4000;
+static const uint16_t BLE_LINK_CONT = 0x8000;
+static const uint16_t BLE_LINK_DEFAULT_MTU = 23;  // until the client negotiates
+static const size_t BLE_LINK_MAX_PAYLOAD = 512;   // largest attribute value (ATT)
+static const uint8_t BLE_LINK_LZ = 0x01;
+static const uint8_t BLE_LINK_LZ_RESET = 0x02;
+static const uint32_t BLE_LINK_LZ_RESET_BYTES = 16384;
+
+struct BleLinkStats {
+  uint32_t messages;       // ble_link_send() calls
+  uint32_t notifies;
+  uint32_t fragmented;     // messages split across notifications
+  uint32_t coalesced;      // notifications carrying more than one record
+  uint32_t payloadBytes;   // message bytes
+  uint32_t wireBytes;      // notification bytes, framing included
+  uint32_t lzMessages;     // messages sent compressed
+  uint32_t lzInBytes;      // their size before compression
+  uint32_t lzOutBytes;     // after (kind byte included, framing not)
+  uint32_t lzMicros;       // time spent compressing and framing them
+};
+
+// New or dropped connection: back to the default MTU, framing and
+// compression off, any pending notification discarded. Safe from the BLE host task; applied by
+// the main loop.
+void ble_link_reset();
+
+// Negotiated ATT MTU (ServerCallbacks::onMtuChanged). Safe from any task.
+void ble_link_set_mtu(uint16_t mtu);
+uint16_t ble_link_mtu();
+
+// Main loop only.
+void ble_link_set_framing(bool on);   // off also turns compression off
+bool ble_link_framing();
+void ble_link_set_compress(bool on);  // on also turns framing on
+bool ble_link_compress();
+void ble_link_send(const uint8_t *data, size_t len);
+void ble_link_flush();
+void ble_link_stats(BleLinkStats &out);
+
+#endif // BLE_LINK_H
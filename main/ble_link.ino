@@ -0,0 +1,190 @@
+#include "globals.h"
+#include "ble_link.h"
+#include "lzss.h"
+
+#include <atomic>
+
+static std::atomic<uint16_t> bleLinkMtu{BLE_LINK_DEFAULT_MTU};
+static std::atomic<bool> bleLinkResetRequested{false};
+static bool bleLinkFraming = false;
+static bool bleLinkCompress = false;
+static uint8_t bleLinkSeq = 0;
+static uint8_t bleLinkPending[BLE_LINK_MAX_PAYLOAD];
+static size_t bleLinkPendingLen = 0;        // 0: no notification open
+static uint8_t bleLinkPendingRecords = 0;
+static size_t bleLinkCap = 0;               // notification size for the message being written
+static size_t bleLinkRecordAt = 0;          // header offset of the open record; 0: none
+static uint8_t bleLinkMsgRecords = 0;       // records of the message being written so far
+static LzssEncoder bleLinkLz;
+static uint32_t bleLinkLzSinceReset = 0;    // message bytes compressed since the window was cleared
+static BleLinkStats bleLinkStats;
+
+void ble_link_reset() {
+  bleLinkMtu.store(BLE_LINK_DEFAULT_MTU, std::memory_order_relaxed);
+  bleLinkResetRequested.store(true, std::memory_order_release);
+}
+
+void ble_link_set_mtu(uint16_t mtu) { bleLinkMtu.store(mtu, std::memory_order_relaxed); }
+
+uint16_t ble_link_mtu() { return bleLinkMtu.load(std::memory_order_relaxed); }
+
+static void ble_link_apply_reset() {
+  if (!bleLinkResetRequested.exchange(false, std::memory_order_acquire)) return;
+  bleLinkFraming = false;
+  bleLinkCompress = false;
+  bleLinkSeq = 0;
+  bleLinkPendingLen = 0;
+  bleLinkPendingRecords = 0;
+}
+
+// ATT notification payload for the current MTU.
+static size_t ble_link_capacity() {
+  size_t mtu = ble_link_mtu();
+  size_t cap = mtu > 3 ? mtu - 3 : 0;
+  if (cap > BLE_LINK_MAX_PAYLOAD) cap = BLE_LINK_MAX_PAYLOAD;
+  // room for the headers and at least one byte of message
+  if (cap < BLE_LINK_HEADER + BLE_LINK_RECORD_HEADER + 1) cap = BLE_LINK_HEADER + BLE_LINK_RECORD_HEADER + 1;
+  return cap;
+}
+
+static void ble_link_notify(const uint8_t *data, size_t len) {
+  bleLinkStats.notifies++;
+  bleLinkStats.wireBytes += len;
+  if (!pStatusChar) return;
+  pStatusChar->setValue((uint8_t *)data, len);
+  pStatusChar->notify();
+}
+
+static void ble_link_send_pending() {
+  if (bleLinkPendingLen == 0) return;
+  if (bleLinkPendingRecords > 1) bleLinkStats.coalesced++;
+  ble_link_notify(bleLinkPending, bleLinkPendingLen);
+  bleLinkPendingLen = 0;
+  bleLinkPendingRecords = 0;
+}
+
+void ble_link_flush() {
+  ble_link_apply_reset();
+  ble_link_send_pending();
+}
+
+void ble_link_set_framing(bool on) {
+  ble_link_flush();
+  bleLinkFraming = on;
+  if (!on) bleLinkCompress = false;
+}
+
+bool ble_link_framing() { return bleLinkFraming; }
+
+void ble_link_set_compress(bool on) {
+  ble_link_flush();
+  if (on) bleLinkFraming = true;
+  bleLinkCompress = on;
+  bleLinkLzSinceReset = BLE_LINK_LZ_RESET_BYTES;  // the first message starts a fresh window
+}
+
+bool ble_link_compress() { return bleLinkCompress; }
+
+// --- framing: one message is written as begin, any number of writes, end ---
+
+// Start a message of (at most) `hint` bytes. A message that would fit a
+// notification of its own is not split across the tail of the pending one.
+static void ble_link_begin(size_t hint) {
+  bleLinkCap = ble_link_capacity();
+  bleLinkMsgRecords = 0;
+  if (bleLinkPendingLen == 0) return;
+  size_t room = bleLinkCap > bleLinkPendingLen ? bleLinkCap - bleLinkPendingLen : 0;
+  bool fitsFresh = hint <= bleLinkCap - BLE_LINK_HEADER - BLE_LINK_RECORD_HEADER;
+  if (room <= BLE_LINK_RECORD_HEADER || (fitsFresh && hint > room - BLE_LINK_RECORD_HEADER)) ble_link_send_pending();
+}
+
+// Open a record for the current message, in a notification with room for
+// its header and at least one byte.
+static void ble_link_open_record() {
+  if (bleLinkPendingLen > 0 && bleLinkPendingLen + BLE_LINK_RECORD_HEADER >= bleLinkCap) ble_link_send_pending();
+  if (bleLinkPendingLen == 0) {
+    bleLinkPending[0] = BLE_LINK_MAGIC;
+    bleLinkPending[1] = bleLinkSeq++;
+    bleLinkPendingLen = BLE_LINK_HEADER;
+  }
+  bleLinkRecordAt = bleLinkPendingLen;
+  bleLinkPendingLen += BLE_LINK_RECORD_HEADER;
+  bleLinkMsgRecords++;
+}
+
+// The record header is written once its length is known.
+static void ble_link_close_record(bool more) {
+  uint16_t hdr = (uint16_t)(bleLinkPendingLen - bleLinkRecordAt - BLE_LINK_RECORD_HEADER);
+  if (bleLinkMsgRecords > 1) hdr |= BLE_LINK_CONT;
+  if (more) hdr |= BLE_LINK_MORE;
+  bleLinkPending[bleLinkRecordAt] = (uint8_t)(hdr & 0xFF);
+  bleLinkPending[bleLinkRecordAt + 1] = (uint8_t)(hdr >> 8);
+  bleLinkRecordAt = 0;
+  bleLinkPendingRecords++;
+}
+
+static void ble_link_write(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    if (bleLinkRecordAt == 0) {
+      ble_link_open_record();
+    } else if (bleLinkPendingLen == bleLinkCap) {
+      // full, and the message goes on
+      ble_link_close_record(true);
+      ble_link_send_pending();
+      continue;
+    }
+    size_t take = bleLinkCap - bleLinkPendingLen;
+    if (take > len) take = len;
+    memcpy(bleLinkPending + bleLinkPendingLen, data, take);
+    bleLinkPendingLen += take;
+    data += take;
+    len -= take;
+  }
+}
+
+static void ble_link_end() {
+  if (bleLinkRecordAt == 0) ble_link_open_record();  // empty message
+  ble_link_close_record(false);
+  if (bleLinkMsgRecords > 1) bleLinkStats.fragmented++;
+  if (bleLinkCap - bleLinkPendingLen <= BLE_LINK_RECORD_HEADER) ble_link_send_pending();
+}
+
+static void ble_link_lz_sink(void *ctx, const uint8_t *data, size_t len) {
+  (void)ctx;
+  ble_link_write(data, len);
+}
+
+void ble_link_send(const uint8_t *data, size_t len) {
+  ble_link_apply_reset();
+  bleLinkStats.messages++;
+  bleLinkStats.payloadBytes += len;
+  if (!bleLinkFraming) {
+    ble_link_notify(data, len);
+    return;
+  }
+  if (!bleLinkCompress) {
+    ble_link_begin(len);
+    ble_link_write(data, len);
+    ble_link_end();
+    return;
+  }
+
+  uint32_t t0 = micros();
+  uint8_t kind = BLE_LINK_LZ;
+  if (bleLinkLzSinceReset >= BLE_LINK_LZ_RESET_BYTES) {
+    bleLinkLz.reset();
+    bleLinkLzSinceReset = 0;
+    kind = BLE_LINK_LZ_RESET;
+  }
+  bleLinkLzSinceReset += len;
+  ble_link_begin(1 + lzss_bound(len));
+  ble_link_write(&kind, 1);
+  size_t out = bleLinkLz.compress(data, len, ble_link_lz_sink, nullptr);
+  ble_link_end();
+  bleLinkStats.lzMessages++;
+  bleLinkStats.lzInBytes += len;
+  bleLinkStats.lzOutBytes += 1 + out;
+  bleLinkStats.lzMicros += micros() - t0;
+}
+
+void ble_link_stats(BleLinkStats &out) { out = bleLinkStats; }
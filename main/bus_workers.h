@@ -0,0 +1,63 @@
+#pragma once
+
+// Per-SPI-bus radio workers. Each bus gets one persistent FreeRTOS task,
+// pinned to BUS_WORKER_CORE, that owns the bus and runs radio work submitted
+// through its queue. CC1101 #1 (FSPI) and CC1101 #2 (HSPI) can therefore
+// sweep in parallel while the main loop stays free for BLE and dispatch.
+//
+// Ownership rule: work is only ever submitted from the main loop, and while
+// a bus has work queued or running (bus_worker_busy) nothing on the main
+// loop touches that bus. The job scheduler in events.ino enforces this for
+// background jobs through their declared resources.
+//
+// Workers never touch the BLE stack or the telemetry sink. Samples and sweep
+// chunks they produce go through radio_sample_emit() / radio_sweep_emit()
+// into per-worker rings that the main loop publishes with
+// bus_workers_publish().
+
+#ifndef BUS_WORKERS_H
+#define BUS_WORKERS_H
+
+#include <Arduino.h>
+#include "telemetry.h"
+
+// Core the bus workers are pinned to. The Arduino loop runs on core 1.
+#ifndef BUS_WORKER_CORE
+#define BUS_WORKER_CORE 0
+#endif
+
+enum SpiBus : uint8_t {
+  SPI_BUS_FSPI = 0,   // SPI2: CC1101 #1, nRF24, LoRa
+  SPI_BUS_HSPI,       // SPI3: CC1101 #2
+  SPI_BUS_COUNT
+};
+
+typedef void (*BusWorkFn)(void *arg);
+
+// Create the worker tasks. Call once from setup() after the radios exist.
+void bus_workers_init();
+
+// Queue `fn(arg)` on the bus worker. Main loop only. Returns false if the
+// workers are not running or the bus queue is full.
+bool bus_worker_submit(SpiBus bus, BusWorkFn fn, void *arg);
+
+// True while work submitted to `bus` is queued or running.
+bool bus_worker_busy(SpiBus bus);
+
+// Block the caller until `bus` has no queued or running work.
+void bus_worker_wait_idle(SpiBus bus);
+
+// Forward samples produced by the workers to the telemetry sink.
+// Main loop only; called from events_process_one().
+void bus_workers_publish();
+
+// Report a radio sample. On a bus worker it is queued for the main loop;
+// anywhere else it goes to the telemetry sink directly.
+void radio_sample_emit(int module, const uint8_t *data, size_t len, float frequency_mhz, int32_t rssi,
+                       const char *extra);
+
+// Report a sweep chunk (telemetry_publish_sweep()). Same threading rules as
+// radio_sample_emit().
+void radio_sweep_emit(const RadioSweepChunk &chunk);
+
+#endif // BUS_WORKERS_H
@@ -0,0 +1,191 @@
+#include "globals.h"
+#include "bus_workers.h"
+#include "events.h"
+
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+static const UBaseType_t BUS_WORK_QUEUE_LEN = 4;
+static const UBaseType_t BUS_WORKER_PRIORITY = 2;       // above the Arduino loop (1)
+static const uint32_t BUS_WORKER_STACK = 4 * 1024;
+static const uint32_t BUS_SAMPLE_RING_SIZE = 64;        // power of two
+static const size_t BUS_SAMPLE_MAX_LEN = 16;            // scan_range samples are 7 bytes
+static const uint32_t BUS_SWEEP_RING_SIZE = 4;          // power of two
+static const int BUS_SAMPLE_FULL_WAIT_MS = 50;          // then the sample is dropped
+static_assert((BUS_SAMPLE_RING_SIZE & (BUS_SAMPLE_RING_SIZE - 1)) == 0, "BUS_SAMPLE_RING_SIZE must be a power of two");
+
+struct BusWork {
+  BusWorkFn fn;
+  void *arg;
+};
+
+struct BusSample {
+  uint64_t timestampMs;        // millis() on the worker when the sample was taken
+  float frequencyMhz;
+  int32_t rssi;
+  int8_t module;
+  uint8_t len;
+  const char *extra;           // string literal, e.g. "scan_range"
+  uint8_t data[BUS_SAMPLE_MAX_LEN];
+};
+
+// Samples go worker -> main loop through a single-producer/single-consumer
+// ring, the same scheme as the BLE command rings in events.ino.
+struct BusWorker {
+  const char *name;
+  TaskHandle_t task;
+  QueueHandle_t queue;
+  std::atomic<uint32_t> pending{0};          // submitted, not yet finished
+  std::atomic<uint32_t> sampleHead{0};       // main loop
+  std::atomic<uint32_t> sampleTail{0};       // worker
+  std::atomic<uint32_t> samplesDropped{0};
+  uint32_t samplesDroppedReported;           // main loop
+  BusSample samples[BUS_SAMPLE_RING_SIZE];
+  std::atomic<uint32_t> sweepHead{0};        // main loop
+  std::atomic<uint32_t> sweepTail{0};        // worker
+  RadioSweepChunk sweeps[BUS_SWEEP_RING_SIZE];
+};
+
+static BusWorker busWorkers[SPI_BUS_COUNT] = {{"spi_fspi"}, {"spi_hspi"}};
+
+static void bus_worker_task(void *param) {
+  BusWorker &w = *(BusWorker *)param;
+  BusWork work;
+  for (;;) {
+    if (xQueueReceive(w.queue, &work, portMAX_DELAY) != pdPASS) continue;
+    work.fn(work.arg);
+    w.pending.fetch_sub(1, std::memory_order_release);
+    // publish what the work produced and let jobs waiting on this bus run
+    events_wake();
+  }
+}
+
+void bus_workers_init() {
+  for (int i = 0; i < SPI_BUS_COUNT; ++i) {
+    BusWorker &w = busWorkers[i];
+    if (w.queue != NULL) continue;
+    w.queue = xQueueCreate(BUS_WORK_QUEUE_LEN, sizeof(BusWork));
+    if (w.queue == NULL) {
+      Serial.printf("bus_workers: queue for %s failed\n", w.name);
+      continue;
+    }
+    if (xTaskCreatePinnedToCore(bus_worker_task, w.name, BUS_WORKER_STACK, &w, BUS_WORKER_PRIORITY, &w.task,
+                                BUS_WORKER_CORE) != pdPASS) {
+      Serial.printf("bus_workers: task %s failed\n", w.name);
+      vQueueDelete(w.queue);
+      w.queue = NULL;
+      w.task = NULL;
+    }
+  }
+}
+
+bool bus_worker_submit(SpiBus bus, BusWorkFn fn, void *arg) {
+  BusWorker &w = busWorkers[bus];
+  if (w.queue == NULL) return false;
+  BusWork work = {fn, arg};
+  w.pending.fetch_add(1, std::memory_order_relaxed);
+  if (xQueueSend(w.queue, &work, 0) != pdPASS) {
+    w.pending.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+bool bus_worker_busy(SpiBus bus) { return busWorkers[bus].pending.load(std::memory_order_acquire) != 0; }
+
+void bus_worker_wait_idle(SpiBus bus) {
+  while (bus_worker_busy(bus)) {
+    // keep draining so a worker blocked on a full sample ring can finish
+    bus_workers_publish();
+    delay(1);
+  }
+}
+
+static BusWorker *bus_worker_self() {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  for (int i = 0; i < SPI_BUS_COUNT; ++i) {
+    if (busWorkers[i].task != NULL && busWorkers[i].task == self) return &busWorkers[i];
+  }
+  return nullptr;
+}
+
+// Ring full: give the main loop a moment to drain rather than lose the
+// item. False once BUS_SAMPLE_FULL_WAIT_MS has passed.
+static bool bus_worker_wait_space(const std::atomic<uint32_t> &head, uint32_t tail, uint32_t size) {
+  for (int waited = 0; tail - head.load(std::memory_order_acquire) >= size; ++waited) {
+    if (waited >= BUS_SAMPLE_FULL_WAIT_MS) return false;
+    events_wake();
+    vTaskDelay(1);
+  }
+  return true;
+}
+
+void radio_sample_emit(int module, const uint8_t *data, size_t len, float frequency_mhz, int32_t rssi,
+                       const char *extra) {
+  BusWorker *w = bus_worker_self();
+  if (!w) {
+    telemetry_publish(telemetry_sample(module, frequency_mhz, rssi, data, len, extra));
+    return;
+  }
+
+  uint32_t tail = w->sampleTail.load(std::memory_order_relaxed);
+  if (len > BUS_SAMPLE_MAX_LEN || !bus_worker_wait_space(w->sampleHead, tail, BUS_SAMPLE_RING_SIZE)) {
+    w->samplesDropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  BusSample &s = w->samples[tail & (BUS_SAMPLE_RING_SIZE - 1)];
+  s.timestampMs = (uint64_t)millis();
+  s.frequencyMhz = frequency_mhz;
+  s.rssi = rssi;
+  s.module = (int8_t)module;
+  s.len = (uint8_t)len;
+  s.extra = extra;
+  memcpy(s.data, data, len);
+  w->sampleTail.store(tail + 1, std::memory_order_release);
+  if (tail + 1 - w->sampleHead.load(std::memory_order_relaxed) >= BUS_SAMPLE_RING_SIZE / 2) events_wake();
+}
+
+void radio_sweep_emit(const RadioSweepChunk &chunk) {
+  BusWorker *w = bus_worker_self();
+  if (!w) {
+    telemetry_publish_sweep(chunk);
+    return;
+  }
+  uint32_t tail = w->sweepTail.load(std::memory_order_relaxed);
+  if (!bus_worker_wait_space(w->sweepHead, tail, BUS_SWEEP_RING_SIZE)) {
+    w->samplesDropped.fetch_add(chunk.count, std::memory_order_relaxed);
+    return;
+  }
+  w->sweeps[tail & (BUS_SWEEP_RING_SIZE - 1)] = chunk;
+  w->sweepTail.store(tail + 1, std::memory_order_release);
+  events_wake();
+}
+
+void bus_workers_publish() {
+  for (int i = 0; i < SPI_BUS_COUNT; ++i) {
+    BusWorker &w = busWorkers[i];
+    uint32_t head = w.sampleHead.load(std::memory_order_relaxed);
+    uint32_t tail = w.sampleTail.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      const BusSample &s = w.samples[head & (BUS_SAMPLE_RING_SIZE - 1)];
+      TelemetrySample sample = {s.timestampMs, s.module, s.frequencyMhz, s.rssi, s.data, s.len, s.extra,
+                                s.extra ? strlen(s.extra) : 0};
+      telemetry_publish(sample);
+      w.sampleHead.store(head + 1, std::memory_order_release);
+    }
+    uint32_t sweepHead = w.sweepHead.load(std::memory_order_relaxed);
+    uint32_t sweepTail = w.sweepTail.load(std::memory_order_acquire);
+    for (; sweepHead != sweepTail; ++sweepHead) {
+      telemetry_publish_sweep(w.sweeps[sweepHead & (BUS_SWEEP_RING_SIZE - 1)]);
+      w.sweepHead.store(sweepHead + 1, std::memory_order_release);
+    }
+    uint32_t dropped = w.samplesDropped.load(std::memory_order_relaxed);
+    if (dropped != w.samplesDroppedReported) {
+      Serial.printf("bus_workers: %s dropped %u sample(s)\n", w.name, (unsigned)(dropped - w.samplesDroppedReported));
+      w.samplesDroppedReported = dropped;
+    }
+  }
+}
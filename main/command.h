@@ -0,0 +1,199 @@
+#pragma once
+
+// Typed BLE command. A raw BLE write is decoded exactly once by
+// command_parse() (events.ino) into a Command; validation, LED feedback,
+// pairing and the dispatchers all work from that struct instead of
+// re-parsing the JSON.
+//
+// A Command owns all of its text (correlation id, key, param keys, string
+// values and a protobuf transmit body) in a fixed inline buffer, so it can
+// be built on the stack and copied without touching the heap.
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <Arduino.h>
+#include "commands.h"
+#include "sharkos.pb.h"
+
+enum CommandFormat : uint8_t {
+  COMMAND_FORMAT_INVALID = 0,  // not a known shape (unknown plain text, JSON without a key)
+  COMMAND_FORMAT_PLAIN,        // bare key, e.g. "status.info"
+  COMMAND_FORMAT_JSON,         // {"command":"...","params":{...},"id":"..."}
+  COMMAND_FORMAT_LEGACY,       // {"Command":{"StartRadioScan":{...}}}
+  COMMAND_FORMAT_BATCH,        // {"batch":[<command>,...],"id":"..."}
+  COMMAND_FORMAT_PROTOBUF      // [0xAA 0x55][u16 le length][Command message] (.proto)
+};
+
+// Transmit message carried by a protobuf command.
+enum CommandBodyKind : uint8_t {
+  COMMAND_BODY_NONE = 0,
+  COMMAND_BODY_CC1101_TX,
+  COMMAND_BODY_LORA_TX,
+  COMMAND_BODY_IR_TX
+};
+
+// Sub-command of a legacy {"Command":{...}} message.
+enum LegacyCommandKind : uint8_t {
+  LEGACY_NONE = 0,
+  LEGACY_NOT_OBJECT,           // "Command" is not an object
+  LEGACY_EMPTY,                // "Command":{}
+  LEGACY_UNKNOWN,
+  LEGACY_START_RADIO_SCAN,
+  LEGACY_STOP_RADIO_SCAN,
+  LEGACY_READ_NFC,
+  LEGACY_WRITE_NFC,
+  LEGACY_SEND_IR,
+  LEGACY_GET_STATUS,
+  LEGACY_PAIR
+};
+
+// CommandParamType is declared in commands.h next to the param schemas.
+struct CommandParam {
+  uint16_t key;                // offset into Command::text
+  CommandParamType type;
+  union {
+    bool b;
+    long i;
+    float f;
+    uint16_t s;                // offset into Command::text
+  };
+};
+
+static const uint8_t COMMAND_MAX_PARAMS = 10;
+static const uint16_t COMMAND_TEXT_CAPACITY = 320;
+static const uint16_t COMMAND_NO_TEXT = 0xFFFF;
+// Items accepted in one {"batch":[...]} envelope; longer batches are
+// rejected as overflow.
+static const uint8_t COMMAND_MAX_BATCH = 8;
+
+struct Command {
+  CommandFormat format = COMMAND_FORMAT_INVALID;
+  CommandId id = CMDID_UNKNOWN;          // interned key, or the protobuf command_id
+  LegacyCommandKind legacy = LEGACY_NONE;
+  bool json = false;                     // payload parsed as JSON
+  bool overflow = false;                 // text or param table ran out of space
+  uint8_t paramCount = 0;
+  uint8_t batchCount = 0;                // items in a COMMAND_FORMAT_BATCH envelope
+  uint16_t keyText = COMMAND_NO_TEXT;    // command key / legacy sub-command as received
+  uint16_t correlationText = COMMAND_NO_TEXT;
+  uint16_t textUsed = 0;
+  CommandBodyKind bodyKind = COMMAND_BODY_NONE;
+  uint16_t bodyText = COMMAND_NO_TEXT;   // encoded body, copied into text
+  uint16_t bodyLen = 0;
+  CommandParam params[COMMAND_MAX_PARAMS];
+  char text[COMMAND_TEXT_CAPACITY];
+
+  void reset() {
+    format = COMMAND_FORMAT_INVALID;
+    id = CMDID_UNKNOWN;
+    legacy = LEGACY_NONE;
+    json = false;
+    overflow = false;
+    paramCount = 0;
+    batchCount = 0;
+    keyText = COMMAND_NO_TEXT;
+    correlationText = COMMAND_NO_TEXT;
+    textUsed = 0;
+    bodyKind = COMMAND_BODY_NONE;
+    bodyText = COMMAND_NO_TEXT;
+    bodyLen = 0;
+  }
+
+  const char *textAt(uint16_t off) const { return off == COMMAND_NO_TEXT ? "" : text + off; }
+  const char *key() const { return textAt(keyText); }
+  // Correlation id from "id" (or "requestId"); empty when absent.
+  const char *correlationId() const { return textAt(correlationText); }
+  bool hasCorrelationId() const { return correlationText != COMMAND_NO_TEXT; }
+
+  const CommandParam *param(const char *name) const {
+    for (uint8_t i = 0; i < paramCount; ++i) {
+      if (strcmp(text + params[i].key, name) == 0) return &params[i];
+    }
+    return nullptr;
+  }
+  bool has(const char *name) const { return param(name) != nullptr; }
+
+  // Numeric accessors convert between int/float/bool the way ArduinoJson's
+  // as<T>() does; strings and missing params yield `def`.
+  long paramInt(const char *name, long def = 0) const {
+    const CommandParam *p = param(name);
+    if (!p) return def;
+    switch (p->type) {
+      case PARAM_INT: return p->i;
+      case PARAM_FLOAT: return (long)p->f;
+      case PARAM_BOOL: return p->b ? 1 : 0;
+      default: return 0;
+    }
+  }
+  float paramFloat(const char *name, float def = 0.0f) const {
+    const CommandParam *p = param(name);
+    if (!p) return def;
+    switch (p->type) {
+      case PARAM_INT: return (float)p->i;
+      case PARAM_FLOAT: return p->f;
+      default: return 0.0f;
+    }
+  }
+  // nullptr when missing or not a string.
+  const char *paramString(const char *name) const {
+    const CommandParam *p = param(name);
+    return (p && p->type == PARAM_STRING) ? text + p->s : nullptr;
+  }
+
+  // Transmit body of a protobuf command. False if the command carries none
+  // of that kind; bytes/string fields of `out` point into this Command.
+  bool bodyCC1101Tx(CC1101Tx_pb &out) const {
+    return bodyKind == COMMAND_BODY_CC1101_TX && pb_decode_CC1101Tx((const uint8_t *)text + bodyText, bodyLen, out);
+  }
+  bool bodyLoraTx(LoraTx_pb &out) const {
+    return bodyKind == COMMAND_BODY_LORA_TX && pb_decode_LoraTx((const uint8_t *)text + bodyText, bodyLen, out);
+  }
+  bool bodyIRTx(IRTx_pb &out) const {
+    return bodyKind == COMMAND_BODY_IR_TX && pb_decode_IRTx((const uint8_t *)text + bodyText, bodyLen, out);
+  }
+
+  // Builders used by the decoders. When the fixed storage is exhausted they
+  // set `overflow` and return COMMAND_NO_TEXT / nullptr.
+  uint16_t addText(const char *s, size_t len) {
+    if (!s || (size_t)textUsed + len + 1 > COMMAND_TEXT_CAPACITY) {
+      overflow = true;
+      return COMMAND_NO_TEXT;
+    }
+    uint16_t off = textUsed;
+    memcpy(text + off, s, len);
+    text[off + len] = 0;
+    textUsed = (uint16_t)(textUsed + len + 1);
+    return off;
+  }
+  CommandParam *addParam(const char *name) { return addParam(name, strlen(name)); }
+  CommandParam *addParam(const char *name, size_t len) {
+    if (paramCount >= COMMAND_MAX_PARAMS) {
+      overflow = true;
+      return nullptr;
+    }
+    uint16_t k = addText(name, len);
+    if (k == COMMAND_NO_TEXT) return nullptr;
+    CommandParam *p = &params[paramCount++];
+    p->key = k;
+    p->type = PARAM_NULL;
+    p->i = 0;
+    return p;
+  }
+};
+
+// Map a command key to its interned id (CMDID_UNKNOWN if not in commands.h).
+CommandId command_intern(const char *key, size_t len);
+
+// Decode `len` bytes of a BLE write into `out`: a framed protobuf Command,
+// JSON or a plain key. Never fails: unrecognised payloads come back with
+// format == COMMAND_FORMAT_INVALID.
+void command_parse(const char *raw, size_t len, Command &out);
+
+// Decode item `index` of the batch envelope most recently passed to
+// command_parse(). The items stay in the parser's scratch document, so this
+// is only valid until the next command_parse() call. Items are plain keys,
+// JSON or legacy commands; a nested batch comes back INVALID.
+void command_parse_batch_item(uint8_t index, Command &out);
+
+#endif // COMMAND_H
@@ -8,124 +8,440 @@
 #ifndef COMMANDS_H
 #define COMMANDS_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
 // BLE scanner
-static const char CMD_BLE_SCAN_START[] = "ble.scan.start";
-static const char CMD_BLE_SCAN_STOP[]  = "ble.scan.stop";
+static constexpr char CMD_BLE_SCAN_START[] = "ble.scan.start";
+static constexpr char CMD_BLE_SCAN_STOP[]  = "ble.scan.stop";
 
 // Wi‑Fi scan / sniffer
-static const char CMD_WIFI_SCAN_START[]    = "wifi.scan.start";
-static const char CMD_WIFI_SCAN_STOP[]     = "wifi.scan.stop";
+static constexpr char CMD_WIFI_SCAN_START[]    = "wifi.scan.start";
+static constexpr char CMD_WIFI_SCAN_STOP[]     = "wifi.scan.stop";
 // visual-only command used by the app; firmware handles it identically to
 // a normal Wi‑Fi scan request.
-static const char CMD_WIFI_CHANNEL_SCAN[]  = "wifi.channel.scan";
-static const char CMD_WIFI_SNIFFER_START[] = "wifi.sniffer.start";
-static const char CMD_WIFI_SNIFFER_STOP[]  = "wifi.sniffer.stop";
+static constexpr char CMD_WIFI_CHANNEL_SCAN[]  = "wifi.channel.scan";
+static constexpr char CMD_WIFI_SNIFFER_START[] = "wifi.sniffer.start";
+static constexpr char CMD_WIFI_SNIFFER_STOP[]  = "wifi.sniffer.stop";
 
 // nRF (2.4GHz)
-static const char CMD_NRF_SCAN_START[] = "nrf.scan.start";
-static const char CMD_NRF_SCAN_STOP[]  = "nrf.scan.stop";
+static constexpr char CMD_NRF_SCAN_START[] = "nrf.scan.start";
+static constexpr char CMD_NRF_SCAN_STOP[]  = "nrf.scan.stop";
 
 // Sub‑GHz (CC1101/LoRa)
-static const char CMD_SUBGHZ_READ_START[] = "subghz.read.start";
-static const char CMD_SUBGHZ_READ_STOP[]  = "subghz.read.stop";
-static const char CMD_SUBGHZ_SET_MOD_ONE[] = "subghz.set.mod.one"; // params: { modulation: string }
-static const char CMD_SUBGHZ_SET_MOD_TWO[] = "subghz.set.mod.two"; // params: { modulation: string }
-static const char CMD_SUBGHZ_SET_TOP_FREQ[] = "subghz.set.top.freq"; // params: { frequency: float }
-static const char CMD_SUBGHZ_SET_BOT_FREQ[] = "subghz.set.bot.freq"; // params: { frequency: float }
-static const char CMD_SUBGHZ_RECORD_START[] = "subghz.record.start";
-static const char CMD_SUBGHZ_RECORD_STOP[]  = "subghz.record.stop";
-static const char CMD_SUBGHZ_PLAYBACK_START[] = "subghz.playback.start";
-static const char CMD_SUBGHZ_PLAYBACK_STOP[]  = "subghz.playback.stop";
-static const char CMD_SUBGHZ_PACKET_SEND[] = "subghz.packet.send";
-static const char CMD_SUBGHZ_DISRUPTOR_START[] = "subghz.disruptor.start";
-static const char CMD_SUBGHZ_DISRUPTOR_STOP[]  = "subghz.disruptor.stop";
-static const char CMD_SUBGHZ_TEST[]             = "subghz.test"; // connection self-test between radio1 and radio2
+static constexpr char CMD_SUBGHZ_READ_START[] = "subghz.read.start";
+static constexpr char CMD_SUBGHZ_READ_STOP[]  = "subghz.read.stop";
+static constexpr char CMD_SUBGHZ_SET_MOD_ONE[] = "subghz.set.mod.one"; // params: { modulation: string }
+static constexpr char CMD_SUBGHZ_SET_MOD_TWO[] = "subghz.set.mod.two"; // params: { modulation: string }
+static constexpr char CMD_SUBGHZ_SET_TOP_FREQ[] = "subghz.set.top.freq"; // params: { frequency: float }
+static constexpr char CMD_SUBGHZ_SET_BOT_FREQ[] = "subghz.set.bot.freq"; // params: { frequency: float }
+static constexpr char CMD_SUBGHZ_RECORD_START[] = "subghz.record.start";
+static constexpr char CMD_SUBGHZ_RECORD_STOP[]  = "subghz.record.stop";
+static constexpr char CMD_SUBGHZ_PLAYBACK_START[] = "subghz.playback.start";
+static constexpr char CMD_SUBGHZ_PLAYBACK_STOP[]  = "subghz.playback.stop";
+static constexpr char CMD_SUBGHZ_PACKET_SEND[] = "subghz.packet.send"; // CC1101Tx body, or params: { radio: int, frequency_mhz: float, power_dbm: int, payload: base64 }
+static constexpr char CMD_SUBGHZ_DISRUPTOR_START[] = "subghz.disruptor.start";
+static constexpr char CMD_SUBGHZ_DISRUPTOR_STOP[]  = "subghz.disruptor.stop";
+static constexpr char CMD_SUBGHZ_TEST[]             = "subghz.test"; // connection self-test between radio1 and radio2
 
 // Oscilloscope / ADC
-static const char CMD_OSCILLOSCOPE_START[] = "oscilloscope.start";
-static const char CMD_OSCILLOSCOPE_STOP[]  = "oscilloscope.stop";
+static constexpr char CMD_OSCILLOSCOPE_START[] = "oscilloscope.start";
+static constexpr char CMD_OSCILLOSCOPE_STOP[]  = "oscilloscope.stop";
 
 // I2C scanner
-static const char CMD_I2C_SCAN_ONCE[]  = "i2c.scan.once";
-static const char CMD_I2C_SCAN_START[] = "i2c.scan.start";
-static const char CMD_I2C_SCAN_STOP[]  = "i2c.scan.stop";
+static constexpr char CMD_I2C_SCAN_ONCE[]  = "i2c.scan.once";
+static constexpr char CMD_I2C_SCAN_START[] = "i2c.scan.start";
+static constexpr char CMD_I2C_SCAN_STOP[]  = "i2c.scan.stop";
 
 // NFC polling
-static const char CMD_NFC_POLL_START[] = "nfc.poll.start";
-static const char CMD_NFC_POLL_STOP[]  = "nfc.poll.stop";
+static constexpr char CMD_NFC_POLL_START[] = "nfc.poll.start";
+static constexpr char CMD_NFC_POLL_STOP[]  = "nfc.poll.stop";
 
 // Sensor streaming (accelerometer / gyro)
-static const char CMD_SENSOR_STREAM_START[] = "sensor.stream.start";
-static const char CMD_SENSOR_STREAM_STOP[]  = "sensor.stream.stop";
+static constexpr char CMD_SENSOR_STREAM_START[] = "sensor.stream.start";
+static constexpr char CMD_SENSOR_STREAM_STOP[]  = "sensor.stream.stop";
 
 // Cellular / cell-scan (generic)
-static const char CMD_CELL_SCAN_START[] = "cell.scan.start";
-static const char CMD_CELL_SCAN_STOP[]  = "cell.scan.stop";
+static constexpr char CMD_CELL_SCAN_START[] = "cell.scan.start";
+static constexpr char CMD_CELL_SCAN_STOP[]  = "cell.scan.stop";
 
 // SD / Files
-static const char CMD_SD_INFO[]   = "sd.info";
-static const char CMD_FILES_LIST[] = "files.list"; // optional param: path
+static constexpr char CMD_SD_INFO[]   = "sd.info";
+static constexpr char CMD_FILES_LIST[] = "files.list"; // optional param: path
 
 // IR receive
-static const char CMD_IR_RECV_START[] = "ir.recv.start";
-static const char CMD_IR_RECV_STOP[]  = "ir.recv.stop";
+static constexpr char CMD_IR_RECV_START[] = "ir.recv.start";
+static constexpr char CMD_IR_RECV_STOP[]  = "ir.recv.stop";
 
 // Convenience / control
-static const char CMD_LIST_PAIRED_DEVICES[] = "list.paired.devices";
-static const char CMD_PAIR_SET[]             = "pair.set"; // params: { pin: string|int }
-static const char CMD_BATTERY_INFO[]         = "battery.info";
-static const char CMD_STATUS_INFO[]          = "status.info"; // one-shot status snapshot
-static const char CMD_STATUS_REPORT_START[]  = "status.reporting.start";
-static const char CMD_STATUS_REPORT_STOP[]   = "status.reporting.stop";
-
-// Array of all command strings (useful for registration / validation)
-static const char* const SHARKOS_BT_COMMANDS[] = {
-    CMD_BLE_SCAN_START,
-    CMD_BLE_SCAN_STOP,
-    CMD_WIFI_SCAN_START,
-    CMD_WIFI_SCAN_STOP,
-    CMD_WIFI_CHANNEL_SCAN,
-    CMD_WIFI_SNIFFER_START,
-    CMD_WIFI_SNIFFER_STOP,
-    CMD_NRF_SCAN_START,
-    CMD_NRF_SCAN_STOP,
-    CMD_SUBGHZ_READ_START,
-    CMD_SUBGHZ_READ_STOP,
-    CMD_SUBGHZ_SET_MOD_ONE,
-    CMD_SUBGHZ_SET_MOD_TWO,
-    CMD_SUBGHZ_SET_TOP_FREQ,
-    CMD_SUBGHZ_SET_BOT_FREQ,
-    CMD_SUBGHZ_RECORD_START,
-    CMD_SUBGHZ_RECORD_STOP,
-    CMD_SUBGHZ_PLAYBACK_START,
-    CMD_SUBGHZ_PLAYBACK_STOP,
-    CMD_SUBGHZ_PACKET_SEND,
-    CMD_SUBGHZ_DISRUPTOR_START,
-    CMD_SUBGHZ_DISRUPTOR_STOP,
-    CMD_SUBGHZ_TEST,
-    CMD_OSCILLOSCOPE_START,
-    CMD_OSCILLOSCOPE_STOP,
-    CMD_I2C_SCAN_ONCE,
-    CMD_I2C_SCAN_START,
-    CMD_I2C_SCAN_STOP,
-    CMD_NFC_POLL_START,
-    CMD_NFC_POLL_STOP,
-    CMD_SENSOR_STREAM_START,
-    CMD_SENSOR_STREAM_STOP,
-    CMD_CELL_SCAN_START,
-    CMD_CELL_SCAN_STOP,
-    CMD_SD_INFO,
-    CMD_FILES_LIST,
-    CMD_IR_RECV_START,
-    CMD_IR_RECV_STOP,
-    CMD_LIST_PAIRED_DEVICES,
-    CMD_PAIR_SET,
-    CMD_BATTERY_INFO,
-    CMD_STATUS_INFO,
-    CMD_STATUS_REPORT_START,
-    CMD_STATUS_REPORT_STOP
+static constexpr char CMD_LIST_PAIRED_DEVICES[] = "list.paired.devices";
+static constexpr char CMD_PAIR_SET[]             = "pair.set"; // params: { pin: string|int }
+static constexpr char CMD_BATTERY_INFO[]         = "battery.info";
+static constexpr char CMD_STATUS_INFO[]          = "status.info"; // one-shot status snapshot
+static constexpr char CMD_STATUS_REPORT_START[]  = "status.reporting.start";
+static constexpr char CMD_STATUS_REPORT_STOP[]   = "status.reporting.stop";
+static constexpr char CMD_BLE_LINK[]             = "ble.link"; // params: { framing: bool, compress: bool } (see ble_link.h)
+static constexpr char CMD_SERIAL_LINK[]          = "serial.link"; // params: { binary: bool } (see serial_link.h)
+static constexpr char CMD_RADIO_BATCH_POLICY[]   = "radio.batch.policy"; // JSON radio-batch opt-in, flush limits and layout
+static constexpr char CMD_MEM_STATS[]            = "mem.stats"; // heap and PSRAM usage by region (see psram_alloc.h)
+
+// ---------------------------------------------------------------------------
+// Command table
+//
+// One entry per command key, in CommandId order. Each entry carries the
+// handler the events subsystem dispatches to, the background scan kind it
+// starts or stops, the id of its start/stop counterpart and the params it
+// understands. Keys are resolved through a perfect hash that is computed at
+// compile time over the table (see command_lookup()), so looking up a key is
+// one hash, two table reads and one string compare, with no allocation.
+// ---------------------------------------------------------------------------
+
+// Interned command ids: one per entry of SHARKOS_COMMAND_TABLE, in the same
+// order, so `SHARKOS_COMMAND_TABLE[id]` describes `id`. Binary commands name
+// their command by `id + 1` (Command.command_id in .proto), so new commands
+// go at the end.
+enum CommandId {
+    CMDID_UNKNOWN = -1,
+    CMDID_BLE_SCAN_START = 0,
+    CMDID_BLE_SCAN_STOP,
+    CMDID_WIFI_SCAN_START,
+    CMDID_WIFI_SCAN_STOP,
+    CMDID_WIFI_CHANNEL_SCAN,
+    CMDID_WIFI_SNIFFER_START,
+    CMDID_WIFI_SNIFFER_STOP,
+    CMDID_NRF_SCAN_START,
+    CMDID_NRF_SCAN_STOP,
+    CMDID_SUBGHZ_READ_START,
+    CMDID_SUBGHZ_READ_STOP,
+    CMDID_SUBGHZ_SET_MOD_ONE,
+    CMDID_SUBGHZ_SET_MOD_TWO,
+    CMDID_SUBGHZ_SET_TOP_FREQ,
+    CMDID_SUBGHZ_SET_BOT_FREQ,
+    CMDID_SUBGHZ_RECORD_START,
+    CMDID_SUBGHZ_RECORD_STOP,
+    CMDID_SUBGHZ_PLAYBACK_START,
+    CMDID_SUBGHZ_PLAYBACK_STOP,
+    CMDID_SUBGHZ_PACKET_SEND,
+    CMDID_SUBGHZ_DISRUPTOR_START,
+    CMDID_SUBGHZ_DISRUPTOR_STOP,
+    CMDID_SUBGHZ_TEST,
+    CMDID_OSCILLOSCOPE_START,
+    CMDID_OSCILLOSCOPE_STOP,
+    CMDID_I2C_SCAN_ONCE,
+    CMDID_I2C_SCAN_START,
+    CMDID_I2C_SCAN_STOP,
+    CMDID_NFC_POLL_START,
+    CMDID_NFC_POLL_STOP,
+    CMDID_SENSOR_STREAM_START,
+    CMDID_SENSOR_STREAM_STOP,
+    CMDID_CELL_SCAN_START,
+    CMDID_CELL_SCAN_STOP,
+    CMDID_SD_INFO,
+    CMDID_FILES_LIST,
+    CMDID_IR_RECV_START,
+    CMDID_IR_RECV_STOP,
+    CMDID_LIST_PAIRED_DEVICES,
+    CMDID_PAIR_SET,
+    CMDID_BATTERY_INFO,
+    CMDID_STATUS_INFO,
+    CMDID_STATUS_REPORT_START,
+    CMDID_STATUS_REPORT_STOP,
+    CMDID_BLE_LINK,
+    CMDID_SERIAL_LINK,
+    CMDID_RADIO_BATCH_POLICY,
+    CMDID_MEM_STATS,
+    CMDID_COUNT
+};
+
+// Background jobs scheduled by events.ino: one per kind, and any number of
+// kinds side by side, kept apart only by the hardware they share.
+enum ActiveScanKind {
+  SCAN_NONE = 0,
+  SCAN_WIFI_SNIFFER,
+  SCAN_BLE,
+  SCAN_NRF,
+  SCAN_SUBGHZ,
+  SCAN_OSCILLOSCOPE,
+  SCAN_I2C,
+  SCAN_NFC_POLL,
+  SCAN_SENSOR_STREAM,
+  SCAN_STATUS_REPORT,
+  SCAN_PRESENCE_REFRESH,  // runs alongside SCAN_STATUS_REPORT; no command of its own
+  SCAN_KIND_COUNT
+};
+
+// Whether a command starts, stops or is a one-shot action.
+enum CommandRole : uint8_t { COMMAND_ONESHOT = 0, COMMAND_START, COMMAND_STOP };
+
+// Param value types. In a schema, PARAM_NULL means "any type" and the two
+// numeric types accept either an integer or a float on the wire.
+enum CommandParamType : uint8_t { PARAM_NULL = 0, PARAM_BOOL, PARAM_INT, PARAM_FLOAT, PARAM_STRING };
+
+struct CommandParamSpec {
+    const char *name;
+    CommandParamType type;
+};
+
+struct Command;  // command.h
+typedef void (*CommandHandler)(const Command &cmd);
+
+struct CommandSpec {
+    const char *key;
+    CommandId id;
+    CommandHandler handler;          // nullptr: known key, not implemented
+    CommandRole role;
+    ActiveScanKind scan;             // loop started / stopped, SCAN_NONE otherwise
+    CommandId pair;                  // matching start/stop, CMDID_UNKNOWN otherwise
+    const CommandParamSpec *params;
+    uint8_t paramCount;
+};
+
+// Handlers (events.ino).
+void cmd_handle_scan_start(const Command &cmd);
+void cmd_handle_scan_stop(const Command &cmd);
+void cmd_handle_wifi_scan_start(const Command &cmd);
+void cmd_handle_wifi_scan_stop(const Command &cmd);
+void cmd_handle_subghz_set_mod(const Command &cmd);
+void cmd_handle_subghz_set_freq(const Command &cmd);
+void cmd_handle_subghz_test(const Command &cmd);
+void cmd_handle_subghz_packet_send(const Command &cmd);
+void cmd_handle_i2c_scan_once(const Command &cmd);
+void cmd_handle_cell_scan_start(const Command &cmd);
+void cmd_handle_cell_scan_stop(const Command &cmd);
+void cmd_handle_sd_info(const Command &cmd);
+void cmd_handle_files_list(const Command &cmd);
+void cmd_handle_ir_recv_start(const Command &cmd);
+void cmd_handle_ir_recv_stop(const Command &cmd);
+void cmd_handle_list_paired_devices(const Command &cmd);
+void cmd_handle_pair_set(const Command &cmd);
+void cmd_handle_battery_info(const Command &cmd);
+void cmd_handle_status_info(const Command &cmd);
+void cmd_handle_ble_link(const Command &cmd);
+void cmd_handle_serial_link(const Command &cmd);
+void cmd_handle_radio_batch_policy(const Command &cmd);
+void cmd_handle_mem_stats(const Command &cmd);
+
+// Param schemas
+static constexpr CommandParamSpec PARAMS_WIFI_SCAN[] = {
+    {"channel", PARAM_INT}, {"band", PARAM_NULL}  // band: "2.4" | "5" | 5
 };
+static constexpr CommandParamSpec PARAMS_SUBGHZ_READ[] = {
+    {"frequency_khz", PARAM_INT},
+    {"frequency_mhz", PARAM_FLOAT},
+    {"top_frequency_mhz", PARAM_FLOAT}, {"top_freq_mhz", PARAM_FLOAT},
+    {"bottom_frequency_mhz", PARAM_FLOAT}, {"bot_frequency_mhz", PARAM_FLOAT},
+    {"modulation", PARAM_STRING}, {"modulation_one", PARAM_STRING}, {"modulation_two", PARAM_STRING}
+};
+static constexpr CommandParamSpec PARAMS_MODULATION[] = { {"modulation", PARAM_STRING} };
+static constexpr CommandParamSpec PARAMS_FREQUENCY[] = { {"frequency", PARAM_FLOAT}, {"radio", PARAM_INT} };
+static constexpr CommandParamSpec PARAMS_PACKET_SEND[] = {
+    {"radio", PARAM_INT}, {"frequency_mhz", PARAM_FLOAT}, {"power_dbm", PARAM_INT}, {"payload", PARAM_STRING}
+};
+static constexpr CommandParamSpec PARAMS_PATH[] = { {"path", PARAM_STRING} };
+static constexpr CommandParamSpec PARAMS_PIN[] = { {"pin", PARAM_NULL}, {"code", PARAM_NULL} };  // string|int
+static constexpr CommandParamSpec PARAMS_INTERVAL[] = { {"interval_ms", PARAM_INT} };
+static constexpr CommandParamSpec PARAMS_BLE_LINK[] = { {"framing", PARAM_BOOL}, {"compress", PARAM_BOOL} };
+static constexpr CommandParamSpec PARAMS_SERIAL_LINK[] = { {"binary", PARAM_BOOL} };
+static constexpr CommandParamSpec PARAMS_RADIO_BATCH_POLICY[] = {
+    {"module", PARAM_INT}, {"preset", PARAM_STRING}, {"max_events", PARAM_INT}, {"max_bytes", PARAM_INT},
+    {"idle_ms", PARAM_INT}, {"max_age_ms", PARAM_INT}, {"frame_bytes", PARAM_INT}, {"match_mtu", PARAM_BOOL},
+    {"layout", PARAM_STRING}, {"json", PARAM_BOOL}
+};
+
+#define CMD_PARAMS(p) p, (uint8_t)(sizeof(p) / sizeof(p[0]))
+#define CMD_NO_PARAMS nullptr, 0
+
+static constexpr CommandSpec SHARKOS_COMMAND_TABLE[] = {
+    // BLE scanner
+    {CMD_BLE_SCAN_START,  CMDID_BLE_SCAN_START, cmd_handle_scan_start, COMMAND_START, SCAN_BLE, CMDID_BLE_SCAN_STOP, CMD_NO_PARAMS},
+    {CMD_BLE_SCAN_STOP,   CMDID_BLE_SCAN_STOP,  cmd_handle_scan_stop,  COMMAND_STOP,  SCAN_BLE, CMDID_BLE_SCAN_START, CMD_NO_PARAMS},
+    // Wi‑Fi scan / sniffer
+    {CMD_WIFI_SCAN_START,    CMDID_WIFI_SCAN_START,    cmd_handle_wifi_scan_start, COMMAND_START,   SCAN_NONE, CMDID_WIFI_SCAN_STOP, CMD_PARAMS(PARAMS_WIFI_SCAN)},
+    {CMD_WIFI_SCAN_STOP,     CMDID_WIFI_SCAN_STOP,     cmd_handle_wifi_scan_stop,  COMMAND_STOP,    SCAN_NONE, CMDID_WIFI_SCAN_START, CMD_NO_PARAMS},
+    {CMD_WIFI_CHANNEL_SCAN,  CMDID_WIFI_CHANNEL_SCAN,  cmd_handle_wifi_scan_start, COMMAND_START,   SCAN_NONE, CMDID_WIFI_SCAN_STOP, CMD_PARAMS(PARAMS_WIFI_SCAN)},
+    {CMD_WIFI_SNIFFER_START, CMDID_WIFI_SNIFFER_START, cmd_handle_scan_start,      COMMAND_START,   SCAN_WIFI_SNIFFER, CMDID_WIFI_SNIFFER_STOP, CMD_NO_PARAMS},
+    {CMD_WIFI_SNIFFER_STOP,  CMDID_WIFI_SNIFFER_STOP,  cmd_handle_scan_stop,       COMMAND_STOP,    SCAN_WIFI_SNIFFER, CMDID_WIFI_SNIFFER_START, CMD_NO_PARAMS},
+    // nRF (2.4GHz)
+    {CMD_NRF_SCAN_START, CMDID_NRF_SCAN_START, cmd_handle_scan_start, COMMAND_START, SCAN_NRF, CMDID_NRF_SCAN_STOP, CMD_NO_PARAMS},
+    {CMD_NRF_SCAN_STOP,  CMDID_NRF_SCAN_STOP,  cmd_handle_scan_stop,  COMMAND_STOP,  SCAN_NRF, CMDID_NRF_SCAN_START, CMD_NO_PARAMS},
+    // Sub‑GHz (CC1101/LoRa)
+    {CMD_SUBGHZ_READ_START,      CMDID_SUBGHZ_READ_START,      cmd_handle_scan_start,      COMMAND_START,   SCAN_SUBGHZ, CMDID_SUBGHZ_READ_STOP, CMD_PARAMS(PARAMS_SUBGHZ_READ)},
+    {CMD_SUBGHZ_READ_STOP,       CMDID_SUBGHZ_READ_STOP,       cmd_handle_scan_stop,       COMMAND_STOP,    SCAN_SUBGHZ, CMDID_SUBGHZ_READ_START, CMD_NO_PARAMS},
+    {CMD_SUBGHZ_SET_MOD_ONE,     CMDID_SUBGHZ_SET_MOD_ONE,     cmd_handle_subghz_set_mod,  COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_MODULATION)},
+    {CMD_SUBGHZ_SET_MOD_TWO,     CMDID_SUBGHZ_SET_MOD_TWO,     cmd_handle_subghz_set_mod,  COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_MODULATION)},
+    {CMD_SUBGHZ_SET_TOP_FREQ,    CMDID_SUBGHZ_SET_TOP_FREQ,    cmd_handle_subghz_set_freq, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_FREQUENCY)},
+    {CMD_SUBGHZ_SET_BOT_FREQ,    CMDID_SUBGHZ_SET_BOT_FREQ,    cmd_handle_subghz_set_freq, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_FREQUENCY)},
+    {CMD_SUBGHZ_RECORD_START,    CMDID_SUBGHZ_RECORD_START,    nullptr, COMMAND_START,   SCAN_NONE, CMDID_SUBGHZ_RECORD_STOP, CMD_NO_PARAMS},
+    {CMD_SUBGHZ_RECORD_STOP,     CMDID_SUBGHZ_RECORD_STOP,     nullptr, COMMAND_STOP,    SCAN_NONE, CMDID_SUBGHZ_RECORD_START, CMD_NO_PARAMS},
+    {CMD_SUBGHZ_PLAYBACK_START,  CMDID_SUBGHZ_PLAYBACK_START,  nullptr, COMMAND_START,   SCAN_NONE, CMDID_SUBGHZ_PLAYBACK_STOP, CMD_NO_PARAMS},
+    {CMD_SUBGHZ_PLAYBACK_STOP,   CMDID_SUBGHZ_PLAYBACK_STOP,   nullptr, COMMAND_STOP,    SCAN_NONE, CMDID_SUBGHZ_PLAYBACK_START, CMD_NO_PARAMS},
+    {CMD_SUBGHZ_PACKET_SEND,     CMDID_SUBGHZ_PACKET_SEND,     cmd_handle_subghz_packet_send, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_PACKET_SEND)},
+    {CMD_SUBGHZ_DISRUPTOR_START, CMDID_SUBGHZ_DISRUPTOR_START, nullptr, COMMAND_START,   SCAN_NONE, CMDID_SUBGHZ_DISRUPTOR_STOP, CMD_NO_PARAMS},
+    {CMD_SUBGHZ_DISRUPTOR_STOP,  CMDID_SUBGHZ_DISRUPTOR_STOP,  nullptr, COMMAND_STOP,    SCAN_NONE, CMDID_SUBGHZ_DISRUPTOR_START, CMD_NO_PARAMS},
+    {CMD_SUBGHZ_TEST,            CMDID_SUBGHZ_TEST,            cmd_handle_subghz_test, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_NO_PARAMS},
+    // Oscilloscope / ADC
+    {CMD_OSCILLOSCOPE_START, CMDID_OSCILLOSCOPE_START, cmd_handle_scan_start, COMMAND_START, SCAN_OSCILLOSCOPE, CMDID_OSCILLOSCOPE_STOP, CMD_NO_PARAMS},
+    {CMD_OSCILLOSCOPE_STOP,  CMDID_OSCILLOSCOPE_STOP,  cmd_handle_scan_stop,  COMMAND_STOP,  SCAN_OSCILLOSCOPE, CMDID_OSCILLOSCOPE_START, CMD_NO_PARAMS},
+    // I2C scanner
+    {CMD_I2C_SCAN_ONCE,  CMDID_I2C_SCAN_ONCE,  cmd_handle_i2c_scan_once, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_NO_PARAMS},
+    {CMD_I2C_SCAN_START, CMDID_I2C_SCAN_START, cmd_handle_scan_start,    COMMAND_START,   SCAN_I2C, CMDID_I2C_SCAN_STOP, CMD_NO_PARAMS},
+    {CMD_I2C_SCAN_STOP,  CMDID_I2C_SCAN_STOP,  cmd_handle_scan_stop,     COMMAND_STOP,    SCAN_I2C, CMDID_I2C_SCAN_START, CMD_NO_PARAMS},
+    // NFC polling
+    {CMD_NFC_POLL_START, CMDID_NFC_POLL_START, cmd_handle_scan_start, COMMAND_START, SCAN_NFC_POLL, CMDID_NFC_POLL_STOP, CMD_NO_PARAMS},
+    {CMD_NFC_POLL_STOP,  CMDID_NFC_POLL_STOP,  cmd_handle_scan_stop,  COMMAND_STOP,  SCAN_NFC_POLL, CMDID_NFC_POLL_START, CMD_NO_PARAMS},
+    // Sensor streaming
+    {CMD_SENSOR_STREAM_START, CMDID_SENSOR_STREAM_START, cmd_handle_scan_start, COMMAND_START, SCAN_SENSOR_STREAM, CMDID_SENSOR_STREAM_STOP, CMD_NO_PARAMS},
+    {CMD_SENSOR_STREAM_STOP,  CMDID_SENSOR_STREAM_STOP,  cmd_handle_scan_stop,  COMMAND_STOP,  SCAN_SENSOR_STREAM, CMDID_SENSOR_STREAM_START, CMD_NO_PARAMS},
+    // Cellular / cell-scan
+    {CMD_CELL_SCAN_START, CMDID_CELL_SCAN_START, cmd_handle_cell_scan_start, COMMAND_START, SCAN_NONE, CMDID_CELL_SCAN_STOP, CMD_NO_PARAMS},
+    {CMD_CELL_SCAN_STOP,  CMDID_CELL_SCAN_STOP,  cmd_handle_cell_scan_stop,  COMMAND_STOP,  SCAN_NONE, CMDID_CELL_SCAN_START, CMD_NO_PARAMS},
+    // SD / Files
+    {CMD_SD_INFO,    CMDID_SD_INFO,    cmd_handle_sd_info,    COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_NO_PARAMS},
+    {CMD_FILES_LIST, CMDID_FILES_LIST, cmd_handle_files_list, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_PATH)},
+    // IR receive
+    {CMD_IR_RECV_START, CMDID_IR_RECV_START, cmd_handle_ir_recv_start, COMMAND_START, SCAN_NONE, CMDID_IR_RECV_STOP, CMD_NO_PARAMS},
+    {CMD_IR_RECV_STOP,  CMDID_IR_RECV_STOP,  cmd_handle_ir_recv_stop,  COMMAND_STOP,  SCAN_NONE, CMDID_IR_RECV_START, CMD_NO_PARAMS},
+    // Convenience / control
+    {CMD_LIST_PAIRED_DEVICES, CMDID_LIST_PAIRED_DEVICES, cmd_handle_list_paired_devices, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_NO_PARAMS},
+    {CMD_PAIR_SET,            CMDID_PAIR_SET,            cmd_handle_pair_set,            COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_PIN)},
+    {CMD_BATTERY_INFO,        CMDID_BATTERY_INFO,        cmd_handle_battery_info,        COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_NO_PARAMS},
+    {CMD_STATUS_INFO,         CMDID_STATUS_INFO,         cmd_handle_status_info,         COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_NO_PARAMS},
+    {CMD_STATUS_REPORT_START, CMDID_STATUS_REPORT_START, cmd_handle_scan_start, COMMAND_START, SCAN_STATUS_REPORT, CMDID_STATUS_REPORT_STOP, CMD_PARAMS(PARAMS_INTERVAL)},
+    {CMD_STATUS_REPORT_STOP,  CMDID_STATUS_REPORT_STOP,  cmd_handle_scan_stop,  COMMAND_STOP,  SCAN_STATUS_REPORT, CMDID_STATUS_REPORT_START, CMD_NO_PARAMS},
+    {CMD_BLE_LINK,            CMDID_BLE_LINK,            cmd_handle_ble_link,   COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_BLE_LINK)},
+    {CMD_SERIAL_LINK,         CMDID_SERIAL_LINK,         cmd_handle_serial_link, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_SERIAL_LINK)},
+    {CMD_RADIO_BATCH_POLICY,  CMDID_RADIO_BATCH_POLICY,  cmd_handle_radio_batch_policy, COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_PARAMS(PARAMS_RADIO_BATCH_POLICY)},
+    {CMD_MEM_STATS,           CMDID_MEM_STATS,           cmd_handle_mem_stats,  COMMAND_ONESHOT, SCAN_NONE, CMDID_UNKNOWN, CMD_NO_PARAMS},
+};
+
+#undef CMD_PARAMS
+#undef CMD_NO_PARAMS
+
+static constexpr unsigned int SHARKOS_BT_COMMAND_COUNT = sizeof(SHARKOS_COMMAND_TABLE) / sizeof(SHARKOS_COMMAND_TABLE[0]);
+
+static_assert((unsigned int)CMDID_COUNT == SHARKOS_BT_COMMAND_COUNT, "CommandId must mirror SHARKOS_COMMAND_TABLE");
+
+// --- compile-time perfect hash ---------------------------------------------
+//
+// Two-level "hash and displace": the key hash picks one of
+// COMMAND_HASH_BUCKETS buckets, and that bucket's displacement, remixed with
+// the same hash, picks the slot. Displacements are searched at compile time,
+// largest bucket first, until every key owns a slot.
+
+static constexpr unsigned int COMMAND_HASH_BUCKETS = 16;  // powers of two
+static constexpr unsigned int COMMAND_HASH_SLOTS = 64;
+static constexpr uint8_t COMMAND_HASH_EMPTY = 0xFF;
+
+// FNV-1a; usable at compile time and run time.
+constexpr uint32_t command_hash(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr uint32_t command_hash_slot(uint32_t h, uint16_t displacement) {
+    uint32_t x = h + (uint32_t)displacement * 0x9e3779b9u;
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x & (COMMAND_HASH_SLOTS - 1);
+}
+
+constexpr size_t command_key_length(const char *s) {
+    size_t n = 0;
+    while (s[n]) ++n;
+    return n;
+}
+
+struct CommandHashTable {
+    uint16_t displacement[COMMAND_HASH_BUCKETS];
+    uint8_t slot[COMMAND_HASH_SLOTS];   // CommandId, or COMMAND_HASH_EMPTY
+    bool perfect;
+};
+
+constexpr CommandHashTable command_build_hash_table() {
+    CommandHashTable t{};
+    for (unsigned int s = 0; s < COMMAND_HASH_SLOTS; ++s) t.slot[s] = COMMAND_HASH_EMPTY;
+
+    uint32_t hashes[SHARKOS_BT_COMMAND_COUNT] = {};
+    unsigned int bucketSize[COMMAND_HASH_BUCKETS] = {};
+    for (unsigned int i = 0; i < SHARKOS_BT_COMMAND_COUNT; ++i) {
+        const char *k = SHARKOS_COMMAND_TABLE[i].key;
+        hashes[i] = command_hash(k, command_key_length(k));
+        ++bucketSize[hashes[i] & (COMMAND_HASH_BUCKETS - 1)];
+    }
+
+    bool placed[COMMAND_HASH_BUCKETS] = {};
+    for (unsigned int round = 0; round < COMMAND_HASH_BUCKETS; ++round) {
+        unsigned int b = 0, best = 0;
+        for (unsigned int c = 0; c < COMMAND_HASH_BUCKETS; ++c) {
+            if (!placed[c] && bucketSize[c] >= best) { b = c; best = bucketSize[c]; }
+        }
+        placed[b] = true;
+        if (best == 0) continue;
+
+        bool found = false;
+        for (uint32_t d = 0; d <= 0xFFFF && !found; ++d) {
+            bool taken[COMMAND_HASH_SLOTS] = {};
+            bool fits = true;
+            for (unsigned int i = 0; i < SHARKOS_BT_COMMAND_COUNT && fits; ++i) {
+                if ((hashes[i] & (COMMAND_HASH_BUCKETS - 1)) != b) continue;
+                uint32_t s = command_hash_slot(hashes[i], (uint16_t)d);
+                if (t.slot[s] != COMMAND_HASH_EMPTY || taken[s]) fits = false;
+                taken[s] = true;
+            }
+            if (!fits) continue;
+            for (unsigned int i = 0; i < SHARKOS_BT_COMMAND_COUNT; ++i) {
+                if ((hashes[i] & (COMMAND_HASH_BUCKETS - 1)) != b) continue;
+                t.slot[command_hash_slot(hashes[i], (uint16_t)d)] = (uint8_t)i;
+            }
+            t.displacement[b] = (uint16_t)d;
+            found = true;
+        }
+        if (!found) return t;
+    }
+    t.perfect = true;
+    return t;
+}
+
+static constexpr CommandHashTable COMMAND_HASH_TABLE = command_build_hash_table();
+static_assert(COMMAND_HASH_TABLE.perfect, "command table has no perfect hash; grow COMMAND_HASH_SLOTS");
+
+constexpr bool command_table_is_ordered() {
+    for (unsigned int i = 0; i < SHARKOS_BT_COMMAND_COUNT; ++i) {
+        if (SHARKOS_COMMAND_TABLE[i].id != (CommandId)i) return false;
+    }
+    return true;
+}
+static_assert(command_table_is_ordered(), "SHARKOS_COMMAND_TABLE entries must be in CommandId order");
+
+// Resolve `len` bytes of `key` to its table entry, or nullptr. `key` comes
+// straight off the air and may hold NULs, so lengths are compared first.
+inline const CommandSpec *command_lookup(const char *key, size_t len) {
+    if (!key) return nullptr;
+    uint32_t h = command_hash(key, len);
+    uint16_t d = COMMAND_HASH_TABLE.displacement[h & (COMMAND_HASH_BUCKETS - 1)];
+    uint8_t idx = COMMAND_HASH_TABLE.slot[command_hash_slot(h, d)];
+    if (idx == COMMAND_HASH_EMPTY) return nullptr;
+    const CommandSpec *spec = &SHARKOS_COMMAND_TABLE[idx];
+    if (strlen(spec->key) != len || memcmp(spec->key, key, len) != 0) return nullptr;
+    return spec;
+}
+
+inline const CommandSpec *command_spec(CommandId id) {
+    return (id >= 0 && id < CMDID_COUNT) ? &SHARKOS_COMMAND_TABLE[id] : nullptr;
+}
 
-static const unsigned int SHARKOS_BT_COMMAND_COUNT = sizeof(SHARKOS_BT_COMMANDS) / sizeof(SHARKOS_BT_COMMANDS[0]);
+// Control commands skip ahead of queued work in the event queue: every stop,
+// plus status.info and pair.set.
+constexpr bool command_is_control(const CommandSpec &spec) {
+    return spec.role == COMMAND_STOP || spec.id == CMDID_STATUS_INFO || spec.id == CMDID_PAIR_SET;
+}
 
 #endif // COMMANDS_H
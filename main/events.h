@@ -5,16 +5,125 @@
 // Initialize the event subsystem. Call from setup().
 void events_init();
 
-// Enqueue a raw command string received via BLE. Returns true if queued.
+// Enqueue a raw command received via BLE. Returns true if queued; a full
+// queue or an oversized write is counted (see events_queue_overflows()).
+// Single producer: call only from the BLE host task.
+bool events_enqueue_command_bytes(const uint8_t *data, size_t len);
 bool events_enqueue_command(const String &cmd);
 
+// Number of incoming commands dropped because the queue was full or the
+// write was larger than a queue slot.
+uint32_t events_queue_overflows();
+
+// Queue occupancy per lane: control commands (stops, status.info, pair.set)
+// are kept apart from, and served before, normal traffic.
+struct EventsLaneStats {
+  uint32_t depth;
+  uint32_t highWater;
+  uint32_t dropped;
+};
+struct EventsQueueStats {
+  EventsLaneStats control;
+  EventsLaneStats normal;
+  uint32_t oversize;      // writes larger than a queue slot
+  uint32_t creditLimit;   // normal writes the client may have sent since connecting
+};
+void events_queue_stats(EventsQueueStats &out);
+
+// True while a stop command is queued; long-running work (scan_range)
+// checks it so the stop does not wait for the whole sweep.
+bool events_preempt_requested();
+
+// Start a new credit window for a freshly connected client; the main loop
+// then advertises the limit in a {"flow":{...}} notification.
+void events_flow_reset();
+
 // Helper: accept a Bluetooth command (wrapper that forwards into the events queue)
 // - this centralises pairing checks and queue handling for all BLE->events entrypoints
+void bluetooth_receive_command_bytes(const uint8_t *data, size_t len);
 void bluetooth_receive_command(const String &cmd);
 
 // Process one pending event (non-blocking). Call regularly from loop().
 void events_process_one();
 
+// Milliseconds until events_process_one() next has work (0 = now), at most
+// `maxMs`. loop() sleeps for this long via events_wait().
+unsigned long events_next_deadline_ms(unsigned long maxMs);
+
+// Sleep the calling (main loop) task for up to `timeoutMs`, returning early
+// when a command is enqueued or events_wake() is called.
+void events_wait(unsigned long timeoutMs);
+
+// Wake a sleeping main loop from another task (e.g. BLE connection changes).
+void events_wake();
+
+// Command-to-ack latency: from the BLE write until events_process_one()
+// has handled the command and sent its reply.
+struct EventsLatencyStats {
+  uint32_t count;
+  uint32_t lastUs;
+  uint32_t maxUs;
+  uint64_t totalUs;
+};
+void events_command_latency(EventsLatencyStats &out);
+void events_reset_command_latency();
+
+// Status reporting (status.reporting.start). Peripheral presence is probed
+// on the buses only on a slow cadence, on status.info, or after a hot-plug;
+// the report job sends a status frame when the snapshot changed and resends
+// an unchanged one as a heartbeat.
+struct EventsStatusStats {
+  uint32_t probes;      // presence probes (I2C + both SPI buses)
+  uint32_t ticks;       // report job runs
+  uint32_t sent;        // status frames sent, heartbeats included
+  uint32_t heartbeats;  // resends of an unchanged snapshot
+};
+void events_status_stats(EventsStatusStats &out);
+
+// A peripheral may have come or gone (radio re-init, NFC/WiFi mode change):
+// re-probe presence now instead of at the next slow refresh. Main loop only.
+void events_presence_invalidate();
+
+// Background job scheduler, per ActiveScanKind (commands.h), counted since
+// the kind was last started. `tick` numbers the scheduler passes.
+struct EventsJobStats {
+  bool active;
+  uint32_t runs;
+  uint32_t deferred;    // left due for the next pass: resource taken or tick budget spent
+  uint32_t busRetries;  // pushed back EVENTS_JOB_BUS_RETRY_MS: its bus worker was busy
+  uint32_t firstTick;   // pass of the first run, 0 before it
+  uint32_t lastTick;    // pass of the latest run
+};
+void events_job_stats(int kind, EventsJobStats &out);
+
+// Shape of the JSON radio-batch (TELEMETRY_FORMAT_JSON_BATCH):
+//   rows:    {"type":"radio-batch","module":M,"signals":[{"timestamp_ms":..,
+//             "module":M,"frequency_mhz":..,"rssi":..,"payload":".."},...]}
+//   columns: {"type":"radio-batch","module":M,"layout":"columns","count":N,
+//             "timestamp_ms":[..],"frequency_mhz":[..],"rssi":[..],"payload":[..]}
+// Columns drop the per-signal keys, roughly halving the text.
+enum RadioBatchLayout : uint8_t { RADIO_BATCH_ROWS = 0, RADIO_BATCH_COLUMNS };
+void events_set_radio_batch_layout(RadioBatchLayout layout);
+
+// Radio batches sent so far, by what triggered them (radio.batch.policy).
+struct EventsRadioFlushStats {
+  uint32_t batches;
+  uint32_t signals;
+  uint32_t events;   // maxEvents reached
+  uint32_t bytes;    // maxBytes reached
+  uint32_t frame;    // the next signal would overrun the target frame
+  uint32_t full;     // buffer entries or arena used up
+  uint32_t idle;     // idle deadline
+  uint32_t age;      // age deadline
+  uint32_t offloaded;  // encoded and sent by the radio TX task
+  uint32_t stalls;     // a flush waited for the module's previous batch
+};
+void events_radio_flush_stats(EventsRadioFlushStats &out);
+
+// Block until every batch handed to the radio TX task has reached the JSON
+// subscribers. Main loop only.
+void events_radio_flush_wait();
+
 // Validate whether a received payload is an accepted topic/command.
 bool events_validate_topic(const String &payload);
 
@@ -23,4 +132,4 @@ void handleBLECommand(const String &jsonCmd);
 
 // Send a response over BLE back to the client(s). If `inReplyTo` is
 // non-empty the response will include that correlation id.
-void bluetooth_send_response(const String &payload, const String &inReplyTo);
+void bluetooth_send_response(const char *payload, const char *inReplyTo);
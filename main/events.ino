@@ -3,13 +3,25 @@
 #include "globals.h"
 #include "events.h"
 #include "commands.h"
+#include "command.h"
+#include "bus_workers.h"
+#include "telemetry.h"
+#include "json_writer.h"
+#include "radio_batch.h"
+#include "psram_alloc.h"
+#include <esp_heap_caps.h>
+#include "base64.h"
+#include "ble_link.h"
 #include <ArduinoJson.h>
 #include <Preferences.h>
 #include <vector>
+#include <atomic>
 #include <WiFi.h>
 #include <BLEDevice.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
 
 // Status / firmware externs used by the event subsystem
 extern void notifyStatus(const char *s);
@@ -18,9 +30,8 @@ extern bool paired;        // persistent auth flag (from HIZMOS_OLED_U8G2lib.ino
 extern bool pairingMode;   // pairing mode enabled/disabled
 extern Preferences prefs;  // NVS storage (initialized during device setup)
 
-// Hooks provided by hardware-utils for polling transceivers and base64 encoding
+// Hooks provided by hardware-utils for polling transceivers
 extern void runTransceiverPollTasks();
-extern String base64_encode(const uint8_t *data, size_t len);
 extern void hw_send_status_protobuf(bool is_scanning,
                                     int battery_percent,
                                     bool cc1101_1_connected,
@@ -34,365 +45,1160 @@ extern void hw_send_status_protobuf(bool is_scanning,
 extern bool cc1101Connected();
 extern bool cc1101_2Connected();
 
-// Buffered signal representation used by events enqueueing
-struct BufferedSignal {
-  std::vector<uint8_t> payload;
-  float frequency_mhz;
-  int32_t rssi;
-  uint64_t timestamp_ms;
-};
-
-// Per-module buffers
+// Per-module buffers (radio_batch.h), two per module: new signals go to the
+// active half while the other one is with the radio TX task (below). A
+// module's entries and payload arenas are allocated once, on its first
+// signal, and kept, in PSRAM when the board has it (psram_alloc.h). Signals
+// only arrive here while a JSON batch subscriber is active (a BLE client
+// that sent radio.batch.policy {"json":true}), so until then nothing is
+// allocated.
 static const int RADIO_MODULE_COUNT = 8;
-static std::vector<BufferedSignal> radioBuffers[RADIO_MODULE_COUNT];
-static size_t radioBufferBytes[RADIO_MODULE_COUNT] = {0};
-static size_t radioBufferCount[RADIO_MODULE_COUNT] = {0};
+static RadioBatchBuffer radioBuffers[RADIO_MODULE_COUNT][2];
+static uint8_t radioActive[RADIO_MODULE_COUNT] = {0};     // half taking new signals
+static std::atomic<bool> radioTxBusy[RADIO_MODULE_COUNT];  // the other half is with the TX task
 static unsigned long radioLastReceivedMs[RADIO_MODULE_COUNT] = {0};
+static unsigned long radioFirstReceivedMs[RADIO_MODULE_COUNT] = {0};
+static size_t radioBatchText[RADIO_MODULE_COUNT] = {0};  // estimated JSON size of the pending batch
 static const int RADIO_SIGNAL_EVENT_COUNT = 250; // flush threshold for event-counted modules (subghz)
+static const size_t RADIO_BATCH_OTHER_CAPACITY = 64;  // entries for byte-counted modules
+static const size_t RADIO_BATCH_ARENA = 1024;         // payloads longer than RADIO_BATCH_INLINE
+static const size_t RADIO_BATCH_JSON_CHUNK = 256;  // radio-batch text is streamed in pieces of this size
+static char radioBatchChunk[RADIO_BATCH_JSON_CHUNK];
+static RadioBatchLayout radioBatchLayout = RADIO_BATCH_ROWS;
+
+// When a module's batch is sent (radio.batch.policy): as soon as any limit
+// is reached. 0 turns a limit off; maxEvents is capped at the buffer.
+struct RadioFlushPolicy {
+  uint16_t maxEvents;
+  uint16_t maxBytes;     // payload bytes
+  uint16_t idleMs;       // since the last signal
+  uint16_t maxAgeMs;     // since the first signal of the batch
+  uint16_t frameBytes;   // estimated batch text
+  bool matchMtu;         // frameBytes follows the BLE notification payload
+};
+static RadioFlushPolicy radioPolicies[RADIO_MODULE_COUNT];
+
+// Idle and age flushes are one-shot deadlines, armed when a batch gets its
+// first signal. When one comes due, a batch still receiving signals is
+// re-armed to its real deadline instead of flushed, so enqueue never touches
+// the timers and the main loop compares one time while anything is armed.
+static uint8_t radioTimerArmed = 0;                      // bit per module
+static unsigned long radioTimerDueMs[RADIO_MODULE_COUNT] = {0};
+static unsigned long radioTimerNextMs = 0;               // earliest armed deadline
+
+enum RadioFlushReason : uint8_t {
+  RADIO_FLUSH_EVENTS,
+  RADIO_FLUSH_BYTES,
+  RADIO_FLUSH_FRAME,
+  RADIO_FLUSH_FULL,
+  RADIO_FLUSH_IDLE,
+  RADIO_FLUSH_AGE,
+  RADIO_FLUSH_POLICY
+};
+static EventsRadioFlushStats radioFlushStats = {};
 
 // Forward: flush buffer for given module index
-static void events_flush_radio_buffer(int moduleIdx);
+static void events_flush_radio_buffer(int moduleIdx, RadioFlushReason reason);
 static void send_status_snapshot_protobuf();
-static void set_scan_modulation_single(const String &value);
-static void set_scan_modulation_pair(const String &v1, const String &v2);
-static void set_scan_modulation_index(size_t idx, const String &value);
-static bool scan_modulation_contains(const String &value);
-static String scan_modulation_joined();
+static void set_scan_target(ScanTarget target);
+static void set_scan_modulation_pair(ModulationType m1, ModulationType m2);
+static void set_scan_modulation_index(size_t idx, ModulationType m);
+
+static bool radio_module_event_counted(int module) {
+  return module == (int)CC1101_1 || module == (int)CC1101_2 || module == (int)LORA;
+}
+
+static size_t radio_module_capacity(int module) {
+  return radio_module_event_counted(module) ? RADIO_SIGNAL_EVENT_COUNT : RADIO_BATCH_OTHER_CAPACITY;
+}
+
+// The policy the firmware always had: sub-GHz modules by count, the rest by
+// payload bytes, both after RADIO_SIGNAL_IDLE_TIMEOUT_MS of quiet.
+static RadioFlushPolicy radio_default_policy(int module) {
+  RadioFlushPolicy p = {};
+  p.maxEvents = (uint16_t)radio_module_capacity(module);
+  p.maxBytes = radio_module_event_counted(module) ? 0 : RADIO_SIGNAL_BUFFER_SIZE;
+  p.idleMs = RADIO_SIGNAL_IDLE_TIMEOUT_MS;
+  return p;
+}
+
+static void radio_policies_init() {
+  for (int i = 0; i < RADIO_MODULE_COUNT; ++i) radioPolicies[i] = radio_default_policy(i);
+}
+
+// The policy's target, capped at what the JSON subscribers can take.
+static size_t radio_policy_frame_bytes(const RadioFlushPolicy &p) {
+  size_t frame = p.frameBytes;
+  if (p.matchMtu) {
+    uint16_t mtu = ble_link_mtu();
+    frame = mtu > 3 ? mtu - 3 : 20;  // ATT notification payload
+  }
+  size_t limit = telemetry_json_batch_limit();
+  return limit && (!frame || frame > limit) ? limit : frame;
+}
+
+// Upper estimate of the text one signal adds to a batch (frameBytes), and of
+// the batch text around the signals.
+static size_t radio_batch_signal_text(uint64_t timestampMs, size_t payloadLen) {
+  size_t digits = 1;
+  for (uint64_t v = timestampMs; v >= 10; v /= 10) ++digits;
+  size_t values = digits + 11 /* frequency, 6 decimals */ + 5 /* rssi */ + base64_encoded_len(payloadLen);
+  return values + (radioBatchLayout == RADIO_BATCH_COLUMNS ? 6 /* separators, quotes */ : 70 /* keys, module */);
+}
+static size_t radio_batch_header_text() { return radioBatchLayout == RADIO_BATCH_COLUMNS ? 128 : 48; }
+
+static void radio_timer_update_next() {
+  bool first = true;
+  for (uint8_t bits = radioTimerArmed; bits; bits &= (uint8_t)(bits - 1)) {
+    int m = __builtin_ctz(bits);
+    if (first || (long)(radioTimerDueMs[m] - radioTimerNextMs) < 0) radioTimerNextMs = radioTimerDueMs[m];
+    first = false;
+  }
+}
+
+static void radio_timer_arm(int module, unsigned long dueMs) {
+  radioTimerDueMs[module] = dueMs;
+  radioTimerArmed |= (uint8_t)(1u << module);
+  radio_timer_update_next();
+}
+
+static void radio_timer_disarm(int module) {
+  if (!(radioTimerArmed & (1u << module))) return;
+  radioTimerArmed &= (uint8_t)~(1u << module);
+  radio_timer_update_next();
+}
+
+// The pending batch's idle/age deadline; false when neither limit is set.
+static bool radio_batch_deadline(int module, unsigned long &dueMs, RadioFlushReason &reason) {
+  const RadioFlushPolicy &p = radioPolicies[module];
+  bool have = false;
+  if (p.idleMs) {
+    dueMs = radioLastReceivedMs[module] + p.idleMs;
+    reason = RADIO_FLUSH_IDLE;
+    have = true;
+  }
+  if (p.maxAgeMs) {
+    unsigned long ageDue = radioFirstReceivedMs[module] + p.maxAgeMs;
+    if (!have || (long)(ageDue - dueMs) < 0) {
+      dueMs = ageDue;
+      reason = RADIO_FLUSH_AGE;
+    }
+    have = true;
+  }
+  return have;
+}
+
+static RadioBatchBuffer &radio_active(int module) { return radioBuffers[module][radioActive[module]]; }
+
+static bool radio_half_init(RadioBatchBuffer &buf, size_t capacity) {
+  size_t entryBytes = capacity * sizeof(RadioBatchEntry);
+  RadioBatchEntry *entries = (RadioBatchEntry *)psram_alloc(PSRAM_REGION_RADIO_BATCH, entryBytes);
+  uint8_t *arena = (uint8_t *)psram_alloc(PSRAM_REGION_RADIO_BATCH, RADIO_BATCH_ARENA);
+  if (!entries || !arena) {
+    psram_free(PSRAM_REGION_RADIO_BATCH, entries, entryBytes);
+    psram_free(PSRAM_REGION_RADIO_BATCH, arena, RADIO_BATCH_ARENA);
+    return false;
+  }
+  buf.init(entries, capacity, arena, RADIO_BATCH_ARENA);
+  return true;
+}
 
-// Enqueue raw packet bytes from transceivers. Called from hardware-utils.
-// forward to hardware helper for immediate protobuf sends
-extern void hw_send_radio_signal_protobuf(int module, float frequency_mhz, int32_t rssi, const uint8_t* data, size_t len, const char* extra);
+static void radio_tx_init();
 
-void events_enqueue_radio_bytes(int module, const uint8_t* data, size_t len, float frequency_mhz, int32_t rssi) {
+static bool radio_buffer_ready(int module) {
+  if (radio_active(module).ready()) return true;
+  radio_tx_init();  // the first buffered signal of any module starts it
+  size_t capacity = radio_module_capacity(module);
+  if (!radio_half_init(radioBuffers[module][0], capacity)) return false;
+  // without a second half the module's batches are encoded inline
+  radio_half_init(radioBuffers[module][1], capacity);
+  return true;
+}
+
+// JSON radio-batch buffers, filled by the telemetry sink (telemetry.ino) while
+// a subscriber wants TELEMETRY_FORMAT_JSON_BATCH. `timestamp_ms` is the
+// capture time (bus worker samples are published a little after they were
+// taken).
+void events_enqueue_radio_bytes_at(int module, const uint8_t* data, size_t len, float frequency_mhz, int32_t rssi,
+                                   uint64_t timestamp_ms) {
   if (module < 0 || module >= RADIO_MODULE_COUNT) return;
-  BufferedSignal bs;
-  bs.payload.assign(data, data + len);
-  bs.frequency_mhz = frequency_mhz;
-  bs.rssi = rssi;
-  bs.timestamp_ms = (uint64_t)millis();
-  radioBuffers[module].push_back(std::move(bs));
-  radioBufferBytes[module] += len;
-  radioBufferCount[module] += 1;
-  radioLastReceivedMs[module] = millis();
-
-  // For sub-ghz modules (CC1101_1/2, LORA) flush when we reach event-count threshold
-  if (module == (int)CC1101_1 || module == (int)CC1101_2 || module == (int)LORA) {
-    if (radioBufferCount[module] >= RADIO_SIGNAL_EVENT_COUNT) {
-      events_flush_radio_buffer(module);
+  if (!radio_buffer_ready(module)) return;
+  // a flush swaps the active half, so it is looked up again after one
+  RadioBatchBuffer *buf = &radio_active(module);
+  const RadioFlushPolicy &p = radioPolicies[module];
+
+  // keep the batch under the target frame: send it before this signal
+  // would push it over
+  size_t text = radio_batch_signal_text(timestamp_ms, len);
+  size_t frame = radio_policy_frame_bytes(p);
+  if (frame && !buf->empty() && radioBatchText[module] + text > frame) {
+    events_flush_radio_buffer(module, RADIO_FLUSH_FRAME);
+    buf = &radio_active(module);
+  }
+
+  if (!buf->push(timestamp_ms, frequency_mhz, rssi, data, len)) {
+    // out of entries or arena before a threshold: send what is there
+    events_flush_radio_buffer(module, RADIO_FLUSH_FULL);
+    buf = &radio_active(module);
+    buf->push(timestamp_ms, frequency_mhz, rssi, data, len);
+  }
+  unsigned long now = millis();
+  radioLastReceivedMs[module] = now;
+  if (buf->count() == 1) {
+    radioFirstReceivedMs[module] = now;
+    radioBatchText[module] = radio_batch_header_text();
+    unsigned long dueMs;
+    RadioFlushReason reason;
+    if (radio_batch_deadline(module, dueMs, reason)) radio_timer_arm(module, dueMs);
+  }
+  radioBatchText[module] += text;
+
+  if (p.maxEvents && buf->count() >= p.maxEvents) {
+    events_flush_radio_buffer(module, RADIO_FLUSH_EVENTS);
+  } else if (p.maxBytes && buf->payloadBytes() >= p.maxBytes) {
+    events_flush_radio_buffer(module, RADIO_FLUSH_BYTES);
+  } else if (buf->full()) {
+    events_flush_radio_buffer(module, RADIO_FLUSH_FULL);
+  }
+}
+
+// Main loop: flush the batches whose idle/age deadline has passed.
+static void events_fire_radio_timers() {
+  if (!radioTimerArmed) return;
+  unsigned long now = millis();
+  if ((long)(now - radioTimerNextMs) < 0) return;
+  for (uint8_t bits = radioTimerArmed; bits; bits &= (uint8_t)(bits - 1)) {
+    int m = __builtin_ctz(bits);
+    if ((long)(now - radioTimerDueMs[m]) < 0) continue;
+    unsigned long dueMs;
+    RadioFlushReason reason;
+    if (!radio_batch_deadline(m, dueMs, reason)) {
+      radio_timer_disarm(m);
+    } else if ((long)(now - dueMs) >= 0) {
+      events_flush_radio_buffer(m, reason);
+    } else {
+      radioTimerDueMs[m] = dueMs;  // signals kept coming: wait for the real deadline
     }
+  }
+  radio_timer_update_next();
+}
+
+void events_radio_flush_stats(EventsRadioFlushStats &out) { out = radioFlushStats; }
+
+void events_set_radio_batch_layout(RadioBatchLayout layout) { radioBatchLayout = layout; }
+
+static void radio_batch_sink(void *ctx, const char *data, size_t len) {
+  (void)ctx;
+  telemetry_json_batch_write(data, len);
+}
+
+// Write one batch as JSON, a chunk at a time, so encoding needs `chunk` and
+// nothing else however many signals are buffered.
+static void radio_batch_encode(const RadioBatchBuffer &buf, int module, RadioBatchLayout layout, char *chunk,
+                               size_t chunkCap, JsonSinkFn sink) {
+  const size_t n = buf.count();
+  JsonWriter w(chunk, chunkCap, sink, nullptr);
+  w.beginObject();
+  w.key("type"); w.valueString("radio-batch");
+  w.key("module"); w.valueInt(module);
+  if (layout == RADIO_BATCH_COLUMNS) {
+    w.key("layout"); w.valueString("columns");
+    w.key("count"); w.valueUint(n);
+    w.key("timestamp_ms"); w.beginArray();
+    for (size_t i = 0; i < n; ++i) w.valueUint(buf.at(i).timestampMs);
+    w.endArray();
+    w.key("frequency_mhz"); w.beginArray();
+    for (size_t i = 0; i < n; ++i) w.valueFixed(buf.at(i).frequencyMhz, 6);
+    w.endArray();
+    w.key("rssi"); w.beginArray();
+    for (size_t i = 0; i < n; ++i) w.valueInt(buf.at(i).rssi);
+    w.endArray();
+    w.key("payload"); w.beginArray();
+    for (size_t i = 0; i < n; ++i) w.valueBase64(buf.payload(buf.at(i)), buf.at(i).payloadLen);
+    w.endArray();
   } else {
-    // For other modules flush on bytes threshold (legacy behavior)
-    if (radioBufferBytes[module] >= RADIO_SIGNAL_BUFFER_SIZE) {
-      events_flush_radio_buffer(module);
+    w.key("signals"); w.beginArray();
+    for (size_t i = 0; i < n; ++i) {
+      const RadioBatchEntry &e = buf.at(i);
+      w.beginObject();
+      w.key("timestamp_ms"); w.valueUint(e.timestampMs);
+      w.key("module"); w.valueInt(module);
+      w.key("frequency_mhz"); w.valueFixed(e.frequencyMhz, 6);
+      w.key("rssi"); w.valueInt(e.rssi);
+      w.key("payload"); w.valueBase64(buf.payload(e), e.payloadLen);
+      w.endObject();
     }
+    w.endArray();
   }
+  w.endObject();
+  w.flush();
 }
 
-static void events_check_radio_idle_flush() {
-  unsigned long now = millis();
-  for (int i = 0; i < RADIO_MODULE_COUNT; ++i) {
-    if (radioBuffers[i].empty()) continue;
-    if (radioLastReceivedMs[i] == 0) continue;
-    if ((now - radioLastReceivedMs[i]) >= RADIO_SIGNAL_IDLE_TIMEOUT_MS) {
-      events_flush_radio_buffer(i);
-    }
+// --- radio TX task ---
+// A flush hands the module's full half to a low-priority task on the bus
+// worker core and swaps in the other half, so the main loop pays for a
+// pointer swap rather than the JSON and base64. The task encodes batches one
+// at a time, in flush order, into a single-producer/single-consumer ring of
+// chunks (the scheme of the bus worker sample rings); radio_tx_publish()
+// hands them to the JSON subscribers from the main loop, which owns the
+// telemetry sink and the BLE link. Pieces of two batches therefore never
+// interleave. The task and its queue are created with the first buffers, so
+// a device without a JSON subscriber never starts them.
+static const UBaseType_t RADIO_TX_PRIORITY = 1;   // below the bus workers (2)
+static const uint32_t RADIO_TX_STACK = 4 * 1024;
+static const uint32_t RADIO_TX_RING_SIZE = 8;     // power of two
+static_assert((RADIO_TX_RING_SIZE & (RADIO_TX_RING_SIZE - 1)) == 0, "RADIO_TX_RING_SIZE must be a power of two");
+
+struct RadioTxJob {
+  RadioBatchBuffer *buf;
+  int8_t module;
+  RadioBatchLayout layout;   // as it was at the flush
+};
+
+struct RadioTxChunk {
+  uint16_t len;
+  bool end;                  // the batch is complete
+  char data[RADIO_BATCH_JSON_CHUNK];
+};
+
+static QueueHandle_t radioTxQueue = NULL;
+static TaskHandle_t radioTxTask = NULL;
+static RadioTxChunk *radioTxRing = nullptr;    // RADIO_TX_RING_SIZE chunks, PSRAM first
+static std::atomic<uint32_t> radioTxHead{0};   // main loop
+static std::atomic<uint32_t> radioTxTail{0};   // TX task
+
+// TX task: append a piece, waiting for the main loop while the ring is full.
+static void radio_tx_put(const char *data, size_t len, bool end) {
+  uint32_t tail = radioTxTail.load(std::memory_order_relaxed);
+  while (tail - radioTxHead.load(std::memory_order_acquire) >= RADIO_TX_RING_SIZE) {
+    events_wake();
+    vTaskDelay(1);
   }
+  RadioTxChunk &c = radioTxRing[tail & (RADIO_TX_RING_SIZE - 1)];
+  if (len > 0) memcpy(c.data, data, len);
+  c.len = (uint16_t)len;
+  c.end = end;
+  radioTxTail.store(tail + 1, std::memory_order_release);
 }
 
-static void events_flush_radio_buffer(int moduleIdx) {
-  if (moduleIdx < 0 || moduleIdx >= RADIO_MODULE_COUNT) return;
-  if (radioBuffers[moduleIdx].empty()) return;
+static void radio_tx_sink(void *ctx, const char *data, size_t len) {
+  (void)ctx;
+  radio_tx_put(data, len, false);
+}
 
-  // Build a lightweight JSON batch string to send over notifyStatus()
-  String out;
-  out.reserve(256);
-  out += "{\"type\":\"radio-batch\",\"module\":";
-  out += String(moduleIdx);
-  out += ",\"signals\":[";
+static void radio_tx_task(void *param) {
+  (void)param;
+  RadioTxJob job;
+  char chunk[RADIO_BATCH_JSON_CHUNK];  // JsonWriter buffer
+  for (;;) {
+    if (xQueueReceive(radioTxQueue, &job, portMAX_DELAY) != pdPASS) continue;
+    radio_batch_encode(*job.buf, job.module, job.layout, chunk, sizeof(chunk), radio_tx_sink);
+    radio_tx_put(nullptr, 0, true);
+    job.buf->clear();
+    radioTxBusy[job.module].store(false, std::memory_order_release);
+    events_wake();
+  }
+}
 
-  bool first = true;
-  for (auto &bs : radioBuffers[moduleIdx]) {
-    if (!first) out += ',';
-    first = false;
-    String b64 = base64_encode(bs.payload.data(), bs.payload.size());
-    out += "{";
-    out += "\"timestamp_ms\":"; out += String(bs.timestamp_ms);
-    out += ",\"module\":"; out += String(moduleIdx);
-    out += ",\"frequency_mhz\":"; out += String(bs.frequency_mhz, 6);
-    out += ",\"rssi\":"; out += String(bs.rssi);
-    out += ",\"payload\":\""; out += b64; out += "\"";
-    out += "}";
+static void radio_tx_init() {
+  if (radioTxQueue != NULL) return;
+  if (!radioTxRing) {
+    radioTxRing = (RadioTxChunk *)psram_alloc(PSRAM_REGION_RADIO_BATCH, RADIO_TX_RING_SIZE * sizeof(RadioTxChunk));
+    if (!radioTxRing) {
+      Serial.println("events: radio TX ring failed");
+      return;
+    }
+  }
+  // one batch per module can be in flight
+  radioTxQueue = xQueueCreate(RADIO_MODULE_COUNT, sizeof(RadioTxJob));
+  if (radioTxQueue == NULL) {
+    Serial.println("events: radio TX queue failed");
+    return;
+  }
+  if (xTaskCreatePinnedToCore(radio_tx_task, "radio_tx", RADIO_TX_STACK, NULL, RADIO_TX_PRIORITY, &radioTxTask,
+                              BUS_WORKER_CORE) != pdPASS) {
+    Serial.println("events: radio TX task failed");
+    vQueueDelete(radioTxQueue);
+    radioTxQueue = NULL;
+    radioTxTask = NULL;
+  }
+}
+
+// Main loop: pass encoded pieces on to the JSON subscribers.
+static void radio_tx_publish() {
+  uint32_t head = radioTxHead.load(std::memory_order_relaxed);
+  uint32_t tail = radioTxTail.load(std::memory_order_acquire);
+  for (; head != tail; ++head) {
+    const RadioTxChunk &c = radioTxRing[head & (RADIO_TX_RING_SIZE - 1)];
+    if (c.len > 0) telemetry_json_batch_write(c.data, c.len);
+    if (c.end) telemetry_json_batch_end();
+    radioTxHead.store(head + 1, std::memory_order_release);
+  }
+}
+
+// Main loop: until the TX task has given back the module's other half.
+static void radio_tx_wait(int module) {
+  while (radioTxBusy[module].load(std::memory_order_acquire)) {
+    radio_tx_publish();  // it may be waiting for ring space
+    delay(1);
   }
+}
+
+// Main loop: until every batch handed over has been delivered.
+static void radio_tx_drain() {
+  for (int m = 0; m < RADIO_MODULE_COUNT; ++m) radio_tx_wait(m);
+  radio_tx_publish();
+}
 
-  out += "]}";
+void events_radio_flush_wait() { radio_tx_drain(); }
 
-  // send via notifyStatus which abstracts BLE/Serial transport
-  notifyStatus(out.c_str());
+// Hand the module's active half to the TX task and switch to the other one.
+// False if there is no task or no second half; the caller encodes inline.
+static bool radio_tx_submit(int module) {
+  if (radioTxQueue == NULL || !radioBuffers[module][radioActive[module] ^ 1].ready()) return false;
+  if (radioTxBusy[module].load(std::memory_order_acquire)) {
+    radioFlushStats.stalls++;
+    radio_tx_wait(module);
+  }
+  RadioTxJob job = {&radio_active(module), (int8_t)module, radioBatchLayout};
+  radioTxBusy[module].store(true, std::memory_order_relaxed);
+  if (xQueueSend(radioTxQueue, &job, 0) != pdPASS) {
+    radioTxBusy[module].store(false, std::memory_order_relaxed);
+    return false;
+  }
+  radioActive[module] ^= 1;
+  return true;
+}
+
+static void events_flush_radio_buffer(int moduleIdx, RadioFlushReason reason) {
+  if (moduleIdx < 0 || moduleIdx >= RADIO_MODULE_COUNT) return;
+  RadioBatchBuffer &buf = radio_active(moduleIdx);
+  if (buf.empty()) return;
+  const size_t n = buf.count();
+
+  radioFlushStats.batches++;
+  radioFlushStats.signals += n;
+  switch (reason) {
+    case RADIO_FLUSH_EVENTS: radioFlushStats.events++; break;
+    case RADIO_FLUSH_BYTES: radioFlushStats.bytes++; break;
+    case RADIO_FLUSH_FRAME: radioFlushStats.frame++; break;
+    case RADIO_FLUSH_FULL: radioFlushStats.full++; break;
+    case RADIO_FLUSH_IDLE: radioFlushStats.idle++; break;
+    case RADIO_FLUSH_AGE: radioFlushStats.age++; break;
+    case RADIO_FLUSH_POLICY: break;
+  }
 
-  // clear buffer
-  radioBuffers[moduleIdx].clear();
-  radioBufferBytes[moduleIdx] = 0;
-  radioBufferCount[moduleIdx] = 0;
+  if (radio_tx_submit(moduleIdx)) {
+    radioFlushStats.offloaded++;
+  } else {
+    radio_tx_drain();  // batches stay whole and in order
+    radio_batch_encode(buf, moduleIdx, radioBatchLayout, radioBatchChunk, sizeof(radioBatchChunk), radio_batch_sink);
+    telemetry_json_batch_end();
+    buf.clear();
+  }
   radioLastReceivedMs[moduleIdx] = 0;
+  radioBatchText[moduleIdx] = 0;
+  radio_timer_disarm(moduleIdx);
+}
+
+// Let both CC1101 bus workers finish before the main loop touches the radios.
+static void subghz_wait_buses_idle() {
+  bus_worker_wait_idle(SPI_BUS_FSPI);
+  bus_worker_wait_idle(SPI_BUS_HSPI);
+}
+
+// Status reports. Probing presence costs bus time (a PN532 firmware query
+// on I2C, a CC1101 VERSION read on each SPI bus), so only presence_refresh()
+// probes: on status.info, and while reporting runs, from the presence_refresh
+// job every STATUS_PRESENCE_REFRESH_MS or right after
+// events_presence_invalidate(). The status_report job only compares the cache
+// and a few globals against the last frame sent, so at any interval it costs
+// no bus time and sends nothing until something changes or a heartbeat is
+// due.
+static const unsigned long STATUS_PRESENCE_REFRESH_MS = 10000;
+static const unsigned long STATUS_HEARTBEAT_MS = 30000;
+
+struct PeripheralPresence {
+  bool cc1;
+  bool cc2;
+  bool nfc;
+  bool wifi;
+  bool probed;
+};
+
+struct StatusSnapshot {
+  bool scanning;
+  int battery;
+  bool cc1;
+  bool cc2;
+  bool lora;
+  bool nfc;
+  bool wifi;
+  bool bluetooth;
+};
+
+static PeripheralPresence presence = {};
+static StatusSnapshot statusSent = {};
+static bool statusSentValid = false;
+static bool presenceStale = false;
+static unsigned long statusSentMs = 0;
+static EventsStatusStats statusStats = {};
+
+static void presence_refresh() {
+  // a radio being swept by its bus worker is in use, so report it present
+  // rather than probe the bus underneath the worker
+  presence.cc1 = bus_worker_busy(SPI_BUS_FSPI) || cc1101Connected();
+  presence.cc2 = bus_worker_busy(SPI_BUS_HSPI) || cc1101_2Connected();
+  presence.nfc = nfc.getFirmwareVersion() != 0;
+  presence.wifi = WiFi.getMode() != WIFI_MODE_NULL;
+  presence.probed = true;
+  statusStats.probes++;
+}
+
+static StatusSnapshot status_snapshot() {
+  StatusSnapshot s;
+  s.scanning = scanningRadio;
+  s.battery = batteryPercent;
+  s.cc1 = presence.cc1;
+  s.cc2 = presence.cc2;
+  s.lora = loraTx != nullptr;
+  s.nfc = presence.nfc;
+  s.wifi = presence.wifi;
+  s.bluetooth = anyConnected;
+  return s;
+}
+
+static bool status_equal(const StatusSnapshot &a, const StatusSnapshot &b) {
+  return a.scanning == b.scanning && a.battery == b.battery && a.cc1 == b.cc1 && a.cc2 == b.cc2 &&
+         a.lora == b.lora && a.nfc == b.nfc && a.wifi == b.wifi && a.bluetooth == b.bluetooth;
+}
+
+static void status_send(const StatusSnapshot &s) {
+  hw_send_status_protobuf(s.scanning, s.battery, s.cc1, s.cc2, s.lora, s.nfc, s.wifi, s.bluetooth,
+                          true /* ir */, true /* serial */);
+  statusSent = s;
+  statusSentValid = true;
+  statusSentMs = millis();
+  statusStats.sent++;
+}
+
+// Send the snapshot if it differs from the last one sent, or as a heartbeat.
+static void status_report_changes() {
+  if (!presence.probed) return;
+  StatusSnapshot s = status_snapshot();
+  if (statusSentValid && status_equal(s, statusSent)) {
+    if (millis() - statusSentMs < STATUS_HEARTBEAT_MS) return;
+    statusStats.heartbeats++;
+  }
+  status_send(s);
 }
 
+// status.info: probe now and always send.
 static void send_status_snapshot_protobuf() {
-  bool isScanning = scanningRadio;
-  bool cc1 = cc1101Connected();
-  bool cc2 = cc1101_2Connected();
-  bool loraConnected = (loraTx != nullptr);
-  bool nfcConnected = (nfc.getFirmwareVersion() != 0);
-  bool wifiConnected = (WiFi.getMode() != WIFI_MODE_NULL);
-  bool bluetoothConnected = anyConnected;
-  bool irConnected = true;
-  bool serialConnected = true;
-
-  hw_send_status_protobuf(isScanning,
-                          batteryPercent,
-                          cc1,
-                          cc2,
-                          loraConnected,
-                          nfcConnected,
-                          wifiConnected,
-                          bluetoothConnected,
-                          irConnected,
-                          serialConnected);
-}
-
-static void set_scan_modulation_single(const String &value) {
-  scanModulation.clear();
-  if (value.length() > 0) scanModulation.push_back(value);
-}
-
-static void set_scan_modulation_pair(const String &v1, const String &v2) {
-  scanModulation.clear();
-  if (v1.length() > 0) scanModulation.push_back(v1);
-  if (v2.length() > 0) {
-    if (scanModulation.empty() || scanModulation[0] != v2) scanModulation.push_back(v2);
-  }
-  if (scanModulation.size() > 2) scanModulation.resize(2);
-}
-
-static void set_scan_modulation_index(size_t idx, const String &value) {
+  presence_refresh();
+  status_send(status_snapshot());
+}
+
+void events_status_stats(EventsStatusStats &out) { out = statusStats; }
+
+static void set_scan_target(ScanTarget target) {
+  scanModulation.target = target;
+  scanModulation.radio[0] = scanModulation.radio[1] = MOD_UNKNOWN;
+}
+
+static void set_scan_modulation_pair(ModulationType m1, ModulationType m2) {
+  scanModulation.target = SCAN_TARGET_SUBGHZ;
+  scanModulation.radio[0] = m1;
+  scanModulation.radio[1] = m2;
+}
+
+// One CC1101's modulation changed; whatever the scan is after stays.
+static void set_scan_modulation_index(size_t idx, ModulationType m) {
   if (idx > 1) return;
-  while (scanModulation.size() <= idx) scanModulation.push_back("");
-  scanModulation[idx] = value;
-  if (scanModulation.size() > 2) scanModulation.resize(2);
-  while (!scanModulation.empty() && scanModulation.back().length() == 0) {
-    scanModulation.pop_back();
-  }
+  scanModulation.radio[idx] = m;
 }
 
-static bool scan_modulation_contains(const String &value) {
-  for (const auto &item : scanModulation) {
-    if (item == value) return true;
+// "WIFI", or the sub-GHz modulations as "OOK,2-FSK" ("OOK" when both match).
+static void scan_modulation_describe(FixedString<16> &out) {
+  static const char *const targetNames[] = {"", "WIFI", "BLE", "NFC", "IR"};
+  out.assign(targetNames[scanModulation.target]);
+  if (scanModulation.target != SCAN_TARGET_SUBGHZ) return;
+  for (size_t i = 0; i < 2; ++i) {
+    ModulationType m = scanModulation.radio[i];
+    if (m == MOD_UNKNOWN || (i == 1 && m == scanModulation.radio[0])) continue;
+    if (!out.empty()) out.append(',');
+    out.append(modulationToString(m));
   }
-  return false;
 }
 
-static String scan_modulation_joined() {
-  String out;
-  for (size_t i = 0; i < scanModulation.size(); ++i) {
-    if (scanModulation[i].length() == 0) continue;
-    if (out.length() > 0) out += ",";
-    out += scanModulation[i];
+// ---------------------------------------------------------------------------
+// Incoming BLE command rings
+//
+// Single-producer / single-consumer, lock-free: the BLE host task
+// (CommandCallbacks::onWrite) is the only producer and the main loop
+// (events_process_one) the only consumer. Slots are preallocated and large
+// enough for any characteristic write the stack can deliver (a GATT value is
+// capped at 512 bytes, long/prepared writes included, so this also covers
+// the largest ATT MTU), which means the producer never allocates, locks or
+// prints. Head/tail are free-running counters; the producer publishes a slot
+// with a release store of `tail`, the consumer frees it with a release
+// store of `head`.
+//
+// There are two lanes. Control commands (stops, status.info, pair.set; see
+// events_classify) go into a small lane that is always drained first, so
+// they overtake queued work, and a queued sub-GHz stop also cuts a running
+// sweep short (events_preempt_requested). Everything else is normal traffic, paced
+// by the credit limit advertised in the "flow" notification.
+// ---------------------------------------------------------------------------
+
+static const uint16_t EVENT_SLOT_CAPACITY = 512;
+static const uint32_t EVENT_QUEUE_SIZE = 16;         // normal lane, power of two
+static const uint32_t EVENT_CONTROL_QUEUE_SIZE = 4;  // control lane, power of two
+static_assert((EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) == 0, "EVENT_QUEUE_SIZE must be a power of two");
+static_assert((EVENT_CONTROL_QUEUE_SIZE & (EVENT_CONTROL_QUEUE_SIZE - 1)) == 0,
+              "EVENT_CONTROL_QUEUE_SIZE must be a power of two");
+
+struct EventSlot {
+  uint16_t len;
+  int16_t id;                          // CommandId from events_classify (CMDID_UNKNOWN if none)
+  bool cancelled;                      // superseded by a later stop (consumer only)
+  uint32_t seq;                        // arrival order across both lanes
+  uint32_t enqueuedUs;                 // micros() at the BLE write, for latency stats
+  char data[EVENT_SLOT_CAPACITY + 1];  // NUL-terminated for logging
+};
+
+struct EventLane {
+  EventSlot *slots;
+  uint32_t size;
+  std::atomic<uint32_t> head{0};       // next slot to consume (main loop)
+  std::atomic<uint32_t> tail{0};       // next slot to fill (BLE task)
+  std::atomic<uint32_t> dropped{0};    // writes rejected: lane full
+  std::atomic<uint32_t> highWater{0};  // deepest the lane has been (BLE task)
+};
+
+static EventSlot eventControlSlots[EVENT_CONTROL_QUEUE_SIZE];
+static EventSlot eventNormalSlots[EVENT_QUEUE_SIZE];
+static EventLane controlLane = {eventControlSlots, EVENT_CONTROL_QUEUE_SIZE};
+static EventLane normalLane = {eventNormalSlots, EVENT_QUEUE_SIZE};
+static std::atomic<uint32_t> eventOversize{0};  // writes rejected: > EVENT_SLOT_CAPACITY
+static std::atomic<bool> eventPreempt{false};   // a sub-GHz stop is waiting in the control lane
+static uint32_t eventSeq = 0;                   // BLE task only
+static uint32_t eventOverflowsReported = 0;     // main loop only
+
+// Credit-based flow control for the normal lane. The device advertises a
+// cumulative limit: a client may have sent `limit` normal (non-control)
+// writes since it connected. The limit is raised as the queue drains, so a
+// client that honours it never overflows the lane. Main loop only, except
+// the reset request which the BLE task raises on connect.
+static uint32_t flowBase = 0;    // normal-lane writes received before this connection
+static uint32_t flowLimit = 0;   // absolute limit last advertised
+static std::atomic<bool> flowResetRequested{false};
+static std::atomic<uint32_t> flowResetBase{0};
+
+// Main-loop wake-up. Producers set a bit after publishing work; loop() sleeps
+// in events_wait() until a bit is set or its next deadline is due.
+static const EventBits_t EVENTS_WAKE_COMMAND = 1 << 0;  // command enqueued (or dropped)
+static const EventBits_t EVENTS_WAKE_OTHER = 1 << 1;    // events_wake(): state changed elsewhere
+static EventGroupHandle_t eventsWakeGroup = NULL;
+
+// While scanningRadio is set the transceivers are polled from the main loop
+// at this period (the cadence the old fixed delay(200) loop gave them).
+static const unsigned long EVENTS_RADIO_POLL_MS = 200;
+static unsigned long radioPollDueMs = 0;
+
+// Command-to-ack latency: BLE write until events_process_one() has handled
+// the command (and sent its reply).
+static EventsLatencyStats commandLatency = {};
+
+static void events_lane_reset(EventLane &lane) {
+  lane.head.store(0, std::memory_order_relaxed);
+  lane.tail.store(0, std::memory_order_relaxed);
+  lane.dropped.store(0, std::memory_order_relaxed);
+  lane.highWater.store(0, std::memory_order_relaxed);
+}
+
+void events_init() {
+  if (eventsWakeGroup == NULL) eventsWakeGroup = xEventGroupCreate();
+  commandLatency = EventsLatencyStats();
+  events_lane_reset(controlLane);
+  events_lane_reset(normalLane);
+  eventOversize.store(0, std::memory_order_relaxed);
+  eventPreempt.store(false, std::memory_order_relaxed);
+  eventSeq = 0;
+  eventOverflowsReported = 0;
+  flowBase = 0;
+  flowLimit = EVENT_QUEUE_SIZE;
+  flowResetRequested.store(false, std::memory_order_relaxed);
+  flowResetBase.store(0, std::memory_order_relaxed);
+  radio_policies_init();
+}
+
+// Naive substring search over a non-terminated buffer (memmem is not
+// available everywhere).
+static const char *events_find(const char *p, size_t len, const char *needle) {
+  size_t n = strlen(needle);
+  for (size_t i = 0; i + n <= len; ++i) {
+    if (memcmp(p + i, needle, n) == 0) return p + i;
   }
-  return out;
+  return nullptr;
 }
 
-// Simple ring-buffer queue for incoming BLE command strings
-static const int EVENT_QUEUE_SIZE = 12;
-static String eventQueue[EVENT_QUEUE_SIZE];
-static int eventHead = 0;
-static int eventTail = 0;
-static int eventCount = 0;
-static portMUX_TYPE eventQueueMux = portMUX_INITIALIZER_UNLOCKED;
+// Table entry a binary command names: command_id (CommandId + 1) or, when
+// that is 0, its key.
+static const CommandSpec *command_protobuf_spec(const Command_pb &m) {
+  if (m.command_id > 0) return m.command_id <= SHARKOS_BT_COMMAND_COUNT ? command_spec((CommandId)(m.command_id - 1)) : nullptr;
+  return command_lookup((const char *)m.command.data, m.command.len);
+}
 
-void events_init() {
-  portENTER_CRITICAL(&eventQueueMux);
-  eventHead = eventTail = eventCount = 0;
-  portEXIT_CRITICAL(&eventQueueMux);
+// Producer-side triage of a raw write, without a JSON parse: returns true
+// for control traffic and sets `preempt` for stops of the sub-GHz scan, the
+// only thing the sweeps in transceivers.h give way to. Recognises plain keys,
+// {"command":"<key>",...}, framed protobuf commands and the legacy
+// StopRadioScan / GetStatus / Pair messages; batches and anything
+// unrecognised are normal traffic. Getting it wrong only costs ordering, the
+// consumer still parses everything.
+static bool events_classify(const char *p, size_t len, CommandId &id, bool &preempt) {
+  id = CMDID_UNKNOWN;
+  preempt = false;
+  const CommandSpec *spec = nullptr;
+  PbIStream msg;
+  if (pb_frame_message((const uint8_t *)p, len, msg)) {
+    Command_pb m;
+    if (pb_decode_Command(msg, m)) spec = command_protobuf_spec(m);
+  } else {
+    while (len > 0 && isspace((unsigned char)*p)) { ++p; --len; }
+    while (len > 0 && isspace((unsigned char)p[len - 1])) --len;
+
+    if (len == 0 || p[0] != '{') {
+      spec = command_lookup(p, len);
+    } else if (events_find(p, len, "\"batch\"")) {
+      return false;
+    } else if (const char *k = events_find(p, len, "\"command\"")) {
+      const char *end = p + len;
+      k += 9;
+      while (k < end && isspace((unsigned char)*k)) ++k;
+      if (k >= end || *k++ != ':') return false;
+      while (k < end && isspace((unsigned char)*k)) ++k;
+      if (k >= end || *k++ != '"') return false;
+      const char *q = k;
+      while (q < end && *q != '"' && *q != '\\') ++q;
+      if (q >= end || *q != '"') return false;
+      spec = command_lookup(k, (size_t)(q - k));
+    } else if (events_find(p, len, "\"Command\"")) {
+      if (events_find(p, len, "\"StopRadioScan\"")) {
+        preempt = true;
+        return true;
+      }
+      return events_find(p, len, "\"GetStatus\"") || events_find(p, len, "\"Pair\"");
+    }
+  }
+
+  if (!spec) return false;
+  id = spec->id;
+  preempt = spec->role == COMMAND_STOP && spec->scan == SCAN_SUBGHZ;
+  return command_is_control(*spec);
 }
 
-bool events_enqueue_command(const String &cmd) {
-  portENTER_CRITICAL(&eventQueueMux);
-  if (eventCount >= EVENT_QUEUE_SIZE) {
-    portEXIT_CRITICAL(&eventQueueMux);
-    // queue full
+static uint32_t events_lane_depth(const EventLane &lane) {
+  return lane.tail.load(std::memory_order_acquire) - lane.head.load(std::memory_order_acquire);
+}
+
+// Producer side. Must only be called from the BLE host task.
+bool events_enqueue_command_bytes(const uint8_t *data, size_t len) {
+  if (len > EVENT_SLOT_CAPACITY) {
+    eventOversize.fetch_add(1, std::memory_order_relaxed);
+    if (eventsWakeGroup) xEventGroupSetBits(eventsWakeGroup, EVENTS_WAKE_COMMAND);
+    return false;
+  }
+  CommandId id;
+  bool preempt;
+  EventLane &lane = events_classify((const char *)data, len, id, preempt) ? controlLane : normalLane;
+
+  uint32_t tail = lane.tail.load(std::memory_order_relaxed);
+  uint32_t head = lane.head.load(std::memory_order_acquire);
+  if (tail - head >= lane.size) {
+    // lane full; reported from the main loop
+    lane.dropped.fetch_add(1, std::memory_order_relaxed);
+    if (eventsWakeGroup) xEventGroupSetBits(eventsWakeGroup, EVENTS_WAKE_COMMAND);
     return false;
   }
-  eventQueue[eventTail] = cmd;
-  eventTail = (eventTail + 1) % EVENT_QUEUE_SIZE;
-  eventCount++;
-  portEXIT_CRITICAL(&eventQueueMux);
+  EventSlot &slot = lane.slots[tail & (lane.size - 1)];
+  memcpy(slot.data, data, len);
+  slot.data[len] = 0;
+  slot.len = (uint16_t)len;
+  slot.id = (int16_t)id;
+  slot.cancelled = false;
+  slot.seq = eventSeq++;
+  slot.enqueuedUs = (uint32_t)micros();
+  lane.tail.store(tail + 1, std::memory_order_release);
+  if (tail + 1 - head > lane.highWater.load(std::memory_order_relaxed)) {
+    lane.highWater.store(tail + 1 - head, std::memory_order_relaxed);
+  }
+  if (preempt) eventPreempt.store(true, std::memory_order_release);
+  if (eventsWakeGroup) xEventGroupSetBits(eventsWakeGroup, EVENTS_WAKE_COMMAND);
   return true;
 }
 
+bool events_enqueue_command(const String &cmd) {
+  return events_enqueue_command_bytes((const uint8_t *)cmd.c_str(), cmd.length());
+}
+
+uint32_t events_queue_overflows() {
+  return controlLane.dropped.load(std::memory_order_relaxed) + normalLane.dropped.load(std::memory_order_relaxed) +
+         eventOversize.load(std::memory_order_relaxed);
+}
+
+bool events_preempt_requested() { return eventPreempt.load(std::memory_order_acquire); }
+
+void events_flow_reset() {
+  // runs in the BLE task, so the producer counters are stable here
+  flowResetBase.store(normalLane.tail.load(std::memory_order_relaxed) + normalLane.dropped.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+  flowResetRequested.store(true, std::memory_order_release);
+  events_wake();
+}
+
+static void events_lane_stats(const EventLane &lane, EventsLaneStats &out) {
+  out.depth = events_lane_depth(lane);
+  out.highWater = lane.highWater.load(std::memory_order_relaxed);
+  out.dropped = lane.dropped.load(std::memory_order_relaxed);
+}
+
+void events_queue_stats(EventsQueueStats &out) {
+  events_lane_stats(controlLane, out.control);
+  events_lane_stats(normalLane, out.normal);
+  out.oversize = eventOversize.load(std::memory_order_relaxed);
+  out.creditLimit = flowLimit - flowBase;
+}
+
 // Central BLE -> events wrapper.  
 // This used to drop every incoming command when the unit was unpaired,
 // which meant the BLE write log looked successful even though nothing
 // ever executed.  We now always enqueue the string; pairing restrictions
-// are enforced later by the dispatcher if required.
+// are enforced later by the dispatcher if required. Runs in the BLE host
+// task, so it only copies into the ring: logging and the queue-full error
+// are left to events_process_one().
+void bluetooth_receive_command_bytes(const uint8_t *data, size_t len) {
+  // the enqueue wakes the main loop; no yield or Serial needed here
+  (void)events_enqueue_command_bytes(data, len);
+}
+
 void bluetooth_receive_command(const String &cmd) {
-  // Use critical section for Serial to prevent garbled output if interrupt occurs during print
-  portENTER_CRITICAL(&eventQueueMux);
-  Serial.print("enqueue BLE command: "); Serial.println(cmd);
-  portEXIT_CRITICAL(&eventQueueMux);
+  bluetooth_receive_command_bytes((const uint8_t *)cmd.c_str(), cmd.length());
+}
 
-  if (!events_enqueue_command(cmd)) {
-    Serial.println("Event queue full — dropping BLE command");
-    notifyStatus("ERROR:event_queue_full");
-  } else {
-    // Force yield to ensure main loop gets a chance
-    taskYIELD();
+// Consumer side (main loop). Control lane first; the returned slot stays
+// owned by the consumer until events_release_slot().
+static EventLane *events_next_lane() {
+  if (events_lane_depth(controlLane) > 0) return &controlLane;
+  if (events_lane_depth(normalLane) > 0) return &normalLane;
+  return nullptr;
+}
+
+static EventSlot *events_peek_slot(EventLane &lane) {
+  uint32_t head = lane.head.load(std::memory_order_relaxed);
+  return &lane.slots[head & (lane.size - 1)];
+}
+
+static void events_release_slot(EventLane &lane) {
+  lane.head.store(lane.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  if (&lane == &controlLane && events_lane_depth(controlLane) == 0) {
+    eventPreempt.store(false, std::memory_order_release);
   }
 }
 
-static String events_dequeue() {
-  portENTER_CRITICAL(&eventQueueMux);
-  if (eventCount == 0) {
-    portEXIT_CRITICAL(&eventQueueMux);
-    return String("");
+// A stop taken from the control lane has overtaken whatever normal traffic
+// arrived before it; starts of the same scan among that traffic would undo
+// it, so they are answered "<key>:cancelled" instead of being run.
+static void events_cancel_superseded(const EventSlot &stop) {
+  const CommandSpec *spec = command_spec((CommandId)stop.id);
+  if (!spec || spec->role != COMMAND_STOP || spec->pair == CMDID_UNKNOWN) return;
+  uint32_t tail = normalLane.tail.load(std::memory_order_acquire);
+  for (uint32_t i = normalLane.head.load(std::memory_order_relaxed); i != tail; ++i) {
+    EventSlot &slot = normalLane.slots[i & (normalLane.size - 1)];
+    if (slot.id == spec->pair && (int32_t)(slot.seq - stop.seq) < 0) slot.cancelled = true;
   }
-  String s = eventQueue[eventHead];
-  eventHead = (eventHead + 1) % EVENT_QUEUE_SIZE;
-  eventCount--;
-  portEXIT_CRITICAL(&eventQueueMux);
-  return s;
+}
+
+static bool events_command_pending() {
+  return events_lane_depth(controlLane) > 0 || events_lane_depth(normalLane) > 0 ||
+         events_queue_overflows() != eventOverflowsReported ||
+         flowResetRequested.load(std::memory_order_relaxed);
+}
+
+// Send {"flow":{"limit":..,"depth":..,"hwm":..,"dropped":..}}.
+static void events_send_flow() {
+  EventsQueueStats st;
+  events_queue_stats(st);
+  char out[96];
+  snprintf(out, sizeof(out), "{\"flow\":{\"limit\":%u,\"depth\":%u,\"hwm\":%u,\"dropped\":%u}}",
+           (unsigned)st.creditLimit, (unsigned)st.normal.depth, (unsigned)st.normal.highWater,
+           (unsigned)(st.normal.dropped + st.control.dropped + st.oversize));
+  notifyStatus(out);
+}
+
+// Raise the advertised limit once the client has used up half of what it
+// was granted and the queue has room for at least a quarter more, so grants
+// go out in chunks rather than one per command. `force` re-advertises even
+// when the limit is unchanged (after a connect or a drop).
+static void events_update_flow(bool force) {
+  uint32_t head = normalLane.head.load(std::memory_order_relaxed);
+  uint32_t received = normalLane.tail.load(std::memory_order_acquire) + normalLane.dropped.load(std::memory_order_relaxed);
+  uint32_t limit = head + EVENT_QUEUE_SIZE;
+  bool low = (int32_t)(flowLimit - received) <= (int32_t)(EVENT_QUEUE_SIZE / 2);
+  int32_t raise = (int32_t)(limit - flowLimit);
+  if (raise > 0 && (force || (low && raise >= (int32_t)(EVENT_QUEUE_SIZE / 4)))) {
+    flowLimit = limit;
+    events_send_flow();
+  } else if (force) {
+    events_send_flow();
+  }
+}
+
+void events_wake() {
+  if (eventsWakeGroup) xEventGroupSetBits(eventsWakeGroup, EVENTS_WAKE_OTHER);
+}
+
+void events_wait(unsigned long timeoutMs) {
+  if (events_command_pending() || timeoutMs == 0) return;
+  if (eventsWakeGroup == NULL) {
+    delay(timeoutMs);
+    return;
+  }
+  xEventGroupWaitBits(eventsWakeGroup, EVENTS_WAKE_COMMAND | EVENTS_WAKE_OTHER, pdTRUE, pdFALSE,
+                      pdMS_TO_TICKS(timeoutMs));
+}
+
+void events_command_latency(EventsLatencyStats &out) { out = commandLatency; }
+void events_reset_command_latency() { commandLatency = EventsLatencyStats(); }
+
+static void events_record_latency(uint32_t enqueuedUs) {
+  uint32_t us = (uint32_t)micros() - enqueuedUs;
+  commandLatency.count++;
+  commandLatency.lastUs = us;
+  commandLatency.totalUs += us;
+  if (us > commandLatency.maxUs) commandLatency.maxUs = us;
 }
 
 // ---------------------------
-// Background (single) scan-loop manager
-// - Only one background "scan loop" may run at a time. Starting any new
-//   loop will stop the previously running one.
-// - Background tasks are called from `events_process_one()` (non-blocking)
-//   on a periodic interval and must not block the main loop.
+// Background job scheduler
+// - One job per ActiveScanKind may be active, and any number of kinds can
+//   run side by side. Starting a kind that is already running restarts it.
+// - Each job has an interval, a per-run time budget and the hardware it
+//   touches (JobResource). Jobs run from `events_process_one()` on the main
+//   loop, which keeps all SPI access on one task, and must not block.
+// - Next deadlines are kept in a min-heap, so a tick only looks at jobs
+//   that are due: O(log n) per run instead of a pass over every job.
+// - Jobs sharing a resource never run in the same tick; the later one is
+//   deferred to the next pass. A tick also stops starting jobs once
+//   EVENTS_JOB_TICK_BUDGET_MS worth of budgets is used, so queued commands
+//   are not held up behind a pile of due jobs.
+// - A bus with work on its bus worker (bus_workers.h) counts as busy, so
+//   jobs on that bus wait EVENTS_JOB_BUS_RETRY_MS and try again.
 // ---------------------------
 
-enum ActiveScanKind {
-  SCAN_NONE = 0,
-  SCAN_WIFI_SNIFFER,
-  SCAN_BLE,
-  SCAN_NRF,
-  SCAN_SUBGHZ,
-  SCAN_OSCILLOSCOPE,
-  SCAN_I2C,
-  SCAN_NFC_POLL,
-  SCAN_SENSOR_STREAM,
-  SCAN_STATUS_REPORT
-};
+// ActiveScanKind lives in commands.h alongside the command table that maps
+// start/stop keys onto it.
 
 typedef void (*bg_task_fn_t)();
-static ActiveScanKind activeScan = SCAN_NONE;
-static bg_task_fn_t activeScanFn = nullptr;
-static unsigned long activeScanIntervalMs = 1000;
-static unsigned long activeScanLastMs = 0;
-static String activeScanName = String();
-// Active scan RTOS task handle (only one may exist at a time)
-static TaskHandle_t activeScanTask = NULL;
-
-// Task runner that executes the active scan kind in a loop until stopped.
-static void active_scan_task_runner(void *param) {
-  (void)param;
-  const TickType_t delayTick = pdMS_TO_TICKS(activeScanIntervalMs ? activeScanIntervalMs : 2000);
-  while (activeScan != SCAN_NONE) {
-    // perform one iteration according to activeScan
-    switch (activeScan) {
-      case SCAN_WIFI_SNIFFER: {
-        // WiFi scanning DISABLED in RTOS task context.
-        // WiFi.scanNetworks() activates the WiFi radio which conflicts
-        // with ADC2 pins (GPIO 11-18) used by SPI radios, and is not
-        // safe to call from a non-main task. WiFi scanning is handled
-        // by runWifiBleScanTasks() called from the main loop.
-        break;
-      }
-      case SCAN_BLE: {
-        // BLE scanning DISABLED in RTOS task context.
-        // BLEScan::start() is NOT thread-safe and conflicts with the
-        // BLE GATT server (connection drops, crashes, watchdog resets).
-        // BLE scanning must only be triggered from the main loop when
-        // no GATT client is connected.
-        break;
-      }
-      case SCAN_SUBGHZ: {
-        // NOTE: Do NOT call runTransceiverPollTasks() from this RTOS task!
-        // It accesses SPI buses which are not thread-safe. The main loop
-        // already calls runTransceiverPollTasks() via events_process_one().
-        // Just signal that subghz scanning is active; the main-loop poll
-        // handles the actual SPI communication.
-        break;
-      }
-      default:
-        break;
-    }
-    // delay between iterations
-    vTaskDelay(delayTick);
+
+enum JobResource : uint8_t {
+  JOB_RES_NONE = 0,
+  JOB_RES_FSPI = 1 << 0,   // SPI2: CC1101 #1, nRF24, LoRa
+  JOB_RES_HSPI = 1 << 1,   // SPI3: CC1101 #2
+  JOB_RES_WIFI = 1 << 2,   // 2.4 GHz radio, shared by WiFi and BLE scans
+  JOB_RES_I2C  = 1 << 3    // PN532, I2C bus scan
+};
+
+static const unsigned long EVENTS_JOB_TICK_BUDGET_MS = 20;
+static const unsigned long EVENTS_JOB_BUS_RETRY_MS = 10;
+
+struct ScanJob {
+  bg_task_fn_t fn;
+  const char *name;
+  unsigned long intervalMs;
+  unsigned long budgetMs;      // expected worst-case run time
+  unsigned long dueMs;
+  uint8_t resources;           // JobResource bits
+  uint32_t overruns;           // runs that took longer than budgetMs
+  uint32_t runs, deferred, busRetries, firstTick, lastTick;  // EventsJobStats
+};
+
+static ScanJob scanJobs[SCAN_KIND_COUNT];
+static uint8_t jobHeap[SCAN_KIND_COUNT];     // ActiveScanKind, min-heap on dueMs
+static uint8_t jobHeapPos[SCAN_KIND_COUNT];  // index into jobHeap + 1, 0 when inactive
+static uint8_t jobHeapSize = 0;
+static uint32_t jobTicks = 0;                // scheduler passes, for EventsJobStats
+
+static bool job_before(uint8_t a, uint8_t b) { return (long)(scanJobs[a].dueMs - scanJobs[b].dueMs) < 0; }
+
+static void job_heap_swap(uint8_t i, uint8_t j) {
+  uint8_t t = jobHeap[i];
+  jobHeap[i] = jobHeap[j];
+  jobHeap[j] = t;
+  jobHeapPos[jobHeap[i]] = (uint8_t)(i + 1);
+  jobHeapPos[jobHeap[j]] = (uint8_t)(j + 1);
+}
+
+static void job_heap_sift_up(uint8_t i) {
+  while (i > 0) {
+    uint8_t parent = (uint8_t)((i - 1) / 2);
+    if (!job_before(jobHeap[i], jobHeap[parent])) break;
+    job_heap_swap(i, parent);
+    i = parent;
   }
-  // cleanup and delete task
-  TaskHandle_t self = xTaskGetCurrentTaskHandle();
-  if (self) vTaskDelete(self);
 }
 
-static void stop_active_scan_internal();
-static void start_active_scan_internal(ActiveScanKind kind, bg_task_fn_t fn, unsigned long intervalMs, const char *name);
+static void job_heap_sift_down(uint8_t i) {
+  for (;;) {
+    uint8_t l = (uint8_t)(2 * i + 1), r = (uint8_t)(2 * i + 2), m = i;
+    if (l < jobHeapSize && job_before(jobHeap[l], jobHeap[m])) m = l;
+    if (r < jobHeapSize && job_before(jobHeap[r], jobHeap[m])) m = r;
+    if (m == i) break;
+    job_heap_swap(i, m);
+    i = m;
+  }
+}
 
-// forward-declare internal response helper used throughout this file
-static void bluetooth_send_response_internal(const String &payload, const String &inReplyTo = String());
+static void job_heap_push(ActiveScanKind kind) {
+  uint8_t i = jobHeapSize++;
+  jobHeap[i] = (uint8_t)kind;
+  jobHeapPos[kind] = (uint8_t)(i + 1);
+  job_heap_sift_up(i);
+}
 
-static void scan_loop_tick() {
-  if (activeScanFn == nullptr) return;
-  unsigned long now = millis();
-  if (activeScanLastMs == 0 || now - activeScanLastMs >= activeScanIntervalMs) {
-    activeScanLastMs = now;
-    activeScanFn();
+static void job_heap_remove(ActiveScanKind kind) {
+  if (jobHeapPos[kind] == 0) return;
+  uint8_t pos = (uint8_t)(jobHeapPos[kind] - 1);
+  uint8_t last = --jobHeapSize;
+  if (pos != last) {
+    job_heap_swap(pos, last);
+    job_heap_sift_down(pos);
+    job_heap_sift_up(pos);
   }
+  jobHeapPos[kind] = 0;
 }
 
-static void start_active_scan_internal(ActiveScanKind kind, bg_task_fn_t fn, unsigned long intervalMs, const char *name) {
-  // stop any existing scan first
-  if (activeScan != SCAN_NONE) stop_active_scan_internal();
-  activeScan = kind;
-  activeScanFn = fn;
-  activeScanIntervalMs = intervalMs;
-  activeScanLastMs = 0;
-  activeScanName = name ? String(name) : String();
-  Serial.print("Started background scan: "); Serial.println(activeScanName);
-  // spawn RTOS task to run the scan loop
-  if (activeScanTask != NULL) {
-    vTaskDelete(activeScanTask);
-    activeScanTask = NULL;
+static bool job_active(ActiveScanKind kind) { return kind > SCAN_NONE && kind < SCAN_KIND_COUNT && jobHeapPos[kind] != 0; }
+
+static void stop_active_scan_internal(ActiveScanKind kind);
+static void start_active_scan_internal(ActiveScanKind kind, bg_task_fn_t fn, unsigned long intervalMs,
+                                       unsigned long budgetMs, uint8_t resources, const char *name);
+
+// forward-declare internal response helpers used throughout this file
+static void bluetooth_send_response_internal(const char *payload, const char *inReplyTo = "");
+static void bluetooth_send_response_internal(const String &payload, const char *inReplyTo = "");
+
+// Run every job that is due, earliest deadline first.
+static void scan_loop_tick() {
+  if (jobHeapSize == 0) return;
+  if (presenceStale) {
+    presenceStale = false;
+    if (job_active(SCAN_PRESENCE_REFRESH)) {  // otherwise status.info probes anyway
+      job_heap_remove(SCAN_PRESENCE_REFRESH);
+      scanJobs[SCAN_PRESENCE_REFRESH].dueMs = millis();
+      job_heap_push(SCAN_PRESENCE_REFRESH);
+    }
   }
-  BaseType_t res = xTaskCreate(active_scan_task_runner, "active_scan", 8 * 1024, NULL, 1, &activeScanTask);
-  if (res != pdPASS) {
-    Serial.println("Failed to create active_scan task");
-    activeScan = SCAN_NONE;
-    activeScanTask = NULL;
+  unsigned long tickStart = millis();
+  unsigned long budgetUsed = 0;
+  ++jobTicks;
+  uint8_t workerBusy = JOB_RES_NONE;
+  if (bus_worker_busy(SPI_BUS_FSPI)) workerBusy |= JOB_RES_FSPI;
+  if (bus_worker_busy(SPI_BUS_HSPI)) workerBusy |= JOB_RES_HSPI;
+  uint8_t busy = JOB_RES_NONE;
+  uint8_t deferred[SCAN_KIND_COUNT];
+  uint8_t deferredCount = 0;
+
+  while (jobHeapSize > 0) {
+    ActiveScanKind kind = (ActiveScanKind)jobHeap[0];
+    ScanJob &job = scanJobs[kind];
+    if ((long)(job.dueMs - tickStart) > 0) break;
+    job_heap_remove(kind);
+
+    if (job.resources & workerBusy) {
+      // bus owned by its worker until the current sweep finishes
+      job.dueMs = tickStart + EVENTS_JOB_BUS_RETRY_MS;
+      job.busRetries++;
+      deferred[deferredCount++] = (uint8_t)kind;
+      continue;
+    }
+    bool overBudget = budgetUsed > 0 && budgetUsed + job.budgetMs > EVENTS_JOB_TICK_BUDGET_MS;
+    if ((job.resources & busy) || overBudget) {
+      deferred[deferredCount++] = (uint8_t)kind;  // stays due; first in line next pass
+      job.deferred++;
+      continue;
+    }
+    busy |= job.resources;
+    budgetUsed += job.budgetMs;
+    if (job.runs++ == 0) job.firstTick = jobTicks;
+    job.lastTick = jobTicks;
+
+    unsigned long t0 = millis();
+    job.fn();
+    unsigned long ran = millis() - t0;
+    if (ran > job.budgetMs) {
+      job.overruns++;
+      Serial.printf("Background job %s ran %lums (budget %lums)\n", job.name, ran, job.budgetMs);
+    }
+    job.dueMs = t0 + job.intervalMs;
+    job_heap_push(kind);
   }
+
+  for (uint8_t i = 0; i < deferredCount; ++i) job_heap_push((ActiveScanKind)deferred[i]);
+}
+
+static void start_active_scan_internal(ActiveScanKind kind, bg_task_fn_t fn, unsigned long intervalMs,
+                                       unsigned long budgetMs, uint8_t resources, const char *name) {
+  // restarting a kind replaces it; other kinds keep running
+  if (job_active(kind)) stop_active_scan_internal(kind);
+  ScanJob &job = scanJobs[kind];
+  job.fn = fn;
+  job.name = name ? name : "";
+  job.intervalMs = intervalMs;
+  job.budgetMs = budgetMs;
+  job.dueMs = millis();
+  job.resources = resources;
+  job.overruns = 0;
+  job.runs = job.deferred = job.busRetries = job.firstTick = job.lastTick = 0;
+  job_heap_push(kind);
+  Serial.print("Started background job: "); Serial.println(job.name);
 }
 
-static void stop_active_scan_internal() {
-  if (activeScan == SCAN_NONE) return;
-  Serial.print("Stopping background scan: "); Serial.println(activeScanName);
+static void stop_active_scan_internal(ActiveScanKind kind) {
+  if (!job_active(kind)) return;
+  Serial.print("Stopping background job: "); Serial.println(scanJobs[kind].name);
 
   // clear scan-specific flags that older code may rely on
-  if (activeScan == SCAN_SUBGHZ) scanningRadio = false;
-  if (activeScan == SCAN_NFC_POLL) readingNfc = false;
+  if (kind == SCAN_SUBGHZ) scanningRadio = false;
+  if (kind == SCAN_NFC_POLL) readingNfc = false;
 
-  activeScan = SCAN_NONE;
-  activeScanFn = nullptr;
-  activeScanIntervalMs = 1000;
-  activeScanLastMs = 0;
-  activeScanName = String();
-  // delete task if exists
-  if (activeScanTask != NULL) {
-    vTaskDelete(activeScanTask);
-    activeScanTask = NULL;
-  }
+  job_heap_remove(kind);
+  scanJobs[kind].fn = nullptr;
+  if (kind == SCAN_STATUS_REPORT) stop_active_scan_internal(SCAN_PRESENCE_REFRESH);
+}
+
+void events_job_stats(int kind, EventsJobStats &out) {
+  out = EventsJobStats();
+  if (kind <= SCAN_NONE || kind >= SCAN_KIND_COUNT) return;
+  const ScanJob &job = scanJobs[kind];
+  out.active = job_active((ActiveScanKind)kind);
+  out.runs = job.runs;
+  out.deferred = job.deferred;
+  out.busRetries = job.busRetries;
+  out.firstTick = job.firstTick;
+  out.lastTick = job.lastTick;
 }
 
-// Helper used by dispatch_command_key to start/stop by command key
-static void start_scan_for_key(const String &key, const JsonObject *params = nullptr) {
-  if (key == CMD_WIFI_SNIFFER_START) {
+// Only flags the cache: the next scan_loop_tick() moves presence_refresh to
+// the front, so this is safe from inside a job too.
+void events_presence_invalidate() { presenceStale = true; }
+
+// Table handler for COMMAND_START entries that own a background scan loop.
+// Plain-key commands simply carry no params.
+void cmd_handle_scan_start(const Command &cmd) {
+  const CommandId id = cmd.id;
+  if (id == CMDID_WIFI_SNIFFER_START) {
     start_active_scan_internal(SCAN_WIFI_SNIFFER, [](){
       // non-blocking WiFi sniffer: start async scan if not running, then
       // collect results when complete and notify.
@@ -400,6 +1206,7 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
       static unsigned long pendingUntil = 0;
       if (!pending) {
         (void)WiFi.scanNetworks(true); // start async
+        events_presence_invalidate();  // the scan switches the WiFi radio on
         pending = true;
         pendingUntil = millis() + 5000;
         return;
@@ -425,13 +1232,13 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
         pending = false;
         notifyStatus("ERROR:wifi_scan_timeout");
       }
-    }, 6000, "wifi_sniffer");
+    }, 6000, 10, JOB_RES_WIFI, "wifi_sniffer");
     bluetooth_send_response_internal("wifi.sniffer:started");
     return;
   }
 
-  if (key == CMD_BLE_SCAN_START) {
-    set_scan_modulation_single("BLE");
+  if (id == CMDID_BLE_SCAN_START) {
+    set_scan_target(SCAN_TARGET_BLE);
     // BLE scanning runs from the main loop scan_loop_tick(), NOT an RTOS task.
     // This avoids thread-safety issues with the BLE GATT server.
     start_active_scan_internal(SCAN_BLE, [](){
@@ -448,21 +1255,21 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
         JsonArray arr = out.createNestedArray("Devices");
         for (size_t i = 0; i < blescanner_devices.size() && i < 20; ++i) {
           JsonObject d = arr.createNestedObject();
-          d["name"] = blescanner_devices[i].name;
-          d["addr"] = blescanner_devices[i].address;
+          d["name"] = blescanner_devices[i].name.c_str();
+          d["addr"] = blescanner_devices[i].address.c_str();
           d["rssi"] = blescanner_devices[i].rssi;
-          d["manuf"] = blescanner_devices[i].manufacturer;
+          d["manuf"] = blescanner_devices[i].manufacturer.c_str();
         }
         String s; serializeJson(out, s);
         notifyStatus(s.c_str());
         reportAt = 0;
       }
-    }, 6000, "ble_scan");
+    }, 6000, 10, JOB_RES_WIFI, "ble_scan");
     bluetooth_send_response_internal("ble.scan:started");
     return;
   }
 
-  if (key == CMD_SUBGHZ_READ_START) {
+  if (id == CMDID_SUBGHZ_READ_START) {
     // optional params:
     // {
     //   frequency_khz|frequency_mhz,
@@ -474,54 +1281,51 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
     // }
     float topMHz = 0.0f;
     float botMHz = 0.0f;
-    String mod1 = "OOK";
-    String mod2 = "2-FSK";
+    ModulationType mod1 = MOD_OOK;
+    ModulationType mod2 = MOD_2FSK;
 
-    if (params && params->containsKey("frequency_khz")) {
-      long fk = (*params)["frequency_khz"].as<long>();
+    if (cmd.has("frequency_khz")) {
+      long fk = cmd.paramInt("frequency_khz");
       if (fk > 0) {
         scanFrequency = ((float)fk) / 1000.0; // store as MHz
         topMHz = scanFrequency;
       }
-    } else if (params && params->containsKey("frequency_mhz")) {
-      float fm = (*params)["frequency_mhz"].as<float>();
+    } else if (cmd.has("frequency_mhz")) {
+      float fm = cmd.paramFloat("frequency_mhz");
       if (fm > 0.0) {
         scanFrequency = fm;
         topMHz = fm;
       }
     }
 
-    if (params && params->containsKey("top_frequency_mhz")) {
-      float v = (*params)["top_frequency_mhz"].as<float>();
+    if (cmd.has("top_frequency_mhz")) {
+      float v = cmd.paramFloat("top_frequency_mhz");
       if (v > 0.0f) topMHz = v;
-    } else if (params && params->containsKey("top_freq_mhz")) {
-      float v = (*params)["top_freq_mhz"].as<float>();
+    } else if (cmd.has("top_freq_mhz")) {
+      float v = cmd.paramFloat("top_freq_mhz");
       if (v > 0.0f) topMHz = v;
     }
 
-    if (params && params->containsKey("bottom_frequency_mhz")) {
-      float v = (*params)["bottom_frequency_mhz"].as<float>();
+    if (cmd.has("bottom_frequency_mhz")) {
+      float v = cmd.paramFloat("bottom_frequency_mhz");
       if (v > 0.0f) botMHz = v;
-    } else if (params && params->containsKey("bot_frequency_mhz")) {
-      float v = (*params)["bot_frequency_mhz"].as<float>();
+    } else if (cmd.has("bot_frequency_mhz")) {
+      float v = cmd.paramFloat("bot_frequency_mhz");
       if (v > 0.0f) botMHz = v;
     }
 
-    if (params && params->containsKey("modulation")) {
-      const char *m = (*params)["modulation"];
-      if (m) {
-        mod1 = String(m);
-        mod2 = String(m);
-      }
+    if (cmd.has("modulation")) {
+      const char *m = cmd.paramString("modulation");
+      if (m) mod1 = mod2 = modulationFromString(m);
     }
 
-    if (params && params->containsKey("modulation_one")) {
-      const char *m = (*params)["modulation_one"];
-      if (m) mod1 = String(m);
+    if (cmd.has("modulation_one")) {
+      const char *m = cmd.paramString("modulation_one");
+      if (m) mod1 = modulationFromString(m);
     }
-    if (params && params->containsKey("modulation_two")) {
-      const char *m = (*params)["modulation_two"];
-      if (m) mod2 = String(m);
+    if (cmd.has("modulation_two")) {
+      const char *m = cmd.paramString("modulation_two");
+      if (m) mod2 = modulationFromString(m);
     }
 
     if (topMHz <= 0.0f) topMHz = 433.0f;
@@ -532,6 +1336,7 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
       botMHz = t;
     }
 
+    subghz_wait_buses_idle();
     if (cc1101Tx) {
       cc1101Tx->setTopFrequency(topMHz);
       cc1101Tx->setBotFrequency(botMHz);
@@ -544,14 +1349,15 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
     }
     set_scan_modulation_pair(mod1, mod2);
 
-    // use existing cc1101Read() which is non-blocking and reports via notifyStatus
-    start_active_scan_internal(SCAN_SUBGHZ, [](){ cc1101Read(); }, 2000, "subghz_read");
+    // each tick hands one sweep per radio to the bus workers; samples come
+    // back through bus_workers_publish()
+    start_active_scan_internal(SCAN_SUBGHZ, [](){ cc1101ReadAsync(); }, 2000, 2, JOB_RES_FSPI | JOB_RES_HSPI, "subghz_read");
     scanningRadio = true; // keep compatibility with older handlers
     bluetooth_send_response_internal("subghz.read:started");
     return;
   }
 
-  if (key == CMD_NRF_SCAN_START) {
+  if (id == CMDID_NRF_SCAN_START) {
     // lightweight non-blocking nRF sampling: sample a few channels per tick
     // NOTE: SPI access is NOT thread-safe. This lambda runs from scan_loop_tick()
     // in the main loop context, which is safe.
@@ -569,12 +1375,12 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
       String s; serializeJson(out, s);
       notifyStatus(s.c_str());
       ch = (ch + 1) % 126;
-    }, 200, "nrf_scan");
+    }, 200, 2, JOB_RES_FSPI, "nrf_scan");
     bluetooth_send_response_internal("nrf.scan:started");
     return;
   }
 
-  if (key == CMD_OSCILLOSCOPE_START) {
+  if (id == CMDID_OSCILLOSCOPE_START) {
     start_active_scan_internal(SCAN_OSCILLOSCOPE, [](){
       // NOTE: GPIO 3 (ANALOG_PIN) is a strapping pin. analogRead() is safe
       // after boot but we guard with a try to avoid crashes if pin is
@@ -584,23 +1390,23 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
       out["analog"] = raw;
       String s; serializeJson(out, s);
       notifyStatus(s.c_str());
-    }, 200, "oscilloscope"); // slowed from 100ms to 200ms to reduce load
+    }, 200, 2, JOB_RES_NONE, "oscilloscope"); // slowed from 100ms to 200ms to reduce load
     bluetooth_send_response_internal("oscilloscope:started");
     return;
   }
 
-  if (key == CMD_I2C_SCAN_START) {
+  if (id == CMDID_I2C_SCAN_START) {
     start_active_scan_internal(SCAN_I2C, [](){
       i2cScan();
       // i2cScan already calls notifyStatus or updates state; send lightweight ack
       notifyStatus("i2c.scan:iter");
-    }, 2000, "i2c_scan");
+    }, 2000, 50, JOB_RES_I2C, "i2c_scan");
     bluetooth_send_response_internal("i2c.scan:started");
     return;
   }
 
-  if (key == CMD_NFC_POLL_START) {
-    set_scan_modulation_single("NFC");
+  if (id == CMDID_NFC_POLL_START) {
+    set_scan_target(SCAN_TARGET_NFC);
     start_active_scan_internal(SCAN_NFC_POLL, [](){
       // reuse NFC read logic from handleOngoingTasks but non-blocking
       uint8_t uid[7]; uint8_t uidLength;
@@ -615,12 +1421,12 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
         String json; serializeJson(doc, json);
         notifyStatus(json.c_str());
       }
-    }, 1000, "nfc_poll");
+    }, 1000, 100, JOB_RES_I2C, "nfc_poll");
     bluetooth_send_response_internal("nfc.poll:started");
     return;
   }
 
-  if (key == CMD_SENSOR_STREAM_START) {
+  if (id == CMDID_SENSOR_STREAM_START) {
     // placeholder sensor stream: send small sample periodically
     start_active_scan_internal(SCAN_SENSOR_STREAM, [](){
       DynamicJsonDocument doc(128);
@@ -629,383 +1435,932 @@ static void start_scan_for_key(const String &key, const JsonObject *params = nul
       doc["sensor"]["accel.z"] = random(-10, 10);
       String s; serializeJson(doc, s);
       notifyStatus(s.c_str());
-    }, 200, "sensor_stream");
+    }, 200, 2, JOB_RES_NONE, "sensor_stream");
     bluetooth_send_response_internal("sensor.stream:started");
     return;
   }
 
-  if (key == CMD_STATUS_REPORT_START) {
+  if (id == CMDID_STATUS_REPORT_START) {
     unsigned long intervalMs = 5000;
-    if (params && params->containsKey("interval_ms")) {
-      unsigned long requested = (*params)["interval_ms"].as<unsigned long>();
+    if (cmd.has("interval_ms")) {
+      unsigned long requested = (unsigned long)cmd.paramInt("interval_ms");
       if (requested >= 250) intervalMs = requested;
     }
+    // the first frame goes out once presence_refresh has probed
+    statusSentValid = false;
     start_active_scan_internal(SCAN_STATUS_REPORT, [](){
-      send_status_snapshot_protobuf();
-    }, intervalMs, "status_report");
+      statusStats.ticks++;
+      status_report_changes();
+    }, intervalMs, 2, JOB_RES_NONE, "status_report");
+    start_active_scan_internal(SCAN_PRESENCE_REFRESH, [](){
+      presence_refresh();
+      status_report_changes();
+    }, STATUS_PRESENCE_REFRESH_MS, 20, JOB_RES_FSPI | JOB_RES_HSPI | JOB_RES_I2C, "presence_refresh");
     bluetooth_send_response_internal("status.reporting:started");
     return;
   }
 
   // Fallback: no background task for this key
-  bluetooth_send_response_internal(String(key + String(":start-not-supported")));
+  FixedString<64> reply(SHARKOS_COMMAND_TABLE[id].key);
+  reply.append(":start-not-supported");
+  bluetooth_send_response_internal(reply.c_str());
 }
 
-static void stop_scan_for_key(const String &key) {
-  // stop any active scan if it matches the requested key (or stop any if key=="*")
-  if (activeScan == SCAN_NONE) {
+// Table handler for COMMAND_STOP entries of background scan loops. Only the
+// job the key names is stopped; other jobs keep running.
+void cmd_handle_scan_stop(const Command &cmd) {
+  const CommandSpec *spec = command_spec(cmd.id);
+  if (!spec || !job_active(spec->scan)) {
     bluetooth_send_response_internal("ERROR:no_active_scan");
     return;
   }
 
-  bool matches = false;
-  if ((key == CMD_WIFI_SNIFFER_STOP) && activeScan == SCAN_WIFI_SNIFFER) matches = true;
-  if ((key == CMD_BLE_SCAN_STOP) && activeScan == SCAN_BLE) matches = true;
-  if ((key == CMD_SUBGHZ_READ_STOP) && activeScan == SCAN_SUBGHZ) matches = true;
-  if ((key == CMD_NRF_SCAN_STOP) && activeScan == SCAN_NRF) matches = true;
-  if ((key == CMD_OSCILLOSCOPE_STOP) && activeScan == SCAN_OSCILLOSCOPE) matches = true;
-  if ((key == CMD_I2C_SCAN_STOP) && activeScan == SCAN_I2C) matches = true;
-  if ((key == CMD_NFC_POLL_STOP) && activeScan == SCAN_NFC_POLL) matches = true;
-  if ((key == CMD_SENSOR_STREAM_STOP) && activeScan == SCAN_SENSOR_STREAM) matches = true;
-  if ((key == CMD_STATUS_REPORT_STOP) && activeScan == SCAN_STATUS_REPORT) matches = true;
-
-  if (!matches) {
-    // If a different scan is active, stop it and report the change
-    stop_active_scan_internal();
-    bluetooth_send_response_internal("scan:stopped-other");
+  stop_active_scan_internal(spec->scan);
+  FixedString<64> reply(spec->key);
+  reply.append(":stopped");
+  bluetooth_send_response_internal(reply.c_str());
+}
+
+// ---------------------------------------------------------------------------
+// Command decoding. Every BLE write is parsed exactly once into a Command
+// (command.h); validation, LED feedback, pairing and the dispatchers below
+// only look at that struct.
+// ---------------------------------------------------------------------------
+
+// Scratch document for command_parse(). Only the events task decodes
+// commands, so a single static pool avoids a heap document per command.
+static StaticJsonDocument<1024> commandDoc;
+
+CommandId command_intern(const char *key, size_t len) {
+  const CommandSpec *spec = command_lookup(key, len);
+  return spec ? spec->id : CMDID_UNKNOWN;
+}
+
+static LegacyCommandKind legacy_kind_for(const char *type) {
+  if (strcmp(type, "StartRadioScan") == 0) return LEGACY_START_RADIO_SCAN;
+  if (strcmp(type, "StopRadioScan") == 0) return LEGACY_STOP_RADIO_SCAN;
+  if (strcmp(type, "ReadNfc") == 0) return LEGACY_READ_NFC;
+  if (strcmp(type, "WriteNfc") == 0) return LEGACY_WRITE_NFC;
+  if (strcmp(type, "SendIr") == 0) return LEGACY_SEND_IR;
+  if (strcmp(type, "GetStatus") == 0) return LEGACY_GET_STATUS;
+  if (strcmp(type, "Pair") == 0) return LEGACY_PAIR;
+  return LEGACY_UNKNOWN;
+}
+
+// Copy the scalar members of `obj` into out.params. Nested objects/arrays
+// and nulls are kept as PARAM_NULL so has() still reports them.
+static void command_flatten_params(JsonObject obj, Command &out) {
+  for (JsonPair kv : obj) {
+    CommandParam *p = out.addParam(kv.key().c_str());
+    if (!p) return;
+    JsonVariant v = kv.value();
+    if (v.is<const char*>()) {
+      const char *s = v.as<const char*>();
+      uint16_t off = out.addText(s, strlen(s));
+      if (off == COMMAND_NO_TEXT) return;
+      p->type = PARAM_STRING;
+      p->s = off;
+    } else if (v.is<long>()) {
+      p->type = PARAM_INT;
+      p->i = v.as<long>();
+    } else if (v.is<float>()) {
+      p->type = PARAM_FLOAT;
+      p->f = v.as<float>();
+    } else if (v.is<bool>()) {
+      p->type = PARAM_BOOL;
+      p->b = v.as<bool>();
+    }
+  }
+}
+
+// Decode one JSON command: the whole payload, or one item of a batch.
+static void command_from_json(JsonVariant root, Command &out) {
+  out.json = true;
+
+  // optional correlation id at top level, echoed back on replies
+  const char *cid = root["id"];
+  if (!cid) cid = root["requestId"];
+  if (cid) out.correlationText = out.addText(cid, strlen(cid));
+
+  // Legacy firmware format takes precedence, as it always has
+  if (root.containsKey("Command")) {
+    out.format = COMMAND_FORMAT_LEGACY;
+    JsonObject cmdObj = root["Command"].as<JsonObject>();
+    if (cmdObj.isNull()) { out.legacy = LEGACY_NOT_OBJECT; return; }
+    if (cmdObj.size() == 0) { out.legacy = LEGACY_EMPTY; return; }
+    // single key expected inside Command e.g. { "StartRadioScan": { ... } };
+    // a "Pair" member wins wherever it appears
+    const char *type = cmdObj.containsKey("Pair") ? "Pair" : cmdObj.begin()->key().c_str();
+    out.legacy = legacy_kind_for(type);
+    out.keyText = out.addText(type, strlen(type));
+    command_flatten_params(cmdObj[type].as<JsonObject>(), out);
     return;
   }
 
-  stop_active_scan_internal();
-  bluetooth_send_response_internal(String(key + String(":stopped")));
+  const char *key = root["command"];
+  if (key) {
+    out.format = COMMAND_FORMAT_JSON;
+    size_t keyLen = strlen(key);
+    out.id = command_intern(key, keyLen);
+    out.keyText = out.addText(key, keyLen);
+    command_flatten_params(root["params"].as<JsonObject>(), out);
+  }
 }
 
-bool events_validate_topic(const String &payload) {
-  // Accept either existing BleMessage JSON (contains "Command") or
-  // a simple JSON/payload with a `command` field that matches commands.h.
-  DynamicJsonDocument doc(1024);
-  auto err = deserializeJson(doc, payload);
-  if (!err) {
-    if (doc.containsKey("Command")) return true; // legacy firmware command
-    if (doc.containsKey("command")) {
-      const char* key = doc["command"];
-      if (!key) return false;
-      // check against known command constants
-      for (unsigned int i = 0; i < SHARKOS_BT_COMMAND_COUNT; ++i) {
-        if (strcmp(key, SHARKOS_BT_COMMANDS[i]) == 0) return true;
+// Accept a bare command key, ignoring surrounding whitespace
+static void command_from_plain(const char *raw, size_t len, Command &out) {
+  while (len > 0 && isspace((unsigned char)*raw)) { ++raw; --len; }
+  while (len > 0 && isspace((unsigned char)raw[len - 1])) --len;
+  CommandId id = command_intern(raw, len);
+  if (id != CMDID_UNKNOWN) {
+    out.format = COMMAND_FORMAT_PLAIN;
+    out.id = id;
+    out.keyText = out.addText(raw, len);
+  }
+}
+
+static_assert((int)ParamType_PARAM_STRING == (int)PARAM_STRING, "ParamType in .proto must mirror CommandParamType");
+
+// Decode a framed protobuf Command. Params keep their wire types, the first
+// transmit body present is copied for the handler, and the key is the table
+// key whichever way the command was named. Anything that does not decode,
+// body included, leaves the command INVALID.
+static void command_from_protobuf(PbIStream msg, Command &out) {
+  Command_pb m;
+  if (!pb_decode_Command(msg, m)) return;
+
+  const CommandSpec *spec = command_protobuf_spec(m);
+  if (spec) {
+    out.id = spec->id;
+    out.keyText = out.addText(spec->key, strlen(spec->key));
+  } else if (m.command.len) {
+    out.keyText = out.addText((const char *)m.command.data, m.command.len);
+  }
+  if (m.correlation_id.len) out.correlationText = out.addText((const char *)m.correlation_id.data, m.correlation_id.len);
+
+  PbIStream it = pb_repeated_iter(m.params);
+  PbBytes item;
+  while (pb_repeated_next(it, m.params, item)) {
+    CommandParam_pb wire;
+    if (!pb_decode_CommandParam(item.data, item.len, wire)) return;
+    if (wire.key.len == 0) continue;
+    CommandParam *p = out.addParam((const char *)wire.key.data, wire.key.len);
+    if (!p) break;
+    switch (wire.type) {
+      case ParamType_PARAM_BOOL: p->type = PARAM_BOOL; p->b = wire.bool_value; break;
+      case ParamType_PARAM_INT: p->type = PARAM_INT; p->i = wire.int_value; break;
+      case ParamType_PARAM_FLOAT: p->type = PARAM_FLOAT; p->f = wire.float_value; break;
+      case ParamType_PARAM_STRING: {
+        const char *v = wire.string_value.len ? (const char *)wire.string_value.data : "";
+        uint16_t off = out.addText(v, wire.string_value.len);
+        if (off == COMMAND_NO_TEXT) break;
+        p->type = PARAM_STRING;
+        p->s = off;
+        break;
       }
-      return false;
+      default: break;  // PARAM_NULL: present, no value
     }
   }
 
-  // Not JSON? accept plain-string commands if they match constants
-  String trimmed = payload;
-  trimmed.trim();
-  for (unsigned int i = 0; i < SHARKOS_BT_COMMAND_COUNT; ++i) {
-    if (trimmed == String(SHARKOS_BT_COMMANDS[i])) return true;
+  CommandBodyKind kind = COMMAND_BODY_NONE;
+  PbBytes body = {};
+  CC1101Tx_pb cc;
+  LoraTx_pb lora;
+  IRTx_pb ir;
+  if (!m.cc1101_tx.empty()) {
+    if (!pb_decode_CC1101Tx(m.cc1101_tx.data, m.cc1101_tx.len, cc)) return;
+    kind = COMMAND_BODY_CC1101_TX;
+    body = m.cc1101_tx;
+  } else if (!m.lora_tx.empty()) {
+    if (!pb_decode_LoraTx(m.lora_tx.data, m.lora_tx.len, lora)) return;
+    kind = COMMAND_BODY_LORA_TX;
+    body = m.lora_tx;
+  } else if (!m.ir_tx.empty()) {
+    if (!pb_decode_IRTx(m.ir_tx.data, m.ir_tx.len, ir)) return;
+    kind = COMMAND_BODY_IR_TX;
+    body = m.ir_tx;
+  }
+  if (kind != COMMAND_BODY_NONE) {
+    uint16_t off = out.addText((const char *)body.data, body.len);
+    if (off != COMMAND_NO_TEXT) {
+      out.bodyKind = kind;
+      out.bodyText = off;
+      out.bodyLen = (uint16_t)body.len;
+    }
   }
-  return false;
+  out.format = COMMAND_FORMAT_PROTOBUF;
 }
 
-// Helper: send a BLE response. If `inReplyTo` is provided we wrap the
-// payload so the client can correlate the reply to a request id. Falls back
-// to the existing `notifyStatus` for plain strings.
-static void bluetooth_send_response_internal(const String &payload, const String &inReplyTo) {
-  if (inReplyTo.length() == 0) {
-    // preserve existing simple text-notify behavior
-    notifyStatus(payload.c_str());
+void command_parse(const char *raw, size_t len, Command &out) {
+  out.reset();
+  if (!raw) return;
+
+  // binary commands skip the JSON parser entirely
+  PbIStream msg;
+  if (pb_frame_message((const uint8_t *)raw, len, msg)) {
+    command_from_protobuf(msg, out);
+    return;
+  }
+
+  auto err = deserializeJson(commandDoc, raw, len);
+  if (err) {
+    command_from_plain(raw, len, out);
+    return;
+  }
+
+  // {"batch":[...]} carries several commands in one write; the items are
+  // decoded one at a time by command_parse_batch_item()
+  JsonArray items = commandDoc["batch"].as<JsonArray>();
+  if (!items.isNull()) {
+    out.json = true;
+    out.format = COMMAND_FORMAT_BATCH;
+    const char *cid = commandDoc["id"];
+    if (!cid) cid = commandDoc["requestId"];
+    if (cid) out.correlationText = out.addText(cid, strlen(cid));
+    if (items.size() > COMMAND_MAX_BATCH) out.overflow = true;
+    else out.batchCount = (uint8_t)items.size();
     return;
   }
 
-  DynamicJsonDocument out(512);
-  out["Response"] = payload;
-  out["inReplyTo"] = inReplyTo;
-  String outStr;
-  serializeJson(out, outStr);
-  notifyStatus(outStr.c_str());
+  command_from_json(commandDoc.as<JsonVariant>(), out);
 }
 
-// Public wrapper matching prototype in events.h
-void bluetooth_send_response(const String &payload, const String &inReplyTo) {
-  bluetooth_send_response_internal(payload, inReplyTo);
+void command_parse_batch_item(uint8_t index, Command &out) {
+  out.reset();
+  JsonVariant item = commandDoc["batch"].as<JsonArray>()[index];
+  if (item.is<const char*>()) {
+    const char *key = item.as<const char*>();
+    command_from_plain(key, strlen(key), out);
+    return;
+  }
+  if (item.is<JsonObject>() && !item.containsKey("batch")) command_from_json(item, out);
 }
 
-// Legacy JSON 'Command' handler (moved from other firmware files). This now
-// runs in events context and will call the same handlers as dispatch_command_key
-// when possible.
-void handleBLECommand(const String &jsonCmd) {
-  Serial.print("Handling BLE command (legacy JSON): "); Serial.println(jsonCmd);
+// Params named in the command's schema must carry a compatible type; params
+// the schema does not mention are ignored by the handlers and pass.
+static bool command_params_match_schema(const Command &cmd, const CommandSpec &spec) {
+  for (uint8_t i = 0; i < spec.paramCount; ++i) {
+    const CommandParamSpec &ps = spec.params[i];
+    const CommandParam *p = cmd.param(ps.name);
+    if (!p || ps.type == PARAM_NULL) continue;
+    bool numeric = ps.type == PARAM_INT || ps.type == PARAM_FLOAT;
+    if (numeric ? !(p->type == PARAM_INT || p->type == PARAM_FLOAT) : p->type != ps.type) return false;
+  }
+  return true;
+}
 
-  DynamicJsonDocument doc(1024);
-  auto err = deserializeJson(doc, jsonCmd);
-  if (err) {
-    Serial.print("JSON parse error: "); Serial.println(err.c_str());
-    notifyStatus("ERROR:json_parse");
+// Accept either existing BleMessage JSON (contains "Command") or a JSON /
+// plain / protobuf payload whose command matches commands.h.
+static bool events_validate_command(const Command &cmd) {
+  if (cmd.overflow) return false;
+  switch (cmd.format) {
+    case COMMAND_FORMAT_LEGACY: return true;
+    case COMMAND_FORMAT_PLAIN: return true;
+    case COMMAND_FORMAT_BATCH: return cmd.batchCount > 0;
+    case COMMAND_FORMAT_JSON:
+    case COMMAND_FORMAT_PROTOBUF: {
+      const CommandSpec *spec = command_spec(cmd.id);
+      return spec && command_params_match_schema(cmd, *spec);
+    }
+    default: return false;
+  }
+}
+
+bool events_validate_topic(const String &payload) {
+  Command cmd;
+  command_parse(payload.c_str(), payload.length(), cmd);
+  return events_validate_command(cmd);
+}
+
+// While a batch runs, replies are collected here instead of being notified
+// one by one (see events_handle_batch). Each is written whole into
+// replyText and copied in; one that no longer fits is notified on its own,
+// so every item is still answered. batchReplyReserve keeps room for the
+// closing `],"inReplyTo":"<batch id>"}`. Main loop only.
+static const size_t BATCH_REPLY_CAPACITY = 2048;
+static char batchReplyText[BATCH_REPLY_CAPACITY];
+static size_t batchReplyLen;
+static size_t batchReplyReserve;
+static uint8_t batchReplyCount;
+static bool batchCapturing = false;
+static const char *batchItemId = "";   // the item's id, or batchItemIndex
+static char batchItemIndex[4];
+
+// A correlated reply is written here whole (json_writer.h) and notified.
+// Sized for the largest reply, radio.batch.policy for every module, escaped.
+static char replyText[1536];
+static size_t replyLen;
+static bool replyOverflow;
+
+static void reply_text_sink(void *ctx, const char *data, size_t len) {
+  (void)ctx;
+  (void)data;
+  // the writer's buffer is replyText itself: a second hand-off means the
+  // first one was a full buffer that has since been overwritten
+  if (replyLen != 0) replyOverflow = true;
+  replyLen += len;
+}
+
+static bool reply_text_write(const char *payload, const char *inReplyTo) {
+  replyLen = 0;
+  replyOverflow = false;
+  JsonWriter w(replyText, sizeof(replyText) - 1, reply_text_sink, nullptr);
+  w.beginObject();
+  w.key("Response");
+  if (payload) w.valueString(payload);
+  else w.valueNull();
+  w.key("inReplyTo"); w.valueString(inReplyTo);
+  w.endObject();
+  w.flush();
+  if (replyOverflow) return false;
+  replyText[replyLen] = '\0';
+  return true;
+}
+
+// A correlated reply, as {"Response":...,"inReplyTo":...} in replyText.
+static void reply_text_build(const char *payload, const char *inReplyTo) {
+  if (!reply_text_write(payload, inReplyTo)) {
+    // a reply this long never fit the old 512-byte document either
+    Serial.println("bluetooth_send_response: reply too long, sent without payload");
+    reply_text_write(nullptr, inReplyTo);
+  }
+}
+
+static void batch_reply_begin(const char *batchId) {
+  static const char head[] = "{\"batch\":[";
+  memcpy(batchReplyText, head, sizeof(head) - 1);
+  batchReplyLen = sizeof(head) - 1;
+  batchReplyCount = 0;
+  // worst case every id byte escapes to \u00XX
+  batchReplyReserve = *batchId ? sizeof("],\"inReplyTo\":\"\"}") + 6 * strlen(batchId) : sizeof("]}");
+}
+
+static void batch_reply_add(const char *payload, const char *inReplyTo) {
+  reply_text_build(payload, inReplyTo);
+  size_t need = replyLen + (batchReplyCount ? 1 : 0);
+  if (batchReplyLen + need + batchReplyReserve > BATCH_REPLY_CAPACITY) {
+    notifyStatus(replyText);
     return;
   }
+  if (batchReplyCount++) batchReplyText[batchReplyLen++] = ',';
+  memcpy(batchReplyText + batchReplyLen, replyText, replyLen);
+  batchReplyLen += replyLen;
+}
+
+static void batch_reply_sink(void *ctx, const char *data, size_t len) {
+  (void)ctx;
+  (void)data;
+  batchReplyLen += len;  // written in place
+}
+
+static void batch_reply_end(const char *batchId) {
+  batchReplyText[batchReplyLen++] = ']';
+  if (*batchId) {
+    static const char key[] = ",\"inReplyTo\":";
+    memcpy(batchReplyText + batchReplyLen, key, sizeof(key) - 1);
+    batchReplyLen += sizeof(key) - 1;
+    JsonWriter w(batchReplyText + batchReplyLen, BATCH_REPLY_CAPACITY - batchReplyLen - 2, batch_reply_sink, nullptr);
+    w.valueString(batchId);
+    w.flush();
+  }
+  batchReplyText[batchReplyLen++] = '}';
+  batchReplyText[batchReplyLen] = '\0';
+}
 
-  // allow optional correlation id at top level and echo it back on replies
-  String correlationId = String();
-  if (doc.containsKey("id")) {
-    const char *cid = doc["id"];
-    if (cid) correlationId = String(cid);
+// Helper: send a BLE response. If `inReplyTo` is provided we wrap the
+// payload so the client can correlate the reply to a request id. Falls back
+// to the existing `notifyStatus` for plain strings. Inside a batch every
+// reply is tagged with the current item's id and held for the aggregate.
+// Main loop only; nothing here touches the heap outside a batch.
+static void bluetooth_send_response_internal(const char *payload, const char *inReplyTo) {
+  if (batchCapturing) {
+    batch_reply_add(payload, *inReplyTo ? inReplyTo : batchItemId);
+    return;
   }
-  if (doc.containsKey("requestId")) {
-    const char *cid = doc["requestId"];
-    if (cid && correlationId.length() == 0) correlationId = String(cid);
+
+  if (*inReplyTo == '\0') {
+    // preserve existing simple text-notify behavior
+    notifyStatus(payload);
+    return;
   }
 
-  // If this is the legacy 'Command' object, handle well-known subcommands
-  if (doc.containsKey("Command")) {
-    JsonObject cmdObj = doc["Command"].as<JsonObject>();
-    if (cmdObj.isNull()) {
+  reply_text_build(payload, inReplyTo);
+  notifyStatus(replyText);
+}
+
+static void bluetooth_send_response_internal(const String &payload, const char *inReplyTo) {
+  bluetooth_send_response_internal(payload.c_str(), inReplyTo);
+}
+
+// Public wrapper matching prototype in events.h
+void bluetooth_send_response(const char *payload, const char *inReplyTo) {
+  bluetooth_send_response_internal(payload, inReplyTo);
+}
+
+// Legacy JSON 'Command' handler (moved from other firmware files). This runs
+// in events context on an already-decoded Command and calls the same
+// handlers as dispatch_command when possible.
+static void handle_legacy_command(const Command &cmd) {
+  const char *correlationId = cmd.correlationId();
+
+  switch (cmd.legacy) {
+    case LEGACY_NOT_OBJECT:
       bluetooth_send_response_internal("ERROR:invalid_command", correlationId);
       return;
-    }
 
-    // single key expected inside Command e.g. { "StartRadioScan": { ... } }
-    if (cmdObj.size() == 0) {
+    case LEGACY_EMPTY:
       bluetooth_send_response_internal("ERROR:empty_command", correlationId);
       return;
-    }
-    auto it = cmdObj.begin();
-    const char *cmdType = (it != cmdObj.end()) ? it->key().c_str() : nullptr;
-
-    if (strcmp(cmdType, "StartRadioScan") == 0) {
-      JsonObject params = cmdObj["StartRadioScan"].as<JsonObject>();
-      if (params.containsKey("frequency")) scanFrequency = params["frequency"];
-      if (params.containsKey("modulation")) {
-        set_scan_modulation_pair(String((const char*)params["modulation"]), String((const char*)params["modulation"]));
+
+    case LEGACY_START_RADIO_SCAN:
+      if (cmd.has("frequency")) scanFrequency = cmd.paramFloat("frequency");
+      if (cmd.has("modulation")) {
+        ModulationType m = modulationFromString(cmd.paramString("modulation"));
+        set_scan_modulation_pair(m, m);
       }
       scanningRadio = true;
       Serial.println("Starting radio scan (legacy)");
       bluetooth_send_response_internal("radio_scan:started", correlationId);
       return;
-    }
 
-    if (strcmp(cmdType, "StopRadioScan") == 0) {
+    case LEGACY_STOP_RADIO_SCAN:
       scanningRadio = false;
       Serial.println("Stopping radio scan (legacy)");
       bluetooth_send_response_internal("radio_scan:stopped", correlationId);
       return;
-    }
 
-    if (strcmp(cmdType, "ReadNfc") == 0) {
+    case LEGACY_READ_NFC:
       readingNfc = true;
       bluetooth_send_response_internal("nfc_read:started", correlationId);
       return;
-    }
 
-    if (strcmp(cmdType, "WriteNfc") == 0) {
+    case LEGACY_WRITE_NFC:
       // not implemented yet
       bluetooth_send_response_internal("ERROR:nfc_write_not_implemented", correlationId);
       return;
-    }
 
-    if (strcmp(cmdType, "SendIr") == 0) {
-      JsonObject irObj = cmdObj["SendIr"].as<JsonObject>();
+    case LEGACY_SEND_IR:
       // payload is implementation-dependent; forward to existing helper if present
-      if (irObj.containsKey("IrData")) {
-        String payload = String((const char*)irObj["IrData"]);
+      if (cmd.has("IrData")) {
+        String payload = String(cmd.paramString("IrData") ? cmd.paramString("IrData") : "");
         irSend(payload);
         bluetooth_send_response_internal("ir_send:ok", correlationId);
       } else {
         bluetooth_send_response_internal("ERROR:ir_missing_data", correlationId);
       }
       return;
-    }
 
-    if (strcmp(cmdType, "GetStatus") == 0) {
+    case LEGACY_GET_STATUS:
       send_status_snapshot_protobuf();
       bluetooth_send_response_internal("status.info:ok", correlationId);
       return;
-    }
 
-    // unknown legacy command
-    bluetooth_send_response_internal("ERROR:unknown_command", correlationId);
+    default:
+      // unknown legacy command
+      bluetooth_send_response_internal("ERROR:unknown_command", correlationId);
+      return;
+  }
+}
+
+// Public entry point for callers that still hold the raw JSON text.
+void handleBLECommand(const String &jsonCmd) {
+  Serial.print("Handling BLE command (legacy JSON): "); Serial.println(jsonCmd);
+
+  Command cmd;
+  command_parse(jsonCmd.c_str(), jsonCmd.length(), cmd);
+  if (!cmd.json) {
+    notifyStatus("ERROR:json_parse");
     return;
   }
+  if (cmd.format != COMMAND_FORMAT_LEGACY) {
+    // If not a legacy Command object, treat as invalid for this path
+    bluetooth_send_response_internal("ERROR:invalid_message", cmd.correlationId());
+    return;
+  }
+  handle_legacy_command(cmd);
+}
 
-  // If not a legacy Command object, treat as invalid for this path
-  bluetooth_send_response_internal("ERROR:invalid_message", correlationId);
-}
-
-// Dispatch a plain command key (matches commands.h). This runs in main loop
-// context and may call existing functions or set flags.
-static void dispatch_command_key(const String &key, const JsonObject *params = nullptr) {
-  // BLE scanner
-  if (key == CMD_BLE_SCAN_START) { start_scan_for_key(String(CMD_BLE_SCAN_START), params); return; }
-  if (key == CMD_BLE_SCAN_STOP)  { stop_scan_for_key(String(CMD_BLE_SCAN_STOP)); return; }
-
-  // Wi‑Fi scan / sniffer
-  if (key == CMD_WIFI_SCAN_START || key == CMD_WIFI_CHANNEL_SCAN) {
-        // channel-scan is exactly the same operation on the device side;
-        // the UI decides how to plot the results.
-        
-        // Parse optional parameters from run_action()
-        wifi_scan_channel = 0;
-        wifi_scan_5ghz = false;
-        if (params) {
-          if (params->containsKey("channel")) {
-             int c = (*params)["channel"].as<int>();
-             if (c > 0) wifi_scan_channel = c;
-          }
-          if (params->containsKey("band")) {
-            // "2.4" or "5"
-            String b = (*params)["band"].as<String>();
-            if (b == "5") wifi_scan_5ghz = true;
-          }
-        }
-        
-        // Mark as scanning so runWifiBleScanTasks picks it up
-        scanningRadio = true;
-        set_scan_modulation_single("WIFI");
-
-        // trigger immediate scan (sync) to ensure user sees results quickly?
-        // Or rely on background task. Background task is better.
-        // runWifiBleScanTasks() runs every 2s.
-        bluetooth_send_response_internal("wifi.scan:started");
-        return;
-    }
-    if (key == CMD_WIFI_SCAN_STOP)     { bluetooth_send_response_internal("wifi.scan:stopped"); return; }
-  if (key == CMD_WIFI_SNIFFER_START) { start_scan_for_key(String(CMD_WIFI_SNIFFER_START), params); return; }
-  if (key == CMD_WIFI_SNIFFER_STOP)  { stop_scan_for_key(String(CMD_WIFI_SNIFFER_STOP)); return; }
-
-  // nRF (2.4GHz)
-  if (key == CMD_NRF_SCAN_START) { start_scan_for_key(String(CMD_NRF_SCAN_START), params); return; }
-  if (key == CMD_NRF_SCAN_STOP)  { stop_scan_for_key(String(CMD_NRF_SCAN_STOP)); return; }
-
-  // Sub‑GHz (CC1101/LoRa)
-  if (key == CMD_SUBGHZ_SET_MOD_ONE) {
-    if (params && params->containsKey("modulation")) {
-      String m = (*params)["modulation"].as<String>();
-      ModulationType mt = modulationFromString(m);
-      if (cc1101Tx && mt != MOD_UNKNOWN) {
-        cc1101Tx->setModulation(m);
-        set_scan_modulation_index(0, m);
+// ---------------------------------------------------------------------------
+// Command table handlers (see SHARKOS_COMMAND_TABLE in commands.h). These run
+// in main loop context and may call existing functions or set flags.
+// ---------------------------------------------------------------------------
+
+// wifi.scan.start / wifi.channel.scan
+void cmd_handle_wifi_scan_start(const Command &cmd) {
+  // channel-scan is exactly the same operation on the device side;
+  // the UI decides how to plot the results.
+
+  // Parse optional parameters from run_action()
+  wifi_scan_channel = 0;
+  wifi_scan_5ghz = false;
+  if (cmd.has("channel")) {
+     int c = (int)cmd.paramInt("channel");
+     if (c > 0) wifi_scan_channel = c;
+  }
+  if (cmd.has("band")) {
+    // "2.4" or "5" (string or number)
+    const char *b = cmd.paramString("band");
+    if (b ? strcmp(b, "5") == 0 : cmd.paramFloat("band") == 5.0f) wifi_scan_5ghz = true;
+  }
+
+  // Mark as scanning so runWifiBleScanTasks picks it up
+  scanningRadio = true;
+  set_scan_target(SCAN_TARGET_WIFI);
+
+  // trigger immediate scan (sync) to ensure user sees results quickly?
+  // Or rely on background task. Background task is better.
+  // runWifiBleScanTasks() runs every 2s.
+  bluetooth_send_response_internal("wifi.scan:started");
+}
+
+void cmd_handle_wifi_scan_stop(const Command &cmd) {
+  (void)cmd;
+  bluetooth_send_response_internal("wifi.scan:stopped");
+}
+
+// subghz.set.mod.one / subghz.set.mod.two
+void cmd_handle_subghz_set_mod(const Command &cmd) {
+  const bool second = cmd.id == CMDID_SUBGHZ_SET_MOD_TWO;
+  if (cmd.paramString("modulation")) {
+    bus_worker_wait_idle(second ? SPI_BUS_HSPI : SPI_BUS_FSPI);
+    ModulationType mt = modulationFromString(cmd.paramString("modulation"));
+    if (mt != MOD_UNKNOWN) {
+      if (second && cc1101Tx2) {
+        cc1101Tx2->setModulation(mt);
+        set_scan_modulation_index(1, mt);
+      } else if (!second && cc1101Tx) {
+        cc1101Tx->setModulation(mt);
+        set_scan_modulation_index(0, mt);
       }
     }
-    bluetooth_send_response_internal("subghz.mod.one:ok");
-    return;
   }
-  if (key == CMD_SUBGHZ_SET_MOD_TWO) {
-    if (params && params->containsKey("modulation")) {
-      String m = (*params)["modulation"].as<String>();
-      ModulationType mt = modulationFromString(m);
-      if (cc1101Tx2 && mt != MOD_UNKNOWN) {
-        cc1101Tx2->setModulation(m);
-        set_scan_modulation_index(1, m);
+  bluetooth_send_response_internal(second ? "subghz.mod.two:ok" : "subghz.mod.one:ok");
+}
+
+// subghz.set.top.freq / subghz.set.bot.freq
+void cmd_handle_subghz_set_freq(const Command &cmd) {
+  const bool top = cmd.id == CMDID_SUBGHZ_SET_TOP_FREQ;
+  if (cmd.has("frequency")) {
+    float f = cmd.paramFloat("frequency");
+    int radio = (int)cmd.paramInt("radio", 1);
+    if (f > 0.0f) {
+      bus_worker_wait_idle(radio == 2 ? SPI_BUS_HSPI : SPI_BUS_FSPI);
+      if (radio == 2) {
+        if (cc1101Tx2) { if (top) cc1101Tx2->setTopFrequency(f); else cc1101Tx2->setBotFrequency(f); }
+      } else {
+        if (cc1101Tx) { if (top) cc1101Tx->setTopFrequency(f); else cc1101Tx->setBotFrequency(f); }
       }
     }
-    bluetooth_send_response_internal("subghz.mod.two:ok");
+  }
+  bluetooth_send_response_internal(top ? "subghz.top.freq:ok" : "subghz.bot.freq:ok");
+}
+
+void cmd_handle_subghz_test(const Command &cmd) {
+  (void)cmd;
+  Serial.println("[SubGhzTest] CMD_SUBGHZ_TEST received — starting loopback test...");
+  subghz_wait_buses_idle();
+  String result = performCc1101TestDetailed();
+  Serial.printf("[SubGhzTest] BLE result: %s\n", result.c_str());
+  bluetooth_send_response_internal(result);
+}
+
+// subghz.packet.send: one CC1101 packet, from the CC1101Tx body of a binary
+// command or from JSON params {radio, frequency_mhz, power_dbm, payload
+// (base64)}. The radio is only retuned / re-powered when asked to.
+static const size_t CC1101_MAX_PACKET = 61;  // TX FIFO less the length byte
+
+void cmd_handle_subghz_packet_send(const Command &cmd) {
+  const char *correlationId = cmd.correlationId();
+  uint8_t payload[CC1101_MAX_PACKET];
+  size_t len = 0;
+  bool second;
+  float mhz;
+  bool setPower;
+  int powerDbm;
+  CC1101Tx_pb tx;
+  if (cmd.bodyCC1101Tx(tx)) {
+    second = tx.module == RadioModuleCC_CC1101_2;
+    mhz = tx.frequency_mhz;
+    setPower = true;
+    powerDbm = tx.power_dbm;
+    len = tx.payload.len <= sizeof(payload) ? tx.payload.len : 0;
+    if (len > 0) memcpy(payload, tx.payload.data, len);
+  } else {
+    second = cmd.paramInt("radio", 1) == 2;
+    mhz = cmd.paramFloat("frequency_mhz");
+    setPower = cmd.has("power_dbm");
+    powerDbm = (int)cmd.paramInt("power_dbm");
+    const char *b64 = cmd.paramString("payload");
+    if (b64) len = base64_decode_to(b64, strlen(b64), payload, sizeof(payload));
+    if (len == BASE64_INVALID) len = 0;  // not base64, or longer than one packet
+  }
+  if (len == 0) {
+    bluetooth_send_response_internal("ERROR:packet_payload", correlationId);
     return;
   }
-  if (key == CMD_SUBGHZ_SET_TOP_FREQ) {
-    if (params && params->containsKey("frequency")) {
-      float f = (*params)["frequency"].as<float>();
-      int radio = params->containsKey("radio") ? (*params)["radio"].as<int>() : 1;
-      if (f > 0.0f) {
-        if (radio == 2) {
-          if (cc1101Tx2) cc1101Tx2->setTopFrequency(f);
-        } else {
-          if (cc1101Tx) cc1101Tx->setTopFrequency(f);
-        }
-      }
+
+  ELECHOUSE_CC1101 &radio = second ? cc1101_driver_2 : cc1101_driver_1;
+  subghz_wait_buses_idle();
+  if (mhz > 0.0f) radio.setMHZ(mhz);
+  if (setPower) radio.setPA(powerDbm);
+  radio.SendData(payload, (byte)len);
+  bluetooth_send_response_internal("subghz.packet.send:ok", correlationId);
+}
+
+void cmd_handle_i2c_scan_once(const Command &cmd) {
+  (void)cmd;
+  i2cScan();
+  bluetooth_send_response_internal("i2c.scan:done");
+}
+
+// Cellular / cell-scan (not implemented)
+void cmd_handle_cell_scan_start(const Command &cmd) {
+  (void)cmd;
+  bluetooth_send_response_internal("cell.scan:start-not-implemented");
+}
+
+void cmd_handle_cell_scan_stop(const Command &cmd) {
+  (void)cmd;
+  bluetooth_send_response_internal("cell.scan:stopped");
+}
+
+void cmd_handle_sd_info(const Command &cmd) {
+  (void)cmd;
+  sdinfo_readStats();
+  bluetooth_send_response_internal("sd.info:ok");
+}
+
+void cmd_handle_files_list(const Command &cmd) {
+  // optional param: path (not fully implemented) — return a stub or basic root listing
+  if (cmd.has("path")) {
+    String path = String(cmd.paramString("path") ? cmd.paramString("path") : "");
+    bluetooth_send_response_internal(String("files.list:requested ") + path);
+  } else {
+    bluetooth_send_response_internal("files.list:root-not-implemented");
+  }
+}
+
+void cmd_handle_ir_recv_start(const Command &cmd) {
+  (void)cmd;
+  set_scan_target(SCAN_TARGET_IR);
+  bluetooth_send_response_internal("ir.recv:started");
+}
+
+void cmd_handle_ir_recv_stop(const Command &cmd) {
+  (void)cmd;
+  bluetooth_send_response_internal("ir.recv:stopped");
+}
+
+void cmd_handle_list_paired_devices(const Command &cmd) {
+  (void)cmd;
+  bluetooth_send_response_internal("list.paired.devices:[]");
+}
+
+// pair.set and legacy { "Command": { "Pair": { "pin": "6942" } } }. Works
+// whether or not pairingMode is on; the pin may be a string or a number and
+// JSON commands may call it "code".
+void cmd_handle_pair_set(const Command &cmd) {
+  const char *correlationId = cmd.correlationId();
+  const char *pinKey = cmd.has("pin") ? "pin" : (cmd.format == COMMAND_FORMAT_JSON && cmd.has("code") ? "code" : nullptr);
+  String pinStr = String();
+  if (pinKey) {
+    if (cmd.paramString(pinKey)) pinStr = String(cmd.paramString(pinKey));
+    else pinStr = String(cmd.paramInt(pinKey));
+  }
+  if (pinStr == String("6942")) {
+    paired = true;
+    pairingMode = false;
+    prefs.putBool("paired", true);
+    notifyStatus("paired:yes");
+    bluetooth_send_response_internal("pair:ok", correlationId);
+  } else {
+    bluetooth_send_response_internal("ERROR:invalid_pin", correlationId);
+  }
+}
+
+void cmd_handle_battery_info(const Command &cmd) {
+  (void)cmd;
+  DynamicJsonDocument jb(128);
+  jb["battery"] = batteryPercent;
+  String s; serializeJson(jb, s);
+  bluetooth_send_response_internal(s);
+}
+
+void cmd_handle_status_info(const Command &cmd) {
+  (void)cmd;
+  send_status_snapshot_protobuf();
+  bluetooth_send_response_internal("status.info:ok");
+}
+
+// Switch the status characteristic between plain, MTU-framed and
+// compressed notifications (ble_link.h); without params it only reports the
+// link, with the compression counters so far. The reply goes out before
+// anything changes, in the form the client expects.
+void cmd_handle_ble_link(const Command &cmd) {
+  bool framing = cmd.has("framing") ? cmd.paramInt("framing") != 0 : ble_link_framing();
+  bool compress = cmd.has("compress") ? cmd.paramInt("compress") != 0 : ble_link_compress() && framing;
+  if (compress) framing = true;
+  BleLinkStats st;
+  ble_link_stats(st);
+  DynamicJsonDocument jb(192);
+  jb["mtu"] = ble_link_mtu();
+  jb["framing"] = framing;
+  jb["compress"] = compress;
+  jb["lz_in"] = st.lzInBytes;
+  jb["lz_out"] = st.lzOutBytes;
+  jb["lz_us"] = st.lzMicros;
+  String s; serializeJson(jb, s);
+  bluetooth_send_response_internal(s, cmd.correlationId());
+  ble_link_set_framing(framing);
+  ble_link_set_compress(compress);
+}
+
+// Switch the serial port between text and framed binary output
+// (serial_link.h); without `binary` it only reports the mode.
+void cmd_handle_serial_link(const Command &cmd) {
+  bool binary = cmd.has("binary") ? cmd.paramInt("binary") != 0 : serial_link_binary();
+  serial_link_set_binary(binary);
+  DynamicJsonDocument jb(128);
+  jb["baud"] = SHARKOS_SERIAL_BAUD;
+  jb["binary"] = binary;
+  String s; serializeJson(jb, s);
+  bluetooth_send_response_internal(s, cmd.correlationId());
+}
+
+static RadioFlushPolicy radio_preset_policy(int module, const char *preset) {
+  RadioFlushPolicy p = radio_default_policy(module);
+  if (strcmp(preset, "interactive") == 0) {
+    // a notification's worth of signals, on screen within a frame or two
+    p.maxEvents = 32;
+    p.maxBytes = 0;
+    p.idleMs = 50;
+    p.maxAgeMs = 200;
+    p.matchMtu = true;
+  } else if (strcmp(preset, "bulk") == 0) {
+    // whole buffers, for captures that care about throughput, not latency
+    p.maxBytes = 0;
+    p.idleMs = 1000;
+    p.maxAgeMs = 5000;
+  }
+  return p;
+}
+
+static uint16_t radio_policy_param(const Command &cmd, const char *name, uint16_t current) {
+  if (!cmd.has(name)) return current;
+  long v = cmd.paramInt(name);
+  return (uint16_t)(v < 0 ? 0 : (v > 0xFFFF ? 0xFFFF : v));
+}
+
+// Report or change when JSON radio-batches go out (RadioFlushPolicy), for
+// one module or, without `module`, for all of them. A preset resets every
+// limit and the named params then adjust it. A module whose policy changes
+// sends what it has buffered first, so the new limits start on a fresh
+// batch. `json` subscribes this BLE client to the batches
+// (telemetry_set_ble_json) and turns link framing on, which they need. The
+// reply lists the resulting policies.
+void cmd_handle_radio_batch_policy(const Command &cmd) {
+  const char *inReplyTo = cmd.correlationId();
+  int first = 0, last = RADIO_MODULE_COUNT - 1;
+  if (cmd.has("module")) {
+    long m = cmd.paramInt("module", -1);
+    if (m < 0 || m >= RADIO_MODULE_COUNT) {
+      bluetooth_send_response_internal("ERROR:radio_module", inReplyTo);
+      return;
     }
-    bluetooth_send_response_internal("subghz.top.freq:ok");
-    return;
+    first = last = (int)m;
   }
-  if (key == CMD_SUBGHZ_TEST) {
-    Serial.println("[SubGhzTest] CMD_SUBGHZ_TEST received — starting loopback test...");
-    String result = performCc1101TestDetailed();
-    Serial.printf("[SubGhzTest] BLE result: %s\n", result.c_str());
-    bluetooth_send_response_internal(result);
+  const char *preset = cmd.paramString("preset");
+  if (preset && strcmp(preset, "interactive") != 0 && strcmp(preset, "bulk") != 0 && strcmp(preset, "default") != 0) {
+    bluetooth_send_response_internal("ERROR:radio_preset", inReplyTo);
     return;
   }
-  if (key == CMD_SUBGHZ_SET_BOT_FREQ) {
-    if (params && params->containsKey("frequency")) {
-      float f = (*params)["frequency"].as<float>();
-      int radio = params->containsKey("radio") ? (*params)["radio"].as<int>() : 1;
-      if (f > 0.0f) {
-        if (radio == 2) {
-          if (cc1101Tx2) cc1101Tx2->setBotFrequency(f);
-        } else {
-          if (cc1101Tx) cc1101Tx->setBotFrequency(f);
-        }
-      }
+  const char *layoutName = cmd.paramString("layout");
+  RadioBatchLayout layout = radioBatchLayout;
+  if (layoutName) {
+    if (strcmp(layoutName, "rows") == 0) layout = RADIO_BATCH_ROWS;
+    else if (strcmp(layoutName, "columns") == 0) layout = RADIO_BATCH_COLUMNS;
+    else {
+      bluetooth_send_response_internal("ERROR:radio_layout", inReplyTo);
+      return;
     }
-    bluetooth_send_response_internal("subghz.bot.freq:ok");
-    return;
   }
-  if (key == CMD_SUBGHZ_READ_START) { start_scan_for_key(String(CMD_SUBGHZ_READ_START), params); return; }
-  if (key == CMD_SUBGHZ_READ_STOP)  { stop_scan_for_key(String(CMD_SUBGHZ_READ_STOP)); return; }
-
-  // Oscilloscope / ADC
-  if (key == CMD_OSCILLOSCOPE_START) { start_scan_for_key(String(CMD_OSCILLOSCOPE_START), params); return; }
-  if (key == CMD_OSCILLOSCOPE_STOP)  { stop_scan_for_key(String(CMD_OSCILLOSCOPE_STOP)); return; }
-
-  // I2C scanner
-  if (key == CMD_I2C_SCAN_ONCE)  { i2cScan(); bluetooth_send_response_internal("i2c.scan:done"); return; }
-  if (key == CMD_I2C_SCAN_START) { start_scan_for_key(String(CMD_I2C_SCAN_START), params); return; }
-  if (key == CMD_I2C_SCAN_STOP)  { stop_scan_for_key(String(CMD_I2C_SCAN_STOP)); return; }
-
-  // NFC polling
-  if (key == CMD_NFC_POLL_START) { start_scan_for_key(String(CMD_NFC_POLL_START), params); return; }
-  if (key == CMD_NFC_POLL_STOP)  { stop_scan_for_key(String(CMD_NFC_POLL_STOP)); return; }
-
-  // Sensor streaming
-  if (key == CMD_SENSOR_STREAM_START) { start_scan_for_key(String(CMD_SENSOR_STREAM_START), params); return; }
-  if (key == CMD_SENSOR_STREAM_STOP)  { stop_scan_for_key(String(CMD_SENSOR_STREAM_STOP)); return; }
-
-  // Cellular / cell-scan (not implemented)
-  if (key == CMD_CELL_SCAN_START) { bluetooth_send_response_internal("cell.scan:start-not-implemented"); return; }
-  if (key == CMD_CELL_SCAN_STOP)  { bluetooth_send_response_internal("cell.scan:stopped"); return; }
-
-  // SD / Files
-  if (key == CMD_SD_INFO)   { sdinfo_readStats(); bluetooth_send_response_internal("sd.info:ok"); return; }
-  if (key == CMD_FILES_LIST) {
-    // optional param: path (not fully implemented) — return a stub or basic root listing
-    if (params && params->containsKey("path")) {
-      String path = String((*params)["path"].as<const char*>());
-      bluetooth_send_response_internal(String("files.list:requested ") + path);
-    } else {
-      bluetooth_send_response_internal("files.list:root-not-implemented");
+
+  if (layout != radioBatchLayout) {
+    for (int m = 0; m < RADIO_MODULE_COUNT; ++m) events_flush_radio_buffer(m, RADIO_FLUSH_POLICY);
+    radioBatchLayout = layout;
+  }
+  static const char *const LIMITS[] = {"max_events", "max_bytes", "idle_ms", "max_age_ms", "frame_bytes", "match_mtu"};
+  bool change = preset != nullptr;
+  for (const char *name : LIMITS) change |= cmd.has(name);
+  for (int m = first; m <= last && change; ++m) {
+    RadioFlushPolicy p = preset ? radio_preset_policy(m, preset) : radioPolicies[m];
+    p.maxEvents = radio_policy_param(cmd, "max_events", p.maxEvents);
+    if (p.maxEvents > radio_module_capacity(m)) p.maxEvents = (uint16_t)radio_module_capacity(m);
+    p.maxBytes = radio_policy_param(cmd, "max_bytes", p.maxBytes);
+    p.idleMs = radio_policy_param(cmd, "idle_ms", p.idleMs);
+    p.maxAgeMs = radio_policy_param(cmd, "max_age_ms", p.maxAgeMs);
+    if (cmd.has("frame_bytes")) {
+      p.frameBytes = radio_policy_param(cmd, "frame_bytes", p.frameBytes);
+      p.matchMtu = false;
     }
-    return;
+    if (cmd.has("match_mtu")) p.matchMtu = cmd.paramInt("match_mtu") != 0;
+    events_flush_radio_buffer(m, RADIO_FLUSH_POLICY);
+    radioPolicies[m] = p;
   }
 
-  // IR receive
-  if (key == CMD_IR_RECV_START) { set_scan_modulation_single("IR"); bluetooth_send_response_internal("ir.recv:started"); return; }
-  if (key == CMD_IR_RECV_STOP)  { bluetooth_send_response_internal("ir.recv:stopped"); return; }
+  bool json = cmd.has("json") ? cmd.paramInt("json") != 0 : telemetry_ble_json();
+
+  DynamicJsonDocument jb(1536);
+  jb["json"] = json;
+  jb["layout"] = radioBatchLayout == RADIO_BATCH_COLUMNS ? "columns" : "rows";
+  JsonArray list = jb.createNestedArray("policies");
+  for (int m = first; m <= last; ++m) {
+    const RadioFlushPolicy &p = radioPolicies[m];
+    JsonObject o = list.createNestedObject();
+    o["module"] = m;
+    o["max_events"] = p.maxEvents;
+    o["max_bytes"] = p.maxBytes;
+    o["idle_ms"] = p.idleMs;
+    o["max_age_ms"] = p.maxAgeMs;
+    o["frame_bytes"] = (unsigned)radio_policy_frame_bytes(p);
+    o["match_mtu"] = p.matchMtu;
+  }
+  String s; serializeJson(jb, s);
+  bluetooth_send_response_internal(s, inReplyTo);
+  // after the reply, which goes out in the framing the client expects
+  if (json) ble_link_set_framing(true);
+  telemetry_set_ble_json(json);
+}
 
-  // Convenience / control
-  if (key == CMD_LIST_PAIRED_DEVICES) { bluetooth_send_response_internal("list.paired.devices:[]"); return; }
-  if (key == CMD_BATTERY_INFO) { DynamicJsonDocument jb(128); jb["battery"] = batteryPercent; String s; serializeJson(jb,s); bluetooth_send_response_internal(s); return; }
-  if (key == CMD_STATUS_INFO) { send_status_snapshot_protobuf(); bluetooth_send_response_internal("status.info:ok"); return; }
-  if (key == CMD_STATUS_REPORT_START) { start_scan_for_key(String(CMD_STATUS_REPORT_START), params); return; }
-  if (key == CMD_STATUS_REPORT_STOP)  { stop_scan_for_key(String(CMD_STATUS_REPORT_STOP)); return; }
+// Where memory is going: the PSRAM and internal heaps, and what each
+// PsramRegion holds (psram_alloc.h).
+void cmd_handle_mem_stats(const Command &cmd) {
+  DynamicJsonDocument jb(1024);
+  JsonObject psram = jb.createNestedObject("psram");
+  psram["total"] = (unsigned)psram_total_bytes();
+  psram["free"] = (unsigned)psram_free_bytes();
+  JsonObject internal = jb.createNestedObject("internal");
+  internal["free"] = (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  internal["largest"] = (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  JsonArray regions = jb.createNestedArray("regions");
+  for (int r = 0; r < PSRAM_REGION_COUNT; ++r) {
+    PsramRegionStats st;
+    psram_region_stats((PsramRegion)r, st);
+    JsonObject o = regions.createNestedObject();
+    o["name"] = psram_region_name((PsramRegion)r);
+    o["psram"] = st.psramBytes;
+    o["internal"] = st.internalBytes;
+    o["peak"] = st.peakBytes;
+    o["allocs"] = st.allocs;
+    o["fallbacks"] = st.fallbacks;
+    o["failures"] = st.failures;
+  }
+  String s; serializeJson(jb, s);
+  bluetooth_send_response_internal(s, cmd.correlationId());
+}
 
-  // Fallback: unknown command
-  bluetooth_send_response_internal("ERROR:unknown_command_key");
+// Dispatch a JSON, protobuf or plain-key command through its table entry.
+static void dispatch_command(const Command &cmd) {
+  const CommandSpec *spec = command_spec(cmd.id);
+  if (!spec || !spec->handler) {
+    // Fallback: unknown or not-yet-implemented command
+    bluetooth_send_response_internal("ERROR:unknown_command_key");
+    return;
+  }
+  if (cmd.format == COMMAND_FORMAT_JSON || cmd.format == COMMAND_FORMAT_PROTOBUF) {
+    Serial.print("dispatch_command: key=\""); Serial.print(spec->key); Serial.println("\"");
+  }
+  spec->handler(cmd);
 }
 
+static void events_handle_command(const Command &cmd);
+static void events_handle_batch(const Command &batch);
+
 void events_process_one() {
   //Serial.println("DEBUG: events_process_one start"); // Un-comment to trace loop spam if needed
 
   // Run any active background scan task (non-blocking tick)
-  // scan_loop_tick runs the scan lambda from main-loop context (thread-safe)
+  // scan_loop_tick runs due background jobs from main-loop context (thread-safe)
   scan_loop_tick();
+  // hand samples from the SPI bus workers to the radio buffers / BLE
+  bus_workers_publish();
+  // and JSON radio-batches encoded by the TX task to their subscribers
+  radio_tx_publish();
 
   // Poll transceivers to perform non-blocking reads and enqueue packets
   // only if specifically requested via scanningRadio flag (legacy behavior)
-  // or if we decide to poll all the time (but user wants it gated).
-  if (scanningRadio) {
-    Serial.print("DEBUG: scanningRadio=true, modulation="); Serial.println(scan_modulation_joined());
-    if (scan_modulation_contains("WIFI")) {
+  // or if we decide to poll all the time (but user wants it gated). Other
+  // wakes (commands, bus workers, the TX ring) do not poll early.
+  if (scanningRadio && (long)(millis() - radioPollDueMs) >= 0) {
+    radioPollDueMs = millis() + EVENTS_RADIO_POLL_MS;
+    FixedString<16> modulation;
+    scan_modulation_describe(modulation);
+    Serial.print("DEBUG: scanningRadio=true, modulation="); Serial.println(modulation.c_str());
+    if (scanModulation.target == SCAN_TARGET_WIFI) {
        // WiFi scanning requested - run from main loop (safe context)
        // Serial.println("DEBUG: runWifiBleScanTasks");
        runWifiBleScanTasks();
-    } else if (scan_modulation_contains("BLE")) {
+    } else if (scanModulation.target == SCAN_TARGET_BLE) {
         // BLE scanning requested - run from main loop (safe context)
     } else {
       // Sub-GHz/LoRa/NRF polling requested
@@ -1016,135 +2371,136 @@ void events_process_one() {
     }
   }
 
-  // Check if any radio buffers should be flushed due to idle timeout
-  events_check_radio_idle_flush();
+  // Flush radio batches whose idle/age deadline has passed
+  events_fire_radio_timers();
 
-  if (eventCount == 0) return;
-  String raw = events_dequeue();
-  if (raw.length() == 0) return;
+  // A new connection starts a fresh credit window
+  if (flowResetRequested.exchange(false, std::memory_order_acquire)) {
+    flowBase = flowResetBase.load(std::memory_order_relaxed);
+    flowLimit = normalLane.head.load(std::memory_order_relaxed) + EVENT_QUEUE_SIZE;
+    events_update_flow(true);
+  }
+
+  // Writes the BLE task had to reject since the last pass
+  uint32_t overflows = events_queue_overflows();
+  if (overflows != eventOverflowsReported) {
+    Serial.printf("Event queue full — dropped %u BLE command(s)\n", (unsigned)(overflows - eventOverflowsReported));
+    eventOverflowsReported = overflows;
+    notifyStatus("ERROR:event_queue_full");
+    events_update_flow(true);
+  }
+
+  EventLane *lane = events_next_lane();
+  if (!lane) return;
+  EventSlot *slot = events_peek_slot(*lane);
+
+  if ((uint8_t)slot->data[0] == 0xAA) Serial.printf("events_process_one: dequeued -> <protobuf, %u bytes>\n", (unsigned)slot->len);
+  else { Serial.print("events_process_one: dequeued -> "); Serial.println(slot->data); }
+
+  // Decode once straight out of the ring slot; everything below works from
+  // the typed command, so the slot can go back to the producer right away
+  Command cmd;
+  command_parse(slot->data, slot->len, cmd);
+  uint32_t enqueuedUs = slot->enqueuedUs;
+  bool cancelled = slot->cancelled;
+  if (lane == &controlLane) events_cancel_superseded(*slot);
+  events_release_slot(*lane);
+
+  if (cancelled) {
+    FixedString<64> reply(cmd.key());
+    reply.append(":cancelled");
+    bluetooth_send_response_internal(reply.c_str(), cmd.correlationId());
+  } else {
+    events_handle_command(cmd);
+  }
+  events_record_latency(enqueuedUs);
+  if (lane == &normalLane) events_update_flow(false);
+}
+
+// Milliseconds until events_process_one() next has work: a queued command,
+// the main-loop scan tick, the radio poll while scanningRadio, or a radio
+// batch's idle/age deadline. Capped at `maxMs`.
+unsigned long events_next_deadline_ms(unsigned long maxMs) {
+  if (events_command_pending()) return 0;
+  unsigned long now = millis();
+  unsigned long wait = maxMs;
+  auto until = [&](unsigned long due) {
+    unsigned long left = (long)(due - now) > 0 ? due - now : 0;
+    if (left < wait) wait = left;
+  };
+
+  if (jobHeapSize > 0) until(scanJobs[jobHeap[0]].dueMs);
+  if (scanningRadio) until(radioPollDueMs);
+  if (radioTimerArmed) until(radioTimerNextMs);
+  return wait;
+}
 
-  Serial.print("events_process_one: dequeued -> "); Serial.println(raw);
+static void events_handle_command(const Command &cmd) {
 
   // Indicate LED feedback immediately based on whether the payload is a
   // known/valid topic.  - valid => yellow flash (success), - invalid => red.
-  if (events_validate_topic(raw)) {
+  if (events_validate_command(cmd)) {
     indicate_command_success();
   } else {
     indicate_command_failure();
   }
 
-  // Prefer JSON 'Command' format — forward to existing handler
-  DynamicJsonDocument doc(1024);
-  auto err = deserializeJson(doc, raw);
-  if (!err) {
-    // extract optional correlation id so replies can be correlated
-    String correlationId = String();
-    if (doc.containsKey("id")) {
-      const char *cid = doc["id"];
-      if (cid) correlationId = String(cid);
-    } else if (doc.containsKey("requestId")) {
-      const char *cid = doc["requestId"];
-      if (cid) correlationId = String(cid);
-    }
+  const char *correlationId = cmd.correlationId();
+  if (cmd.overflow) {
+    bluetooth_send_response_internal("ERROR:command_too_large", correlationId);
+    return;
+  }
 
-    // Handle pairing command if present (works whether or not in pairingMode)
-    if (doc.containsKey("command")) {
-      const char *pkey = doc["command"];
-      if (pkey && String(pkey) == String(CMD_PAIR_SET)) {
-        JsonObject params = doc.containsKey("params") ? doc["params"].as<JsonObject>() : JsonObject();
-        String pinStr = String();
-        if (params.containsKey("pin")) {
-          if (params["pin"].is<const char*>()) pinStr = String((const char*)params["pin"]);
-          else pinStr = String((long)params["pin"]);
-        } else if (params.containsKey("code")) {
-          if (params["code"].is<const char*>()) pinStr = String((const char*)params["code"]);
-          else pinStr = String((long)params["code"]);
-        }
-        if (pinStr == String("6942")) {
-          paired = true;
-          pairingMode = false;
-          prefs.putBool("paired", true);
-          notifyStatus("paired:yes");
-          bluetooth_send_response_internal("pair:ok", correlationId);
-        } else {
-          bluetooth_send_response_internal("ERROR:invalid_pin", correlationId);
-        }
-        return;
-      }
-    }
-    // Legacy pairing: { "Command": { "Pair": { "pin": "6942" } } }
-    if (doc.containsKey("Command")) {
-      JsonObject cmdObj = doc["Command"].as<JsonObject>();
-      if (!cmdObj.isNull() && cmdObj.containsKey("Pair")) {
-        JsonObject p = cmdObj["Pair"].as<JsonObject>();
-        String pinStr = String();
-        if (p.containsKey("pin")) {
-          if (p["pin"].is<const char*>()) pinStr = String((const char*)p["pin"]);
-          else pinStr = String((long)p["pin"]);
-        }
-        if (pinStr == String("6942")) {
-          paired = true;
-          pairingMode = false;
-          prefs.putBool("paired", true);
-          notifyStatus("paired:yes");
-          bluetooth_send_response_internal("pair:ok", correlationId);
-        } else {
-          bluetooth_send_response_internal("ERROR:invalid_pin", correlationId);
-        }
-        return;
-      }
-    }
+  // Normal flows below (pairing no longer blocks commands)
+  switch (cmd.format) {
+    case COMMAND_FORMAT_LEGACY:
+      // Legacy firmware command format
+      if (cmd.legacy == LEGACY_PAIR) cmd_handle_pair_set(cmd);
+      else handle_legacy_command(cmd);
+      return;
 
-    // Normal flows below (pairing no longer blocks commands)
-    if (doc.containsKey("Command")) {
-      // Legacy firmware command format — let existing handler parse & act
-      handleBLECommand(raw);
+    case COMMAND_FORMAT_JSON:
+    case COMMAND_FORMAT_PROTOBUF:
+    case COMMAND_FORMAT_PLAIN:
+      dispatch_command(cmd);
       return;
-    }
 
-    // If 'command' key present, dispatch by key
-    if (doc.containsKey("command")) {
-      const char *key = doc["command"];
-      if (key) {
-        JsonObject params = doc.containsKey("params") ? doc["params"].as<JsonObject>() : JsonObject();
-        // Allow start/stop control for background scans here
-        String k = String(key);
-        if (k == String(CMD_WIFI_SNIFFER_START) || k == String(CMD_BLE_SCAN_START) || k == String(CMD_NRF_SCAN_START) || k == String(CMD_SUBGHZ_READ_START) || k == String(CMD_OSCILLOSCOPE_START) || k == String(CMD_I2C_SCAN_START) || k == String(CMD_NFC_POLL_START) || k == String(CMD_SENSOR_STREAM_START)) {
-          start_scan_for_key(k, &params);
-          return;
-        }
-        if (k == String(CMD_WIFI_SNIFFER_STOP) || k == String(CMD_BLE_SCAN_STOP) || k == String(CMD_NRF_SCAN_STOP) || k == String(CMD_SUBGHZ_READ_STOP) || k == String(CMD_OSCILLOSCOPE_STOP) || k == String(CMD_I2C_SCAN_STOP) || k == String(CMD_NFC_POLL_STOP) || k == String(CMD_SENSOR_STREAM_STOP)) {
-          stop_scan_for_key(k);
-          return;
-        }
+    case COMMAND_FORMAT_BATCH:
+      events_handle_batch(cmd);
+      return;
 
-        Serial.print("dispatch_command_key: key=\""); Serial.print(k); Serial.println("\"");
-        dispatch_command_key(k, &params);
-        return;
-      }
-    }
+    default:
+      // If we reach here, unknown payload
+      bluetooth_send_response_internal("ERROR:invalid_payload");
+      return;
   }
+}
 
-  // Not JSON or not recognized JSON — treat as plain command key string
-  String trimmed = raw;
-  trimmed.trim();
-  for (unsigned int i = 0; i < SHARKOS_BT_COMMAND_COUNT; ++i) {
-    if (trimmed == String(SHARKOS_BT_COMMANDS[i])) {
-      // translate plain-key starts/stops into scan manager control too
-      if (trimmed == String(CMD_WIFI_SNIFFER_START) || trimmed == String(CMD_BLE_SCAN_START) || trimmed == String(CMD_NRF_SCAN_START) || trimmed == String(CMD_SUBGHZ_READ_START) || trimmed == String(CMD_OSCILLOSCOPE_START) || trimmed == String(CMD_I2C_SCAN_START) || trimmed == String(CMD_NFC_POLL_START) || trimmed == String(CMD_SENSOR_STREAM_START)) {
-        start_scan_for_key(trimmed, nullptr);
-        return;
-      }
-      if (trimmed == String(CMD_WIFI_SNIFFER_STOP) || trimmed == String(CMD_BLE_SCAN_STOP) || trimmed == String(CMD_NRF_SCAN_STOP) || trimmed == String(CMD_SUBGHZ_READ_STOP) || trimmed == String(CMD_OSCILLOSCOPE_STOP) || trimmed == String(CMD_I2C_SCAN_STOP) || trimmed == String(CMD_NFC_POLL_STOP) || trimmed == String(CMD_SENSOR_STREAM_STOP)) {
-        stop_scan_for_key(trimmed);
-        return;
-      }
+// Run the items of a {"batch":[...]} envelope in order, within the same
+// dequeue, and answer them with a single notification:
+//   {"batch":[{"Response":"...","inReplyTo":"<item id>"},...],"inReplyTo":"<batch id>"}
+// Items without an id are answered with their index. A reply that would
+// push the aggregate past BATCH_REPLY_CAPACITY goes out on its own, as if it
+// were not batched. Notifications that are not replies (scan results,
+// status frames, "paired:yes") still go out as they happen.
+static void events_handle_batch(const Command &batch) {
+  if (batch.batchCount == 0) {
+    bluetooth_send_response_internal("ERROR:empty_batch", batch.correlationId());
+    return;
+  }
 
-      dispatch_command_key(trimmed, nullptr);
-      return;
-    }
+  const char *batchId = batch.hasCorrelationId() ? batch.correlationId() : "";
+  batch_reply_begin(batchId);
+  batchCapturing = true;
+  Command item;
+  for (uint8_t i = 0; i < batch.batchCount; ++i) {
+    command_parse_batch_item(i, item);
+    snprintf(batchItemIndex, sizeof(batchItemIndex), "%u", (unsigned)i);
+    batchItemId = item.hasCorrelationId() ? item.correlationId() : batchItemIndex;
+    events_handle_command(item);
   }
+  batchCapturing = false;
 
-  // If we reach here, unknown payload
-  notifyStatus("ERROR:invalid_payload");
+  batch_reply_end(batchId);
+  notifyStatus(batchReplyText);
 }
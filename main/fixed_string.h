@@ -0,0 +1,85 @@
+#pragma once
+
+// Text without the heap. FixedString<N> keeps up to N chars (plus the NUL)
+// inline, so a struct holding one can sit in a long-lived vector or ring,
+// or a reply can be built on the stack, without a String allocation per
+// field; assign() and append() cut at N and remember that they did. StrView
+// is a (pointer, length) pair for handing text to a function without
+// copying it; it converts implicitly from a C string and from FixedString.
+//
+// host/bench_soak.cpp watches the heap these are meant to keep flat.
+
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+struct StrView {
+  const char *data;
+  size_t len;
+
+  StrView() : data(""), len(0) {}
+  StrView(const char *s) : data(s ? s : ""), len(s ? strlen(s) : 0) {}
+  StrView(const char *s, size_t n) : data(s), len(n) {}
+
+  bool empty() const { return len == 0; }
+  bool operator==(StrView o) const { return len == o.len && memcmp(data, o.data, len) == 0; }
+  bool operator!=(StrView o) const { return !(*this == o); }
+};
+
+template <size_t N>
+class FixedString {
+public:
+  static_assert(N > 0 && N < 256, "FixedString keeps its length in a byte");
+
+  FixedString() { clear(); }
+  FixedString(StrView s) { assign(s); }
+  FixedString &operator=(StrView s) {
+    assign(s);
+    return *this;
+  }
+
+  void clear() {
+    len_ = 0;
+    truncated_ = false;
+    buf_[0] = '\0';
+  }
+  void assign(StrView s) {
+    clear();
+    append(s);
+  }
+  FixedString &append(StrView s) {
+    size_t n = s.len;
+    if (n > N - len_) {
+      n = N - len_;
+      truncated_ = true;
+    }
+    memmove(buf_ + len_, s.data, n);
+    len_ += (uint8_t)n;
+    buf_[len_] = '\0';
+    return *this;
+  }
+  FixedString &append(char c) { return append(StrView(&c, 1)); }
+  FixedString &operator+=(StrView s) { return append(s); }
+
+  const char *c_str() const { return buf_; }
+  size_t length() const { return len_; }
+  bool empty() const { return len_ == 0; }
+  // Some text did not fit since the last clear()/assign().
+  bool truncated() const { return truncated_; }
+  static constexpr size_t capacity() { return N; }
+
+  StrView view() const { return StrView(buf_, len_); }
+  operator StrView() const { return view(); }
+  bool operator==(StrView s) const { return view() == s; }
+  bool operator!=(StrView s) const { return view() != s; }
+
+private:
+  uint8_t len_;
+  bool truncated_;
+  char buf_[N + 1];
+};
+
+#endif // FIXED_STRING_H
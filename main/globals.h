@@ -32,6 +32,9 @@
 #include "USBHIDKeyboard.h"
 #include <esp_system.h>
 #include <esp_chip_info.h>
+#include "psram_alloc.h"
+#include "fixed_string.h"
+#include <atomic>
 
 // NOTE: do NOT force NO_OLED here — let individual build configs
 // or the user's choice determine whether the OLED/UI is compiled.
@@ -74,21 +77,23 @@ public:
 
 extern DummyU8g2 u8g2;
 
+// Scan results are kept by the hundred for as long as a scan runs, so their
+// text is inline (fixed_string.h) and longer values are cut.
 struct blescanner_Device {
-  String name;
-  String address;
+  FixedString<32> name;
+  FixedString<17> address;        // "aa:bb:cc:dd:ee:ff"
   int rssi;
-  String manufacturer;
-  String deviceType;
+  FixedString<8> manufacturer;    // "0x004C" or "unknown"
+  FixedString<36> deviceType;     // 128-bit service UUID
 };
 struct wifi_Network {
-  String ssid;
+  FixedString<32> ssid;
   int rssi;
-  String bssid;
+  FixedString<17> bssid;
 };
 struct rf_signal {
-  String type;
-  String data;
+  FixedString<16> type;
+  FixedString<64> data;
   int frequency;
   int rssi;
 };
@@ -188,13 +193,14 @@ struct RadioSignal {
   float frequency_mhz;
   int32_t rssi;
   std::vector<uint8_t> payload;
-  String extra;
+  FixedString<32> extra;   // SSID or BLE name
   // helper defined in hardware-utils.ino
   String toJson() const;
 };
 
 // forward declarations for utilities implemented elsewhere
 extern String base64_encode(const uint8_t *data, size_t len);
+extern void base64_append(String &out, const uint8_t *data, size_t len);
 
 // --- Shared globals (defined in one .ino only, declared extern here) ---
 #include <SPI.h>
@@ -220,7 +226,7 @@ extern int batteryPercent;
 //extern USBHIDKeyboard Keyboard;
 //extern BleMouse mouse_ble;
 extern BLEServer *pServer;
-extern bool scanningRadio;
+extern std::atomic<bool> scanningRadio;  // also read by the bus-worker sweeps
 extern int wifi_scan_channel; // 0 = all
 extern bool wifi_scan_5ghz;   // false = 2.4 GHz only
 extern float scanFrequency;
@@ -235,16 +241,35 @@ enum ModulationType {
     MOD_UNKNOWN
 };
 
-extern std::vector<String> scanModulation;
+// What scanningRadio polls for in the main loop. The sub-GHz scan records
+// the modulation each CC1101 was set to (MOD_UNKNOWN when unset); the other
+// targets have none.
+enum ScanTarget : uint8_t {
+    SCAN_TARGET_SUBGHZ,
+    SCAN_TARGET_WIFI,
+    SCAN_TARGET_BLE,
+    SCAN_TARGET_NFC,
+    SCAN_TARGET_IR
+};
+
+struct ScanModulation {
+    ScanTarget target;
+    ModulationType radio[2];
+};
 
-// helpers for converting between string and enum (implemented in hardware-utils)
-ModulationType modulationFromString(const String &s);
-String modulationToString(ModulationType m);
+extern ScanModulation scanModulation;
+
+// helpers for converting between string and enum (implemented in hardware-utils);
+// names are the UI's ("OOK", "2-FSK", ...), MOD_UNKNOWN's is ""
+ModulationType modulationFromString(StrView s);
+const char *modulationToString(ModulationType m);
 extern bool readingNfc;
 extern Adafruit_PN532 nfc;
 extern bool sendingIr;
 
-extern std::vector<blescanner_Device> blescanner_devices;
+// Grows with every device seen, so it lives in PSRAM (psram_alloc.h).
+typedef std::vector<blescanner_Device, PsramAllocator<blescanner_Device, PSRAM_REGION_BLE_DEVICES>> BleScannerDevices;
+extern BleScannerDevices blescanner_devices;
 extern int blescanner_selectedIndex;
 extern BLEScan* blescanner_pBLEScan;
 
@@ -375,7 +400,7 @@ void blemouse();
 
 // WiFi helpers
 void scanningwifi();
-String wifi_encryptionType(wifi_auth_mode_t encryption);
+const char *wifi_encryptionType(wifi_auth_mode_t encryption);
 
 // nRF / NRF scanner helpers
 void scanAll();
@@ -413,7 +438,7 @@ bool events_enqueue_command(const String &cmd);
 void events_process_one();
 bool events_validate_topic(const String &payload);
 void handleBLECommand(const String &jsonCmd);
-void bluetooth_send_response(const String &payload, const String &inReplyTo = "");
+void bluetooth_send_response(const char *payload, const char *inReplyTo = "");
 
 // LED / command indicators
 // - `firstCommandReceived` becomes true after the first *valid* BLE command
@@ -425,6 +450,7 @@ void indicate_command_failure();
 
 // CC1101 / LoRa functions
 void cc1101Read();
+void cc1101ReadAsync();
 void cc1101Jam();
 void loraRead();
 void loraJam();
@@ -465,4 +491,12 @@ struct CC1101RegDump {
   int  gdo0val;
 };
 
+// Debug output goes through the serial link console, which passes it
+// through in text mode and frames it on the log channel in binary mode.
+// serial_link_port() is the port itself. (The ESP32 core may already define
+// Serial as a macro for its USB-CDC port.)
+#include "serial_link.h"
+#undef Serial
+#define Serial serialConsole
+
 #endif // SHARKOS_H
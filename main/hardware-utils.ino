@@ -20,6 +20,11 @@
 
 #include <esp_wifi.h>
 #include <ArduinoJson.h>
+#include "sharkos.pb.h"
+#include "bus_workers.h"
+#include "telemetry.h"
+#include "base64.h"
+#include "ble_link.h"
 
 
 // HID
@@ -77,7 +82,7 @@ volatile bool anyConnected = false; // updated in server callbacks
 // represented here.
 // Enum is defined in globals.h
 
-ModulationType modulationFromString(const String &s) {
+ModulationType modulationFromString(StrView s) {
   if (s == "OOK") return MOD_OOK;
   if (s == "2-FSK") return MOD_2FSK;
   if (s == "ASK") return MOD_ASK;
@@ -85,7 +90,7 @@ ModulationType modulationFromString(const String &s) {
   if (s == "MSK") return MOD_MSK;
   return MOD_UNKNOWN;
 }
-String modulationToString(ModulationType m) {
+const char *modulationToString(ModulationType m) {
   switch (m) {
     case MOD_OOK: return "OOK";
     case MOD_2FSK: return "2-FSK";
@@ -97,38 +102,28 @@ String modulationToString(ModulationType m) {
 }
 
 // State variables for commands
-bool scanningRadio = false;
+std::atomic<bool> scanningRadio{false};
 int wifi_scan_channel = 0; // 0 = all
 bool wifi_scan_5ghz = false; // standard is 2.4 only
 float scanFrequency = 433.0;
-std::vector<String> scanModulation = {"OOK"};
+ScanModulation scanModulation = {SCAN_TARGET_SUBGHZ, {MOD_OOK, MOD_UNKNOWN}};
 bool readingNfc = false;
 bool sendingIr = false;
 
-static bool scanModulationContains(const char *value) {
-  for (const auto &item : scanModulation) {
-    if (item == String(value)) return true;
+
+// Append the base64 of `data` to `out`, a stack block at a time (base64.h).
+void base64_append(String &out, const uint8_t *data, size_t len) {
+  char block[128];  // 96 input bytes per step
+  out.reserve(out.length() + base64_encoded_len(len));
+  for (size_t i = 0; i < len; i += 96) {
+    size_t n = len - i < 96 ? len - i : 96;
+    out.concat(block, (unsigned int)base64_encode_to(data + i, n, block));
   }
-  return false;
 }
 
-
-// Simple base64 encoder (sufficient for small payloads)
-static const char b64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 String base64_encode(const uint8_t *data, size_t len) {
   String out;
-  out.reserve(4 * ((len + 2) / 3));
-  size_t i = 0;
-  while (i < len) {
-    uint32_t a = i < len ? data[i++] : 0;
-    uint32_t b = i < len ? data[i++] : 0;
-    uint32_t c = i < len ? data[i++] : 0;
-    uint32_t triple = (a << 16) | (b << 8) | c;
-    out += b64_table[(triple >> 18) & 0x3F];
-    out += b64_table[(triple >> 12) & 0x3F];
-    out += (i - 2 <= len) ? b64_table[(triple >> 6) & 0x3F] : '=';
-    out += (i - 1 <= len) ? b64_table[triple & 0x3F] : '=';
-  }
+  base64_append(out, data, len);
   return out;
 }
 
@@ -144,167 +139,11 @@ void sendRadioSignalOverBle(const RadioSignal &rs) {
   }
 }
 
-// --- Simple protobuf encoder (hand-rolled) + framing ---
-// NOTE: This is a lightweight manual protobuf encoder tailored to the
-// `RadioSignal` message in .proto. For production use replace with
-// nanopb-generated encoder. This implementation writes fields:
-// 1: timestamp_ms (varint)
-// 2: module (varint)
-// 3: frequency_mhz (32-bit fixed)
-// 4: rssi (varint)
-// 5: payload (length-delimited)
-// 6: extra (length-delimited string)
-
-static void write_varint(std::vector<uint8_t> &out, uint64_t v) {
-  while (v >= 0x80) {
-    out.push_back((uint8_t)((v & 0x7F) | 0x80));
-    v >>= 7;
-  }
-  out.push_back((uint8_t)v);
-}
-
-static void write_tag(std::vector<uint8_t> &out, uint32_t field, uint8_t wire_type) {
-  write_varint(out, ((uint64_t)field << 3) | (wire_type & 0x7));
-}
-
-static void write_fixed32(std::vector<uint8_t> &out, float f) {
-  union { float f; uint32_t u; } u; u.f = f;
-  out.push_back((uint8_t)(u.u & 0xFF));
-  out.push_back((uint8_t)((u.u >> 8) & 0xFF));
-  out.push_back((uint8_t)((u.u >> 16) & 0xFF));
-  out.push_back((uint8_t)((u.u >> 24) & 0xFF));
-}
-
-static void write_bytes_len_prefixed(std::vector<uint8_t> &out, const uint8_t *buf, size_t len) {
-  write_varint(out, (uint64_t)len);
-  for (size_t i = 0; i < len; ++i) out.push_back(buf[i]);
-}
-
-// Encodes RadioSignal into a protobuf-like byte vector. Returns true on success.
-bool encode_radio_signal_pb(const RadioSignal &rs, std::vector<uint8_t> &out) {
-  out.clear();
-  // field 1: timestamp_ms (varint)
-  write_tag(out, 1, 0);
-  write_varint(out, rs.timestamp_ms);
-  // field 2: module (varint)
-  write_tag(out, 2, 0);
-  write_varint(out, (uint64_t)rs.module);
-  // field 3: frequency_mhz (32-bit fixed)
-  write_tag(out, 3, 5);
-  write_fixed32(out, rs.frequency_mhz);
-  // field 4: rssi (varint)
-  write_tag(out, 4, 0);
-  // ZigZag-encode signed RSSI so negative dBm values are encoded compactly
-  {
-    int64_t rssi_signed = (int64_t)rs.rssi;
-    uint64_t zz = ((uint64_t)(rssi_signed << 1)) ^ (uint64_t)(rssi_signed >> 63);
-    write_varint(out, zz);
-  }
-  // field 5: payload (length-delimited)
-  if (!rs.payload.empty()) {
-    write_tag(out, 5, 2);
-    write_bytes_len_prefixed(out, rs.payload.data(), rs.payload.size());
-  }
-  // field 6: extra (length-delimited string)
-  if (rs.extra.length() > 0) {
-    write_tag(out, 6, 2);
-    const char *s = rs.extra.c_str();
-    write_bytes_len_prefixed(out, (const uint8_t*)s, strlen(s));
-  }
-  return true;
-}
-
-// Encodes the `.proto` `status` message fields into protobuf bytes.
-// Field mapping:
-// 1: is_scanning (varint bool)
-// 2: battery_percent (varint int32)
-// 3: cc1101_1_connected (varint bool)
-// 4: cc1101_2_connected (varint bool)
-// 5: lora_connected (varint bool)
-// 6: nfc_connected (varint bool)
-// 7: wifi_connected (varint bool)
-// 8: bluetooth_connected (varint bool)
-// 9: ir_connected (varint bool)
-// 10: serial_connected (varint bool)
-static bool encode_status_pb(bool is_scanning,
-                             int battery_percent,
-                             bool cc1101_1_connected,
-                             bool cc1101_2_connected,
-                             bool lora_connected,
-                             bool nfc_connected,
-                             bool wifi_connected,
-                             bool bluetooth_connected,
-                             bool ir_connected,
-                             bool serial_connected,
-                             std::vector<uint8_t> &out) {
-  out.clear();
-
-  int bp = battery_percent;
-  if (bp < 0) bp = 0;
-  if (bp > 100) bp = 100;
-
-  write_tag(out, 1, 0); write_varint(out, is_scanning ? 1 : 0);
-  write_tag(out, 2, 0); write_varint(out, (uint64_t)bp);
-  write_tag(out, 3, 0); write_varint(out, cc1101_1_connected ? 1 : 0);
-  write_tag(out, 4, 0); write_varint(out, cc1101_2_connected ? 1 : 0);
-  write_tag(out, 5, 0); write_varint(out, lora_connected ? 1 : 0);
-  write_tag(out, 6, 0); write_varint(out, nfc_connected ? 1 : 0);
-  write_tag(out, 7, 0); write_varint(out, wifi_connected ? 1 : 0);
-  write_tag(out, 8, 0); write_varint(out, bluetooth_connected ? 1 : 0);
-  write_tag(out, 9, 0); write_varint(out, ir_connected ? 1 : 0);
-  write_tag(out, 10, 0); write_varint(out, serial_connected ? 1 : 0);
-
-  return true;
-}
-
-// Framing: [0xAA 0x55][u16 le length][payload bytes]
-void send_protobuf_framed(const std::vector<uint8_t> &payload) {
-  uint16_t len = (uint16_t)payload.size();
-  uint8_t header[4];
-  header[0] = 0xAA; header[1] = 0x55;
-  header[2] = (uint8_t)(len & 0xFF);
-  header[3] = (uint8_t)((len >> 8) & 0xFF);
-  // send over BLE if available (binary)
-  if (pStatusChar && anyConnected) {
-    // build contiguous buffer
-    std::vector<uint8_t> buf;
-    buf.insert(buf.end(), header, header+4);
-    buf.insert(buf.end(), payload.begin(), payload.end());
-    pStatusChar->setValue((uint8_t*)buf.data(), buf.size());
-    pStatusChar->notify();
-  }
-  // Always emit base64-framed string over Serial for Rust listener fallback
-  // Format: PROTO:<base64_of_framed>
-  // Build framed bytes
-  std::vector<uint8_t> framed;
-  framed.insert(framed.end(), header, header+4);
-  framed.insert(framed.end(), payload.begin(), payload.end());
-  String b64 = base64_encode(framed.data(), framed.size());
-  Serial.print("PROTO:"); Serial.println(b64);
-}
-
-// Convenience helper used by events/task code to send a single RadioSignal
-// as a protobuf-framed BLE notify (and Serial PROTO: line). Exposed for
-// callers in other files.
-void hw_send_radio_signal_protobuf(int module, float frequency_mhz, int32_t rssi, const uint8_t* data, size_t len, const char* extra) {
-  RadioSignal rs;
-  rs.timestamp_ms = (uint64_t)millis();
-  rs.module = (RadioModule)module;
-  rs.frequency_mhz = frequency_mhz;
-  rs.rssi = rssi;
-  rs.payload.clear();
-  if (data && len > 0) rs.payload.assign(data, data + len);
-
-  rs.extra = extra ? String(extra) : String();
-  Serial.print("hw_send_radio_signal_protobuf: module="); Serial.print(module);
-  Serial.print(", frequency_mhz="); Serial.print(frequency_mhz);
-  Serial.print(", rssi="); Serial.print(rssi);
-  Serial.print(", extra="); Serial.println(rs.extra);
-  std::vector<uint8_t> pb;
-  if (encode_radio_signal_pb(rs, pb)) {
-    send_protobuf_framed(pb);
-  }
-}
+// --- Protobuf messages ---
+// Messages are encoded with the codecs generated from .proto into
+// sharkos.pb.h (re-run gen_proto.py after changing .proto), straight into a
+// fixed frame buffer on the stack, and handed to the telemetry sink
+// (telemetry.h), which frames them for each transport.
 
 void hw_send_status_protobuf(bool is_scanning,
                              int battery_percent,
@@ -316,25 +155,23 @@ void hw_send_status_protobuf(bool is_scanning,
                              bool bluetooth_connected,
                              bool ir_connected,
                              bool serial_connected) {
-  std::vector<uint8_t> pb;
-  if (encode_status_pb(is_scanning,
-                       battery_percent,
-                       cc1101_1_connected,
-                       cc1101_2_connected,
-                       lora_connected,
-                       nfc_connected,
-                       wifi_connected,
-                       bluetooth_connected,
-                       ir_connected,
-                       serial_connected,
-                       pb)) {
-    send_protobuf_framed(pb);
-  }
+  status_pb msg;
+  msg.is_scanning = is_scanning;
+  msg.battery_percent = battery_percent < 0 ? 0 : (battery_percent > 100 ? 100 : battery_percent);
+  msg.cc1101_1_connected = cc1101_1_connected;
+  msg.cc1101_2_connected = cc1101_2_connected;
+  msg.lora_connected = lora_connected;
+  msg.nfc_connected = nfc_connected;
+  msg.wifi_connected = wifi_connected;
+  msg.bluetooth_connected = bluetooth_connected;
+  msg.ir_connected = ir_connected;
+  msg.serial_connected = serial_connected;
+
+  uint8_t frame[PB_FRAME_HEADER + 32];   // status is at most 22 bytes
+  PbOStream s = pb_ostream(frame + PB_FRAME_HEADER, sizeof(frame) - PB_FRAME_HEADER);
+  if (pb_encode_status(s, msg)) telemetry_send_frame(frame, s.len);
 }
 
-// Forward declaration of event enqueue function implemented in events.ino
-extern void events_enqueue_radio_bytes(int module, const uint8_t* data, size_t len, float frequency_mhz, int32_t rssi);
-
 #include "transceivers.h"
 
 // Global transceiver pointers — will be initialized after hardware objects exist
@@ -384,7 +221,7 @@ void runWifiBleScanTasks() {
   // Only run WiFi scan when explicitly requested via BLE command.
   // WiFi radio activation conflicts with ADC2 pins (GPIO 11-18) used by
   // nRF24 and CC1101 SPI buses. Never run this automatically.
-  if (scanningRadio && scanModulationContains("WIFI")) {
+  if (scanningRadio && scanModulation.target == SCAN_TARGET_WIFI) {
       // If 5GHz mode is requested
       // if (wifi_scan_5ghz) {
       //     // Standard ESP32 is 2.4GHz only.
@@ -431,29 +268,20 @@ void runWifiBleScanTasks() {
 
       if (n >= 0) {
         for (int i = 0; i < n; ++i) {
-          RadioSignal rs;
-          rs.timestamp_ms = (uint64_t)millis();
-          rs.module = WIFI;
           // estimate frequency from channel: WiFi.channel(i) not available here,
           // fallback to 2412 + 5*(chan-1) if we get channel via WiFi.channel(i)
           int channel = WiFi.channel(i);
-          if (channel <= 0) rs.frequency_mhz = 2412.0;
-          else rs.frequency_mhz = 2412.0 + (channel - 1) * 5.0;
-          rs.rssi = WiFi.RSSI(i);
-          Serial.print("Found WiFi network: SSID="); Serial.print(WiFi.SSID(i)); Serial.print(" RSSI="); Serial.println(rs.rssi);
+          float frequency_mhz = channel <= 0 ? 2412.0f : 2412.0f + (channel - 1) * 5.0f;
+          int32_t rssi = WiFi.RSSI(i);
           String ssid = WiFi.SSID(i);
-          String enc = wifi_encryptionType(WiFi.encryptionType(i));
-          rs.extra = ssid;
-          rs.payload.clear();
-          // Append encryption type string as bytes into the payload
-          for (size_t k = 0; k < enc.length(); ++k) {
-            rs.payload.push_back((uint8_t)enc.charAt(k));
-          }
-          // Encode protobuf and send framed
-          std::vector<uint8_t> pb;
-          if (encode_radio_signal_pb(rs, pb)) send_protobuf_framed(pb);
-          // Enqueue minimal event for existing batching system (empty payload).
-          events_enqueue_radio_bytes((int)rs.module, nullptr, 0, rs.frequency_mhz, rs.rssi);
+          Serial.print("Found WiFi network: SSID="); Serial.print(ssid); Serial.print(" RSSI="); Serial.println(rssi);
+          const char *enc = wifi_encryptionType(WiFi.encryptionType(i));
+          // SSID goes in extra, the encryption type string in the payload
+          TelemetrySample sample = telemetry_sample((int)WIFI, frequency_mhz, rssi, (const uint8_t *)enc,
+                                                    strlen(enc), nullptr);
+          sample.extra = ssid.c_str();
+          sample.extraLen = ssid.length();
+          telemetry_publish(sample);
       }
     }
     //} // END if 5GHz else 2.4GHz
@@ -500,26 +328,35 @@ class ServerCallbacks : public BLEServerCallbacks {
     if (pServer && pServer->getConnId() >= 0) {
       Serial.print("Connection id: "); Serial.println(pServer->getConnId());
     }
+    events_flow_reset();  // LED / pairing state changed; new credit window
+    ble_link_reset();
+    telemetry_set_ble_json(false);
   }
   void onDisconnect(BLEServer* pServer) {
     anyConnected = false;
+    ble_link_reset();
+    telemetry_set_ble_json(false);
     Serial.println("BLE client disconnected");
     // Restart advertising so new clients can discover and connect
     BLEDevice::startAdvertising();
     Serial.println("BLE advertising restarted");
+    events_wake();
+  }
+  void onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) {
+    ble_link_set_mtu(param->mtu.mtu);
   }
 };
 
 #include "events.h"
 
 class CommandCallbacks : public BLECharacteristicCallbacks {
+  // Runs in the BLE host task: copy the raw value into the events ring
+  // without allocating or logging (events_process_one() logs on dequeue).
   void onWrite(BLECharacteristic *p) {
-    String s = p->getValue();
-    if (s.length() > 0) {
-      Serial.print("BLE Command received: ");
-      Serial.println(s);
+    size_t len = p->getLength();
+    if (len > 0) {
       // Forward to the central BLE->events wrapper (permitting pairing checks)
-      bluetooth_receive_command(s);
+      bluetooth_receive_command_bytes(p->getData(), len);
     }
   }
 };
@@ -530,7 +367,7 @@ void handleOngoingTasks(); // forward
 ///////////////////////////////////////////////////
 
 
-std::vector<blescanner_Device> blescanner_devices;
+BleScannerDevices blescanner_devices;
 int blescanner_selectedIndex = 0;
 BLEScan* blescanner_pBLEScan;
 
@@ -759,6 +596,9 @@ void deviceSetup() {
     Serial.println("deviceSetup: BLE init");
     delay(50); // yield to WDT
     BLEDevice::init("SharkOS");
+    // Offer the largest ATT MTU; ble_link.h sizes notifications to whatever
+    // the client settles on.
+    BLEDevice::setMTU(BLE_LINK_MAX_PAYLOAD + 3);
     pServer = BLEDevice::createServer();
     pServer->setCallbacks(new ServerCallbacks());
     BLEService *pService = pServer->createService(BLE_SERVICE_UUID);
@@ -785,7 +625,7 @@ void deviceSetup() {
     if (paired) {
       Serial.println("Device previously paired (auth found)");
       // notify status
-      if (pStatusChar) { pStatusChar->setValue(String("paired:yes")); pStatusChar->notify(); }
+      notifyStatus("paired:yes");
     }
 
     pService->start();
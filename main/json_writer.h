@@ -0,0 +1,246 @@
+#pragma once
+
+// Streaming JSON writer over a fixed chunk buffer. Values are formatted
+// straight into the buffer (integers two digits at a time, floats as fixed
+// point, bytes as base64 via base64.h; no printf, no String), and every time
+// the buffer fills it is handed to the sink and reused. Output of any size
+// therefore needs only the chunk buffer, and the sink sees consecutive
+// pieces of one document.
+//
+// Commas and nesting are tracked here; callers only open/close containers,
+// name keys and write values.
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "base64.h"
+
+typedef void (*JsonSinkFn)(void *ctx, const char *data, size_t len);
+
+static const uint8_t JSON_WRITER_MAX_DEPTH = 16;
+static const uint8_t JSON_WRITER_MAX_DECIMALS = 9;
+
+class JsonWriter {
+public:
+  // `buf` must hold at least 32 bytes (the longest single token written
+  // without a flush check: a formatted number).
+  JsonWriter(char *buf, size_t cap, JsonSinkFn sink, void *ctx) : buf_(buf), cap_(cap), sink_(sink), ctx_(ctx) {}
+
+  void beginObject() { open('{'); }
+  void endObject() { close('}'); }
+  void beginArray() { open('['); }
+  void endArray() { close(']'); }
+
+  void key(const char *k) {
+    separate();
+    putString(k, strlen(k));
+    put(':');
+    afterKey_ = true;
+  }
+
+  void valueInt(int64_t v) {
+    separate();
+    reserve(21);
+    if (v < 0) {
+      buf_[len_++] = '-';
+      putDigits(0 - (uint64_t)v);
+    } else {
+      putDigits((uint64_t)v);
+    }
+  }
+  void valueUint(uint64_t v) {
+    separate();
+    reserve(20);
+    putDigits(v);
+  }
+
+  // Fixed point with `decimals` digits after the point, rounded like
+  // printf("%.*f") (exact ties to even), so a float prints the same digits as
+  // String(float, decimals) without the snprintf. NaN, infinity and values
+  // too large for 64-bit fixed point are written as null.
+  void valueFixed(double v, uint8_t decimals) {
+    if (decimals > JSON_WRITER_MAX_DECIMALS) decimals = JSON_WRITER_MAX_DECIMALS;
+    uint64_t scale = 1;
+    for (uint8_t i = 0; i < decimals; ++i) scale *= 10;
+    bool neg = v < 0;
+    double mag = (neg ? -v : v) * (double)scale;
+    if (!(mag < 1.8e19)) {  // also catches NaN
+      valueNull();
+      return;
+    }
+    uint64_t fixed = (uint64_t)mag;
+    double rest = mag - (double)fixed;
+    if (rest > 0.5 || (rest == 0.5 && (fixed & 1))) ++fixed;
+    separate();
+    reserve(32);
+    if (neg && fixed != 0) buf_[len_++] = '-';
+    putDigits(fixed / scale);
+    if (decimals == 0) return;
+    buf_[len_++] = '.';
+    uint64_t frac = fixed % scale;
+    for (uint8_t i = decimals; i > 0; --i) {
+      buf_[len_ + i - 1] = (char)('0' + frac % 10);
+      frac /= 10;
+    }
+    len_ += decimals;
+  }
+
+  void valueBool(bool v) {
+    separate();
+    if (v) put("true", 4);
+    else put("false", 5);
+  }
+  void valueNull() {
+    separate();
+    put("null", 4);
+  }
+
+  void valueString(const char *s) { valueString(s, strlen(s)); }
+  void valueString(const char *s, size_t n) {
+    separate();
+    putString(s, n);
+  }
+
+  // A JSON string holding the base64 of `data`, encoded in place a block at
+  // a time.
+  void valueBase64(const uint8_t *data, size_t n) {
+    separate();
+    put('"');
+    while (n > 0) {
+      reserve(4);
+      size_t groups = (cap_ - len_) / 4;
+      size_t take = n < groups * 3 ? n : groups * 3;
+      len_ += base64_encode_to(data, take, buf_ + len_);
+      data += take;
+      n -= take;
+    }
+    put('"');
+  }
+
+  // Hand whatever is buffered to the sink; call once the document is done.
+  void flush() {
+    if (len_ == 0) return;
+    sink_(ctx_, buf_, len_);
+    total_ += len_;
+    len_ = 0;
+  }
+
+  size_t bytesWritten() const { return total_ + len_; }
+  // Containers left open or more nesting than JSON_WRITER_MAX_DEPTH.
+  bool ok() const { return depth_ == 0 && !overflow_; }
+
+private:
+  void open(char c) {
+    separate();
+    put(c);
+    if (depth_ < JSON_WRITER_MAX_DEPTH) first_ |= 1u << depth_;
+    else overflow_ = true;
+    ++depth_;
+  }
+  void close(char c) {
+    if (depth_ > 0) --depth_;
+    afterKey_ = false;
+    put(c);
+  }
+
+  // Comma before every value or key except the first in its container; a
+  // value right after its key gets none.
+  void separate() {
+    if (afterKey_) {
+      afterKey_ = false;
+      return;
+    }
+    if (depth_ == 0 || depth_ > JSON_WRITER_MAX_DEPTH) return;
+    uint32_t bit = 1u << (depth_ - 1);
+    if (first_ & bit) first_ &= ~bit;
+    else put(',');
+  }
+
+  void reserve(size_t n) {
+    if (cap_ - len_ < n) flush();
+  }
+  void put(char c) {
+    reserve(1);
+    buf_[len_++] = c;
+  }
+  void put(const char *s, size_t n) {
+    while (n > 0) {
+      reserve(1);
+      size_t take = cap_ - len_ < n ? cap_ - len_ : n;
+      memcpy(buf_ + len_, s, take);
+      len_ += take;
+      s += take;
+      n -= take;
+    }
+  }
+
+  void putString(const char *s, size_t n) {
+    static const char hex[] = "0123456789abcdef";
+    put('"');
+    size_t run = 0;  // bytes copied through unchanged
+    for (size_t i = 0; i < n; ++i) {
+      uint8_t c = (uint8_t)s[i];
+      if (c >= 0x20 && c != '"' && c != '\\') continue;
+      put(s + run, i - run);
+      run = i + 1;
+      reserve(6);
+      buf_[len_++] = '\\';
+      switch (c) {
+        case '"': buf_[len_++] = '"'; break;
+        case '\\': buf_[len_++] = '\\'; break;
+        case '\n': buf_[len_++] = 'n'; break;
+        case '\r': buf_[len_++] = 'r'; break;
+        case '\t': buf_[len_++] = 't'; break;
+        default:
+          buf_[len_++] = 'u';
+          buf_[len_++] = '0';
+          buf_[len_++] = '0';
+          buf_[len_++] = hex[c >> 4];
+          buf_[len_++] = hex[c & 0xF];
+      }
+    }
+    put(s + run, n - run);
+    put('"');
+  }
+
+  // Caller has reserved 20 bytes.
+  void putDigits(uint64_t v) {
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char tmp[20];
+    size_t n = sizeof(tmp);
+    while (v >= 100) {
+      unsigned d = (unsigned)(v % 100) * 2;
+      v /= 100;
+      tmp[--n] = pairs[d + 1];
+      tmp[--n] = pairs[d];
+    }
+    if (v >= 10) {
+      tmp[--n] = pairs[v * 2 + 1];
+      tmp[--n] = pairs[v * 2];
+    } else {
+      tmp[--n] = (char)('0' + v);
+    }
+    memcpy(buf_ + len_, tmp + n, sizeof(tmp) - n);
+    len_ += sizeof(tmp) - n;
+  }
+
+  char *buf_;
+  size_t cap_;
+  size_t len_ = 0;
+  size_t total_ = 0;
+  JsonSinkFn sink_;
+  void *ctx_;
+  uint32_t first_ = 0;   // bit per open container: nothing written in it yet
+  uint8_t depth_ = 0;
+  bool afterKey_ = false;
+  bool overflow_ = false;
+};
+
+#endif // JSON_WRITER_H
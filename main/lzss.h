@@ -0,0 +1,200 @@
+#pragma once
+
+// Streaming LZSS for the BLE link (ble_link.h). Both ends keep the last
+// LZSS_WINDOW bytes of the stream, so a message can copy from earlier ones:
+// repeated sweep frequencies, noise-floor RSSI runs and the same SSIDs in
+// every WiFi result cost two bytes per copy instead of being resent.
+//
+//   message := group*
+//   group   := flags:u8  item{1..8}       (flag bit i, LSB first, is item i)
+//   item    := literal:u8                 (bit 0)
+//            | match:u16le                (bit 1: distance-1 in bits 0..10,
+//                                          length-3 in bits 11..15)
+//
+// Every message ends on a group boundary, so it decodes on its own given the
+// window. The encoder finds matches through a 3-byte hash with short chains;
+// with the window that is 8 KiB of state (2 KiB window, 2 KiB heads, 4 KiB
+// links) and no heap. The decoder only needs the window. host/bench_lzss.cpp
+// measures it on the firmware's own streams.
+
+#ifndef LZSS_H
+#define LZSS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static const uint8_t LZSS_WINDOW_BITS = 11;
+static const size_t LZSS_WINDOW = (size_t)1 << LZSS_WINDOW_BITS;
+static const size_t LZSS_MIN_MATCH = 3;
+static const size_t LZSS_MAX_MATCH = LZSS_MIN_MATCH + 31;
+static const uint8_t LZSS_HASH_BITS = 10;
+static const uint8_t LZSS_MAX_CHAIN = 8;
+static const size_t LZSS_INVALID = (size_t)-1;
+
+// Worst case: all literals, one flag byte per eight.
+constexpr size_t lzss_bound(size_t len) { return len + (len + 7) / 8; }
+
+typedef void (*LzssSinkFn)(void *ctx, const uint8_t *data, size_t len);
+
+class LzssEncoder {
+public:
+  // Forget the history: the next message copies only from itself.
+  void reset() { base_ = pos_; }
+
+  // Compress one message, handing the output to `sink` in pieces of at
+  // most sizeof(out_) bytes. Returns the compressed size.
+  size_t compress(const uint8_t *in, size_t n, LzssSinkFn sink, void *ctx) {
+    const uint32_t start = pos_;
+    size_t total = 0;
+    outLen_ = 0;
+    flagBit_ = 8;
+    size_t i = 0;
+    while (i < n) {
+      const uint32_t cur = start + (uint32_t)i;
+      const size_t avail = n - i;
+      const size_t maxLen = avail < LZSS_MAX_MATCH ? avail : LZSS_MAX_MATCH;
+      size_t best = 0;
+      uint32_t bestDist = 0;
+      if (avail >= LZSS_MIN_MATCH) {
+        uint32_t limit = cur - base_;
+        if (limit > LZSS_WINDOW) limit = LZSS_WINDOW;
+        uint16_t cand = head_[hash(in + i)];
+        uint32_t lastDist = 0;
+        for (uint8_t c = 0; c < LZSS_MAX_CHAIN; ++c) {
+          // positions are kept mod 2^16; a stale link shows up as a
+          // distance that does not grow along the chain, or out of range
+          uint32_t dist = (uint16_t)((uint16_t)cur - cand);
+          if (dist <= lastDist || dist > limit) break;
+          lastDist = dist;
+          uint32_t p = cur - dist;
+          size_t len = 0;
+          while (len < maxLen && at(p + (uint32_t)len, in, start) == in[i + len]) ++len;
+          if (len > best) {
+            best = len;
+            bestDist = dist;
+            if (len == maxLen) break;
+          }
+          cand = prev_[p & (LZSS_WINDOW - 1)];
+        }
+      }
+
+      size_t step;
+      if (best >= LZSS_MIN_MATCH) {
+        uint16_t v = (uint16_t)((bestDist - 1) | ((best - LZSS_MIN_MATCH) << LZSS_WINDOW_BITS));
+        total += item(true, (uint8_t)(v & 0xFF), (uint8_t)(v >> 8), sink, ctx);
+        step = best;
+      } else {
+        total += item(false, in[i], 0, sink, ctx);
+        step = 1;
+      }
+      for (size_t k = 0; k < step; ++k) {
+        uint32_t p = cur + (uint32_t)k;
+        if (i + k + LZSS_MIN_MATCH <= n) {
+          uint16_t &h = head_[hash(in + i + k)];
+          prev_[p & (LZSS_WINDOW - 1)] = h;
+          h = (uint16_t)p;
+        }
+        ring_[p & (LZSS_WINDOW - 1)] = in[i + k];
+      }
+      i += step;
+    }
+    pos_ = start + (uint32_t)n;
+    if (outLen_ > 0) {
+      sink(ctx, out_, outLen_);
+      total += outLen_;
+      outLen_ = 0;
+    }
+    return total;
+  }
+
+private:
+  static uint32_t hash(const uint8_t *p) {
+    uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    return (v * 2654435761u) >> (32 - LZSS_HASH_BITS);
+  }
+
+  // Stream byte at absolute position p: this message, or the window.
+  uint8_t at(uint32_t p, const uint8_t *in, uint32_t start) const {
+    return p - start < 0x80000000u ? in[p - start] : ring_[p & (LZSS_WINDOW - 1)];
+  }
+
+  // Append one item, opening a group (and flushing full output) as needed.
+  // Returns the bytes handed to the sink.
+  size_t item(bool match, uint8_t b0, uint8_t b1, LzssSinkFn sink, void *ctx) {
+    size_t flushed = 0;
+    if (flagBit_ == 8) {
+      if (outLen_ + 17 > sizeof(out_)) {
+        sink(ctx, out_, outLen_);
+        flushed = outLen_;
+        outLen_ = 0;
+      }
+      flagAt_ = outLen_++;
+      out_[flagAt_] = 0;
+      flagBit_ = 0;
+    }
+    if (match) {
+      out_[flagAt_] |= (uint8_t)(1u << flagBit_);
+      out_[outLen_++] = b0;
+      out_[outLen_++] = b1;
+    } else {
+      out_[outLen_++] = b0;
+    }
+    ++flagBit_;
+    return flushed;
+  }
+
+  uint8_t ring_[LZSS_WINDOW];
+  uint16_t head_[1u << LZSS_HASH_BITS] = {};
+  uint16_t prev_[LZSS_WINDOW];
+  uint32_t pos_ = 0;
+  uint32_t base_ = 0;   // first position of the current history
+  uint8_t out_[64];
+  size_t outLen_ = 0;
+  size_t flagAt_ = 0;
+  uint8_t flagBit_ = 8;
+};
+
+class LzssDecoder {
+public:
+  // Must follow the encoder's reset().
+  void reset() { base_ = pos_; }
+
+  // Decode one message into `out` (capacity `cap`). Returns the decoded
+  // length, or LZSS_INVALID on a truncated match, a distance reaching before
+  // the history or too small a buffer. After an error the window no longer
+  // matches the encoder's; decode nothing more until the next reset.
+  size_t decompress(const uint8_t *in, size_t n, uint8_t *out, size_t cap) {
+    size_t i = 0, o = 0;
+    while (i < n) {
+      uint8_t flags = in[i++];
+      for (uint8_t bit = 0; bit < 8 && i < n; ++bit) {
+        if (flags & (1u << bit)) {
+          if (n - i < 2) return LZSS_INVALID;
+          uint16_t v = (uint16_t)(in[i] | (in[i + 1] << 8));
+          i += 2;
+          uint32_t dist = (v & (LZSS_WINDOW - 1)) + 1;
+          size_t len = (v >> LZSS_WINDOW_BITS) + LZSS_MIN_MATCH;
+          if (dist > pos_ - base_ || len > cap - o) return LZSS_INVALID;
+          for (size_t k = 0; k < len; ++k) {
+            uint8_t b = ring_[(pos_ - dist) & (LZSS_WINDOW - 1)];
+            ring_[pos_++ & (LZSS_WINDOW - 1)] = b;
+            out[o++] = b;
+          }
+        } else {
+          if (o == cap) return LZSS_INVALID;
+          uint8_t b = in[i++];
+          ring_[pos_++ & (LZSS_WINDOW - 1)] = b;
+          out[o++] = b;
+        }
+      }
+    }
+    return o;
+  }
+
+private:
+  uint8_t ring_[LZSS_WINDOW];
+  uint32_t pos_ = 0;
+  uint32_t base_ = 0;
+};
+
+#endif // LZSS_H
@@ -73,6 +73,8 @@ static uint8_t cmdLedState = 0;             // 0 = none, 1 = yellow, 2 = red
 static unsigned long cmdLedUntilMs = 0;     // transient override expiry (ms)
 
 #include "events.h"
+#include "bus_workers.h"
+#include "ble_link.h"
 
 static void setStatusLed(uint8_t r, uint8_t g, uint8_t b) {
 #if defined(ARDUINO_ARCH_ESP32) && defined(RGB_BUILTIN)
@@ -157,7 +159,7 @@ static void updateStatusLed() {
 }
 
 void setup() {
-  Serial.begin(115200);
+  Serial.begin(SHARKOS_SERIAL_BAUD);
   Serial.println("SharkOS starting (headless BLE mode)");
   delay(4500);  // Allow USB CDC to enumerate before any heavy init
   Serial.println("SharkOS passed the delay");
@@ -178,6 +180,8 @@ void setup() {
 
   // Initialize BLE command/event subsystem
   events_init();
+  // per-SPI-bus radio workers (bus_workers.h)
+  bus_workers_init();
 
   // Boot time reference
   bootMillis = millis();
@@ -191,17 +195,26 @@ void setup() {
   updateStatusLed();
 }
 
-// Poll BLE characteristic (safe no-op if characteristic is null).
-// This ensures commands are picked up even if a client writes without
-// triggering a callback in some edge cases.
-static void pollBluetoothCommands() {
-  if (!pCmdChar) return;
-  static String lastVal;
-  String v = pCmdChar->getValue();
-  if (v.length() > 0 && v != lastVal) {
-    lastVal = v;
-    bluetooth_receive_command(v);
-  }
+// Upper bound on one main-loop sleep. Everything time-driven below reports
+// its own deadline; this only bounds state that changes without a wake-up.
+static const unsigned long LOOP_MAX_SLEEP_MS = 1000;
+
+// Milliseconds until loop() next has work: the events subsystem (commands,
+// scan ticks, radio polling, flush deadlines), LED transitions, the boot
+// pairing timeout and the NFC read in handleOngoingTasks().
+static unsigned long loopNextWakeMs() {
+  unsigned long now = millis();
+  unsigned long wait = events_next_deadline_ms(LOOP_MAX_SLEEP_MS);
+  auto until = [&](unsigned long due) {
+    unsigned long left = (long)(due - now) > 0 ? due - now : 0;
+    if (left < wait) wait = left;
+  };
+
+  if (cmdLedUntilMs != 0 && now <= cmdLedUntilMs) until(cmdLedUntilMs + 1);
+  if (pairingMode && !firstCommandReceived) until(pairingBlinkMillis + 400);
+  if (!pairingMode && now - bootMillis <= 5000) until(bootMillis + 5001);
+  if (readingNfc) until(now + 200);
+  return wait;
 }
 
 void loop() {
@@ -218,17 +231,13 @@ void loop() {
     if (!paired || (paired && !anyConnected)) {
       pairingMode = true;
       Serial.println("Pairing mode enabled (waiting for auth)");
-      if (pStatusChar) {
-        pStatusChar->setValue(String("pairing:ready"));
-        pStatusChar->notify();
-      }
+      notifyStatus("pairing:ready");
     }
   }
 
-  // If connected and paired — listen for BLE commands (both callback and polling)
-  if (paired && anyConnected) {
-    pollBluetoothCommands();
-  }
+  // BLE commands arrive through CommandCallbacks::onWrite into the events
+  // ring. (The old characteristic polling fallback re-enqueued every write a
+  // second time and would be a second producer on the single-producer ring.)
 
   // Process one queued BLE event (non-blocking)
   events_process_one();
@@ -239,7 +248,10 @@ void loop() {
   // Update onboard RGB LED status
   updateStatusLed();
 
-  // Main loop idle
-  delay(200);
+  // Send whatever this pass left in the BLE notification being coalesced
+  ble_link_flush();
+
+  // Sleep until a command arrives or the next timed job is due
+  events_wait(loopNextWakeMs());
 }
 
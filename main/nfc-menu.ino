@@ -1,4 +1,5 @@
 #include "globals.h"
+#include "events.h"
 void nfc_init() {
   static bool initialized = false;
 
@@ -14,6 +15,7 @@ void nfc_init() {
 
     nfc.SAMConfig();       // NFC module ready
     initialized = true;
+    events_presence_invalidate();
   }
 
   uint8_t uid[7];    // Buffer to store the returned UID
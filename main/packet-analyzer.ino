@@ -1,4 +1,5 @@
 #include "globals.h"
+#include "events.h"
 #define GRAPH_TOP       10
 #define MAX_POINTS      128
 #define SPIKE_THRESHOLD 30
@@ -36,6 +37,7 @@ void initSniffer(struct SnifferGraph &g) {
   esp_wifi_set_channel(g.currentChannel, WIFI_SECOND_CHAN_NONE);
   esp_wifi_set_promiscuous_rx_cb(snifferCallback);
   esp_wifi_set_promiscuous(true);
+  events_presence_invalidate();
 }
 
 void switchChannel(struct SnifferGraph &g) {
@@ -0,0 +1,299 @@
+#pragma once
+
+// Minimal protobuf wire runtime for the codecs generated from .proto into
+// sharkos.pb.h (see gen_proto.py). Same model as nanopb: messages are plain
+// structs, encoders write into a caller-provided fixed buffer and decoders
+// read straight out of the received bytes, so neither side touches the heap.
+//
+// Bytes/string fields are PbBytes. On encode they either point at existing
+// data or carry a `write` callback that streams the field (called once on a
+// sizing stream for the length prefix, then on the real stream). On decode
+// they are views into the input buffer and are only valid while it is.
+// Message fields are PbBytes as well; repeated ones are PbRepeated.
+//
+// Header only and free of Arduino types, so host/ compiles it unchanged. The
+// other helpers in main/ that do not include Arduino.h keep to the same rule.
+
+#ifndef PB_CODEC_H
+#define PB_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+enum PbWireType : uint8_t {
+  PB_WT_VARINT = 0,
+  PB_WT_64BIT = 1,
+  PB_WT_BYTES = 2,
+  PB_WT_32BIT = 5
+};
+
+// Output stream over a fixed buffer. With buf == nullptr it only counts, which
+// is how callback fields are sized.
+struct PbOStream {
+  uint8_t *buf;
+  size_t cap;
+  size_t len;
+
+  bool write(const uint8_t *data, size_t n) {
+    if (buf) {
+      if (n > cap - len) return false;
+      memcpy(buf + len, data, n);
+    }
+    len += n;
+    return true;
+  }
+};
+
+static inline PbOStream pb_ostream(uint8_t *buf, size_t cap) { return PbOStream{buf, cap, 0}; }
+static inline PbOStream pb_ostream_sizing() { return PbOStream{nullptr, 0, 0}; }
+
+struct PbIStream {
+  const uint8_t *p;
+  const uint8_t *end;
+};
+
+static inline PbIStream pb_istream(const uint8_t *data, size_t len) { return PbIStream{data, data + len}; }
+
+typedef bool (*PbWriteFn)(PbOStream &s, const void *arg);
+
+struct PbBytes {
+  const uint8_t *data;
+  size_t len;
+  PbWriteFn write;             // encode only; takes precedence over data/len
+  const void *arg;
+
+  bool empty() const { return !write && len == 0; }
+};
+
+// Packed repeated int32/sint32 field. Encoders read values[0..count); decoders
+// set count and leave the packed varints in data/len, walked with
+// pb_packed_next() (no copy, no heap).
+struct PbPackedInt32 {
+  const int32_t *values;
+  size_t count;
+  const uint8_t *data;
+  size_t len;
+
+  bool empty() const { return count == 0; }
+};
+
+// Repeated message field. Encoders call `item` for elements [0..count), each
+// written as its own length-delimited field (once on a sizing stream, then for
+// real). Decoders set count and remember where the first element's tag is;
+// pb_repeated_next() walks the elements from there as views into the input,
+// skipping the other fields in between.
+typedef bool (*PbItemFn)(PbOStream &s, const void *arg, size_t index);
+
+struct PbRepeated {
+  PbItemFn item;               // encode only
+  const void *arg;
+  size_t count;
+  const uint8_t *data;         // decode only: first element's tag
+  const uint8_t *end;          // decode only: end of the enclosing message
+  uint32_t field;              // decode only
+
+  bool empty() const { return count == 0; }
+};
+
+static inline PbBytes pb_bytes(const uint8_t *data, size_t len) { return PbBytes{data, len, nullptr, nullptr}; }
+static inline PbBytes pb_str(const char *s) { return PbBytes{(const uint8_t *)s, s ? strlen(s) : 0, nullptr, nullptr}; }
+static inline PbBytes pb_stream(PbWriteFn fn, const void *arg) { return PbBytes{nullptr, 0, fn, arg}; }
+
+// --- encoding ---
+
+static inline bool pb_write_varint(PbOStream &s, uint64_t v) {
+  uint8_t tmp[10];
+  size_t n = 0;
+  while (v >= 0x80) {
+    tmp[n++] = (uint8_t)((v & 0x7F) | 0x80);
+    v >>= 7;
+  }
+  tmp[n++] = (uint8_t)v;
+  return s.write(tmp, n);
+}
+
+static inline bool pb_write_tag(PbOStream &s, uint32_t field, PbWireType wt) {
+  return pb_write_varint(s, ((uint64_t)field << 3) | wt);
+}
+
+// int32 / enum: negative values are sign-extended to ten bytes, as protoc does.
+static inline bool pb_write_int32(PbOStream &s, int32_t v) { return pb_write_varint(s, (uint64_t)(int64_t)v); }
+
+static inline bool pb_write_sint32(PbOStream &s, int32_t v) {
+  return pb_write_varint(s, (uint32_t)(((uint32_t)v << 1) ^ (uint32_t)(v >> 31)));
+}
+
+static inline bool pb_write_float(PbOStream &s, float f) {
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  uint8_t b[4] = {(uint8_t)u, (uint8_t)(u >> 8), (uint8_t)(u >> 16), (uint8_t)(u >> 24)};
+  return s.write(b, sizeof(b));
+}
+
+static inline bool pb_write_bytes(PbOStream &s, const PbBytes &b) {
+  if (!b.write) return pb_write_varint(s, b.len) && s.write(b.data, b.len);
+  PbOStream sizing = pb_ostream_sizing();
+  if (!b.write(sizing, b.arg)) return false;
+  if (!pb_write_varint(s, sizing.len)) return false;
+  size_t start = s.len;
+  if (!b.write(s, b.arg)) return false;
+  return s.len - start == sizing.len;  // callback must write the same bytes twice
+}
+
+static inline bool pb_write_packed_int32(PbOStream &s, const PbPackedInt32 &p, bool zigzag) {
+  PbOStream sizing = pb_ostream_sizing();
+  for (size_t i = 0; i < p.count; ++i) zigzag ? pb_write_sint32(sizing, p.values[i]) : pb_write_int32(sizing, p.values[i]);
+  if (!pb_write_varint(s, sizing.len)) return false;
+  for (size_t i = 0; i < p.count; ++i) {
+    if (!(zigzag ? pb_write_sint32(s, p.values[i]) : pb_write_int32(s, p.values[i]))) return false;
+  }
+  return true;
+}
+
+static inline bool pb_write_repeated(PbOStream &s, uint32_t field, const PbRepeated &r) {
+  for (size_t i = 0; i < r.count; ++i) {
+    PbOStream sizing = pb_ostream_sizing();
+    if (!r.item(sizing, r.arg, i)) return false;
+    if (!(pb_write_tag(s, field, PB_WT_BYTES) && pb_write_varint(s, sizing.len))) return false;
+    size_t start = s.len;
+    if (!r.item(s, r.arg, i) || s.len - start != sizing.len) return false;
+  }
+  return true;
+}
+
+// --- decoding ---
+
+static inline bool pb_read_varint(PbIStream &s, uint64_t &out) {
+  uint64_t v = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (s.p >= s.end) return false;
+    uint8_t b = *s.p++;
+    v |= (uint64_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      out = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline bool pb_read_tag(PbIStream &s, uint32_t &field, PbWireType &wt) {
+  uint64_t tag;
+  if (!pb_read_varint(s, tag)) return false;
+  field = (uint32_t)(tag >> 3);
+  wt = (PbWireType)(tag & 0x7);
+  return field != 0;
+}
+
+static inline bool pb_read_float(PbIStream &s, float &out) {
+  if (s.end - s.p < 4) return false;
+  uint32_t u = (uint32_t)s.p[0] | ((uint32_t)s.p[1] << 8) | ((uint32_t)s.p[2] << 16) | ((uint32_t)s.p[3] << 24);
+  memcpy(&out, &u, sizeof(out));
+  s.p += 4;
+  return true;
+}
+
+static inline bool pb_read_bytes(PbIStream &s, PbBytes &out) {
+  uint64_t len;
+  if (!pb_read_varint(s, len) || len > (uint64_t)(s.end - s.p)) return false;
+  out = pb_bytes(s.p, (size_t)len);
+  s.p += len;
+  return true;
+}
+
+// Only the packed encoding is accepted; every encoder of these messages packs.
+static inline bool pb_read_packed_int32(PbIStream &s, PbPackedInt32 &out) {
+  PbBytes b;
+  if (!pb_read_bytes(s, b)) return false;
+  size_t count = 0;
+  for (size_t i = 0; i < b.len; ++i) {
+    if (!(b.data[i] & 0x80)) ++count;
+  }
+  if (b.len > 0 && (b.data[b.len - 1] & 0x80)) return false;  // truncated last varint
+  out.values = nullptr;
+  out.count = count;
+  out.data = b.data;
+  out.len = b.len;
+  return true;
+}
+
+// One element of a repeated message field; `tag` is where its tag started.
+static inline bool pb_read_repeated(PbIStream &s, uint32_t field, const uint8_t *tag, PbRepeated &out) {
+  PbBytes b;
+  if (!pb_read_bytes(s, b)) return false;
+  if (out.count++ == 0) {
+    out.data = tag;
+    out.end = s.end;
+    out.field = field;
+  }
+  return true;
+}
+
+static inline int32_t pb_zigzag32(uint64_t v) { return (int32_t)((uint32_t)(v >> 1) ^ (uint32_t)-(int32_t)(v & 1)); }
+
+// Next value of a decoded packed field: PbIStream it = pb_istream(f.data, f.len).
+static inline bool pb_packed_next(PbIStream &it, bool zigzag, int32_t &v) {
+  uint64_t raw;
+  if (it.p >= it.end || !pb_read_varint(it, raw)) return false;
+  v = zigzag ? pb_zigzag32(raw) : (int32_t)raw;
+  return true;
+}
+
+// Skip a field this schema does not know (newer peer).
+static inline bool pb_skip(PbIStream &s, PbWireType wt) {
+  uint64_t v;
+  switch (wt) {
+    case PB_WT_VARINT: return pb_read_varint(s, v);
+    case PB_WT_64BIT:
+      if (s.end - s.p < 8) return false;
+      s.p += 8;
+      return true;
+    case PB_WT_BYTES:
+      if (!pb_read_varint(s, v) || v > (uint64_t)(s.end - s.p)) return false;
+      s.p += v;
+      return true;
+    case PB_WT_32BIT:
+      if (s.end - s.p < 4) return false;
+      s.p += 4;
+      return true;
+    default: return false;
+  }
+}
+
+// Next element of a decoded repeated message field, as a view of its bytes
+// for pb_decode_<Msg>(): PbIStream it = pb_repeated_iter(f).
+static inline PbIStream pb_repeated_iter(const PbRepeated &r) {
+  return r.count ? PbIStream{r.data, r.end} : PbIStream{nullptr, nullptr};
+}
+
+static inline bool pb_repeated_next(PbIStream &it, const PbRepeated &r, PbBytes &item) {
+  uint32_t field;
+  PbWireType wt;
+  while (it.p < it.end) {
+    if (!pb_read_tag(it, field, wt)) return false;
+    if (field == r.field && wt == PB_WT_BYTES) return pb_read_bytes(it, item);
+    if (!pb_skip(it, wt)) return false;
+  }
+  return false;
+}
+
+// Framing used on BLE and the Serial PROTO: lines: [0xAA 0x55][u16 le length][message].
+static const size_t PB_FRAME_HEADER = 4;
+
+static inline void pb_frame_header(uint8_t *frame, size_t msgLen) {
+  frame[0] = 0xAA;
+  frame[1] = 0x55;
+  frame[2] = (uint8_t)(msgLen & 0xFF);
+  frame[3] = (uint8_t)((msgLen >> 8) & 0xFF);
+}
+
+// The message inside `frame` if it is exactly one frame, header included.
+static inline bool pb_frame_message(const uint8_t *frame, size_t len, PbIStream &msg) {
+  if (len < PB_FRAME_HEADER || frame[0] != 0xAA || frame[1] != 0x55) return false;
+  if ((size_t)(frame[2] | (frame[3] << 8)) != len - PB_FRAME_HEADER) return false;
+  msg = pb_istream(frame + PB_FRAME_HEADER, len - PB_FRAME_HEADER);
+  return true;
+}
+
+#endif // PB_CODEC_H
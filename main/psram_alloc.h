@@ -0,0 +1,82 @@
+#pragma once
+
+// PSRAM-first allocation for large, long-lived buffers. The N16R8 boards the
+// `flash` target builds for (PSRAM=opi) have 8 MB of PSRAM next to ~320 KB of
+// internal SRAM; everything here asks for PSRAM first and falls back to
+// internal RAM when the board has none or it is full, so callers never need
+// to know which they got.
+//
+// Every allocation is charged to a PsramRegion, and psram_region_stats()
+// reports per region how much is live where, the peak, and how often PSRAM
+// had to be skipped. `mem.stats` sends the same over BLE.
+//
+// PSRAM is slower than internal RAM and is not usable for DMA, so only
+// buffers that are filled and drained in bulk belong here, not hot rings
+// shared with ISRs or the SPI bus workers. Safe from any task.
+
+#ifndef PSRAM_ALLOC_H
+#define PSRAM_ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+
+// One per kind of buffer; add a region when moving another buffer here.
+enum PsramRegion : uint8_t {
+  PSRAM_REGION_RADIO_BATCH = 0,   // JSON radio-batch buffers (events.ino), BLE batch message (telemetry.ino)
+  PSRAM_REGION_BLE_DEVICES,       // BLE scan results (blescanner_devices)
+  PSRAM_REGION_COUNT
+};
+
+struct PsramRegionStats {
+  uint32_t psramBytes;      // live, in PSRAM
+  uint32_t internalBytes;   // live, in internal RAM
+  uint32_t peakBytes;       // most live at once, both together
+  uint32_t allocs;
+  uint32_t fallbacks;       // the board has PSRAM but it had no room
+  uint32_t failures;        // neither had room
+};
+
+// `bytes` from PSRAM, else internal RAM; nullptr if neither has room.
+void *psram_alloc(PsramRegion region, size_t bytes);
+// `bytes` must be what was asked of psram_alloc().
+void psram_free(PsramRegion region, void *p, size_t bytes);
+
+void psram_region_stats(PsramRegion region, PsramRegionStats &out);
+const char *psram_region_name(PsramRegion region);
+
+// Whole PSRAM heap; both 0 on a board without PSRAM.
+size_t psram_total_bytes();
+size_t psram_free_bytes();
+
+// std allocator over a region, e.g.
+//   std::vector<Item, PsramAllocator<Item, PSRAM_REGION_X>>
+template <typename T, PsramRegion R>
+struct PsramAllocator {
+  typedef T value_type;
+  template <typename U> struct rebind { typedef PsramAllocator<U, R> other; };
+
+  PsramAllocator() = default;
+  template <typename U> PsramAllocator(const PsramAllocator<U, R> &) {}
+
+  T *allocate(size_t n) {
+    void *p = psram_alloc(R, n * sizeof(T));
+    if (!p) {
+#if defined(__cpp_exceptions)
+      throw std::bad_alloc();
+#else
+      abort();
+#endif
+    }
+    return static_cast<T *>(p);
+  }
+  void deallocate(T *p, size_t n) { psram_free(R, p, n * sizeof(T)); }
+};
+
+template <typename T, typename U, PsramRegion R>
+bool operator==(const PsramAllocator<T, R> &, const PsramAllocator<U, R> &) { return true; }
+template <typename T, typename U, PsramRegion R>
+bool operator!=(const PsramAllocator<T, R> &, const PsramAllocator<U, R> &) { return false; }
+
+#endif // PSRAM_ALLOC_H
@@ -0,0 +1,62 @@
+#include "psram_alloc.h"
+
+#include <esp_heap_caps.h>
+#include <esp_memory_utils.h>
+#include "freertos/FreeRTOS.h"
+
+static const char *const psramRegionNames[PSRAM_REGION_COUNT] = {"radio_batch", "ble_devices"};
+
+// Any task may allocate (BLE scan results arrive on the BLE host task); the
+// heap calls stay outside the critical section.
+static portMUX_TYPE psramStatsMux = portMUX_INITIALIZER_UNLOCKED;
+static PsramRegionStats psramStats[PSRAM_REGION_COUNT];
+
+void *psram_alloc(PsramRegion region, size_t bytes) {
+  void *p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  bool psram = p != nullptr;
+  bool fallback = false;
+  if (!p) {
+    fallback = psram_total_bytes() > 0;
+    p = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  }
+
+  portENTER_CRITICAL(&psramStatsMux);
+  PsramRegionStats &s = psramStats[region];
+  if (!p) {
+    s.failures++;
+  } else {
+    s.allocs++;
+    if (fallback) s.fallbacks++;
+    if (psram) s.psramBytes += (uint32_t)bytes;
+    else s.internalBytes += (uint32_t)bytes;
+    uint32_t live = s.psramBytes + s.internalBytes;
+    if (live > s.peakBytes) s.peakBytes = live;
+  }
+  portEXIT_CRITICAL(&psramStatsMux);
+  return p;
+}
+
+void psram_free(PsramRegion region, void *p, size_t bytes) {
+  if (!p) return;
+  bool psram = esp_ptr_external_ram(p);
+  heap_caps_free(p);
+
+  portENTER_CRITICAL(&psramStatsMux);
+  PsramRegionStats &s = psramStats[region];
+  if (psram) s.psramBytes -= (uint32_t)bytes;
+  else s.internalBytes -= (uint32_t)bytes;
+  portEXIT_CRITICAL(&psramStatsMux);
+}
+
+void psram_region_stats(PsramRegion region, PsramRegionStats &out) {
+  portENTER_CRITICAL(&psramStatsMux);
+  out = psramStats[region];
+  portEXIT_CRITICAL(&psramStatsMux);
+}
+
+const char *psram_region_name(PsramRegion region) {
+  return region < PSRAM_REGION_COUNT ? psramRegionNames[region] : "?";
+}
+
+size_t psram_total_bytes() { return heap_caps_get_total_size(MALLOC_CAP_SPIRAM); }
+size_t psram_free_bytes() { return heap_caps_get_free_size(MALLOC_CAP_SPIRAM); }
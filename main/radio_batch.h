@@ -0,0 +1,97 @@
+#pragma once
+
+// Fixed-capacity signal buffer behind one module's JSON radio-batch
+// (events.ino). Entries are a flat array filled front to back and drained
+// whole by a flush. A payload of up to RADIO_BATCH_INLINE bytes (a CC1101
+// sweep sample is 7) is stored in its entry. A longer one goes to a bump
+// arena that clear() rewinds. The caller supplies both arrays once, so push()
+// is O(1) and never touches the heap; when it returns false the buffer is
+// full (entries or arena) and must be flushed first.
+//
+// host/bench_radio.cpp compares it with the per-signal vectors it replaced.
+
+#ifndef RADIO_BATCH_H
+#define RADIO_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+static const size_t RADIO_BATCH_INLINE = 14;    // keeps an entry at 32 bytes
+static const size_t RADIO_BATCH_MAX_PAYLOAD = 255;  // longest radio frame (LoRa)
+
+struct RadioBatchEntry {
+  uint64_t timestampMs;
+  float frequencyMhz;
+  int32_t rssi;
+  uint16_t payloadLen;
+  union {
+    uint8_t bytes[RADIO_BATCH_INLINE];  // payloadLen <= RADIO_BATCH_INLINE
+    uint16_t arenaOffset;               // otherwise
+  } payload;
+};
+static_assert(sizeof(RadioBatchEntry) == 32, "RadioBatchEntry should stay 32 bytes");
+
+class RadioBatchBuffer {
+public:
+  // `arenaCap` must be at least RADIO_BATCH_MAX_PAYLOAD for every payload to
+  // fit an empty buffer, and at most 64 KiB.
+  void init(RadioBatchEntry *entries, size_t capacity, uint8_t *arena, size_t arenaCap) {
+    entries_ = entries;
+    capacity_ = capacity;
+    arena_ = arena;
+    arenaCap_ = arenaCap;
+    clear();
+  }
+  bool ready() const { return entries_ != nullptr; }
+
+  // Payloads longer than RADIO_BATCH_MAX_PAYLOAD are cut to it.
+  bool push(uint64_t timestampMs, float frequencyMhz, int32_t rssi, const uint8_t *data, size_t len) {
+    if (count_ == capacity_) return false;
+    if (len > RADIO_BATCH_MAX_PAYLOAD) len = RADIO_BATCH_MAX_PAYLOAD;
+    if (len > RADIO_BATCH_INLINE && len > arenaCap_ - arenaUsed_) return false;
+    RadioBatchEntry &e = entries_[count_++];
+    e.timestampMs = timestampMs;
+    e.frequencyMhz = frequencyMhz;
+    e.rssi = rssi;
+    e.payloadLen = (uint16_t)len;
+    if (len <= RADIO_BATCH_INLINE) {
+      if (len > 0) memcpy(e.payload.bytes, data, len);
+    } else {
+      e.payload.arenaOffset = (uint16_t)arenaUsed_;
+      memcpy(arena_ + arenaUsed_, data, len);
+      arenaUsed_ += len;
+    }
+    payloadBytes_ += len;
+    return true;
+  }
+
+  size_t count() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  bool full() const { return count_ == capacity_; }
+  size_t capacity() const { return capacity_; }
+  size_t payloadBytes() const { return payloadBytes_; }
+  size_t arenaUsed() const { return arenaUsed_; }
+
+  const RadioBatchEntry &at(size_t i) const { return entries_[i]; }
+  const uint8_t *payload(const RadioBatchEntry &e) const {
+    return e.payloadLen <= RADIO_BATCH_INLINE ? e.payload.bytes : arena_ + e.payload.arenaOffset;
+  }
+
+  void clear() {
+    count_ = 0;
+    arenaUsed_ = 0;
+    payloadBytes_ = 0;
+  }
+
+private:
+  RadioBatchEntry *entries_ = nullptr;
+  size_t capacity_ = 0;
+  uint8_t *arena_ = nullptr;
+  size_t arenaCap_ = 0;
+  size_t count_ = 0;
+  size_t arenaUsed_ = 0;
+  size_t payloadBytes_ = 0;
+};
+
+#endif // RADIO_BATCH_H
@@ -0,0 +1,160 @@
+#pragma once
+
+// Wire format of the binary serial link (serial_link.h), shared by the
+// firmware and the host decoder (host/serial_decode.cpp):
+//
+//   frame := COBS(channel:u8  payload  crc:u16le)  0x00
+//
+// COBS removes every 0x00 from the body, so 0x00 only ever marks the end of
+// a frame and a receiver that starts mid-stream or loses bytes resyncs at
+// the next one. `crc` is CRC-16/CCITT-FALSE over channel and payload.
+
+#ifndef SERIAL_FRAME_H
+#define SERIAL_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+enum SerialChannel : uint8_t {
+  SERIAL_CH_TELEMETRY = 1,   // one telemetry frame as in pb_codec.h: [0xAA 0x55][u16 le len][protobuf]
+  SERIAL_CH_LOG = 2,         // one line of debug text, without the line ending
+};
+
+static const uint8_t SERIAL_FRAME_DELIMITER = 0x00;
+static const size_t SERIAL_FRAME_CRC = 2;
+static const size_t SERIAL_FRAME_MAX_PAYLOAD = 512;
+
+// COBS adds one byte per started 254-byte run, plus the delimiter.
+constexpr size_t serial_frame_encoded_max(size_t payloadLen) {
+  return 1 + payloadLen + SERIAL_FRAME_CRC + (1 + payloadLen + SERIAL_FRAME_CRC) / 254 + 1 + 1;
+}
+
+static inline uint16_t serial_frame_crc(uint16_t crc, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; ++b) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+// Streams bytes into COBS form: `code` is the position of the current run's
+// length byte, which is filled in when the run ends.
+struct SerialCobsWriter {
+  uint8_t *out;
+  size_t len;
+  size_t code;
+
+  void begin(uint8_t *buf) {
+    out = buf;
+    len = 1;
+    code = 0;
+  }
+  void put(uint8_t b) {
+    if (b != 0) out[len++] = b;
+    if (b == 0 || len - code == 0xFF) {
+      out[code] = (uint8_t)(len - code);
+      code = len++;
+    }
+  }
+  void put(const uint8_t *data, size_t n) {
+    for (size_t i = 0; i < n; ++i) put(data[i]);
+  }
+  size_t finish() {
+    out[code] = (uint8_t)(len - code);
+    out[len++] = SERIAL_FRAME_DELIMITER;
+    return len;
+  }
+};
+
+// Encode one frame into `out`, which must hold
+// serial_frame_encoded_max(len) bytes. Returns the bytes written, delimiter
+// included, or 0 if the payload is too large.
+static inline size_t serial_frame_encode(uint8_t channel, const uint8_t *payload, size_t len, uint8_t *out) {
+  if (len > SERIAL_FRAME_MAX_PAYLOAD) return 0;
+  uint16_t crc = serial_frame_crc(0xFFFF, &channel, 1);
+  crc = serial_frame_crc(crc, payload, len);
+  uint8_t tail[SERIAL_FRAME_CRC] = {(uint8_t)(crc & 0xFF), (uint8_t)(crc >> 8)};
+  SerialCobsWriter w;
+  w.begin(out);
+  w.put(channel);
+  w.put(payload, len);
+  w.put(tail, sizeof(tail));
+  return w.finish();
+}
+
+// Incremental receiver. push() every received byte; it returns true when a
+// frame completed and passed its CRC, with channel()/payload()/length()
+// describing it until the next push(). Frames that are oversized, malformed
+// or fail the CRC are dropped and counted.
+class SerialFrameDecoder {
+public:
+  bool push(uint8_t b) {
+    if (complete_) {
+      len_ = 0;
+      complete_ = false;
+    }
+    if (b == SERIAL_FRAME_DELIMITER) return finish();
+    if (overflow_) return false;
+    if (run_ == 0) {
+      // code byte; the previous run ends in a zero unless it was a full one
+      if (started_ && zeroAfterRun_) append(0);
+      started_ = true;
+      run_ = (uint8_t)(b - 1);
+      zeroAfterRun_ = b != 0xFF;
+    } else {
+      append(b);
+      --run_;
+    }
+    return false;
+  }
+
+  uint8_t channel() const { return buf_[0]; }
+  const uint8_t *payload() const { return buf_ + 1; }
+  size_t length() const { return len_ - 1 - SERIAL_FRAME_CRC; }
+
+  unsigned long frames() const { return frames_; }
+  unsigned long crcErrors() const { return crcErrors_; }
+  unsigned long malformed() const { return malformed_; }
+
+private:
+  void append(uint8_t b) {
+    if (len_ >= sizeof(buf_)) overflow_ = true;
+    else buf_[len_++] = b;
+  }
+
+  // The zero implied by the last run is the frame end, not data.
+  bool finish() {
+    bool ok = false;
+    if (!started_) {
+      // back-to-back delimiters
+    } else if (overflow_ || run_ != 0 || len_ < 1 + SERIAL_FRAME_CRC) {
+      ++malformed_;
+    } else {
+      size_t body = len_ - SERIAL_FRAME_CRC;
+      uint16_t crc = serial_frame_crc(0xFFFF, buf_, body);
+      ok = buf_[body] == (uint8_t)(crc & 0xFF) && buf_[body + 1] == (uint8_t)(crc >> 8);
+      if (ok) ++frames_;
+      else ++crcErrors_;
+    }
+    started_ = false;
+    overflow_ = false;
+    run_ = 0;
+    if (ok) complete_ = true;
+    else len_ = 0;
+    return ok;
+  }
+
+  uint8_t buf_[1 + SERIAL_FRAME_MAX_PAYLOAD + SERIAL_FRAME_CRC];
+  size_t len_ = 0;
+  uint8_t run_ = 0;
+  bool started_ = false;
+  bool zeroAfterRun_ = false;
+  bool overflow_ = false;
+  bool complete_ = false;
+  unsigned long frames_ = 0;
+  unsigned long crcErrors_ = 0;
+  unsigned long malformed_ = 0;
+};
+
+#endif // SERIAL_FRAME_H
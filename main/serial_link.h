@@ -0,0 +1,62 @@
+#pragma once
+
+// Serial port ownership. The sketch's debug output (`Serial.print...`) goes
+// through serialConsole, and globals.h maps `Serial` to it. In text mode
+// (the default) the console is a straight pass-through and telemetry goes out
+// as PROTO:<base64> lines, as before. In binary mode the port only carries
+// serial_frame.h frames:
+//   - telemetry frames on SERIAL_CH_TELEMETRY, raw (no base64)
+//   - debug text on SERIAL_CH_LOG, one frame per line
+// host/serial_decode.cpp reads that stream and writes the telemetry to disk.
+//
+// SHARKOS_SERIAL_BAUD sets the UART rate (ignored by native USB-CDC, which
+// runs at USB speed) and SHARKOS_SERIAL_BINARY the mode at boot. The app can
+// switch modes with the `serial.link` command.
+
+#ifndef SERIAL_LINK_H
+#define SERIAL_LINK_H
+
+#include <Arduino.h>
+#include "serial_frame.h"
+
+#ifndef SHARKOS_SERIAL_BAUD
+#define SHARKOS_SERIAL_BAUD 115200
+#endif
+#ifndef SHARKOS_SERIAL_BINARY
+#define SHARKOS_SERIAL_BINARY 0
+#endif
+
+static const size_t SERIAL_LINK_LOG_LINE = 160;     // longer lines are split across frames
+static const size_t SERIAL_LINK_MAX_FRAME = 256;    // telemetry frame capacity (telemetry.ino)
+
+// The UART / USB-CDC port itself. Defined here, before globals.h maps
+// `Serial` to the console, so it names the real port.
+static inline decltype(Serial) &serial_link_port() { return Serial; }
+
+class SerialConsole : public Print {
+public:
+  void begin(unsigned long baud) { serial_link_port().begin(baud); }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *data, size_t len) override;
+  explicit operator bool() { return (bool)serial_link_port(); }
+  using Print::write;
+};
+
+extern SerialConsole serialConsole;
+
+struct SerialLinkStats {
+  uint32_t telemetryFrames;
+  uint32_t logFrames;
+  uint32_t wireBytes;      // bytes written in binary mode, framing included
+  uint32_t oversized;      // frames too large to send
+};
+
+// Safe from any task; a partial debug line is flushed before switching.
+void serial_link_set_binary(bool on);
+bool serial_link_binary();
+
+// One frame on `channel`. Binary mode only; false if not sent.
+bool serial_link_write(uint8_t channel, const uint8_t *data, size_t len);
+void serial_link_stats(SerialLinkStats &out);
+
+#endif // SERIAL_LINK_H
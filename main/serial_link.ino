@@ -0,0 +1,90 @@
+#include "globals.h"
+#include "serial_link.h"
+
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+
+SerialConsole serialConsole;
+
+static std::atomic<bool> serialLinkBinary{SHARKOS_SERIAL_BINARY != 0};
+static std::atomic<uint32_t> serialLinkTelemetryFrames{0};
+static std::atomic<uint32_t> serialLinkLogFrames{0};
+static std::atomic<uint32_t> serialLinkWireBytes{0};
+static std::atomic<uint32_t> serialLinkOversized{0};
+
+// Debug text of the line being assembled in binary mode. Any task may print,
+// so the buffer is guarded; the port is written outside the critical section.
+static portMUX_TYPE serialLinkLogMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t serialLinkLog[SERIAL_LINK_LOG_LINE];
+static size_t serialLinkLogLen = 0;
+
+static void serial_link_send(uint8_t channel, const uint8_t *data, size_t len) {
+  uint8_t out[serial_frame_encoded_max(SERIAL_LINK_MAX_FRAME)];
+  size_t n = serial_frame_encode(channel, data, len, out);
+  serial_link_port().write(out, n);
+  serialLinkWireBytes.fetch_add((uint32_t)n, std::memory_order_relaxed);
+}
+
+bool serial_link_write(uint8_t channel, const uint8_t *data, size_t len) {
+  if (!serialLinkBinary.load(std::memory_order_relaxed)) return false;
+  if (len > SERIAL_LINK_MAX_FRAME) {
+    serialLinkOversized.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  serial_link_send(channel, data, len);
+  if (channel == SERIAL_CH_TELEMETRY) serialLinkTelemetryFrames.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+static void serial_link_send_log(const uint8_t *line, size_t len) {
+  serial_link_send(SERIAL_CH_LOG, line, len);
+  serialLinkLogFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Cuts the text into lines: '\n' ends one ('\r' is dropped), and a line
+// that fills the buffer goes out as it is.
+size_t SerialConsole::write(const uint8_t *data, size_t len) {
+  if (!serialLinkBinary.load(std::memory_order_relaxed)) return serial_link_port().write(data, len);
+
+  size_t i = 0;
+  while (i < len) {
+    uint8_t line[SERIAL_LINK_LOG_LINE];
+    size_t lineLen = 0;
+    bool haveLine = false;
+    portENTER_CRITICAL(&serialLinkLogMux);
+    while (i < len && !haveLine) {
+      uint8_t c = data[i++];
+      if (c == '\r') continue;
+      if (c != '\n') serialLinkLog[serialLinkLogLen++] = c;
+      if (c == '\n' || serialLinkLogLen == sizeof(serialLinkLog)) {
+        memcpy(line, serialLinkLog, serialLinkLogLen);
+        lineLen = serialLinkLogLen;
+        serialLinkLogLen = 0;
+        haveLine = true;
+      }
+    }
+    portEXIT_CRITICAL(&serialLinkLogMux);
+    if (haveLine) serial_link_send_log(line, lineLen);
+  }
+  return len;
+}
+
+void serial_link_set_binary(bool on) {
+  uint8_t line[SERIAL_LINK_LOG_LINE];
+  portENTER_CRITICAL(&serialLinkLogMux);
+  size_t lineLen = serialLinkLogLen;
+  memcpy(line, serialLinkLog, lineLen);
+  serialLinkLogLen = 0;
+  portEXIT_CRITICAL(&serialLinkLogMux);
+  if (lineLen > 0) serial_link_send_log(line, lineLen);
+  serialLinkBinary.store(on, std::memory_order_relaxed);
+}
+
+bool serial_link_binary() { return serialLinkBinary.load(std::memory_order_relaxed); }
+
+void serial_link_stats(SerialLinkStats &out) {
+  out.telemetryFrames = serialLinkTelemetryFrames.load(std::memory_order_relaxed);
+  out.logFrames = serialLinkLogFrames.load(std::memory_order_relaxed);
+  out.wireBytes = serialLinkWireBytes.load(std::memory_order_relaxed);
+  out.oversized = serialLinkOversized.load(std::memory_order_relaxed);
+}
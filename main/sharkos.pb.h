@@ -0,0 +1,527 @@
+// Generated by gen_proto.py from .proto -- do not edit.
+//
+// Encoders write into a PbOStream over a caller buffer; decoders fill the
+// struct from a PbIStream, with bytes/string fields pointing into the
+// input. See pb_codec.h.
+
+#ifndef SHARKOS_PB_H
+#define SHARKOS_PB_H
+
+#include "pb_codec.h"
+
+enum RadioModule_pb : int32_t {
+  RadioModule_CC1101_1 = 0,
+  RadioModule_CC1101_2 = 1,
+  RadioModule_LORA = 2,
+  RadioModule_NFC = 3,
+  RadioModule_WIFI = 4,
+  RadioModule_BLUETOOTH = 5,
+  RadioModule_IR = 6,
+};
+
+enum RadioModuleCC_pb : int32_t {
+  RadioModuleCC_CC1101_1 = 0,
+  RadioModuleCC_CC1101_2 = 1,
+};
+
+enum ParamType_pb : int32_t {
+  ParamType_PARAM_NULL = 0,
+  ParamType_PARAM_BOOL = 1,
+  ParamType_PARAM_INT = 2,
+  ParamType_PARAM_FLOAT = 3,
+  ParamType_PARAM_STRING = 4,
+};
+
+struct RadioSignal_pb {
+  uint64_t timestamp_ms = 0;
+  RadioModule_pb module = (RadioModule_pb)0;
+  float frequency_mhz = 0;
+  int32_t rssi = 0;
+  PbBytes payload = {};
+  PbBytes extra = {};
+};
+
+static inline bool pb_encode_RadioSignal(PbOStream &s, const RadioSignal_pb &m) {
+  if (!(pb_write_tag(s, 1, PB_WT_VARINT) && pb_write_varint(s, m.timestamp_ms))) return false;
+  if (!(pb_write_tag(s, 2, PB_WT_VARINT) && pb_write_int32(s, (int32_t)m.module))) return false;
+  if (!(pb_write_tag(s, 3, PB_WT_32BIT) && pb_write_float(s, m.frequency_mhz))) return false;
+  if (!(pb_write_tag(s, 4, PB_WT_VARINT) && pb_write_sint32(s, m.rssi))) return false;
+  if (!m.payload.empty() && !(pb_write_tag(s, 5, PB_WT_BYTES) && pb_write_bytes(s, m.payload))) return false;
+  if (!m.extra.empty() && !(pb_write_tag(s, 6, PB_WT_BYTES) && pb_write_bytes(s, m.extra))) return false;
+  return true;
+}
+
+static inline bool pb_decode_RadioSignal(PbIStream &s, RadioSignal_pb &m) {
+  m = RadioSignal_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.timestamp_ms = v; break;
+      case 2: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.module = (RadioModule_pb)(int32_t)v; break;
+      case 3: if (wt != PB_WT_32BIT || !pb_read_float(s, m.frequency_mhz)) return false; break;
+      case 4: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.rssi = pb_zigzag32(v); break;
+      case 5: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.payload)) return false; break;
+      case 6: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.extra)) return false; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_RadioSignal(const uint8_t *data, size_t len, RadioSignal_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_RadioSignal(s, m);
+}
+
+struct Command_pb {
+  uint64_t timestamp_ms = 0;
+  PbBytes command = {};
+  uint32_t command_id = 0;
+  PbBytes correlation_id = {};
+  PbRepeated params = {};  // CommandParam
+  PbBytes cc1101_tx = {};  // CC1101Tx
+  PbBytes lora_tx = {};  // LoraTx
+  PbBytes ir_tx = {};  // IRTx
+};
+
+static inline bool pb_encode_Command(PbOStream &s, const Command_pb &m) {
+  if (!(pb_write_tag(s, 1, PB_WT_VARINT) && pb_write_varint(s, m.timestamp_ms))) return false;
+  if (!m.command.empty() && !(pb_write_tag(s, 2, PB_WT_BYTES) && pb_write_bytes(s, m.command))) return false;
+  if (!(pb_write_tag(s, 3, PB_WT_VARINT) && pb_write_varint(s, m.command_id))) return false;
+  if (!m.correlation_id.empty() && !(pb_write_tag(s, 4, PB_WT_BYTES) && pb_write_bytes(s, m.correlation_id))) return false;
+  if (!pb_write_repeated(s, 5, m.params)) return false;
+  if (!m.cc1101_tx.empty() && !(pb_write_tag(s, 6, PB_WT_BYTES) && pb_write_bytes(s, m.cc1101_tx))) return false;
+  if (!m.lora_tx.empty() && !(pb_write_tag(s, 7, PB_WT_BYTES) && pb_write_bytes(s, m.lora_tx))) return false;
+  if (!m.ir_tx.empty() && !(pb_write_tag(s, 8, PB_WT_BYTES) && pb_write_bytes(s, m.ir_tx))) return false;
+  return true;
+}
+
+static inline bool pb_decode_Command(PbIStream &s, Command_pb &m) {
+  m = Command_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    const uint8_t *tag = s.p;
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.timestamp_ms = v; break;
+      case 2: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.command)) return false; break;
+      case 3: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.command_id = (uint32_t)v; break;
+      case 4: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.correlation_id)) return false; break;
+      case 5: if (wt != PB_WT_BYTES || !pb_read_repeated(s, 5, tag, m.params)) return false; break;
+      case 6: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.cc1101_tx)) return false; break;
+      case 7: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.lora_tx)) return false; break;
+      case 8: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.ir_tx)) return false; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_Command(const uint8_t *data, size_t len, Command_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_Command(s, m);
+}
+
+struct CommandParam_pb {
+  PbBytes key = {};
+  ParamType_pb type = (ParamType_pb)0;
+  bool bool_value = false;
+  int32_t int_value = 0;
+  float float_value = 0;
+  PbBytes string_value = {};
+};
+
+static inline bool pb_encode_CommandParam(PbOStream &s, const CommandParam_pb &m) {
+  if (!m.key.empty() && !(pb_write_tag(s, 1, PB_WT_BYTES) && pb_write_bytes(s, m.key))) return false;
+  if (!(pb_write_tag(s, 2, PB_WT_VARINT) && pb_write_int32(s, (int32_t)m.type))) return false;
+  if (!(pb_write_tag(s, 3, PB_WT_VARINT) && pb_write_varint(s, m.bool_value ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 4, PB_WT_VARINT) && pb_write_sint32(s, m.int_value))) return false;
+  if (!(pb_write_tag(s, 5, PB_WT_32BIT) && pb_write_float(s, m.float_value))) return false;
+  if (!m.string_value.empty() && !(pb_write_tag(s, 6, PB_WT_BYTES) && pb_write_bytes(s, m.string_value))) return false;
+  return true;
+}
+
+static inline bool pb_decode_CommandParam(PbIStream &s, CommandParam_pb &m) {
+  m = CommandParam_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.key)) return false; break;
+      case 2: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.type = (ParamType_pb)(int32_t)v; break;
+      case 3: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.bool_value = v != 0; break;
+      case 4: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.int_value = pb_zigzag32(v); break;
+      case 5: if (wt != PB_WT_32BIT || !pb_read_float(s, m.float_value)) return false; break;
+      case 6: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.string_value)) return false; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_CommandParam(const uint8_t *data, size_t len, CommandParam_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_CommandParam(s, m);
+}
+
+static inline bool pb_write_msg_CommandParam(PbOStream &s, const void *arg) {
+  return pb_encode_CommandParam(s, *(const CommandParam_pb *)arg);
+}
+static inline bool pb_write_item_CommandParam(PbOStream &s, const void *arg, size_t i) {
+  return pb_encode_CommandParam(s, ((const CommandParam_pb *)arg)[i]);
+}
+// Encode `m` as a message field; it must outlive the encode.
+static inline PbBytes pb_message(const CommandParam_pb &m) { return pb_stream(pb_write_msg_CommandParam, &m); }
+static inline PbRepeated pb_repeated(const CommandParam_pb *items, size_t count) {
+  return PbRepeated{pb_write_item_CommandParam, items, count, nullptr, nullptr, 0};
+}
+
+struct status_pb {
+  bool is_scanning = false;
+  int32_t battery_percent = 0;
+  bool cc1101_1_connected = false;
+  bool cc1101_2_connected = false;
+  bool lora_connected = false;
+  bool nfc_connected = false;
+  bool wifi_connected = false;
+  bool bluetooth_connected = false;
+  bool ir_connected = false;
+  bool serial_connected = false;
+};
+
+static inline bool pb_encode_status(PbOStream &s, const status_pb &m) {
+  if (!(pb_write_tag(s, 1, PB_WT_VARINT) && pb_write_varint(s, m.is_scanning ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 2, PB_WT_VARINT) && pb_write_int32(s, m.battery_percent))) return false;
+  if (!(pb_write_tag(s, 3, PB_WT_VARINT) && pb_write_varint(s, m.cc1101_1_connected ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 4, PB_WT_VARINT) && pb_write_varint(s, m.cc1101_2_connected ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 5, PB_WT_VARINT) && pb_write_varint(s, m.lora_connected ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 6, PB_WT_VARINT) && pb_write_varint(s, m.nfc_connected ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 7, PB_WT_VARINT) && pb_write_varint(s, m.wifi_connected ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 8, PB_WT_VARINT) && pb_write_varint(s, m.bluetooth_connected ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 9, PB_WT_VARINT) && pb_write_varint(s, m.ir_connected ? 1 : 0))) return false;
+  if (!(pb_write_tag(s, 10, PB_WT_VARINT) && pb_write_varint(s, m.serial_connected ? 1 : 0))) return false;
+  return true;
+}
+
+static inline bool pb_decode_status(PbIStream &s, status_pb &m) {
+  m = status_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.is_scanning = v != 0; break;
+      case 2: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.battery_percent = (int32_t)v; break;
+      case 3: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.cc1101_1_connected = v != 0; break;
+      case 4: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.cc1101_2_connected = v != 0; break;
+      case 5: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.lora_connected = v != 0; break;
+      case 6: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.nfc_connected = v != 0; break;
+      case 7: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.wifi_connected = v != 0; break;
+      case 8: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.bluetooth_connected = v != 0; break;
+      case 9: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.ir_connected = v != 0; break;
+      case 10: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.serial_connected = v != 0; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_status(const uint8_t *data, size_t len, status_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_status(s, m);
+}
+
+struct CC1101Tx_pb {
+  uint64_t timestamp_ms = 0;
+  RadioModuleCC_pb module = (RadioModuleCC_pb)0;
+  float frequency_mhz = 0;
+  int32_t power_dbm = 0;
+  PbBytes payload = {};
+  PbBytes mod = {};
+  PbBytes extra = {};
+};
+
+static inline bool pb_encode_CC1101Tx(PbOStream &s, const CC1101Tx_pb &m) {
+  if (!(pb_write_tag(s, 1, PB_WT_VARINT) && pb_write_varint(s, m.timestamp_ms))) return false;
+  if (!(pb_write_tag(s, 2, PB_WT_VARINT) && pb_write_int32(s, (int32_t)m.module))) return false;
+  if (!(pb_write_tag(s, 3, PB_WT_32BIT) && pb_write_float(s, m.frequency_mhz))) return false;
+  if (!(pb_write_tag(s, 4, PB_WT_VARINT) && pb_write_int32(s, m.power_dbm))) return false;
+  if (!m.payload.empty() && !(pb_write_tag(s, 5, PB_WT_BYTES) && pb_write_bytes(s, m.payload))) return false;
+  if (!m.mod.empty() && !(pb_write_tag(s, 6, PB_WT_BYTES) && pb_write_bytes(s, m.mod))) return false;
+  if (!m.extra.empty() && !(pb_write_tag(s, 7, PB_WT_BYTES) && pb_write_bytes(s, m.extra))) return false;
+  return true;
+}
+
+static inline bool pb_decode_CC1101Tx(PbIStream &s, CC1101Tx_pb &m) {
+  m = CC1101Tx_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.timestamp_ms = v; break;
+      case 2: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.module = (RadioModuleCC_pb)(int32_t)v; break;
+      case 3: if (wt != PB_WT_32BIT || !pb_read_float(s, m.frequency_mhz)) return false; break;
+      case 4: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.power_dbm = (int32_t)v; break;
+      case 5: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.payload)) return false; break;
+      case 6: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.mod)) return false; break;
+      case 7: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.extra)) return false; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_CC1101Tx(const uint8_t *data, size_t len, CC1101Tx_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_CC1101Tx(s, m);
+}
+
+static inline bool pb_write_msg_CC1101Tx(PbOStream &s, const void *arg) {
+  return pb_encode_CC1101Tx(s, *(const CC1101Tx_pb *)arg);
+}
+static inline bool pb_write_item_CC1101Tx(PbOStream &s, const void *arg, size_t i) {
+  return pb_encode_CC1101Tx(s, ((const CC1101Tx_pb *)arg)[i]);
+}
+// Encode `m` as a message field; it must outlive the encode.
+static inline PbBytes pb_message(const CC1101Tx_pb &m) { return pb_stream(pb_write_msg_CC1101Tx, &m); }
+static inline PbRepeated pb_repeated(const CC1101Tx_pb *items, size_t count) {
+  return PbRepeated{pb_write_item_CC1101Tx, items, count, nullptr, nullptr, 0};
+}
+
+struct LoraTx_pb {
+  uint64_t timestamp_ms = 0;
+  float frequency_mhz = 0;
+  int32_t power_dbm = 0;
+  PbBytes payload = {};
+  PbBytes mod = {};
+  PbBytes extra = {};
+};
+
+static inline bool pb_encode_LoraTx(PbOStream &s, const LoraTx_pb &m) {
+  if (!(pb_write_tag(s, 1, PB_WT_VARINT) && pb_write_varint(s, m.timestamp_ms))) return false;
+  if (!(pb_write_tag(s, 2, PB_WT_32BIT) && pb_write_float(s, m.frequency_mhz))) return false;
+  if (!(pb_write_tag(s, 3, PB_WT_VARINT) && pb_write_int32(s, m.power_dbm))) return false;
+  if (!m.payload.empty() && !(pb_write_tag(s, 4, PB_WT_BYTES) && pb_write_bytes(s, m.payload))) return false;
+  if (!m.mod.empty() && !(pb_write_tag(s, 5, PB_WT_BYTES) && pb_write_bytes(s, m.mod))) return false;
+  if (!m.extra.empty() && !(pb_write_tag(s, 6, PB_WT_BYTES) && pb_write_bytes(s, m.extra))) return false;
+  return true;
+}
+
+static inline bool pb_decode_LoraTx(PbIStream &s, LoraTx_pb &m) {
+  m = LoraTx_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.timestamp_ms = v; break;
+      case 2: if (wt != PB_WT_32BIT || !pb_read_float(s, m.frequency_mhz)) return false; break;
+      case 3: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.power_dbm = (int32_t)v; break;
+      case 4: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.payload)) return false; break;
+      case 5: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.mod)) return false; break;
+      case 6: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.extra)) return false; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_LoraTx(const uint8_t *data, size_t len, LoraTx_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_LoraTx(s, m);
+}
+
+static inline bool pb_write_msg_LoraTx(PbOStream &s, const void *arg) {
+  return pb_encode_LoraTx(s, *(const LoraTx_pb *)arg);
+}
+static inline bool pb_write_item_LoraTx(PbOStream &s, const void *arg, size_t i) {
+  return pb_encode_LoraTx(s, ((const LoraTx_pb *)arg)[i]);
+}
+// Encode `m` as a message field; it must outlive the encode.
+static inline PbBytes pb_message(const LoraTx_pb &m) { return pb_stream(pb_write_msg_LoraTx, &m); }
+static inline PbRepeated pb_repeated(const LoraTx_pb *items, size_t count) {
+  return PbRepeated{pb_write_item_LoraTx, items, count, nullptr, nullptr, 0};
+}
+
+struct NfcWrite_pb {
+  uint64_t timestamp_ms = 0;
+  PbBytes payload = {};
+  PbBytes extra = {};
+};
+
+static inline bool pb_encode_NfcWrite(PbOStream &s, const NfcWrite_pb &m) {
+  if (!(pb_write_tag(s, 1, PB_WT_VARINT) && pb_write_varint(s, m.timestamp_ms))) return false;
+  if (!m.payload.empty() && !(pb_write_tag(s, 2, PB_WT_BYTES) && pb_write_bytes(s, m.payload))) return false;
+  if (!m.extra.empty() && !(pb_write_tag(s, 3, PB_WT_BYTES) && pb_write_bytes(s, m.extra))) return false;
+  return true;
+}
+
+static inline bool pb_decode_NfcWrite(PbIStream &s, NfcWrite_pb &m) {
+  m = NfcWrite_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.timestamp_ms = v; break;
+      case 2: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.payload)) return false; break;
+      case 3: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.extra)) return false; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_NfcWrite(const uint8_t *data, size_t len, NfcWrite_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_NfcWrite(s, m);
+}
+
+struct RFIDWrite_pb {
+  uint64_t timestamp_ms = 0;
+  PbBytes payload = {};
+  PbBytes extra = {};
+};
+
+static inline bool pb_encode_RFIDWrite(PbOStream &s, const RFIDWrite_pb &m) {
+  if (!(pb_write_tag(s, 1, PB_WT_VARINT) && pb_write_varint(s, m.timestamp_ms))) return false;
+  if (!m.payload.empty() && !(pb_write_tag(s, 2, PB_WT_BYTES) && pb_write_bytes(s, m.payload))) return false;
+  if (!m.extra.empty() && !(pb_write_tag(s, 3, PB_WT_BYTES) && pb_write_bytes(s, m.extra))) return false;
+  return true;
+}
+
+static inline bool pb_decode_RFIDWrite(PbIStream &s, RFIDWrite_pb &m) {
+  m = RFIDWrite_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.timestamp_ms = v; break;
+      case 2: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.payload)) return false; break;
+      case 3: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.extra)) return false; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_RFIDWrite(const uint8_t *data, size_t len, RFIDWrite_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_RFIDWrite(s, m);
+}
+
+struct IRTx_pb {
+  uint64_t timestamp_ms = 0;
+  int32_t frequency_khz = 0;
+  PbBytes payload = {};
+  PbBytes extra = {};
+};
+
+static inline bool pb_encode_IRTx(PbOStream &s, const IRTx_pb &m) {
+  if (!(pb_write_tag(s, 1, PB_WT_VARINT) && pb_write_varint(s, m.timestamp_ms))) return false;
+  if (!(pb_write_tag(s, 2, PB_WT_VARINT) && pb_write_int32(s, m.frequency_khz))) return false;
+  if (!m.payload.empty() && !(pb_write_tag(s, 3, PB_WT_BYTES) && pb_write_bytes(s, m.payload))) return false;
+  if (!m.extra.empty() && !(pb_write_tag(s, 4, PB_WT_BYTES) && pb_write_bytes(s, m.extra))) return false;
+  return true;
+}
+
+static inline bool pb_decode_IRTx(PbIStream &s, IRTx_pb &m) {
+  m = IRTx_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 1: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.timestamp_ms = v; break;
+      case 2: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.frequency_khz = (int32_t)v; break;
+      case 3: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.payload)) return false; break;
+      case 4: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.extra)) return false; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_IRTx(const uint8_t *data, size_t len, IRTx_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_IRTx(s, m);
+}
+
+static inline bool pb_write_msg_IRTx(PbOStream &s, const void *arg) {
+  return pb_encode_IRTx(s, *(const IRTx_pb *)arg);
+}
+static inline bool pb_write_item_IRTx(PbOStream &s, const void *arg, size_t i) {
+  return pb_encode_IRTx(s, ((const IRTx_pb *)arg)[i]);
+}
+// Encode `m` as a message field; it must outlive the encode.
+static inline PbBytes pb_message(const IRTx_pb &m) { return pb_stream(pb_write_msg_IRTx, &m); }
+static inline PbRepeated pb_repeated(const IRTx_pb *items, size_t count) {
+  return PbRepeated{pb_write_item_IRTx, items, count, nullptr, nullptr, 0};
+}
+
+struct RadioSignalBatch_pb {
+  uint64_t base_timestamp_ms = 0;
+  RadioModule_pb module = (RadioModule_pb)0;
+  uint32_t base_frequency_khz = 0;
+  uint32_t step_khz = 0;
+  PbBytes modulation = {};
+  PbPackedInt32 rssi_delta = {};
+  PbBytes payload = {};
+  uint32_t payload_stride = 0;
+};
+
+static inline bool pb_encode_RadioSignalBatch(PbOStream &s, const RadioSignalBatch_pb &m) {
+  if (!(pb_write_tag(s, 16, PB_WT_VARINT) && pb_write_varint(s, m.base_timestamp_ms))) return false;
+  if (!(pb_write_tag(s, 17, PB_WT_VARINT) && pb_write_int32(s, (int32_t)m.module))) return false;
+  if (!(pb_write_tag(s, 18, PB_WT_VARINT) && pb_write_varint(s, m.base_frequency_khz))) return false;
+  if (!(pb_write_tag(s, 19, PB_WT_VARINT) && pb_write_varint(s, m.step_khz))) return false;
+  if (!m.modulation.empty() && !(pb_write_tag(s, 20, PB_WT_BYTES) && pb_write_bytes(s, m.modulation))) return false;
+  if (!m.rssi_delta.empty() && !(pb_write_tag(s, 21, PB_WT_BYTES) && pb_write_packed_int32(s, m.rssi_delta, true))) return false;
+  if (!m.payload.empty() && !(pb_write_tag(s, 22, PB_WT_BYTES) && pb_write_bytes(s, m.payload))) return false;
+  if (!(pb_write_tag(s, 23, PB_WT_VARINT) && pb_write_varint(s, m.payload_stride))) return false;
+  return true;
+}
+
+static inline bool pb_decode_RadioSignalBatch(PbIStream &s, RadioSignalBatch_pb &m) {
+  m = RadioSignalBatch_pb();
+  uint32_t field;
+  PbWireType wt;
+  uint64_t v;
+  while (s.p < s.end) {
+    if (!pb_read_tag(s, field, wt)) return false;
+    switch (field) {
+      case 16: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.base_timestamp_ms = v; break;
+      case 17: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.module = (RadioModule_pb)(int32_t)v; break;
+      case 18: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.base_frequency_khz = (uint32_t)v; break;
+      case 19: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.step_khz = (uint32_t)v; break;
+      case 20: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.modulation)) return false; break;
+      case 21: if (wt != PB_WT_BYTES || !pb_read_packed_int32(s, m.rssi_delta)) return false; break;
+      case 22: if (wt != PB_WT_BYTES || !pb_read_bytes(s, m.payload)) return false; break;
+      case 23: if (wt != PB_WT_VARINT || !pb_read_varint(s, v)) return false; m.payload_stride = (uint32_t)v; break;
+      default: if (!pb_skip(s, wt)) return false; break;
+    }
+  }
+  return true;
+}
+
+static inline bool pb_decode_RadioSignalBatch(const uint8_t *data, size_t len, RadioSignalBatch_pb &m) {
+  PbIStream s = pb_istream(data, len);
+  return pb_decode_RadioSignalBatch(s, m);
+}
+
+#endif // SHARKOS_PB_H
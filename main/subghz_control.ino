@@ -5,6 +5,8 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include "transceivers.h"
+#include "bus_workers.h"
+#include "ble_link.h"
 
 extern BLECharacteristic *pStatusChar;
 // extern CC1101 cc1101;
@@ -19,14 +21,13 @@ extern bool paired;
 extern bool pairingMode;
 
 void notifyStatus(const char *s) {
-  if (pStatusChar) {
-    // Use std::string for BLECharacteristic::setValue overload
-    pStatusChar->setValue(String(s));
-    pStatusChar->notify();
-  }
+  if (pStatusChar) ble_link_send((const uint8_t *)s, strlen(s));
 }
 
 void cc1101Read() {
+  // the radios belong to their bus workers while a sweep is queued there
+  bus_worker_wait_idle(SPI_BUS_FSPI);
+  bus_worker_wait_idle(SPI_BUS_HSPI);
   bool didScan = false;
   if (cc1101Tx) {
     cc1101Tx->scan_range();
@@ -41,6 +42,24 @@ void cc1101Read() {
   }
 }
 
+// Queue one sweep per radio on its SPI bus worker so both CC1101s sweep in
+// parallel and the caller returns straight away. Falls back to cc1101Read()
+// when the workers are not running.
+void cc1101ReadAsync() {
+  if (!cc1101Tx && !cc1101Tx2) {
+    notifyStatus("cc1101:read:no-transceiver");
+    return;
+  }
+  bool queued = false;
+  if (cc1101Tx) {
+    queued |= bus_worker_submit(SPI_BUS_FSPI, [](void *arg) { ((CC1101_1Transceiver *)arg)->scan_range(); }, cc1101Tx);
+  }
+  if (cc1101Tx2) {
+    queued |= bus_worker_submit(SPI_BUS_HSPI, [](void *arg) { ((CC1101_2Transceiver *)arg)->scan_range(); }, cc1101Tx2);
+  }
+  if (!queued) cc1101Read();
+}
+
 // --- CC1101 connectivity checks -------------------------------------------------
 // Check primary / secondary modules
 bool cc1101Connected() { 
@@ -391,10 +410,7 @@ void handleOngoingTasks() {
 
       String json;
       serializeJson(doc, json);
-      if (pStatusChar) {
-        pStatusChar->setValue(json);
-        pStatusChar->notify();
-      }
+      notifyStatus(json.c_str());
       Serial.println("Sent NFC data: " + json);
       readingNfc = false; // Stop after one read
     }
@@ -404,5 +420,5 @@ void handleOngoingTasks() {
 }
 
 // handleBLECommand moved to `events.ino` (events subsystem now handles
-// legacy JSON 'Command' messages and dispatches to `dispatch_command_key`)
+// legacy JSON 'Command' messages and dispatches to `dispatch_command`)
 // Original implementation preserved in `events.ino`.
@@ -0,0 +1,107 @@
+#pragma once
+
+// Telemetry sink. Radio producers (transceiver polls, scan_range sweeps, the
+// WiFi scan) publish every sample exactly once; transport subscribers (BLE,
+// Serial, later storage) each pick one wire format. A published sample is
+// encoded at most once per format and only for formats that currently have
+// an active subscriber, so with nobody listening nothing is encoded at all.
+//
+// Main loop only: subscribers write to the BLE stack and Serial. Bus
+// workers report through radio_sample_emit() / radio_sweep_emit() in
+// bus_workers.h, which hand their rings to the sink from the main loop.
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+enum TelemetryFormat : uint8_t {
+  TELEMETRY_FORMAT_PB_FRAME = 0,   // [0xAA 0x55][u16 le len][protobuf] (binary transports)
+  TELEMETRY_FORMAT_PB_BASE64,      // "PROTO:<base64 of the frame>" (text transports)
+  TELEMETRY_FORMAT_JSON_BATCH,     // buffered per module, streamed as {"type":"radio-batch",...}
+  TELEMETRY_FORMAT_COUNT
+};
+
+struct TelemetrySubscriber {
+  const char *name;
+  TelemetryFormat format;
+  bool (*active)();                                 // checked on every publish; nullptr: always
+  void (*write)(const uint8_t *data, size_t len);   // one encoded message (JSON batch: the next piece of one)
+  void (*end)();                                    // JSON batch: the message is complete; may be nullptr
+};
+
+// One radio sample. Pointers only need to live for the publish call.
+struct TelemetrySample {
+  uint64_t timestampMs;
+  int module;                  // RadioModule
+  float frequencyMhz;
+  int32_t rssi;
+  const uint8_t *payload;
+  size_t payloadLen;
+  const char *extra;           // e.g. "scan_range" or an SSID; not NUL-terminated
+  size_t extraLen;
+};
+
+// Steps per RadioSignalBatch frame (.proto).
+static const uint8_t RADIO_SWEEP_CHUNK_STEPS = 64;
+
+// A run of sweep steps: RSSI at baseFrequencyKhz + i * stepKhz, measured
+// at about baseTimestampMs + i * stepMs.
+struct RadioSweepChunk {
+  uint64_t baseTimestampMs;    // millis() at the first step
+  uint32_t baseFrequencyKhz;
+  uint16_t stepKhz;
+  uint16_t stepMs;             // mean time per step, see radio_sweep_chunk_close()
+  int8_t module;               // RadioModule
+  uint8_t modulation;          // ModulationType
+  uint8_t count;
+  int16_t rssi[RADIO_SWEEP_CHUNK_STEPS];
+};
+
+// Add a subscriber. The struct must outlive the sink (static storage).
+// False once TELEMETRY_MAX_SUBSCRIBERS are registered.
+bool telemetry_subscribe(const TelemetrySubscriber *sub);
+
+// The built-in BLE subscriber for TELEMETRY_FORMAT_JSON_BATCH: off until a
+// client asks for it, and then active only while it is connected with
+// framing on (ble_link.h). Cleared on connect and disconnect. Safe from any
+// task.
+void telemetry_set_ble_json(bool on);
+bool telemetry_ble_json();
+
+// Longest JSON batch text the active subscribers can take (the BLE one
+// assembles each batch in a fixed buffer); 0: no limit.
+size_t telemetry_json_batch_limit();
+
+// True if some subscriber wants `format` right now.
+bool telemetry_format_active(TelemetryFormat format);
+
+// Publish a sample, or a sweep chunk (one RadioSignalBatch frame; JSON
+// batch subscribers still get one entry per step).
+void telemetry_publish(const TelemetrySample &s);
+void telemetry_publish_sweep(const RadioSweepChunk &chunk);
+
+// Deliver an already encoded message to the subscribers of its format.
+// Frames are laid out as in pb_codec.h: message bytes at
+// frame + PB_FRAME_HEADER; the header is filled in here.
+void telemetry_send_frame(uint8_t *frame, size_t msgLen);
+void telemetry_send_json_batch(const char *json, size_t len);
+
+// A JSON batch streamed in pieces (the radio TX task in events.ino encodes
+// it a chunk at a time and the main loop passes them on): any number of
+// writes, then one end.
+void telemetry_json_batch_write(const char *data, size_t len);
+void telemetry_json_batch_end();
+
+// Call right after the chunk's last step, before it is emitted.
+static inline void radio_sweep_chunk_close(RadioSweepChunk &chunk) {
+  chunk.stepMs = (uint16_t)(((uint64_t)millis() - chunk.baseTimestampMs) / chunk.count);
+}
+
+static inline TelemetrySample telemetry_sample(int module, float frequency_mhz, int32_t rssi, const uint8_t *payload,
+                                               size_t len, const char *extra) {
+  return TelemetrySample{(uint64_t)millis(), module, frequency_mhz, rssi, payload, len, extra,
+                         extra ? strlen(extra) : 0};
+}
+
+#endif // TELEMETRY_H
@@ -0,0 +1,243 @@
+#include "globals.h"
+#include "telemetry.h"
+#include "sharkos.pb.h"
+#include "base64.h"
+#include "ble_link.h"
+#include "serial_link.h"
+#include "psram_alloc.h"
+
+#include <atomic>
+
+// JSON radio-batch buffers (events.ino).
+extern void events_enqueue_radio_bytes_at(int module, const uint8_t* data, size_t len, float frequency_mhz,
+                                          int32_t rssi, uint64_t timestamp_ms);
+
+static const size_t TELEMETRY_MAX_SUBSCRIBERS = 5;
+static const size_t TELEMETRY_FRAME_CAPACITY = 256;   // largest frames: RadioSignal with SSID + payload, a full sweep chunk
+static const char TELEMETRY_PROTO_PREFIX[] = "PROTO:";
+
+// --- default subscribers ---
+
+// BLE notify on the status characteristic: binary frames (ble_link.h packs
+// them into MTU-sized notifications).
+static bool telemetry_ble_active() { return pStatusChar && anyConnected; }
+static void telemetry_ble_write(const uint8_t *data, size_t len) { ble_link_send(data, len); }
+
+// Serial, for the Rust listener fallback: one PROTO:<base64> line per frame,
+// or in binary mode (serial_link.h) the frame itself on the telemetry channel.
+static bool telemetry_serial_active() { return (bool)Serial && !serial_link_binary(); }
+static void telemetry_serial_write(const uint8_t *data, size_t len) {
+  Serial.write(data, len);
+  Serial.println();
+}
+static bool telemetry_serial_binary_active() { return serial_link_binary(); }
+static void telemetry_serial_binary_write(const uint8_t *data, size_t len) {
+  serial_link_write(SERIAL_CH_TELEMETRY, data, len);
+}
+
+// BLE notify of JSON radio batches, for a client that asks for them
+// (telemetry_set_ble_json). A batch is streamed in pieces but goes out as one
+// message, assembled in a buffer taken from PSRAM on first use; it is longer
+// than a notification, so this waits for framing (ble_link.h). A batch seen
+// only in part, or too long for the buffer, is dropped.
+static const size_t TELEMETRY_BLE_JSON_BYTES = 4096;
+static std::atomic<bool> telemetryBleJson{false};
+static char *telemetryBleJsonBuf = nullptr;
+static size_t telemetryBleJsonLen = 0;
+static bool telemetryBleJsonTaking = false;   // this batch was seen from its first piece
+static bool telemetryJsonBatchOpen = false;   // a piece went out and its end has not
+
+static bool telemetry_ble_json_active() {
+  return telemetryBleJson.load(std::memory_order_relaxed) && telemetry_ble_active() && ble_link_framing();
+}
+
+static void telemetry_ble_json_begin() {
+  telemetryBleJsonLen = 0;
+  telemetryBleJsonTaking = telemetry_ble_json_active();
+  if (telemetryBleJsonTaking && !telemetryBleJsonBuf) {
+    telemetryBleJsonBuf = (char *)psram_alloc(PSRAM_REGION_RADIO_BATCH, TELEMETRY_BLE_JSON_BYTES);
+    telemetryBleJsonTaking = telemetryBleJsonBuf != nullptr;
+  }
+}
+
+static void telemetry_ble_json_write(const uint8_t *data, size_t len) {
+  if (!telemetryBleJsonTaking) return;
+  if (len > TELEMETRY_BLE_JSON_BYTES - telemetryBleJsonLen) {
+    Serial.println("telemetry: radio-batch too long for BLE, dropped");
+    telemetryBleJsonTaking = false;
+    return;
+  }
+  memcpy(telemetryBleJsonBuf + telemetryBleJsonLen, data, len);
+  telemetryBleJsonLen += len;
+}
+
+static void telemetry_ble_json_end() {
+  if (telemetryBleJsonTaking) ble_link_send((const uint8_t *)telemetryBleJsonBuf, telemetryBleJsonLen);
+  telemetryBleJsonTaking = false;
+}
+
+static const TelemetrySubscriber telemetryBle = {"ble", TELEMETRY_FORMAT_PB_FRAME, telemetry_ble_active,
+                                                 telemetry_ble_write, nullptr};
+static const TelemetrySubscriber telemetrySerial = {"serial", TELEMETRY_FORMAT_PB_BASE64, telemetry_serial_active,
+                                                    telemetry_serial_write, nullptr};
+static const TelemetrySubscriber telemetrySerialBinary = {"serial-bin", TELEMETRY_FORMAT_PB_FRAME,
+                                                          telemetry_serial_binary_active, telemetry_serial_binary_write,
+                                                          nullptr};
+
+static const TelemetrySubscriber telemetryBleJsonSub = {"ble-json", TELEMETRY_FORMAT_JSON_BATCH,
+                                                       telemetry_ble_json_active, telemetry_ble_json_write,
+                                                       telemetry_ble_json_end};
+
+static const TelemetrySubscriber *telemetrySubs[TELEMETRY_MAX_SUBSCRIBERS] = {
+    &telemetryBle, &telemetrySerial, &telemetrySerialBinary, &telemetryBleJsonSub};
+static size_t telemetrySubCount = 4;
+
+void telemetry_set_ble_json(bool on) { telemetryBleJson.store(on, std::memory_order_relaxed); }
+
+bool telemetry_ble_json() { return telemetryBleJson.load(std::memory_order_relaxed); }
+
+size_t telemetry_json_batch_limit() { return telemetry_ble_json_active() ? TELEMETRY_BLE_JSON_BYTES : 0; }
+
+bool telemetry_subscribe(const TelemetrySubscriber *sub) {
+  if (!sub || telemetrySubCount >= TELEMETRY_MAX_SUBSCRIBERS) return false;
+  telemetrySubs[telemetrySubCount++] = sub;
+  return true;
+}
+
+static bool telemetry_sub_active(const TelemetrySubscriber &sub) { return !sub.active || sub.active(); }
+
+// Bit per TelemetryFormat with at least one active subscriber.
+static uint8_t telemetry_active_formats() {
+  uint8_t mask = 0;
+  for (size_t i = 0; i < telemetrySubCount; ++i) {
+    if (telemetry_sub_active(*telemetrySubs[i])) mask |= (uint8_t)(1u << telemetrySubs[i]->format);
+  }
+  return mask;
+}
+
+bool telemetry_format_active(TelemetryFormat format) { return telemetry_active_formats() & (1u << format); }
+
+static void telemetry_deliver(TelemetryFormat format, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < telemetrySubCount; ++i) {
+    const TelemetrySubscriber &sub = *telemetrySubs[i];
+    if (sub.format == format && telemetry_sub_active(sub)) sub.write(data, len);
+  }
+}
+
+// Frame subscribers get the bytes as they are; base64 subscribers get one
+// PROTO: line, encoded once into a stack buffer.
+static void telemetry_deliver_frame(uint8_t *frame, size_t msgLen, uint8_t formats) {
+  pb_frame_header(frame, msgLen);
+  size_t frameLen = PB_FRAME_HEADER + msgLen;
+  if (formats & (1u << TELEMETRY_FORMAT_PB_FRAME)) telemetry_deliver(TELEMETRY_FORMAT_PB_FRAME, frame, frameLen);
+  if (formats & (1u << TELEMETRY_FORMAT_PB_BASE64)) {
+    char line[sizeof(TELEMETRY_PROTO_PREFIX) - 1 + base64_encoded_len(TELEMETRY_FRAME_CAPACITY)];
+    memcpy(line, TELEMETRY_PROTO_PREFIX, sizeof(TELEMETRY_PROTO_PREFIX) - 1);
+    size_t n = sizeof(TELEMETRY_PROTO_PREFIX) - 1 + base64_encode_to(frame, frameLen, line + sizeof(TELEMETRY_PROTO_PREFIX) - 1);
+    telemetry_deliver(TELEMETRY_FORMAT_PB_BASE64, (const uint8_t *)line, n);
+  }
+}
+
+void telemetry_send_frame(uint8_t *frame, size_t msgLen) {
+  uint8_t formats = telemetry_active_formats();
+  if (formats & ((1u << TELEMETRY_FORMAT_PB_FRAME) | (1u << TELEMETRY_FORMAT_PB_BASE64))) {
+    telemetry_deliver_frame(frame, msgLen, formats);
+  }
+}
+
+void telemetry_json_batch_write(const char *data, size_t len) {
+  if (!telemetryJsonBatchOpen) {
+    telemetryJsonBatchOpen = true;
+    telemetry_ble_json_begin();
+  }
+  telemetry_deliver(TELEMETRY_FORMAT_JSON_BATCH, (const uint8_t *)data, len);
+}
+
+void telemetry_json_batch_end() {
+  for (size_t i = 0; i < telemetrySubCount; ++i) {
+    const TelemetrySubscriber &sub = *telemetrySubs[i];
+    if (sub.format == TELEMETRY_FORMAT_JSON_BATCH && sub.end && telemetry_sub_active(sub)) sub.end();
+  }
+  telemetryJsonBatchOpen = false;
+}
+
+void telemetry_send_json_batch(const char *json, size_t len) {
+  telemetry_json_batch_write(json, len);
+  telemetry_json_batch_end();
+}
+
+static bool telemetry_wants_frame(uint8_t formats) {
+  return formats & ((1u << TELEMETRY_FORMAT_PB_FRAME) | (1u << TELEMETRY_FORMAT_PB_BASE64));
+}
+
+void telemetry_publish(const TelemetrySample &s) {
+  uint8_t formats = telemetry_active_formats();
+  if (telemetry_wants_frame(formats)) {
+    RadioSignal_pb msg;
+    msg.timestamp_ms = s.timestampMs;
+    msg.module = (RadioModule_pb)s.module;
+    msg.frequency_mhz = s.frequencyMhz;
+    msg.rssi = s.rssi;
+    if (s.payload && s.payloadLen > 0) msg.payload = pb_bytes(s.payload, s.payloadLen);
+    msg.extra = pb_bytes((const uint8_t *)s.extra, s.extraLen);
+
+    uint8_t frame[TELEMETRY_FRAME_CAPACITY];
+    PbOStream o = pb_ostream(frame + PB_FRAME_HEADER, sizeof(frame) - PB_FRAME_HEADER);
+    if (pb_encode_RadioSignal(o, msg)) {
+      telemetry_deliver_frame(frame, o.len, formats);
+    } else {
+      Serial.println("telemetry: RadioSignal does not fit a frame");
+    }
+  }
+  if (formats & (1u << TELEMETRY_FORMAT_JSON_BATCH)) {
+    events_enqueue_radio_bytes_at(s.module, s.payload, s.payloadLen, s.frequencyMhz, s.rssi, s.timestampMs);
+  }
+}
+
+// RSSI is delta-encoded so a step usually costs one byte on air.
+void telemetry_publish_sweep(const RadioSweepChunk &chunk) {
+  if (chunk.count == 0) return;
+  uint8_t formats = telemetry_active_formats();
+  if (telemetry_wants_frame(formats)) {
+    int32_t deltas[RADIO_SWEEP_CHUNK_STEPS];
+    int32_t prev = 0;
+    for (uint8_t i = 0; i < chunk.count; ++i) {
+      deltas[i] = (int32_t)chunk.rssi[i] - prev;
+      prev = chunk.rssi[i];
+    }
+    const char *modulation = modulationToString((ModulationType)chunk.modulation);
+
+    RadioSignalBatch_pb msg;
+    msg.base_timestamp_ms = chunk.baseTimestampMs;
+    msg.module = (RadioModule_pb)chunk.module;
+    msg.base_frequency_khz = chunk.baseFrequencyKhz;
+    msg.step_khz = chunk.stepKhz;
+    msg.modulation = pb_bytes((const uint8_t *)modulation, strlen(modulation));
+    msg.rssi_delta.values = deltas;
+    msg.rssi_delta.count = chunk.count;
+
+    uint8_t frame[TELEMETRY_FRAME_CAPACITY];
+    PbOStream o = pb_ostream(frame + PB_FRAME_HEADER, sizeof(frame) - PB_FRAME_HEADER);
+    if (pb_encode_RadioSignalBatch(o, msg)) {
+      telemetry_deliver_frame(frame, o.len, formats);
+    } else {
+      Serial.println("telemetry: RadioSignalBatch does not fit a frame");
+    }
+  }
+  if (formats & (1u << TELEMETRY_FORMAT_JSON_BATCH)) {
+    // the per-step sample scan_range used to buffer: modulation, freq kHz
+    // (LE32), rssi, module
+    for (uint8_t i = 0; i < chunk.count; ++i) {
+      uint32_t freqKhz = chunk.baseFrequencyKhz + (uint32_t)i * chunk.stepKhz;
+      uint8_t sample[7] = {chunk.modulation,
+                           (uint8_t)(freqKhz & 0xFF),
+                           (uint8_t)((freqKhz >> 8) & 0xFF),
+                           (uint8_t)((freqKhz >> 16) & 0xFF),
+                           (uint8_t)((freqKhz >> 24) & 0xFF),
+                           (uint8_t)(chunk.rssi[i] & 0xFF),
+                           (uint8_t)chunk.module};
+      events_enqueue_radio_bytes_at(chunk.module, sample, sizeof(sample), freqKhz / 1000.0f, chunk.rssi[i],
+                                    chunk.baseTimestampMs + (uint64_t)i * chunk.stepMs);
+    }
+  }
+}
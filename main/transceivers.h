@@ -8,19 +8,29 @@
 #include "globals.h"
 #include <ELECHOUSE_CC1101_SRC_DRV.h>
 
-// Forward declaration of event enqueue function implemented in events.ino
-extern void events_enqueue_radio_bytes(int module, const uint8_t* data, size_t len, float frequency_mhz, int32_t rssi);
-extern void hw_send_radio_signal_protobuf(int module, float frequency_mhz, int32_t rssi, const uint8_t* data, size_t len, const char* extra);
+extern bool events_preempt_requested();
+// radio_sweep_emit(): queued when called on a bus worker
+#include "bus_workers.h"
+// telemetry_publish(): received packets, main loop
+#include "telemetry.h"
 
 // Forward declarations of hardware helpers (must be available at link time)
 void cc1101Read();
+void cc1101ReadAsync();
 void loraRead();
 void nrfscanner();
 
 // --- Transceiver base class ---
 class Transceiver {
 public:
-  virtual bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, const String &extra = "") = 0;
+  virtual bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, StrView extra = StrView()) = 0;
+protected:
+  static void publishPacket(int module, const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi, StrView extra) {
+    TelemetrySample s = telemetry_sample(module, freq_mhz, rssi, payload.data(), payload.size(), nullptr);
+    s.extra = extra.data;
+    s.extraLen = extra.len;
+    telemetry_publish(s);
+  }
 };
 
 class CC1101_1Transceiver : public Transceiver {
@@ -33,9 +43,9 @@ public:
   
   CC1101_1Transceiver(ELECHOUSE_CC1101 *d): dev(d), moduleId(CC1101_1), topFreqMHz(433.0f), botFreqMHz(400.0f), modulation(MOD_OOK) {}
   
-  bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, const String &extra = "") override {
-    // enqueue raw bytes into events subsystem which will batch and notify
-    events_enqueue_radio_bytes((int)moduleId, payload.data(), payload.size(), freq_mhz, rssi);
+  bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, StrView extra = StrView()) override {
+    // published once; each telemetry subscriber encodes it in its own format
+    publishPacket((int)moduleId, payload, freq_mhz, rssi, extra);
     return true;
   }
   // start/stop loop mode and polling
@@ -47,20 +57,10 @@ public:
     // Delegate to existing cc1101Read helper (non-blocking placeholder)
     cc1101Read();
   }
-  void setModulation(const String &modStr) {
-    // -------- Parse string ----------
-    if (modStr == "OOK" || modStr == "ASK") {
-      modulation = MOD_OOK;
-    } else if (modStr == "2-FSK") {
-      modulation = MOD_2FSK;
-    } else if (modStr == "GFSK") {
-      modulation = MOD_GFSK;
-    } else if (modStr == "MSK") {
-      modulation = MOD_MSK;
-    } else {
-      modulation = MOD_UNKNOWN;
-      return;
-    }
+  // Names are parsed once, by the command handler (modulationFromString).
+  void setModulation(ModulationType m) {
+    modulation = m == MOD_ASK ? MOD_OOK : m;  // the CC1101 does ASK as OOK
+    if (modulation == MOD_UNKNOWN) return;
 
     // -------- Apply to CC1101 --------
     dev->SpiStrobe(CC1101_SIDLE); // Enter IDLE state
@@ -117,8 +117,6 @@ public:
       stepMHz = 0.20f;
     }
 
-    extern bool scanningRadio; // from hardware-utils or events
-
     // Sync CC1101's OOK flag for simple modulations
     if (modulation == MOD_OOK || modulation == MOD_ASK) {
       dev->setModulation(2);
@@ -128,25 +126,40 @@ public:
     dev->SetRx();
     delay(2); // initial RX settle
 
-    for (float f = low; f <= high && scanningRadio; f += stepMHz) {
+    // Step in whole kHz so each RadioSignalBatch chunk is exactly
+    // base + i * step; RSSI goes out once per chunk, not once per step.
+    const uint32_t lowKhz = (uint32_t)(low * 1000.0f + 0.5f);
+    const uint32_t highKhz = (uint32_t)(high * 1000.0f + 0.5f);
+    const uint32_t stepKhz = (uint32_t)(stepMHz * 1000.0f + 0.5f);
+    RadioSweepChunk chunk;
+    chunk.stepKhz = (uint16_t)stepKhz;
+    chunk.module = (int8_t)moduleId;
+    chunk.modulation = (uint8_t)modulation;
+    chunk.count = 0;
+
+    for (uint32_t freq_khz = lowKhz; freq_khz <= highKhz && scanningRadio && !events_preempt_requested();
+         freq_khz += stepKhz) {
+      float f = freq_khz / 1000.0f;
       dev->setMHZ(f);
       // Re-enter RX after frequency change for RSSI to update
       dev->SetRx();
       delay(1); // 1ms settle for RSSI register to update
       int32_t rssi = (int32_t)dev->getRssi();
 
-      uint32_t freq_khz = (uint32_t)(f * 1000.0f);
-      uint8_t sample[7];
-      sample[0] = (uint8_t)modulation;
-      sample[1] = (uint8_t)(freq_khz & 0xFF);
-      sample[2] = (uint8_t)((freq_khz >> 8) & 0xFF);
-      sample[3] = (uint8_t)((freq_khz >> 16) & 0xFF);
-      sample[4] = (uint8_t)((freq_khz >> 24) & 0xFF);
-      sample[5] = (uint8_t)(rssi & 0xFF);
-      sample[6] = (uint8_t)moduleId;
-
-      events_enqueue_radio_bytes((int)moduleId, sample, sizeof(sample), f, rssi);
-      hw_send_radio_signal_protobuf((int)moduleId, f, rssi, sample, sizeof(sample), "scan_range");
+      if (chunk.count == 0) {
+        chunk.baseTimestampMs = (uint64_t)millis();
+        chunk.baseFrequencyKhz = freq_khz;
+      }
+      chunk.rssi[chunk.count++] = (int16_t)rssi;
+      if (chunk.count == RADIO_SWEEP_CHUNK_STEPS) {
+        radio_sweep_chunk_close(chunk);
+        radio_sweep_emit(chunk);
+        chunk.count = 0;
+      }
+    }
+    if (chunk.count > 0) {
+      radio_sweep_chunk_close(chunk);
+      radio_sweep_emit(chunk);
     }
   }
 };
@@ -159,27 +172,17 @@ public:
   float botFreqMHz;
   ModulationType modulation;
   CC1101_2Transceiver(ELECHOUSE_CC1101 *d): dev(d), moduleId(CC1101_2), topFreqMHz(433.0f), botFreqMHz(400.0f), modulation(MOD_2FSK) {}
-  bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, const String &extra = "") override {
-    events_enqueue_radio_bytes((int)moduleId, payload.data(), payload.size(), freq_mhz, rssi);
+  bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, StrView extra = StrView()) override {
+    publishPacket((int)moduleId, payload, freq_mhz, rssi, extra);
     return true;
   }
   bool receiving = false;
   void startReceiveLoop() { receiving = true; }
   void stopReceiveLoop() { receiving = false; }
   void poll() { if (!receiving) return; cc1101Read(); }
-  void setModulation(const String &modStr) {
-    if (modStr == "OOK" || modStr == "ASK") {
-      modulation = MOD_OOK;
-    } else if (modStr == "2-FSK") {
-      modulation = MOD_2FSK;
-    } else if (modStr == "GFSK") {
-      modulation = MOD_GFSK;
-    } else if (modStr == "MSK") {
-      modulation = MOD_MSK;
-    } else {
-      modulation = MOD_UNKNOWN;
-      return;
-    }
+  void setModulation(ModulationType m) {
+    modulation = m == MOD_ASK ? MOD_OOK : m;
+    if (modulation == MOD_UNKNOWN) return;
 
     dev->SpiStrobe(CC1101_SIDLE);
     switch (modulation) {
@@ -230,8 +233,6 @@ public:
       stepMHz = 0.20f;
     }
 
-    extern bool scanningRadio; // from hardware-utils or events
-
     if (modulation == MOD_OOK || modulation == MOD_ASK) {
       dev->setModulation(2);
     } 
@@ -239,24 +240,37 @@ public:
     dev->SetRx();
     delay(2); 
 
-    for (float f = low; f <= high && scanningRadio; f += stepMHz) {
+    const uint32_t lowKhz = (uint32_t)(low * 1000.0f + 0.5f);
+    const uint32_t highKhz = (uint32_t)(high * 1000.0f + 0.5f);
+    const uint32_t stepKhz = (uint32_t)(stepMHz * 1000.0f + 0.5f);
+    RadioSweepChunk chunk;
+    chunk.stepKhz = (uint16_t)stepKhz;
+    chunk.module = (int8_t)moduleId;
+    chunk.modulation = (uint8_t)modulation;
+    chunk.count = 0;
+
+    for (uint32_t freq_khz = lowKhz; freq_khz <= highKhz && scanningRadio && !events_preempt_requested();
+         freq_khz += stepKhz) {
+      float f = freq_khz / 1000.0f;
       dev->setMHZ(f);
       dev->SetRx();
       delay(1); 
       int32_t rssi = (int32_t)dev->getRssi();
 
-      uint32_t freq_khz = (uint32_t)(f * 1000.0f);
-      uint8_t sample[7];
-      sample[0] = (uint8_t)modulation;
-      sample[1] = (uint8_t)(freq_khz & 0xFF);
-      sample[2] = (uint8_t)((freq_khz >> 8) & 0xFF);
-      sample[3] = (uint8_t)((freq_khz >> 16) & 0xFF);
-      sample[4] = (uint8_t)((freq_khz >> 24) & 0xFF);
-      sample[5] = (uint8_t)(rssi & 0xFF);
-      sample[6] = (uint8_t)moduleId;
-
-      events_enqueue_radio_bytes((int)moduleId, sample, sizeof(sample), f, rssi);
-      hw_send_radio_signal_protobuf((int)moduleId, f, rssi, sample, sizeof(sample), "scan_range");
+      if (chunk.count == 0) {
+        chunk.baseTimestampMs = (uint64_t)millis();
+        chunk.baseFrequencyKhz = freq_khz;
+      }
+      chunk.rssi[chunk.count++] = (int16_t)rssi;
+      if (chunk.count == RADIO_SWEEP_CHUNK_STEPS) {
+        radio_sweep_chunk_close(chunk);
+        radio_sweep_emit(chunk);
+        chunk.count = 0;
+      }
+    }
+    if (chunk.count > 0) {
+      radio_sweep_chunk_close(chunk);
+      radio_sweep_emit(chunk);
     }
   }
 };
@@ -265,8 +279,8 @@ class LoRaTransceiver : public Transceiver {
 public:
   SX1276 *dev;
   LoRaTransceiver(SX1276 *d): dev(d) {}
-  bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, const String &extra = "") override {
-    events_enqueue_radio_bytes((int)LORA, payload.data(), payload.size(), freq_mhz, rssi);
+  bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, StrView extra = StrView()) override {
+    publishPacket((int)LORA, payload, freq_mhz, rssi, extra);
     return true;
   }
   bool receiving = false;
@@ -279,8 +293,8 @@ class NRF24Transceiver : public Transceiver {
 public:
   RF24 *dev;
   NRF24Transceiver(RF24 *d): dev(d) {}
-  bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, const String &extra = "") override {
-    events_enqueue_radio_bytes((int)BLUETOOTH, payload.data(), payload.size(), freq_mhz, rssi);
+  bool sendPacket(const std::vector<uint8_t> &payload, float freq_mhz, int32_t rssi = 0, StrView extra = StrView()) override {
+    publishPacket((int)BLUETOOTH, payload, freq_mhz, rssi, extra);
     return true;
   }
   bool receiving = false;
@@ -1,4 +1,5 @@
 #include "globals.h"
+#include "events.h"
 void handlewifimenu() {
   const char* menuItems[] = {"SCAN WIFI", "PACKET ANALYZER", "BEACON", "CAPTIVE PORTAL", "DEAUTH DETECTOR"};
   const int menuLength = sizeof(menuItems) / sizeof(menuItems[0]);
@@ -36,6 +37,7 @@ void handlewifimenu() {
 
 
        WiFi.mode(WIFI_STA);
+       events_presence_invalidate();
        WiFi.disconnect();
        delay(100);
        wifi_networkCount = WiFi.scanNetworks();
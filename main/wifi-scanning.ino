@@ -31,7 +31,7 @@ void scanningwifi() {
 
 }
 
-String wifi_encryptionType(wifi_auth_mode_t encryption) {
+const char *wifi_encryptionType(wifi_auth_mode_t encryption) {
   switch (encryption) {
     case WIFI_AUTH_OPEN: return "Open";
     case WIFI_AUTH_WEP: return "WEP";